@@ -0,0 +1,165 @@
+// FrameLoopBench.cpp : Runs the DLL's frame loop on the simulated HMD backend and times it.
+// Usage: FrameLoopBench [frames]
+// Needs no Rift and no Oculus runtime, only an OpenGL driver: the GL context lives on a
+// hidden window. Prints the per-phase latency percentiles from the DLL's telemetry for
+// the synchronous loop and for the async submit thread, and returns non-zero if any
+// export fails or the tracking sampler misses its rate by more than 10%. Build it
+// against the DLL's import library, e.g.
+// cl /EHsc /I..\OculusSDK\LibOVR\Include /I..\OculusSDK\LibOVRKernel\Src /I..\OculusDK2Dll
+//    FrameLoopBench.cpp OculusDK2Dll.lib opengl32.lib user32.lib gdi32.lib
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "OVR_CAPI_GL.h"
+#include "OculusDK2Dll.h"
+#include "HmdBackend.h"
+#include "FrameTelemetry.h"
+
+
+static const char* PhaseNames[OVR_Phase_Count] = {
+	"GetTrackingState",
+	"PrepareOGLContext",
+	"CleanOGLContext",
+	"SubmitFrame",
+	"FrameInterval"
+};
+
+static int failures = 0;
+
+// Reports a failed export; the run goes on so one failure doesn't hide the others
+static bool check(int result, const char* call) {
+	if (result < 0) {
+		fprintf(stderr, "FrameLoopBench: %s failed (%d)\n", call, result);
+		++failures;
+		return false;
+	}
+	return true;
+}
+
+// Hidden window with a GL context current on this thread
+static bool createGLContext() {
+	WNDCLASSA wc = {};
+	wc.style = CS_OWNDC;
+	wc.lpfnWndProc = DefWindowProcA;
+	wc.hInstance = GetModuleHandleA(NULL);
+	wc.lpszClassName = "FrameLoopBench";
+	if (!RegisterClassA(&wc)) {
+		return false;
+	}
+	HWND window = CreateWindowA(wc.lpszClassName, "FrameLoopBench", WS_OVERLAPPEDWINDOW,
+		0, 0, 640, 480, NULL, NULL, wc.hInstance, NULL);
+	if (!window) {
+		return false;
+	}
+
+	HDC dc = GetDC(window);
+	PIXELFORMATDESCRIPTOR pfd = {};
+	pfd.nSize = sizeof(pfd);
+	pfd.nVersion = 1;
+	pfd.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
+	pfd.iPixelType = PFD_TYPE_RGBA;
+	pfd.cColorBits = 32;
+	pfd.cDepthBits = 24;
+	pfd.cStencilBits = 8;
+	if (!SetPixelFormat(dc, ChoosePixelFormat(dc, &pfd), &pfd)) {
+		return false;
+	}
+	HGLRC context = wglCreateContext(dc);
+	return context && wglMakeCurrent(dc, context);
+}
+
+// Runs frames of the loop the engine runs, as in the XVR sample
+static void runFrames(int frames) {
+	for (int i = 0; i < frames; ++i) {
+		check(OVR_GetTrackingState(), "OVR_GetTrackingState");
+		check(OVR_PrepareOGLContext(), "OVR_PrepareOGLContext");
+		// The engine renders the scene here
+		check(OVR_CleanOGLContext(), "OVR_CleanOGLContext");
+		check(OVR_SubmitFrame(), "OVR_SubmitFrame");
+	}
+}
+
+// Runs the tracking sampler for a while and checks the rate it measured against the
+// requested one. Sleep granularity used to cap it near 64Hz.
+static void checkSamplerRate(int rateHz) {
+	if (!check(OVR_StartTrackingSampler(rateHz), "OVR_StartTrackingSampler")) {
+		return;
+	}
+	Sleep(2500);
+	int requestedHz = 0, measuredHz = 0;
+	check(OVR_GetTrackingSamplerRate(requestedHz, measuredHz), "OVR_GetTrackingSamplerRate");
+	check(OVR_StopTrackingSampler(), "OVR_StopTrackingSampler");
+
+	bool ok = (measuredHz >= requestedHz * 9 / 10) && (measuredHz <= requestedHz * 11 / 10);
+	printf("Tracking sampler: requested %d Hz, measured %d Hz%s\n", requestedHz, measuredHz, ok ? "" : " (FAILED)");
+	if (!ok) {
+		++failures;
+	}
+}
+
+static void printTelemetry(const char* title) {
+	printf("%s\n", title);
+	printf("  %-18s %8s %8s %8s %8s\n", "phase (ms)", "count", "p50", "p99", "p99.9");
+	for (int phase = 0; phase < OVR_Phase_Count; ++phase) {
+		float p50, p99, p999;
+		int count = OVR_GetPhaseLatency(phase, p50, p99, p999);
+		printf("  %-18s %8d %8.3f %8.3f %8.3f\n", PhaseNames[phase], count, p50, p99, p999);
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	int frames = (argc > 1) ? atoi(argv[1]) : 1000;
+	if (frames <= 0) {
+		fprintf(stderr, "Usage: FrameLoopBench [frames]\n");
+		return 1;
+	}
+
+	if (!createGLContext()) {
+		fprintf(stderr, "FrameLoopBench: can't create an OpenGL context\n");
+		return 1;
+	}
+
+	if (!check(OVR_SelectBackend(OVR_Backend_Simulated), "OVR_SelectBackend") ||
+		!check(OVR_Initialize(), "OVR_Initialize")) {
+		return 1;
+	}
+	OVR_Create();
+	check(OVR_ConfigureTracking(), "OVR_ConfigureTracking");
+	check(OVR_CreateSwapTextureSetGL(), "OVR_CreateSwapTextureSetGL");
+	check(OVR_PrepareFrameRendering(), "OVR_PrepareFrameRendering");
+	OVR_SetTelemetryEnabled(1);
+
+	// Warm up, then time the loop with the submit on the engine thread
+	runFrames(frames / 10 + 1);
+	OVR_ResetTelemetry();
+	runFrames(frames);
+	printTelemetry("Synchronous submit:");
+
+	// Same loop with the submit thread, at the deepest queue it accepts
+	if (check(OVR_StartAsyncSubmit(2), "OVR_StartAsyncSubmit")) {
+		runFrames(frames / 10 + 1);
+		OVR_ResetTelemetry();
+		runFrames(frames);
+		check(OVR_StopAsyncSubmit(), "OVR_StopAsyncSubmit");
+		printTelemetry("Async submit, 2 frames ahead:");
+	}
+
+	checkSamplerRate(250);
+	checkSamplerRate(500);
+
+	check(OVR_Destroy(), "OVR_Destroy");
+
+	if (failures) {
+		fprintf(stderr, "FrameLoopBench: %d calls failed\n", failures);
+		return 2;
+	}
+	return 0;
+}
@@ -0,0 +1,160 @@
+// ArrayBench.cpp : Times OVR::Array growth for the element types the samples keep in arrays.
+// Usage: ArrayBench [elements]
+// Grows arrays from empty to the given number of elements (default 1M) and prints the
+// average ns per element for:
+//   - Array<Ptr<Model>> filled with PushBack(*new Model), which hands the reference over
+//   - ArrayCPP of Ptr<Model>, relocated with Realloc as it grows, against the same
+//     pointer in a wrapper that isn't declared relocatable and so is moved one by one
+//   - Array and ArrayCPP of a Render::Vertex-sized vertex, with PushBack and EmplaceBack
+// Build it against LibOVRKernel, in release, e.g.
+// cl /O2 /EHsc /I..\OculusSDK\LibOVRKernel\Src ArrayBench.cpp LibOVRKernel.lib
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Kernel/OVR_System.h"
+#include "Kernel/OVR_Timer.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_RefCount.h"
+
+using namespace OVR;
+
+
+// Same size and layout as Render::Vertex
+struct Vec3
+{
+	float x, y, z;
+	Vec3(float ax = 0, float ay = 0, float az = 0) : x(ax), y(ay), z(az) {}
+};
+
+struct Vertex
+{
+	Vec3     Pos;
+	uint32_t C;
+	float    U, V;
+	float    U2, V2;
+	Vec3     Norm;
+
+	Vertex(const Vec3& p, uint32_t c = 0, float u = 0, float v = 0)
+		: Pos(p), C(c), U(u), V(v), U2(u), V2(v) {}
+};
+
+struct Model : public RefCountBase<Model>
+{
+	int   Id;
+	float Transform[16];
+	Model(int id) : Id(id) {}
+};
+
+// Holds the same Ptr, but isn't declared trivially relocatable
+struct ModelRef
+{
+	Ptr<Model> pModel;
+	ModelRef(Model* model) : pModel(model) {}
+};
+
+
+static double nsPerElement(uint64_t start, uint64_t end, int elements, int repeats)
+{
+	return (double)(end - start) / ((double)elements * repeats);
+}
+
+static void printResult(const char* name, double ns)
+{
+	printf("  %-40s %7.2f ns/element\n", name, ns);
+	fflush(stdout);
+}
+
+static void benchModels(int count, int repeats)
+{
+	Array<Ptr<Model> > pool;
+	for (int i = 0; i < count; i++)
+		pool.PushBack(*new Model(i));
+
+	uint64_t t0 = Timer::GetTicksNanos();
+	for (int r = 0; r < repeats; r++)
+	{
+		Array<Ptr<Model> > models;
+		for (int i = 0; i < count; i++)
+			models.PushBack(*new Model(i));
+	}
+	uint64_t t1 = Timer::GetTicksNanos();
+	for (int r = 0; r < repeats; r++)
+	{
+		ArrayCPP<Ptr<Model> > models;
+		for (int i = 0; i < count; i++)
+			models.PushBack(pool[i]);
+	}
+	uint64_t t2 = Timer::GetTicksNanos();
+	for (int r = 0; r < repeats; r++)
+	{
+		ArrayCPP<ModelRef> models;
+		for (int i = 0; i < count; i++)
+			models.PushBack(ModelRef(pool[i]));
+	}
+	uint64_t t3 = Timer::GetTicksNanos();
+
+	printf("%d models\n", count);
+	printResult("Array<Ptr<Model>> PushBack(*new Model)", nsPerElement(t0, t1, count, repeats));
+	printResult("ArrayCPP<Ptr<Model>> PushBack, relocated", nsPerElement(t1, t2, count, repeats));
+	printResult("ArrayCPP<ModelRef> PushBack, moved", nsPerElement(t2, t3, count, repeats));
+}
+
+static void benchVertices(int count, int repeats)
+{
+	uint64_t t0 = Timer::GetTicksNanos();
+	for (int r = 0; r < repeats; r++)
+	{
+		Array<Vertex> vertices;
+		for (int i = 0; i < count; i++)
+			vertices.PushBack(Vertex(Vec3((float)i, 1, 2), 0xff, 0.5f, 0.5f));
+	}
+	uint64_t t1 = Timer::GetTicksNanos();
+	for (int r = 0; r < repeats; r++)
+	{
+		ArrayCPP<Vertex> vertices;
+		for (int i = 0; i < count; i++)
+			vertices.PushBack(Vertex(Vec3((float)i, 1, 2), 0xff, 0.5f, 0.5f));
+	}
+	uint64_t t2 = Timer::GetTicksNanos();
+
+	printf("%d vertices (%u bytes each)\n", count, (unsigned)sizeof(Vertex));
+	printResult("Array<Vertex> PushBack", nsPerElement(t0, t1, count, repeats));
+	printResult("ArrayCPP<Vertex> PushBack", nsPerElement(t1, t2, count, repeats));
+
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES) && !defined(OVR_CPP_NO_VARIADIC_TEMPLATES)
+	uint64_t t3 = Timer::GetTicksNanos();
+	for (int r = 0; r < repeats; r++)
+	{
+		Array<Vertex> vertices;
+		for (int i = 0; i < count; i++)
+			vertices.EmplaceBack(Vec3((float)i, 1, 2), 0xffu, 0.5f, 0.5f);
+	}
+	uint64_t t4 = Timer::GetTicksNanos();
+	printResult("Array<Vertex> EmplaceBack", nsPerElement(t3, t4, count, repeats));
+#endif
+}
+
+
+int main(int argc, char* argv[])
+{
+	int count = (argc > 1) ? atoi(argv[1]) : 1000000;
+	if (count <= 0)
+	{
+		fprintf(stderr, "Usage: ArrayBench [elements]\n");
+		return 1;
+	}
+	// About the same total work for any count
+	int repeats = Alg::Max(1, 20000000 / count);
+
+	System::Init(Log::ConfigureDefaultLog(LogMask_None));
+
+	benchModels(count, repeats);
+	benchVertices(count, repeats);
+
+	System::Destroy();
+	return 0;
+}
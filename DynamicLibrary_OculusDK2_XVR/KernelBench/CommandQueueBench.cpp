@@ -0,0 +1,170 @@
+// CommandQueueBench.cpp : Times OVR::LocklessCommandQueue against OVR::ThreadCommandQueue.
+// Usage: CommandQueueBench [commands]
+// Starts one consumer thread and 1, 2, 4, 8 and 16 producer threads that share the given
+// number of commands (default 2M) and prints the ns per command for each queue, first
+// with PushCall, then with PushCallAndWaitResult on a tenth as many commands. The
+// producers push small calls, as the tracking and loader threads do to the render
+// thread. Lock convoying only shows with more cores than producers to run them; run
+// it on a multicore machine. Build it against LibOVRKernel, in release, e.g.
+// cl /O2 /EHsc /I..\OculusSDK\LibOVRKernel\Src CommandQueueBench.cpp LibOVRKernel.lib
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Kernel/OVR_System.h"
+#include "Kernel/OVR_Timer.h"
+#include "Kernel/OVR_Threads.h"
+#include "Kernel/OVR_ThreadCommandQueue.h"
+
+using namespace OVR;
+
+
+static const int MaxProducers = 16;
+
+// The consumer sleeps on the _Locked notifications, as the SDK's device threads do
+class LockedQueue : public ThreadCommandQueue
+{
+public:
+	LockedQueue() : Sum(0) { }
+
+	virtual void OnPushNonEmpty_Locked() { CommandEvent.SetEvent(); }
+	virtual void OnPopEmpty_Locked()     { CommandEvent.ResetEvent(); }
+
+	void WaitForCommand()      { CommandEvent.Wait(); }
+	Void Add(int value)        { Sum += value; return Void(); }
+	int  AddResult(int value)  { Sum += value; return value; }
+
+	int64_t Sum;
+
+private:
+	Event   CommandEvent;
+};
+
+class LocklessQueue : public LocklessCommandQueue
+{
+public:
+	LocklessQueue() : Sum(0) { }
+
+	Void Add(int value)        { Sum += value; return Void(); }
+	int  AddResult(int value)  { Sum += value; return value; }
+
+	int64_t Sum;
+};
+
+template<class Q>
+class ConsumerThread : public Thread
+{
+public:
+	ConsumerThread(Q* queue) : pQueue(queue) { }
+
+	virtual int Run()
+	{
+		ThreadCommand::PopBuffer command;
+		while (!pQueue->IsExiting())
+		{
+			if (pQueue->PopCommand(&command))
+				command.Execute();
+			else
+				pQueue->WaitForCommand();
+		}
+		return 0;
+	}
+
+private:
+	Q* pQueue;
+};
+
+template<class Q>
+class ProducerThread : public Thread
+{
+public:
+	ProducerThread(Q* queue, int commands, bool wait)
+		: pQueue(queue), Commands(commands), WaitResult(wait) { }
+
+	virtual int Run()
+	{
+		for (int i = 0; i < Commands; i++)
+		{
+			if (WaitResult)
+			{
+				int result;
+				pQueue->PushCallAndWaitResult(&Q::AddResult, &result, 1);
+			}
+			else
+			{
+				pQueue->PushCall(&Q::Add, 1);
+			}
+		}
+		return 0;
+	}
+
+private:
+	Q*   pQueue;
+	int  Commands;
+	bool WaitResult;
+};
+
+// Returns ns per command, from the first push to the exit command being processed
+template<class Q>
+static double runQueue(int producers, int commands, bool wait)
+{
+	Q queue;
+	Ptr<ConsumerThread<Q> > consumer = *new ConsumerThread<Q>(&queue);
+	consumer->Start();
+
+	Ptr<ProducerThread<Q> > threads[MaxProducers];
+	int perProducer = commands / producers;
+	for (int i = 0; i < producers; i++)
+		threads[i] = *new ProducerThread<Q>(&queue, perProducer, wait);
+
+	uint64_t start = Timer::GetTicksNanos();
+	for (int i = 0; i < producers; i++)
+		threads[i]->Start();
+	for (int i = 0; i < producers; i++)
+		threads[i]->Join();
+	queue.PushExitCommand(true);
+	uint64_t end = Timer::GetTicksNanos();
+	consumer->Join();
+
+	if (queue.Sum != (int64_t)perProducer * producers)
+	{
+		fprintf(stderr, "CommandQueueBench: lost commands\n");
+		exit(1);
+	}
+	return (double)(end - start) / ((double)perProducer * producers);
+}
+
+static void benchQueues(int commands, bool wait)
+{
+	printf("%s, %d commands\n", wait ? "PushCallAndWaitResult" : "PushCall", commands);
+	for (int producers = 1; producers <= MaxProducers; producers *= 2)
+	{
+		double locked   = runQueue<LockedQueue>(producers, commands, wait);
+		double lockless = runQueue<LocklessQueue>(producers, commands, wait);
+		printf("  %2d producers  ThreadCommandQueue %8.1f  LocklessCommandQueue %8.1f ns/command\n",
+			producers, locked, lockless);
+		fflush(stdout);
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	int commands = (argc > 1) ? atoi(argv[1]) : 2000000;
+	if (commands < 10 * MaxProducers)
+	{
+		fprintf(stderr, "Usage: CommandQueueBench [commands]\n");
+		return 1;
+	}
+
+	System::Init(Log::ConfigureDefaultLog(LogMask_None));
+
+	benchQueues(commands, false);
+	benchQueues(commands / 10, true);
+
+	System::Destroy();
+	return 0;
+}
@@ -0,0 +1,172 @@
+// HashBench.cpp : Times OVR::FlatHash against OVR::Hash, and FlatStringHash against StringHash.
+// Usage: HashBench [maxEntries]
+// For each table size from 1K entries up to maxEntries (default 10M) prints the average
+// ns per insert, lookup hit, lookup miss and erase. String keys stop at 1M entries
+// unless maxEntries asks for more, since 10M Strings take over a gigabyte. Build it
+// against LibOVRKernel, in release, e.g.
+// cl /O2 /EHsc /I..\OculusSDK\LibOVRKernel\Src HashBench.cpp LibOVRKernel.lib
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Kernel/OVR_System.h"
+#include "Kernel/OVR_Timer.h"
+#include "Kernel/OVR_Hash.h"
+#include "Kernel/OVR_FlatHash.h"
+#include "Kernel/OVR_StringHash.h"
+
+using namespace OVR;
+
+
+// Keeps the optimizer from dropping the lookups
+static volatile size_t Sink;
+
+static uint64_t nextRandom(uint64_t& state)
+{
+	// splitmix64
+	uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+struct Result
+{
+	double Insert, Hit, Miss, Erase;
+};
+
+static double nsPerOp(uint64_t start, uint64_t end, size_t count)
+{
+	return (double)(end - start) / (double)count;
+}
+
+// Hits are looked up in a scattered order, so they don't walk the table in insert order
+template<class H, class K>
+static Result runTable(const K* keys, const K* missKeys, size_t count, int repeats)
+{
+	Result total = { 0, 0, 0, 0 };
+	for (int r = 0; r < repeats; r++)
+	{
+		H* table = new H;
+		size_t found = 0;
+
+		uint64_t t0 = Timer::GetTicksNanos();
+		for (size_t i = 0; i < count; i++)
+			table->Set(keys[i], i);
+		uint64_t t1 = Timer::GetTicksNanos();
+		for (size_t i = 0; i < count; i++)
+			found += *table->Get(keys[(i * 7919) % count]);
+		uint64_t t2 = Timer::GetTicksNanos();
+		for (size_t i = 0; i < count; i++)
+			found += table->Get(missKeys[i]) != 0;
+		uint64_t t3 = Timer::GetTicksNanos();
+		for (size_t i = 0; i < count; i++)
+			table->Remove(keys[i]);
+		uint64_t t4 = Timer::GetTicksNanos();
+
+		Sink = found + table->GetSize();
+		delete table;
+
+		total.Insert += nsPerOp(t0, t1, count);
+		total.Hit    += nsPerOp(t1, t2, count);
+		total.Miss   += nsPerOp(t2, t3, count);
+		total.Erase  += nsPerOp(t3, t4, count);
+	}
+
+	total.Insert /= repeats;
+	total.Hit    /= repeats;
+	total.Miss   /= repeats;
+	total.Erase  /= repeats;
+	return total;
+}
+
+static void printResult(const char* name, const Result& result)
+{
+	printf("  %-14s insert %7.1f  hit %7.1f  miss %7.1f  erase %7.1f ns/op\n",
+		name, result.Insert, result.Hit, result.Miss, result.Erase);
+	fflush(stdout);
+}
+
+// Small tables are timed over more rounds so every size runs for a similar time
+static int getRepeats(size_t count)
+{
+	if (count <= 10000)
+		return 200;
+	if (count <= 100000)
+		return 20;
+	if (count <= 1000000)
+		return 3;
+	return 1;
+}
+
+static void benchIntegers(size_t count)
+{
+	uint64_t  state    = count;
+	uint64_t* keys     = new uint64_t[count];
+	uint64_t* missKeys = new uint64_t[count];
+	// Odd keys are inserted, even keys are the misses
+	for (size_t i = 0; i < count; i++)
+	{
+		keys[i]     = nextRandom(state) | 1;
+		missKeys[i] = nextRandom(state) & ~(uint64_t)1;
+	}
+
+	printf("%u entries, uint64_t -> size_t\n", (unsigned)count);
+	int repeats = getRepeats(count);
+	printResult("Hash", runTable<Hash<uint64_t, size_t> >(keys, missKeys, count, repeats));
+	printResult("FlatHash", runTable<FlatHash<uint64_t, size_t> >(keys, missKeys, count, repeats));
+
+	delete[] keys;
+	delete[] missKeys;
+}
+
+static void benchStrings(size_t count)
+{
+	uint64_t state    = count;
+	String*  keys     = new String[count];
+	String*  missKeys = new String[count];
+	// Identifier-like keys of 16-24 characters, as in scene and option tables
+	for (size_t i = 0; i < count; i++)
+	{
+		char text[40];
+		uint64_t a = nextRandom(state), b = nextRandom(state);
+		OVR_sprintf(text, sizeof(text), "node_%llx_a", (unsigned long long)(a >> (a & 15)));
+		keys[i] = text;
+		OVR_sprintf(text, sizeof(text), "node_%llx_b", (unsigned long long)(b >> (b & 15)));
+		missKeys[i] = text;
+	}
+
+	printf("%u entries, String -> size_t\n", (unsigned)count);
+	int repeats = getRepeats(count);
+	printResult("StringHash", runTable<StringHash<size_t> >(keys, missKeys, count, repeats));
+	printResult("FlatStringHash", runTable<FlatStringHash<size_t> >(keys, missKeys, count, repeats));
+
+	delete[] keys;
+	delete[] missKeys;
+}
+
+
+int main(int argc, char* argv[])
+{
+	size_t maxEntries = (argc > 1) ? (size_t)atof(argv[1]) : 10000000;
+	if (maxEntries < 1000)
+	{
+		fprintf(stderr, "Usage: HashBench [maxEntries]\n");
+		return 1;
+	}
+
+	System::Init(Log::ConfigureDefaultLog(LogMask_None));
+
+	for (size_t count = 1000; count <= maxEntries; count *= 10)
+		benchIntegers(count);
+
+	size_t maxStringEntries = (argc > 1) ? maxEntries : 1000000;
+	for (size_t count = 1000; count <= maxStringEntries; count *= 10)
+		benchStrings(count);
+
+	System::Destroy();
+	return 0;
+}
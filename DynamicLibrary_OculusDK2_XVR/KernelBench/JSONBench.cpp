@@ -0,0 +1,239 @@
+// JSONBench.cpp : Times OVR::JSON parsing and child lookups on a generated document.
+// Usage: JSONBench [records] [configKeys]
+// Builds a document shaped like the DLL's telemetry and settings files (records frame
+// objects, records * 8 numbers in one array and an object of configKeys settings,
+// 40000 and 5000 by default), saves it as JSONBench.json in the current directory and
+// prints the best of 10 runs of Parse, Load and Release for heap and arena nodes, and
+// of the lookups: GetNumberByName over the settings, GetArrayNumber over the first
+// 16000 numbers and a walk over the frames with GetItemByIndex.
+//
+// The lookups are also timed as a walk of the child list, which is what they did
+// before children were indexed. To time the old implementation itself, build with
+// JSONBENCH_BASELINE against a LibOVRKernel from before the child index (it has no
+// AllocMode, so only heap nodes are timed). Build it against LibOVRKernel, in release, e.g.
+// cl /O2 /EHsc /I..\OculusSDK\LibOVRKernel\Src JSONBench.cpp LibOVRKernel.lib
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Kernel/OVR_System.h"
+#include "Kernel/OVR_Timer.h"
+#include "Kernel/OVR_JSON.h"
+
+using namespace OVR;
+
+
+static const char* DocumentPath = "JSONBench.json";
+static const int   Runs = 10;
+static const int   ArrayLookups = 16000;   // Without an index, array access is quadratic
+
+// Keeps the optimizer from dropping the lookups
+static volatile double Sink;
+
+static void makeDocument(StringBuffer& doc, int records, int configKeys)
+{
+	doc += "{\n\t\"config\": {";
+	for (int i = 0; i < configKeys; i++)
+		doc.AppendFormat("%s\"Setting_%d_name\": %d.%d", i ? ", " : "", i, i, i % 10);
+
+	doc += "},\n\t\"samples\": [";
+	for (int i = 0; i < records * 8; i++)
+		doc.AppendFormat("%s%.6f", i ? ", " : "", i * 0.001);
+
+	doc += "],\n\t\"frames\": [";
+	for (int i = 0; i < records; i++)
+	{
+		doc.AppendFormat("%s\n\t\t{\"frame\": %d, \"time\": %.6f, \"pose\": [%.4f, %.4f, %.4f, 1.0], "
+			"\"status\": \"Tracked\", \"latency\": {\"render\": %d, \"timewarp\": %d, \"post\": %d}, "
+			"\"hmd\": \"Rift DK2 \\u00e9 serial %08d\", \"ok\": %s, \"extra\": null}",
+			i ? "," : "", i, i / 75.0, 0.1 * i, -0.2, 1.5, i % 13, i % 7, i % 3, i, (i & 1) ? "true" : "false");
+	}
+	doc += "\n\t]\n}\n";
+}
+
+// Lookups as a walk of the child list, as they were done before the index
+static JSON* walkByName(JSON* node, const char* name)
+{
+	for (JSON* item = node->GetFirstItem(); item; item = node->GetNextItem(item))
+	{
+		if (item->Name == name)
+			return item;
+	}
+	return nullptr;
+}
+
+static JSON* walkByIndex(JSON* node, int index)
+{
+	JSON* item = node->GetFirstItem();
+	for (int i = 0; item && i < index; i++)
+		item = node->GetNextItem(item);
+	return item;
+}
+
+// Best of the runs, in milliseconds
+struct Timings
+{
+	double Parse, Load, Release;
+	double NameLookup, ArrayNumber, FrameWalk;
+	double NameWalk, ArrayWalk;
+};
+
+static double elapsedMs(uint64_t start)
+{
+	return (double)(Timer::GetTicksNanos() - start) * 1e-6;
+}
+
+static void keepBest(double& best, double ms)
+{
+	if (ms < best)
+		best = ms;
+}
+
+#ifdef JSONBENCH_BASELINE
+	#define ALLOC_MODE(mode)
+#else
+	#define ALLOC_MODE(mode) , 0, mode
+#endif
+
+static Timings runMode(const char* text, int configKeys, int modeIndex, bool walkLists)
+{
+	Timings best;
+	double* values = &best.Parse;
+	for (size_t i = 0; i < sizeof(best) / sizeof(double); i++)
+		values[i] = 1e30;
+
+#ifndef JSONBENCH_BASELINE
+	JSON::AllocMode mode = modeIndex ? JSON::Alloc_Arena : JSON::Alloc_Heap;
+#else
+	OVR_UNUSED(modeIndex);
+#endif
+
+	char name[64];
+	for (int run = 0; run < Runs; run++)
+	{
+		double sum = 0;
+
+		uint64_t start = Timer::GetTicksNanos();
+		JSON* root = JSON::Parse(text ALLOC_MODE(mode));
+		keepBest(best.Parse, elapsedMs(start));
+		if (!root)
+		{
+			fprintf(stderr, "JSONBench: parse failed\n");
+			exit(1);
+		}
+
+		JSON* config  = root->GetItemByName("config");
+		JSON* samples = root->GetItemByName("samples");
+		JSON* frames  = root->GetItemByName("frames");
+		int   sampleCount = Alg::Min(samples->GetArraySize(), (int)ArrayLookups);
+		int   frameCount  = frames->GetArraySize();
+
+		// Scattered names, ten passes, so the index is built once and then reused
+		start = Timer::GetTicksNanos();
+		for (int pass = 0; pass < 10; pass++)
+		{
+			for (int i = 0; i < configKeys; i++)
+			{
+				OVR_sprintf(name, sizeof(name), "Setting_%d_name", (i * 7919) % configKeys);
+				sum += config->GetNumberByName(name);
+			}
+		}
+		keepBest(best.NameLookup, elapsedMs(start));
+
+		start = Timer::GetTicksNanos();
+		for (int i = 0; i < sampleCount; i++)
+			sum += samples->GetArrayNumber(i);
+		keepBest(best.ArrayNumber, elapsedMs(start));
+
+		start = Timer::GetTicksNanos();
+		for (int i = 0; i < frameCount; i++)
+		{
+			JSON* frame = frames->GetItemByIndex(i);
+			sum += frame->GetNumberByName("time") + frame->GetItemByName("latency")->GetIntByName("post");
+		}
+		keepBest(best.FrameWalk, elapsedMs(start));
+
+		// The list walks are quadratic; one pass is enough to compare
+		if (walkLists)
+		{
+			start = Timer::GetTicksNanos();
+			for (int i = 0; i < configKeys; i++)
+			{
+				OVR_sprintf(name, sizeof(name), "Setting_%d_name", (i * 7919) % configKeys);
+				sum += walkByName(config, name)->dValue;
+			}
+			keepBest(best.NameWalk, elapsedMs(start) * 10);
+
+			start = Timer::GetTicksNanos();
+			for (int i = 0; i < sampleCount; i++)
+				sum += walkByIndex(samples, i)->dValue;
+			keepBest(best.ArrayWalk, elapsedMs(start));
+		}
+
+		start = Timer::GetTicksNanos();
+		root->Release();
+		keepBest(best.Release, elapsedMs(start));
+
+		start = Timer::GetTicksNanos();
+		JSON* loaded = JSON::Load(DocumentPath ALLOC_MODE(mode));
+		keepBest(best.Load, elapsedMs(start));
+		if (loaded)
+			loaded->Release();
+
+		Sink = sum;
+		walkLists = false;
+	}
+	return best;
+}
+
+
+int main(int argc, char* argv[])
+{
+	int records    = (argc > 1) ? atoi(argv[1]) : 40000;
+	int configKeys = (argc > 2) ? atoi(argv[2]) : 5000;
+	if (records <= 0 || configKeys <= 0)
+	{
+		fprintf(stderr, "Usage: JSONBench [records] [configKeys]\n");
+		return 1;
+	}
+
+	System::Init(Log::ConfigureDefaultLog(LogMask_None));
+
+	StringBuffer doc;
+	makeDocument(doc, records, configKeys);
+	FILE* file = fopen(DocumentPath, "wb");
+	if (!file || fwrite(doc.ToCStr(), 1, doc.GetSize(), file) != doc.GetSize())
+	{
+		fprintf(stderr, "JSONBench: can't write %s\n", DocumentPath);
+		return 1;
+	}
+	fclose(file);
+
+	printf("Document: %.1f MB, %d frames, %d numbers, %d settings; best of %d, ms\n",
+		doc.GetSize() / 1e6, records, records * 8, configKeys, Runs);
+	printf("  %-6s %8s %8s %8s %12s %12s %10s\n", "nodes", "Parse", "Load", "Release",
+		"name lookup", "array index", "frame walk");
+
+#ifdef JSONBENCH_BASELINE
+	const int modeCount = 1;
+#else
+	const int modeCount = 2;
+#endif
+	Timings walk = { 0 };
+	for (int m = 0; m < modeCount; m++)
+	{
+		Timings t = runMode(doc.ToCStr(), configKeys, m, m == 0);
+		printf("  %-6s %8.1f %8.1f %8.1f %12.2f %12.2f %10.2f\n", m ? "arena" : "heap",
+			t.Parse, t.Load, t.Release, t.NameLookup, t.ArrayNumber, t.FrameWalk);
+		if (m == 0)
+			walk = t;
+	}
+	printf("  %-6s %8s %8s %8s %12.2f %12.2f\n", "list", "", "", "", walk.NameWalk, walk.ArrayWalk);
+
+	System::Destroy();
+	return 0;
+}
@@ -0,0 +1,169 @@
+// JSONScanBench.cpp : Times the OVR::JSONText scanning functions and JSON::Parse in MB/s.
+// Usage: JSONScanBench [megabytes]
+// Scans a run of whitespace and a run of plain string characters, each of the given
+// size (default 1 MB), with JSONText::SkipWhitespace and JSONText::FindStringSpecial,
+// which use the best vector version the CPU supports, and with a byte-by-byte loop
+// for comparison. Then parses three documents of about the same size: telemetry
+// frames with single spaces, the same frames indented with tabs, and an array of long
+// strings. Prints the best of 20 runs of each. Build it against LibOVRKernel, in
+// release, e.g.
+// cl /O2 /EHsc /I..\OculusSDK\LibOVRKernel\Src JSONScanBench.cpp LibOVRKernel.lib
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Kernel/OVR_System.h"
+#include "Kernel/OVR_Timer.h"
+#include "Kernel/OVR_JSON.h"
+
+using namespace OVR;
+
+
+static const int Runs = 20;
+
+// Keeps the optimizer from dropping the scans
+static volatile size_t Sink;
+
+// The byte-by-byte loops the parser used before the vector versions
+static const char* skipWhitespaceScalar(const char* p)
+{
+	while ((uint8_t)(*p - 1) < ' ')
+		p++;
+	return p;
+}
+
+static const char* findStringSpecialScalar(const char* p)
+{
+	while (*p && (*p != '\"') && (*p != '\\'))
+		p++;
+	return p;
+}
+
+typedef const char* (*ScanFunction)(const char* p);
+
+// Best of the runs, in MB/s of text scanned
+static double scanRate(ScanFunction scan, const char* text, size_t size)
+{
+	double best = 0;
+	for (int run = 0; run < Runs; run++)
+	{
+		uint64_t start = Timer::GetTicksNanos();
+		const char* end = scan(text);
+		uint64_t ns = Timer::GetTicksNanos() - start;
+
+		if ((size_t)(end - text) != size)
+		{
+			fprintf(stderr, "JSONScanBench: scan stopped at %u of %u\n", (unsigned)(end - text), (unsigned)size);
+			exit(1);
+		}
+		Sink += (size_t)(end - text);
+		if (ns && (size * 1e3 / ns) > best)
+			best = size * 1e3 / ns;
+	}
+	return best;
+}
+
+static double parseRate(const char* text, size_t size)
+{
+	double best = 0;
+	for (int run = 0; run < Runs; run++)
+	{
+		uint64_t start = Timer::GetTicksNanos();
+		JSON* root = JSON::Parse(text);
+		uint64_t ns = Timer::GetTicksNanos() - start;
+
+		if (!root)
+		{
+			fprintf(stderr, "JSONScanBench: parse failed\n");
+			exit(1);
+		}
+		Sink += root->GetArraySize();
+		root->Release();
+		if (ns && (size * 1e3 / ns) > best)
+			best = size * 1e3 / ns;
+	}
+	return best;
+}
+
+// Telemetry frames, separated by single spaces or indented with tabs
+static void makeFrames(StringBuffer& doc, size_t size, bool indented)
+{
+	const char* sep = indented ? "\n\t\t\t" : " ";
+	doc += "[";
+	for (int i = 0; doc.GetSize() < size; i++)
+	{
+		doc.AppendFormat("%s%s{%s\"frame\": %d,%s\"time\": %.6f,%s\"status\": \"Tracked\",%s"
+			"\"latency\": {%s\t\"render\": %d,%s\t\"timewarp\": %d%s}%s}",
+			i ? "," : "", indented ? "\n\t\t" : "", sep, i, sep, i / 75.0, sep, sep,
+			sep, i % 13, sep, i % 7, sep, indented ? "\n\t\t" : "");
+	}
+	doc += "]";
+}
+
+// Log lines and descriptions of a few hundred characters, with an escape now and then
+static void makeStrings(StringBuffer& doc, size_t size)
+{
+	doc += "[";
+	for (int i = 0; doc.GetSize() < size; i++)
+	{
+		doc.AppendFormat("%s\"[%06d] ", i ? ", " : "", i);
+		for (int word = 0; word < 40; word++)
+			doc += (word == 20) ? "tracking \\\"lost\\\" " : "distortion ";
+		doc += "\"";
+	}
+	doc += "]";
+}
+
+static void printRate(const char* name, double rate)
+{
+	printf("  %-40s %9.1f MB/s\n", name, rate);
+	fflush(stdout);
+}
+
+
+int main(int argc, char* argv[])
+{
+	double megabytes = (argc > 1) ? atof(argv[1]) : 1.0;
+	if (megabytes <= 0)
+	{
+		fprintf(stderr, "Usage: JSONScanBench [megabytes]\n");
+		return 1;
+	}
+	size_t size = (size_t)(megabytes * 1e6);
+
+	System::Init(Log::ConfigureDefaultLog(LogMask_None));
+
+	// Both runs end at a byte that stops the scan
+	char* text = (char*)OVR_ALLOC(size + 1);
+	memset(text, '\t', size);
+	text[size] = '\0';
+	memset(text, ' ', size / 2);
+
+	printf("%.1f MB runs, best of %d\n", size / 1e6, Runs);
+	printRate("SkipWhitespace, spaces and tabs", scanRate(JSONText::SkipWhitespace, text, size));
+	printRate("byte loop, spaces and tabs", scanRate(skipWhitespaceScalar, text, size));
+
+	for (size_t i = 0; i < size; i++)
+		text[i] = (char)('a' + i % 26);
+	text[size - 1] = '\"';
+	printRate("FindStringSpecial, plain characters", scanRate(JSONText::FindStringSpecial, text, size - 1));
+	printRate("byte loop, plain characters", scanRate(findStringSpecialScalar, text, size - 1));
+	OVR_FREE(text);
+
+	StringBuffer frames, indented, strings;
+	makeFrames(frames, size, false);
+	makeFrames(indented, size, true);
+	makeStrings(strings, size);
+
+	printf("Parse\n");
+	printRate("telemetry frames", parseRate(frames.ToCStr(), frames.GetSize()));
+	printRate("telemetry frames, tab indented", parseRate(indented.ToCStr(), indented.GetSize()));
+	printRate("long strings", parseRate(strings.ToCStr(), strings.GetSize()));
+
+	System::Destroy();
+	return 0;
+}
@@ -0,0 +1,53 @@
+// LogDecode.cpp : Command line tool that turns binary OVR::AsyncLog files back into text.
+// Usage: LogDecode <input.log> [output.txt]
+// Writes to stdout when no output file is given. Build it against LibOVRKernel,
+// e.g. cl /EHsc /I..\OculusSDK\LibOVRKernel\Src LogDecode.cpp LibOVRKernel.lib
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include <stdio.h>
+
+#include "Kernel/OVR_AsyncLog.h"
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2 || argc > 3)
+	{
+		fprintf(stderr, "Usage: LogDecode <input.log> [output.txt]\n");
+		return 1;
+	}
+
+	FILE* input = fopen(argv[1], "rb");
+	if (!input)
+	{
+		fprintf(stderr, "LogDecode: can't open %s\n", argv[1]);
+		return 1;
+	}
+
+	FILE* output = stdout;
+	if (argc == 3)
+	{
+		output = fopen(argv[2], "w");
+		if (!output)
+		{
+			fprintf(stderr, "LogDecode: can't create %s\n", argv[2]);
+			fclose(input);
+			return 1;
+		}
+	}
+
+	bool ok = OVR::AsyncLog::DecodeBinaryLog(input, output);
+
+	fclose(input);
+	if (output != stdout)
+		fclose(output);
+
+	if (!ok)
+	{
+		fprintf(stderr, "LogDecode: %s is not a binary log or is truncated\n", argv[1]);
+		return 2;
+	}
+	return 0;
+}
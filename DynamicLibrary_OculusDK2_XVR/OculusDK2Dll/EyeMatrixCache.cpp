@@ -0,0 +1,60 @@
+// EyeMatrixCache.cpp
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include "stdafx.h"
+#include <Extras/OVR_CAPI_Util.h>
+#include "EyeMatrixCache.h"
+
+using namespace OVR;
+
+
+EyeMatrixCache::EyeMatrixCache()
+	: ViewsValid(false), ProjectionsValid(false), ProjectionNear(0.0f), ProjectionFar(0.0f) {
+	memset(ProjectionFov, 0, sizeof(ProjectionFov));
+}
+
+void EyeMatrixCache::UpdateViews(const ovrPosef eyePose[2]) {
+	for (int eye = 0; eye < 2; ++eye) {
+		Posef pose(eyePose[eye]);
+		Vector3f up = pose.Rotate(Vector3f(0, 1, 0));
+		Vector3f forward = pose.Rotate(Vector3f(0, 0, -1));
+		View[eye] = Matrix4f::LookAtRH(pose.Translation, pose.Translation + forward, up);
+	}
+	ViewsValid = true;
+}
+
+void EyeMatrixCache::UpdateProjections(const ovrFovPort fov[2], float zNear, float zFar) {
+	if (ProjectionsValid && zNear == ProjectionNear && zFar == ProjectionFar &&
+		memcmp(fov, ProjectionFov, sizeof(ProjectionFov)) == 0) {
+		return;
+	}
+
+	for (int eye = 0; eye < 2; ++eye) {
+		Projection[eye] = ovrMatrix4f_Projection(fov[eye], zNear, zFar,
+			ovrProjection_RightHanded | ovrProjection_ClipRangeOpenGL);
+		ProjectionFov[eye] = fov[eye];
+	}
+	ProjectionNear = zNear;
+	ProjectionFar = zFar;
+	ProjectionsValid = true;
+}
+
+void EyeMatrixCache::CopyViews(float *dest) const {
+	CopyColumnMajor(View[0], dest);
+	CopyColumnMajor(View[1], dest + 16);
+}
+
+void EyeMatrixCache::CopyProjections(float *dest) const {
+	CopyColumnMajor(Projection[0], dest);
+	CopyColumnMajor(Projection[1], dest + 16);
+}
+
+void EyeMatrixCache::CopyColumnMajor(const Matrix4f &m, float *dest) {
+	for (int col = 0; col < 4; ++col) {
+		for (int row = 0; row < 4; ++row) {
+			dest[col * 4 + row] = m.M[row][col];
+		}
+	}
+}
@@ -0,0 +1,46 @@
+// EyeMatrixCache.h
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#pragma once
+
+#include <Extras/OVR_Math.h>
+
+// View and projection matrices of both eyes for the current frame, so the engine gets
+// them ready to load instead of rebuilding them from quaternions in script.
+// Views change every frame; projections are only rebuilt when the FOV or the clipping
+// planes change. Matrices are kept row-major (OVR convention) and handed out column-major
+// (OpenGL convention).
+class EyeMatrixCache
+{
+public:
+	EyeMatrixCache();
+
+	// View matrices from the eye poses in tracking space (from ovr_CalcEyePoses)
+	void UpdateViews(const ovrPosef eyePose[2]);
+	// Right-handed OpenGL projections; does nothing if nothing changed since the last call
+	void UpdateProjections(const ovrFovPort fov[2], float zNear, float zFar);
+
+	bool HasViews() const { return ViewsValid; }
+
+	const OVR::Matrix4f& GetView(int eye) const { return View[eye]; }
+	const OVR::Matrix4f& GetProjection(int eye) const { return Projection[eye]; }
+
+	// Copies both eyes' matrices, left eye first, 16 column-major floats per eye
+	void CopyViews(float *dest) const;
+	void CopyProjections(float *dest) const;
+
+private:
+	static void CopyColumnMajor(const OVR::Matrix4f &m, float *dest);
+
+	OVR::Matrix4f View[2];
+	OVR::Matrix4f Projection[2];
+	bool ViewsValid;
+
+	// Inputs the projections were built from
+	bool ProjectionsValid;
+	ovrFovPort ProjectionFov[2];
+	float ProjectionNear;
+	float ProjectionFar;
+};
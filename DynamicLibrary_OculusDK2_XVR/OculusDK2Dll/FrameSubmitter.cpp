@@ -0,0 +1,170 @@
+// FrameSubmitter.cpp : Submit thread used by the OVR_*AsyncSubmit exports.
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include "stdafx.h"
+
+#include "FrameSubmitter.h"
+
+using namespace OVR;
+
+// ARB_sync (GL 3.2) is not part of GLE; the entry points are loaded when the thread starts.
+// Without them every frame is finished with glFinish before it is queued.
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_SYNC_FLUSH_COMMANDS_BIT    0x00000001
+
+typedef GLsync (APIENTRY *FenceSyncFunc)(GLenum condition, GLbitfield flags);
+typedef GLenum (APIENTRY *ClientWaitSyncFunc)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+typedef void   (APIENTRY *DeleteSyncFunc)(GLsync sync);
+
+static FenceSyncFunc      glFenceSyncFunc = nullptr;
+static ClientWaitSyncFunc glClientWaitSyncFunc = nullptr;
+static DeleteSyncFunc     glDeleteSyncFunc = nullptr;
+
+// Longest the submit thread waits for the GPU to finish a frame
+static const GLuint64 FrameFenceTimeoutNanos = 1000000000;
+
+
+FrameSubmitter::FrameSubmitter(HmdBackend *hmd, ovrSwapTextureSet *textureSet, const ovrLayerEyeFov &layer, int queueAhead) :
+	HMD(hmd),
+	TextureSet(textureSet),
+	Layer(layer),
+	QueueAhead(queueAhead),
+	DeviceContext(nullptr),
+	GLContext(nullptr),
+	QueueHead(0),
+	QueueCount(0),
+	LastResult(ovrSuccess)
+{
+	if (QueueAhead < 1) {
+		QueueAhead = 1;
+	}
+	if (QueueAhead > MaxQueueAhead) {
+		QueueAhead = MaxQueueAhead;
+	}
+}
+
+FrameSubmitter::~FrameSubmitter() {
+	if (GLContext) {
+		wglDeleteContext(GLContext);
+	}
+}
+
+bool FrameSubmitter::Begin() {
+	if (!glFenceSyncFunc) {
+		glFenceSyncFunc = (FenceSyncFunc)wglGetProcAddress("glFenceSync");
+		glClientWaitSyncFunc = (ClientWaitSyncFunc)wglGetProcAddress("glClientWaitSync");
+		glDeleteSyncFunc = (DeleteSyncFunc)wglGetProcAddress("glDeleteSync");
+		if (!glClientWaitSyncFunc || !glDeleteSyncFunc) {
+			glFenceSyncFunc = nullptr;
+		}
+	}
+
+	// Second context on the engine's device context, sharing its textures
+	HGLRC engineContext = wglGetCurrentContext();
+	DeviceContext = wglGetCurrentDC();
+	if (!engineContext || !DeviceContext) {
+		return false;
+	}
+	GLContext = wglCreateContext(DeviceContext);
+	if (!GLContext) {
+		return false;
+	}
+	if (!wglShareLists(engineContext, GLContext)) {
+		wglDeleteContext(GLContext);
+		GLContext = nullptr;
+		return false;
+	}
+
+	SetExitFlag(false);
+	return Start();
+}
+
+void FrameSubmitter::Stop() {
+	{
+		Mutex::Locker lock(&QueueLock);
+		SetExitFlag(true);
+		QueueChanged.NotifyAll();
+	}
+	Join();
+}
+
+ovrResult FrameSubmitter::Enqueue(const QueuedFrame &frame) {
+	QueuedFrame queued = frame;
+	if (glFenceSyncFunc) {
+		queued.Fence = glFenceSyncFunc(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		glFlush();
+	}
+	else {
+		queued.Fence = nullptr;
+		glFinish();
+	}
+
+	Mutex::Locker lock(&QueueLock);
+	while (QueueCount >= QueueAhead) {
+		QueueChanged.Wait(&QueueLock);
+	}
+	Queue[(QueueHead + QueueCount) % MaxQueueAhead] = queued;
+	QueueCount++;
+	QueueChanged.NotifyAll();
+
+	return LastResult;
+}
+
+void FrameSubmitter::WaitForFrame(GLsync fence) {
+	if (fence) {
+		glClientWaitSyncFunc(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FrameFenceTimeoutNanos);
+		glDeleteSyncFunc(fence);
+	}
+}
+
+int FrameSubmitter::Run() {
+	SetThreadName("OculusDK2Dll Frame Submitter");
+	wglMakeCurrent(DeviceContext, GLContext);
+
+	for (;;) {
+		QueuedFrame frame;
+		{
+			Mutex::Locker lock(&QueueLock);
+			while (QueueCount == 0 && !GetExitFlag()) {
+				QueueChanged.Wait(&QueueLock);
+			}
+			// Only leave once everything queued was submitted
+			if (QueueCount == 0) {
+				break;
+			}
+			frame = Queue[QueueHead];
+		}
+
+		WaitForFrame(frame.Fence);
+
+		ovrViewScaleDesc viewScaleDesc;
+		viewScaleDesc.HmdSpaceToWorldScaleInMeters = 1.0f;
+		viewScaleDesc.HmdToEyeViewOffset[0] = frame.HmdToEyeViewOffset[0];
+		viewScaleDesc.HmdToEyeViewOffset[1] = frame.HmdToEyeViewOffset[1];
+
+		ovrLayerEyeFov layer = Layer;
+		layer.RenderPose[0] = frame.EyeRenderPose[0];
+		layer.RenderPose[1] = frame.EyeRenderPose[1];
+		layer.Viewport[0] = frame.Viewport[0];
+		layer.Viewport[1] = frame.Viewport[1];
+
+		// The engine is already rendering into another slot; the compositor takes this one
+		TextureSet->CurrentIndex = frame.TextureIndex;
+
+		ovrLayerHeader* layers = &layer.Header;
+		ovrResult result = HMD->SubmitFrame(frame.FrameIndex, &viewScaleDesc, &layers, 1);
+
+		{
+			Mutex::Locker lock(&QueueLock);
+			QueueHead = (QueueHead + 1) % MaxQueueAhead;
+			QueueCount--;
+			LastResult = result;
+			QueueChanged.NotifyAll();
+		}
+	}
+
+	wglMakeCurrent(NULL, NULL);
+	return 0;
+}
@@ -0,0 +1,73 @@
+// FrameSubmitter.h
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#pragma once
+
+#include <Kernel/OVR_Threads.h>
+#include <GL/CAPI_GLE.h>
+#include "HmdBackend.h"
+
+// A frame the engine finished rendering, waiting to be submitted
+struct QueuedFrame {
+	unsigned int FrameIndex;
+	int          TextureIndex;       // Swap texture set slot the frame was rendered into
+	ovrPosef     EyeRenderPose[2];
+	ovrVector3f  HmdToEyeViewOffset[2];
+	ovrRecti     Viewport[2];        // Part of the texture each eye was rendered to
+	GLsync       Fence;              // Signaled when the GPU finished rendering the frame
+};
+
+// Submits frames on a dedicated thread so the engine thread does not wait in
+// ovr_SubmitFrame for the compositor. The engine may run QueueAhead frames ahead of the
+// frame being submitted; Enqueue blocks once that many frames are in flight.
+//
+// Every queued frame keeps its own swap texture slot and eye poses, so the engine can render
+// the next frame into the next slot meanwhile. That needs QueueAhead + 2 slots: one being
+// rendered, the queued ones, and the one the compositor shows.
+//
+// The thread submits through its own GL context, shared with the engine's, and waits on a
+// fence for every frame before handing it to the compositor.
+class FrameSubmitter : public OVR::Thread
+{
+public:
+	enum { MaxQueueAhead = 2 };
+
+	// layer is the frame layer set up by OVR_PrepareFrameRendering; poses are filled in per frame
+	FrameSubmitter(HmdBackend *hmd, ovrSwapTextureSet *textureSet, const ovrLayerEyeFov &layer, int queueAhead);
+	~FrameSubmitter();
+
+	// Creates the shared GL context and starts the thread. Call from the engine thread with
+	// the engine's GL context current.
+	bool Begin();
+	// Submits what is queued, stops the thread and releases the GL context
+	void Stop();
+
+	// Queues a frame rendered with the current GL context. Blocks while the queue is full.
+	// Returns the result of the most recent submit that completed.
+	ovrResult Enqueue(const QueuedFrame &frame);
+
+	int GetQueueAhead() const { return QueueAhead; }
+
+protected:
+	virtual int Run();
+
+private:
+	void WaitForFrame(GLsync fence);
+
+	HmdBackend* HMD;
+	ovrSwapTextureSet* TextureSet;
+	ovrLayerEyeFov Layer;
+	int QueueAhead;
+
+	HDC   DeviceContext;
+	HGLRC GLContext;
+
+	OVR::Mutex QueueLock;
+	OVR::WaitCondition QueueChanged;
+	QueuedFrame Queue[MaxQueueAhead];
+	int QueueHead;
+	int QueueCount;     // Frames queued, including the one being submitted
+	ovrResult LastResult;
+};
@@ -0,0 +1,170 @@
+// FrameTelemetry.cpp
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include "stdafx.h"
+#include <math.h>
+#include "FrameTelemetry.h"
+
+using namespace OVR;
+
+
+void LatencyHistogram::Reset() {
+	memset(Buckets, 0, sizeof(Buckets));
+	Count = 0;
+	Total = 0;
+	Min = ~(uint64_t)0;
+	Max = 0;
+}
+
+void LatencyHistogram::Record(uint64_t nanos) {
+	Buckets[GetBucketIndex(nanos)]++;
+	Count++;
+	Total += nanos;
+	if (nanos < Min) {
+		Min = nanos;
+	}
+	if (nanos > Max) {
+		Max = nanos;
+	}
+}
+
+int LatencyHistogram::GetBucketIndex(uint64_t nanos) {
+	if (nanos < SubBucketCount) {
+		return (int)nanos;
+	}
+
+	// Position of the highest set bit
+	int exponent = SubBucketBits;
+	while (exponent < 63 && (nanos >> (exponent + 1)) != 0) {
+		exponent++;
+	}
+	if (exponent > MaxExponent) {
+		return BucketCount - 1;
+	}
+
+	int sub = (int)(nanos >> (exponent - SubBucketBits)) - SubBucketCount;
+	return (exponent - SubBucketBits + 1) * SubBucketCount + sub;
+}
+
+uint64_t LatencyHistogram::GetBucketLowerBound(int bucket) {
+	if (bucket < SubBucketCount) {
+		return (uint64_t)bucket;
+	}
+	int group = bucket / SubBucketCount;
+	int sub = bucket % SubBucketCount;
+	return (uint64_t)(SubBucketCount + sub) << (group - 1);
+}
+
+uint64_t LatencyHistogram::GetPercentile(double fraction) const {
+	if (Count == 0) {
+		return 0;
+	}
+
+	uint64_t target = (uint64_t)ceil(fraction * (double)Count);
+	if (target < 1) {
+		target = 1;
+	}
+
+	uint64_t seen = 0;
+	for (int i = 0; i < BucketCount; ++i) {
+		seen += Buckets[i];
+		if (seen >= target) {
+			if (i == BucketCount - 1) {
+				return Max;
+			}
+			uint64_t upper = GetBucketLowerBound(i + 1) - 1;
+			return (upper < Max) ? upper : Max;
+		}
+	}
+	return Max;
+}
+
+
+FrameTelemetry::FrameTelemetry()
+	: Enabled(true), LastFrameNanos(0) {
+}
+
+void FrameTelemetry::SetEnabled(bool enabled) {
+	// Frames weren't marked while disabled: the first interval after enabling would span
+	// the whole time telemetry was off
+	if (enabled && !Enabled) {
+		LastFrameNanos = 0;
+	}
+	Enabled = enabled;
+}
+
+void FrameTelemetry::Reset() {
+	for (int i = 0; i < OVR_Phase_Count; ++i) {
+		Phases[i].Reset();
+	}
+	LastFrameNanos = 0;
+}
+
+void FrameTelemetry::MarkFrame(uint64_t nowNanos) {
+	if (LastFrameNanos != 0) {
+		Record(OVR_Phase_FrameInterval, nowNanos - LastFrameNanos);
+	}
+	LastFrameNanos = nowNanos;
+}
+
+const char* FrameTelemetry::GetPhaseName(int phase) {
+	switch (phase) {
+	case OVR_Phase_GetTrackingState:  return "GetTrackingState";
+	case OVR_Phase_PrepareOGLContext: return "PrepareOGLContext";
+	case OVR_Phase_CleanOGLContext:   return "CleanOGLContext";
+	case OVR_Phase_SubmitFrame:       return "SubmitFrame";
+	case OVR_Phase_FrameInterval:     return "FrameInterval";
+	default:                          return "Unknown";
+	}
+}
+
+// {
+//   "phases": [
+//     { "name": "SubmitFrame", "count": 9000, "min_us": ..., "mean_us": ..., "max_us": ...,
+//       "p50_us": ..., "p99_us": ..., "p999_us": ...,
+//       "buckets": [ [lower_bound_ns, count], ... ] },
+//     ...
+//   ]
+// }
+JSON* FrameTelemetry::ToJSON() const {
+	JSON* root = JSON::CreateObject();
+	JSON* phases = JSON::CreateArray();
+
+	for (int i = 0; i < OVR_Phase_Count; ++i) {
+		const LatencyHistogram &h = Phases[i];
+
+		JSON* phase = JSON::CreateObject();
+		phase->AddStringItem("name", GetPhaseName(i));
+		phase->AddNumberItem("count", (double)h.GetCount());
+		phase->AddNumberItem("min_us", h.GetMin() / 1000.0);
+		phase->AddNumberItem("mean_us", h.GetMean() / 1000.0);
+		phase->AddNumberItem("max_us", h.GetMax() / 1000.0);
+		phase->AddNumberItem("p50_us", h.GetPercentile(0.5) / 1000.0);
+		phase->AddNumberItem("p99_us", h.GetPercentile(0.99) / 1000.0);
+		phase->AddNumberItem("p999_us", h.GetPercentile(0.999) / 1000.0);
+
+		JSON* buckets = JSON::CreateArray();
+		for (int b = 0; b < LatencyHistogram::BucketCount; ++b) {
+			if (h.GetBucketCount(b) == 0) {
+				continue;
+			}
+			JSON* bucket = JSON::CreateArray();
+			bucket->AddArrayNumber((double)LatencyHistogram::GetBucketLowerBound(b));
+			bucket->AddArrayNumber((double)h.GetBucketCount(b));
+			buckets->AddArrayElement(bucket);
+		}
+		phase->AddItem("buckets", buckets);
+
+		phases->AddArrayElement(phase);
+	}
+
+	root->AddItem("phases", phases);
+	return root;
+}
+
+bool FrameTelemetry::Save(const char *path) const {
+	Ptr<JSON> root = *ToJSON();
+	return root->Save(path);
+}
@@ -0,0 +1,112 @@
+// FrameTelemetry.h
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#pragma once
+
+#include <Kernel/OVR_Types.h>
+#include <Kernel/OVR_Timer.h>
+#include <Kernel/OVR_JSON.h>
+
+// Phases of a frame that are timed. Values are part of the DLL interface (OVR_GetPhaseLatency).
+enum OVR_TelemetryPhase {
+	OVR_Phase_GetTrackingState = 0,
+	OVR_Phase_PrepareOGLContext = 1,
+	OVR_Phase_CleanOGLContext = 2,  // MSAA resolve and mirror blits
+	OVR_Phase_SubmitFrame = 3,
+	OVR_Phase_FrameInterval = 4,    // Time between two OVR_SubmitFrame calls
+	OVR_Phase_Count
+};
+
+// Fixed-size log-linear histogram of durations in nanoseconds. Every power of two is split
+// into SubBucketCount linear buckets, so a bucket is at most 1/16 (6%) wider than its lower
+// bound, from 1ns up to ~17s. Recording is a few shifts and an increment, no allocation.
+class LatencyHistogram
+{
+public:
+	enum {
+		SubBucketBits = 4,
+		SubBucketCount = 1 << SubBucketBits,
+		MaxExponent = 34,  // 2^34ns ~ 17s, longer durations land in the last bucket
+		BucketCount = (MaxExponent - SubBucketBits + 2) * SubBucketCount
+	};
+
+	LatencyHistogram() { Reset(); }
+
+	void Reset();
+	void Record(uint64_t nanos);
+
+	uint64_t GetCount() const { return Count; }
+	uint64_t GetMin() const { return Count ? Min : 0; }
+	uint64_t GetMax() const { return Max; }
+	double   GetMean() const { return Count ? (double)Total / (double)Count : 0.0; }
+
+	// Duration below which the given fraction (0-1) of the samples fall. Resolved to the
+	// upper bound of the bucket it lands in, clamped to the largest recorded value.
+	uint64_t GetPercentile(double fraction) const;
+
+	uint64_t GetBucketCount(int bucket) const { return Buckets[bucket]; }
+	static int      GetBucketIndex(uint64_t nanos);
+	static uint64_t GetBucketLowerBound(int bucket);
+
+private:
+	uint64_t Buckets[BucketCount];
+	uint64_t Count;
+	uint64_t Total;
+	uint64_t Min;
+	uint64_t Max;
+};
+
+// Histograms for every OVR_TelemetryPhase. Only touched from the render thread, like
+// the exports it times.
+class FrameTelemetry
+{
+public:
+	FrameTelemetry();
+
+	void SetEnabled(bool enabled);
+	bool IsEnabled() const { return Enabled; }
+
+	void Reset();
+	void Record(int phase, uint64_t nanos) { Phases[phase].Record(nanos); }
+
+	// Records the time since the previous call as OVR_Phase_FrameInterval
+	void MarkFrame(uint64_t nowNanos);
+
+	const LatencyHistogram& GetPhase(int phase) const { return Phases[phase]; }
+	static const char* GetPhaseName(int phase);
+
+	// Builds a JSON report with the summary and the non-empty buckets of every phase
+	OVR::JSON* ToJSON() const;
+	bool Save(const char *path) const;
+
+private:
+	bool Enabled;
+	uint64_t LastFrameNanos;
+	LatencyHistogram Phases[OVR_Phase_Count];
+};
+
+// Times the enclosing scope into one phase of a FrameTelemetry. Costs two timer reads
+// when telemetry is enabled and a branch when it is not.
+class TelemetryScope
+{
+public:
+	TelemetryScope(FrameTelemetry &telemetry, int phase)
+		: Telemetry(telemetry.IsEnabled() ? &telemetry : nullptr),
+		  Phase(phase),
+		  StartNanos(Telemetry ? OVR::Timer::GetTicksNanos() : 0) { }
+
+	~TelemetryScope() {
+		if (Telemetry) {
+			Telemetry->Record(Phase, OVR::Timer::GetTicksNanos() - StartNanos);
+		}
+	}
+
+private:
+	FrameTelemetry* Telemetry;
+	int Phase;
+	uint64_t StartNanos;
+
+	OVR_NON_COPYABLE(TelemetryScope);
+};
@@ -0,0 +1,75 @@
+// GpuFrameTimer.cpp
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include "stdafx.h"
+
+#include "GpuFrameTimer.h"
+
+
+GpuFrameTimer::GpuFrameTimer()
+	: Initialized(false), Running(false), Next(0), Oldest(0) {
+	memset(Queries, 0, sizeof(Queries));
+	memset(Pending, 0, sizeof(Pending));
+}
+
+void GpuFrameTimer::Init() {
+	if (Initialized || !GLE_ARB_timer_query) {
+		return;
+	}
+	glGenQueries(QueryCount, Queries);
+	memset(Pending, 0, sizeof(Pending));
+	Next = Oldest = 0;
+	Running = false;
+	Initialized = true;
+}
+
+void GpuFrameTimer::Shutdown() {
+	if (Initialized) {
+		if (Running) {
+			glEndQuery(GL_TIME_ELAPSED);
+			Running = false;
+		}
+		glDeleteQueries(QueryCount, Queries);
+		Initialized = false;
+	}
+}
+
+void GpuFrameTimer::Begin() {
+	// All queries still in flight: skip this frame rather than wait for one
+	if (!Initialized || Running || Pending[Next]) {
+		return;
+	}
+	glBeginQuery(GL_TIME_ELAPSED, Queries[Next]);
+	Running = true;
+}
+
+void GpuFrameTimer::End() {
+	if (!Running) {
+		return;
+	}
+	glEndQuery(GL_TIME_ELAPSED);
+	Running = false;
+	Pending[Next] = true;
+	Next = (Next + 1) % QueryCount;
+}
+
+bool GpuFrameTimer::Poll(uint64_t &gpuNanos) {
+	bool found = false;
+	while (Initialized && Pending[Oldest]) {
+		GLuint available = 0;
+		glGetQueryObjectuiv(Queries[Oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			break;
+		}
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(Queries[Oldest], GL_QUERY_RESULT, &elapsed);
+		gpuNanos = elapsed;
+		found = true;
+
+		Pending[Oldest] = false;
+		Oldest = (Oldest + 1) % QueryCount;
+	}
+	return found;
+}
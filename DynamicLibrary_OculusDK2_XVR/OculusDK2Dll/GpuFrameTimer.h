@@ -0,0 +1,40 @@
+// GpuFrameTimer.h
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#pragma once
+
+#include <GL/CAPI_GLE.h>
+
+// Measures the GPU time of the frame rendering with GL_TIME_ELAPSED queries. Results are
+// read a few frames later from a small ring of queries so reading them never stalls the
+// pipeline. Does nothing if ARB_timer_query is not available.
+class GpuFrameTimer
+{
+public:
+	enum { QueryCount = 4 };
+
+	GpuFrameTimer();
+
+	// Needs a current GL context
+	void Init();
+	void Shutdown();
+
+	bool IsAvailable() const { return Initialized; }
+
+	void Begin();
+	void End();
+
+	// Collects the finished queries. Returns true and the most recent GPU time if any
+	// query finished since the last call.
+	bool Poll(uint64_t &gpuNanos);
+
+private:
+	bool Initialized;
+	bool Running;
+	GLuint Queries[QueryCount];
+	bool Pending[QueryCount];
+	unsigned int Next;       // Slot of the next query to begin
+	unsigned int Oldest;     // Slot of the oldest pending query
+};
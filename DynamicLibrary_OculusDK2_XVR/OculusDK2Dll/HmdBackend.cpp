@@ -0,0 +1,108 @@
+// HmdBackend.cpp : LibOVR backend and backend factory.
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include "stdafx.h"
+
+#include "HmdBackend.h"
+#include "SimulatedHmd.h"
+#include "ReplayHmd.h"
+
+// Straight pass-through to LibOVR. LibOVR is initialized once per process, so when several
+// contexts own a LibOVR backend the runtime is only shut down with the last one.
+class LibOVRBackend : public HmdBackend
+{
+public:
+	LibOVRBackend() : HMD(nullptr), Initialized(false) {}
+
+	virtual ovrResult Initialize() {
+		if (Initialized) {
+			return ovrSuccess;
+		}
+		if (InitializeCount == 0) {
+			ovrResult result = ovr_Initialize(nullptr);
+			if (!OVR_SUCCESS(result)) {
+				return result;
+			}
+		}
+		InitializeCount++;
+		Initialized = true;
+		return ovrSuccess;
+	}
+	virtual void Shutdown() {
+		if (Initialized) {
+			Initialized = false;
+			if (--InitializeCount == 0) {
+				ovr_Shutdown();
+			}
+		}
+	}
+
+	virtual ovrResult Create(ovrHmdDesc &desc) {
+		ovrGraphicsLuid luid;
+		ovrResult result = ovr_Create(&HMD, &luid);
+		desc = ovr_GetHmdDesc(HMD);
+		return result;
+	}
+	virtual void Destroy() {
+		ovr_Destroy(HMD);
+		HMD = nullptr;
+	}
+	virtual bool IsCreated() const {
+		return HMD != nullptr;
+	}
+
+	virtual ovrResult ConfigureTracking(unsigned int requestedTrackingCaps, unsigned int requiredTrackingCaps) {
+		return ovr_ConfigureTracking(HMD, requestedTrackingCaps, requiredTrackingCaps);
+	}
+	virtual ovrTrackingState GetTrackingState(double absTime) {
+		return ovr_GetTrackingState(HMD, absTime);
+	}
+	virtual ovrFrameTiming GetFrameTiming(unsigned int frameIndex) {
+		return ovr_GetFrameTiming(HMD, frameIndex);
+	}
+	virtual double GetTimeInSeconds() {
+		return ovr_GetTimeInSeconds();
+	}
+
+	virtual ovrSizei GetFovTextureSize(ovrEyeType eye, ovrFovPort fov, float pixelsPerDisplayPixel) {
+		return ovr_GetFovTextureSize(HMD, eye, fov, pixelsPerDisplayPixel);
+	}
+	virtual ovrEyeRenderDesc GetRenderDesc(ovrEyeType eye, ovrFovPort fov) {
+		return ovr_GetRenderDesc(HMD, eye, fov);
+	}
+
+	virtual ovrResult CreateSwapTextureSetGL(GLuint format, int width, int height, ovrSwapTextureSet **textureSet) {
+		return ovr_CreateSwapTextureSetGL(HMD, format, width, height, textureSet);
+	}
+	virtual void DestroySwapTextureSet(ovrSwapTextureSet *textureSet) {
+		ovr_DestroySwapTextureSet(HMD, textureSet);
+	}
+
+	virtual ovrResult SubmitFrame(unsigned int frameIndex, const ovrViewScaleDesc *viewScaleDesc,
+		ovrLayerHeader const * const *layers, unsigned int layerCount) {
+		return ovr_SubmitFrame(HMD, frameIndex, viewScaleDesc, layers, layerCount);
+	}
+
+private:
+	ovrHmd HMD;
+	bool Initialized;
+
+	static int InitializeCount;
+};
+
+int LibOVRBackend::InitializeCount = 0;
+
+HmdBackend* CreateHmdBackend(int type, const char *replayPath) {
+	switch (type) {
+	case OVR_Backend_LibOVR:
+		return new LibOVRBackend();
+	case OVR_Backend_Simulated:
+		return new SimulatedHmd();
+	case OVR_Backend_Replay:
+		return new ReplayHmd(replayPath);
+	default:
+		return nullptr;
+	}
+}
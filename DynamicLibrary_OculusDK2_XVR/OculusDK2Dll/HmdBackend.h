@@ -0,0 +1,49 @@
+// HmdBackend.h
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#pragma once
+
+#include "OVR_CAPI_GL.h"
+
+// Backends the exported OVR_* functions can run on. Selected with OVR_SelectBackend
+// (or OVR_SelectReplayBackend) before OVR_Initialize.
+enum OVR_BackendType {
+	OVR_Backend_LibOVR = 0,    // The real Rift through LibOVR
+	OVR_Backend_Simulated = 1, // Synthetic head motion, frames are accepted and dropped
+	OVR_Backend_Replay = 2     // Like Simulated, with head motion played back from a recording
+};
+
+// Everything the DLL needs from the HMD runtime. The methods mirror the ovr_* functions
+// they replace, minus the ovrHmd handle, which the backend owns.
+class HmdBackend
+{
+public:
+	virtual ~HmdBackend() {}
+
+	virtual ovrResult Initialize() = 0;
+	virtual void Shutdown() = 0;
+
+	virtual ovrResult Create(ovrHmdDesc &desc) = 0;
+	virtual void Destroy() = 0;
+	virtual bool IsCreated() const = 0;
+
+	virtual ovrResult ConfigureTracking(unsigned int requestedTrackingCaps, unsigned int requiredTrackingCaps) = 0;
+	virtual ovrTrackingState GetTrackingState(double absTime) = 0;
+	virtual ovrFrameTiming GetFrameTiming(unsigned int frameIndex) = 0;
+	virtual double GetTimeInSeconds() = 0;
+
+	virtual ovrSizei GetFovTextureSize(ovrEyeType eye, ovrFovPort fov, float pixelsPerDisplayPixel) = 0;
+	virtual ovrEyeRenderDesc GetRenderDesc(ovrEyeType eye, ovrFovPort fov) = 0;
+
+	virtual ovrResult CreateSwapTextureSetGL(GLuint format, int width, int height, ovrSwapTextureSet **textureSet) = 0;
+	virtual void DestroySwapTextureSet(ovrSwapTextureSet *textureSet) = 0;
+
+	virtual ovrResult SubmitFrame(unsigned int frameIndex, const ovrViewScaleDesc *viewScaleDesc,
+		ovrLayerHeader const * const *layers, unsigned int layerCount) = 0;
+};
+
+// Returns a new backend of the given type, or nullptr for an unknown type.
+// replayPath is the recording played back by OVR_Backend_Replay.
+HmdBackend* CreateHmdBackend(int type, const char *replayPath);
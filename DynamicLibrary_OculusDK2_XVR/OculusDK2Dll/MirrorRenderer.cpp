@@ -0,0 +1,131 @@
+// MirrorRenderer.cpp
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include "stdafx.h"
+
+#include "MirrorRenderer.h"
+
+using namespace OVR;
+
+
+MirrorRenderer::MirrorRenderer()
+	: Mode(OVR_Mirror_BothEyes), Interval(1), Width(0), Height(0),
+	  FrameCount(0), CacheValid(false), CacheSize(0, 0), CacheTexId(0), CacheFboId(0) {
+}
+
+void MirrorRenderer::SetPolicy(int mode, int interval, int width, int height) {
+	Mode = mode;
+	Interval = (interval > 1) ? interval : 1;
+	Width = (width > 0 && height > 0) ? width : 0;
+	Height = (width > 0 && height > 0) ? height : 0;
+
+	// Refresh the mirror on the next frame
+	FrameCount = 0;
+	CacheValid = false;
+}
+
+Recti MirrorRenderer::GetSourceRect(const Sizei &sourceSize) const {
+	switch (Mode) {
+	case OVR_Mirror_LeftEye:
+		return Recti(0, 0, sourceSize.w / 2, sourceSize.h);
+	case OVR_Mirror_RightEye:
+		return Recti(sourceSize.w / 2, 0, sourceSize.w / 2, sourceSize.h);
+	default:
+		return Recti(0, 0, sourceSize.w, sourceSize.h);
+	}
+}
+
+// Both eyes fill the window as they always did; a single eye keeps its aspect ratio
+Recti MirrorRenderer::GetDestRect(const Recti &source, const Sizei &destSize, bool &letterboxed) const {
+	letterboxed = false;
+	if (Mode == OVR_Mirror_BothEyes || source.w <= 0 || source.h <= 0) {
+		return Recti(0, 0, destSize.w, destSize.h);
+	}
+
+	int w = destSize.w;
+	int h = (int)((long long)destSize.w * source.h / source.w);
+	if (h > destSize.h) {
+		h = destSize.h;
+		w = (int)((long long)destSize.h * source.w / source.h);
+	}
+	letterboxed = (w != destSize.w || h != destSize.h);
+	return Recti((destSize.w - w) / 2, (destSize.h - h) / 2, w, h);
+}
+
+void MirrorRenderer::EnsureCache(const Sizei &size) {
+	if (CacheTexId && CacheSize == size) {
+		return;
+	}
+	if (!CacheTexId) {
+		glGenTextures(1, &CacheTexId);
+		glGenFramebuffers(1, &CacheFboId);
+	}
+
+	glBindTexture(GL_TEXTURE_2D, CacheTexId);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, size.w, size.h, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, CacheFboId);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, CacheTexId, 0);
+
+	CacheSize = size;
+	CacheValid = false;
+}
+
+void MirrorRenderer::Update(GLuint sourceFbo, const Sizei &sourceSize, GLuint destFbo, const Sizei &destSize) {
+	if (Mode == OVR_Mirror_Off) {
+		return;
+	}
+
+	Recti source = GetSourceRect(sourceSize);
+	bool letterboxed;
+	Recti dest = GetDestRect(source, destSize, letterboxed);
+
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, destFbo);
+	if (letterboxed) {
+		glClearColor(0, 0, 0, 1);
+		glClear(GL_COLOR_BUFFER_BIT);
+	}
+
+	if (!UsesCache()) {
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, sourceFbo);
+		glBlitFramebuffer(source.x, source.y, source.x + source.w, source.y + source.h,
+			dest.x, dest.y, dest.x + dest.w, dest.y + dest.h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		return;
+	}
+
+	// Refresh the cached mirror from the eye buffer every Interval frames
+	Sizei cacheSize = (Width > 0) ? Sizei(Width, Height) : Sizei(source.w, source.h);
+	EnsureCache(cacheSize);
+	if (!CacheValid || FrameCount % Interval == 0) {
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, sourceFbo);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, CacheFboId);
+		glBlitFramebuffer(source.x, source.y, source.x + source.w, source.y + source.h,
+			0, 0, cacheSize.w, cacheSize.h, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+		CacheValid = true;
+	}
+	FrameCount++;
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, CacheFboId);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, destFbo);
+	glBlitFramebuffer(0, 0, cacheSize.w, cacheSize.h,
+		dest.x, dest.y, dest.x + dest.w, dest.y + dest.h, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+}
+
+void MirrorRenderer::Release() {
+	if (CacheFboId) {
+		glDeleteFramebuffers(1, &CacheFboId);
+		CacheFboId = 0;
+	}
+	if (CacheTexId) {
+		glDeleteTextures(1, &CacheTexId);
+		CacheTexId = 0;
+	}
+	CacheSize = Sizei(0, 0);
+	CacheValid = false;
+}
@@ -0,0 +1,58 @@
+// MirrorRenderer.h
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#pragma once
+
+#include <GL/CAPI_GLE.h>
+#include <Extras/OVR_Math.h>
+
+// What the XVR window shows of the eye buffer. Values are part of the DLL interface
+// (OVR_SetMirrorPolicy).
+enum OVR_MirrorMode {
+	OVR_Mirror_BothEyes = 0,   // Whole eye buffer, stretched to the window (default)
+	OVR_Mirror_LeftEye = 1,    // One eye, letterboxed to keep its aspect ratio
+	OVR_Mirror_RightEye = 2,
+	OVR_Mirror_Off = 3         // Nothing is drawn to the window
+};
+
+// Copies the eye buffer to the XVR window according to the mirror policy.
+//
+// With the default policy (every frame, full resolution) the eye buffer is blitted straight
+// to the window as before. Otherwise the mirror goes through a cached texture: it is
+// refreshed from the eye buffer every Interval frames, at Width x Height if set, and only
+// the cached texture is blitted to the window in between. That keeps the big eye buffer
+// read off most frames.
+class MirrorRenderer
+{
+public:
+	MirrorRenderer();
+
+	// width and height of 0 mirror at the resolution of the eye buffer
+	void SetPolicy(int mode, int interval, int width, int height);
+	int GetMode() const { return Mode; }
+
+	// Call with the viewport set to the window. sourceSize is the rendered part of the eye buffer.
+	void Update(GLuint sourceFbo, const OVR::Sizei &sourceSize, GLuint destFbo, const OVR::Sizei &destSize);
+
+	// Releases the cached texture. Needs the GL context current.
+	void Release();
+
+private:
+	bool UsesCache() const { return Interval > 1 || Width > 0; }
+	OVR::Recti GetSourceRect(const OVR::Sizei &sourceSize) const;
+	OVR::Recti GetDestRect(const OVR::Recti &source, const OVR::Sizei &destSize, bool &letterboxed) const;
+	void EnsureCache(const OVR::Sizei &size);
+
+	int Mode;
+	int Interval;
+	int Width;
+	int Height;
+
+	unsigned int FrameCount;
+	bool CacheValid;
+	OVR::Sizei CacheSize;
+	GLuint CacheTexId;
+	GLuint CacheFboId;
+};
@@ -0,0 +1,127 @@
+// OculusContext.h
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#pragma once
+
+#include <GL/CAPI_GLE.h>
+#include <Extras/OVR_Math.h>
+#include <Kernel/OVR_String.h>
+#include "HmdBackend.h"
+#include "TrackingSampler.h"
+#include "TrackingRecording.h"
+#include "FrameTelemetry.h"
+#include "EyeMatrixCache.h"
+#include "FrameSubmitter.h"
+#include "GpuFrameTimer.h"
+#include "ResolutionController.h"
+#include "MirrorRenderer.h"
+
+// Everything one session of the exports works on. The exports always run on the current
+// context (see OVR_SelectContext); the default context is current until another one is
+// selected, so engines that never create a context see the DLL as before.
+//
+// A context either owns its HMD backend or shares the one of another context
+// (OVR_CreateContext). Sharing contexts have their own swap texture set, FBOs and
+// render state, e.g. for an operator preview rendered from the same tracking.
+struct OculusContext {
+	OculusContext()
+		: systemInitialized(false),
+		  HMD(nullptr), HmdOwner(this), backendType(OVR_Backend_LibOVR),
+		  TextureSet(nullptr),
+		  fboMsaaId(0), numSamples(4), maxSamples(4), depthMsaaId(0), fboOculusId(0), fboXvrId(0),
+		  depthTexId(0), msaaTexId(0), useMSAA(false),
+		  trackingRecorder(nullptr),
+		  frameIndex(0), renderTextureIndex(0),
+		  adaptiveQuality(false), renderStartNanos(0), cpuRenderNanos(0), gpuRenderNanos(0),
+		  clipNear(0.1f), clipFar(1000.0f) {
+		memset(&hmdDesc, 0, sizeof(hmdDesc));
+		memset(&trackingState, 0, sizeof(trackingState));
+		memset(&frameTiming, 0, sizeof(frameTiming));
+		memset(XVRViewportRect, 0, sizeof(XVRViewportRect));
+		memset(&layer, 0, sizeof(layer));
+	}
+
+	bool OwnsHmd() const { return HmdOwner == this; }
+
+	// OVR::System::Init was called for this context
+	bool systemInitialized;
+
+	// HMD the exports run on; the real Rift unless another backend was selected
+	HmdBackend* HMD;
+	OculusContext* HmdOwner;  // Context that created HMD
+	int backendType;
+	OVR::String replayPath;
+	ovrHmdDesc hmdDesc;
+	ovrTrackingState trackingState;
+	ovrFrameTiming frameTiming;
+
+	ovrSwapTextureSet*  TextureSet;
+	ovrSizei idealTextureSizeSet[2];
+
+	// Size of the buffer for the Oculus
+	OVR::Sizei bufferSize;
+	// Part of the buffer rendered to this frame; smaller than bufferSize when the
+	// adaptive quality controller scaled the viewport down
+	OVR::Sizei renderSize;
+
+	// Rect for the XVR viewport
+	GLint XVRViewportRect[4];
+
+	ovrVector3f ViewOffset[2];
+	ovrPosef EyeRenderPose[2];
+	ovrEyeRenderDesc EyeRenderDesc[2];
+	ovrVector3f      hmdToEyeViewOffset[2];
+	ovrLayerEyeFov layer;
+
+	// View and projection matrices of the frame being rendered
+	EyeMatrixCache eyeMatrices;
+
+	// MSAA fbo
+	GLuint fboMsaaId;
+	GLuint numSamples;
+	GLuint maxSamples;  // Asked for by the engine; numSamples is lower while adaptive quality steps MSAA down
+	GLuint depthMsaaId; // Attachment point for depth MSAA render buffer
+	// Oculus fbo
+	GLuint fboOculusId;
+	// XVR fbo
+	GLint fboXvrId;
+
+	// Textures
+	GLuint depthTexId;
+	GLuint msaaTexId;
+
+	// MSAA or not
+	bool useMSAA;
+
+	// Optional background tracking sampler
+	OVR::Ptr<TrackingSampler> trackingSampler;
+
+	// Optional tracking session recorder
+	TrackingRecorder* trackingRecorder;
+
+	// Optional submit thread. While it runs, frames are numbered (frameIndex is the one
+	// being rendered) and the engine renders into renderTextureIndex, not CurrentIndex.
+	OVR::Ptr<FrameSubmitter> frameSubmitter;
+	unsigned int frameIndex;
+	int renderTextureIndex;
+
+	// What OVR_CleanOGLContext copies to the XVR window
+	MirrorRenderer mirror;
+
+	// Adaptive resolution and MSAA (OVR_SetAdaptiveQuality)
+	bool adaptiveQuality;
+	ResolutionController qualityController;
+	GpuFrameTimer gpuTimer;
+	uint64_t renderStartNanos;
+	uint64_t cpuRenderNanos;    // OVR_PrepareOGLContext to OVR_CleanOGLContext, last frame
+	uint64_t gpuRenderNanos;    // Same on the GPU, latest frame measured
+
+	// Per-phase latency histograms
+	FrameTelemetry telemetry;
+
+	// Clipping planes used for the projection matrices handed to the engine
+	float clipNear;
+	float clipFar;
+};
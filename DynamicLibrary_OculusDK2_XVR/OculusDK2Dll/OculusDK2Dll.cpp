@@ -13,8 +13,10 @@
 
 #include "Win32_GLAppUtil.h"
 #include <Kernel/OVR_System.h>
+#include <Extras/OVR_CAPI_Util.h>
 
 #include "OculusDk2Dll.h"
+#include "OculusContext.h"
 
 
 using namespace OVR;
@@ -22,61 +24,117 @@ using namespace std;
 
 OVR::GLEContext GLEContexto;
 
-ovrHmd HMD;
-ovrGraphicsLuid luid;
-ovrHmdDesc hmdDesc;
-ovrTrackingState trackingState;
+// Contexts by handle. Slot 0 is the default context, which always exists.
+enum { MaxContexts = 16 };
+OculusContext defaultContext;
+OculusContext* contexts[MaxContexts] = { &defaultContext };
 
-ovrSwapTextureSet*  TextureSet;
-ovrSizei idealTextureSizeSet[2];
+// Context the exports run on
+OculusContext* ctx = &defaultContext;
 
-// Size of the buffer for the Oculus
-Sizei bufferSize;
+static OculusContext* GetContext(int handle) {
+	if (handle < 0 || handle >= MaxContexts) {
+		return nullptr;
+	}
+	return contexts[handle];
+}
+
+// True if another context renders with the HMD owned by owner
+static bool IsHmdShared(const OculusContext *owner) {
+	for (int i = 0; i < MaxContexts; ++i) {
+		if (contexts[i] && contexts[i] != owner && contexts[i]->HmdOwner == owner) {
+			return true;
+		}
+	}
+	return false;
+}
 
-// Rect for the XVR viewport
-GLint XVRViewportRect[4] = {};
+// Reallocates the MSAA color and depth buffers with another sample count
+static void ResizeMsaaBuffers(GLuint samples) {
+	glBindRenderbuffer(GL_RENDERBUFFER, ctx->depthMsaaId);
+	glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH24_STENCIL8, ctx->bufferSize.w, ctx->bufferSize.h);
 
-ovrVector3f ViewOffset[2];
-ovrPosef EyeRenderPose[2];
-ovrEyeRenderDesc EyeRenderDesc[2];
-ovrVector3f      hmdToEyeViewOffset[2];
-ovrLayerEyeFov layer;
+	glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, ctx->msaaTexId);
+	glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, samples, GL_SRGB8_ALPHA8, ctx->bufferSize.w, ctx->bufferSize.h, GL_TRUE);
 
-// MSAA fbo
-GLuint fboMsaaId;
-GLuint numSamples = 4;
-GLuint depthMsaaId; // Attachment point for depth MSAA render buffer
-// Oculus fbo
-GLuint fboOculusId;
-// XVR fbo
-GLint fboXvrId;
+	ctx->numSamples = samples;
+}
 
-// Textures
-GLuint depthTexId;
-GLuint msaaTexId;
+// Feeds the cost of the last frame to the adaptive quality controller and applies the
+// MSAA sample count it decides on. The viewport scale is applied by UpdateRenderViewports.
+static void UpdateAdaptiveQuality() {
+	uint64_t gpuNanos;
+	if (ctx->gpuTimer.Poll(gpuNanos)) {
+		ctx->gpuRenderNanos = gpuNanos;
+	}
+
+	float refreshRate = (ctx->hmdDesc.DisplayRefreshRate > 0.0f) ? ctx->hmdDesc.DisplayRefreshRate : 75.0f;
+	if (!ctx->qualityController.Update(ctx->cpuRenderNanos * 1e-9, ctx->gpuRenderNanos * 1e-9, 1.0 / refreshRate)) {
+		return;
+	}
+
+	GLuint samples = (GLuint)ctx->qualityController.GetSampleCount();
+	if (samples == 0) {
+		ctx->useMSAA = false;
+		glDisable(GL_MULTISAMPLE);
+	}
+	else {
+		if (samples != ctx->numSamples) {
+			ResizeMsaaBuffers(samples);
+		}
+		ctx->useMSAA = true;
+		glEnable(GL_MULTISAMPLE);
+	}
+}
 
-// MSAA or not
-bool useMSAA = false;
+// Part of the buffer rendered this frame and the eye viewports the compositor reads from it.
+// The engine splits the GL viewport in two halves, so the eyes stay side by side.
+static void UpdateRenderViewports() {
+	float scale = ctx->adaptiveQuality ? ctx->qualityController.GetViewportScale() : 1.0f;
+	if (scale < 1.0f) {
+		ctx->renderSize.w = (int)(ctx->bufferSize.w * scale) & ~1;
+		ctx->renderSize.h = (int)(ctx->bufferSize.h * scale);
+	}
+	else {
+		ctx->renderSize = ctx->bufferSize;
+	}
+	ctx->layer.Viewport[0] = Recti(0, 0, ctx->renderSize.w / 2, ctx->renderSize.h);
+	ctx->layer.Viewport[1] = Recti(ctx->renderSize.w / 2, 0, ctx->renderSize.w / 2, ctx->renderSize.h);
+}
 
 
 int OVR_Initialize() {
-	OVR::System::Init();
+	if (!ctx->systemInitialized) {
+		OVR::System::Init();
+		ctx->systemInitialized = true;
+	}
+
+	// A context sharing the HMD of another one has nothing else to initialize
+	if (!ctx->OwnsHmd()) {
+		return ovrSuccess;
+	}
+
+	if (!ctx->HMD) {
+		ctx->HMD = CreateHmdBackend(ctx->backendType, ctx->replayPath.ToCStr());
+	}
+	VALIDATE(ctx->HMD, "Unknown HMD backend.");
 
-	ovrResult result = ovr_Initialize(nullptr);
+	ovrResult result = ctx->HMD->Initialize();
 	VALIDATE(OVR_SUCCESS(result), "Failed to initialize libOVR.");
 
 	return result;
 }
 
 float OVR_Create() {
-	ovrResult result = ovr_Create(&HMD, &luid);
-	hmdDesc = ovr_GetHmdDesc(HMD);
-	return hmdDesc.DefaultEyeFov[0].UpTan;
+	if (ctx->OwnsHmd()) {
+		ovrResult result = ctx->HMD->Create(ctx->hmdDesc);
+	}
+	return ctx->hmdDesc.DefaultEyeFov[0].UpTan;
 }
 
 int OVR_GetScreenResolution(int &HRes, int &VRes) {
-	HRes = hmdDesc.Resolution.w;
-	VRes = hmdDesc.Resolution.h;
+	HRes = ctx->hmdDesc.Resolution.w;
+	VRes = ctx->hmdDesc.Resolution.h;
 	return 0;
 }
 
@@ -86,67 +144,92 @@ int OVR_GetInterpupillaryDistance(float &IPD) {
 }
 
 int OVR_Destroy() {
+	// Contexts sharing the HMD still have swap texture sets on it
+	if (IsHmdShared(ctx)) {
+		return ovrError_LeakingResources;
+	}
+
+	OVR_StopAsyncSubmit();
+	OVR_StopTrackingSampler();
+	ctx->gpuTimer.Shutdown();
+	ctx->adaptiveQuality = false;
+	ctx->mirror.Release();
+	OVR_StopRecording();
+
 	// Destroy swap texture set
-	if (TextureSet) {
-		ovr_DestroySwapTextureSet(HMD, TextureSet);
-		TextureSet = nullptr;
+	if (ctx->TextureSet) {
+		ctx->HMD->DestroySwapTextureSet(ctx->TextureSet);
+		ctx->TextureSet = nullptr;
 	}
 	// TODO: destroy MSAA texture
 	// ...
 
-	if (fboMsaaId) {
-		glDeleteFramebuffers(1, &fboMsaaId);
-		fboMsaaId = 0;
+	if (ctx->fboMsaaId) {
+		glDeleteFramebuffers(1, &ctx->fboMsaaId);
+		ctx->fboMsaaId = 0;
+	}
+	if (ctx->fboOculusId) {
+		glDeleteFramebuffers(1, &ctx->fboOculusId);
+		ctx->fboOculusId = 0;
 	}
-	if (fboOculusId) {
-		glDeleteFramebuffers(1, &fboOculusId);
-		fboOculusId = 0;
+
+	// Destroy and shutdown HMD, unless it belongs to another context
+	if (ctx->HMD && ctx->OwnsHmd()) {
+		ctx->HMD->Destroy();
+		ctx->HMD->Shutdown();
+		delete ctx->HMD;
 	}
+	ctx->HMD = nullptr;
+	ctx->HmdOwner = ctx;
 
-	// Destroy and shutdown HMD
-	ovr_Destroy(HMD);
-	ovr_Shutdown();
-	OVR::System::Destroy();
+	if (ctx->systemInitialized) {
+		OVR::System::Destroy();
+		ctx->systemInitialized = false;
+	}
 	return 0;
 }
 
 int OVR_ConfigureTracking() {
-	ovrResult result = ovr_ConfigureTracking(HMD, ovrTrackingCap_Orientation | ovrTrackingCap_MagYawCorrection | ovrTrackingCap_Position, 0);
+	ovrResult result = ctx->HMD->ConfigureTracking(ovrTrackingCap_Orientation | ovrTrackingCap_MagYawCorrection | ovrTrackingCap_Position, 0);
 	return result;
 }
 
 // Retrieves the tracking state from the Oculus Rift
 int OVR_GetTrackingState() {
-	ovrFrameTiming ftiming = ovr_GetFrameTiming(HMD, 0);
-	trackingState = ovr_GetTrackingState(HMD, ftiming.DisplayMidpointSeconds);
+	TelemetryScope scope(ctx->telemetry, OVR_Phase_GetTrackingState);
+	ctx->frameTiming = ctx->HMD->GetFrameTiming(ctx->frameIndex);
+	ctx->trackingState = ctx->HMD->GetTrackingState(ctx->frameTiming.DisplayMidpointSeconds);
+	if (ctx->trackingRecorder) {
+		ctx->trackingRecorder->Record(ctx->HMD->GetTimeInSeconds(), ctx->trackingState, ctx->frameTiming);
+	}
 	return 0;
 }
 
 // Retrieves the orientation of the Oculus Rift as a quaternion
 int OVR_GetSensorPredictedOrientation(float &qW, float &qX, float &qY, float &qZ) {
-	qW = trackingState.HeadPose.ThePose.Orientation.w;
-	qX = trackingState.HeadPose.ThePose.Orientation.x;
-	qY = trackingState.HeadPose.ThePose.Orientation.y;
-	qZ = trackingState.HeadPose.ThePose.Orientation.z;
+	qW = ctx->trackingState.HeadPose.ThePose.Orientation.w;
+	qX = ctx->trackingState.HeadPose.ThePose.Orientation.x;
+	qY = ctx->trackingState.HeadPose.ThePose.Orientation.y;
+	qZ = ctx->trackingState.HeadPose.ThePose.Orientation.z;
 	return 0;
 }
 
 // Retrieves the position of the Oculus Rift 
 int OVR_GetSensorPredictedPosition(float &vX, float &vY, float &vZ) {
-	vX = trackingState.HeadPose.ThePose.Position.x;
-	vY = trackingState.HeadPose.ThePose.Position.y;
-	vZ = trackingState.HeadPose.ThePose.Position.z;
+	vX = ctx->trackingState.HeadPose.ThePose.Position.x;
+	vY = ctx->trackingState.HeadPose.ThePose.Position.y;
+	vZ = ctx->trackingState.HeadPose.ThePose.Position.z;
 	return 0;
 }
 
 int OVR_CreateSwapTextureSetGL() {
 	ovrResult result;
 	for (int eye = 0; eye < 2; ++eye) {
-		idealTextureSizeSet[eye] = ovr_GetFovTextureSize(HMD, ovrEyeType(eye), hmdDesc.DefaultEyeFov[eye], 1);
+		ctx->idealTextureSizeSet[eye] = ctx->HMD->GetFovTextureSize(ovrEyeType(eye), ctx->hmdDesc.DefaultEyeFov[eye], 1);
 	}
 
-	bufferSize.w = idealTextureSizeSet[0].w + idealTextureSizeSet[1].w;
-	bufferSize.h = max(idealTextureSizeSet[0].h, idealTextureSizeSet[1].h);
+	ctx->bufferSize.w = ctx->idealTextureSizeSet[0].w + ctx->idealTextureSizeSet[1].w;
+	ctx->bufferSize.h = max(ctx->idealTextureSizeSet[0].h, ctx->idealTextureSizeSet[1].h);
 	
 	// Init OpenGL context
 	OVR::GLEContext::SetCurrentContext(&GLEContexto);
@@ -154,11 +237,11 @@ int OVR_CreateSwapTextureSetGL() {
 
 	////////////////////////////////////
 	// Allocate the "eye render buffer" in a 2D texture
-	result = ovr_CreateSwapTextureSetGL(HMD, GL_SRGB8_ALPHA8, bufferSize.w, bufferSize.h, &TextureSet);
+	result = ctx->HMD->CreateSwapTextureSetGL(GL_SRGB8_ALPHA8, ctx->bufferSize.w, ctx->bufferSize.h, &ctx->TextureSet);
 	
-	for (int i = 0; i < TextureSet->TextureCount; ++i)
+	for (int i = 0; i < ctx->TextureSet->TextureCount; ++i)
 	{
-		ovrGLTexture* tex = (ovrGLTexture*)&TextureSet->Textures[i];
+		ovrGLTexture* tex = (ovrGLTexture*)&ctx->TextureSet->Textures[i];
 		glBindTexture(GL_TEXTURE_2D, tex->OGL.TexId); // id for texture unit 1 and 2
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -170,18 +253,18 @@ int OVR_CreateSwapTextureSetGL() {
 
 	////////////////////////////////////
 	// Depth texture (MSAA)
-	glGenRenderbuffers(1, &depthMsaaId);
-	glBindRenderbuffer(GL_RENDERBUFFER, depthMsaaId);
+	glGenRenderbuffers(1, &ctx->depthMsaaId);
+	glBindRenderbuffer(GL_RENDERBUFFER, ctx->depthMsaaId);
 	// Add depth/stencil buffer to MSAA fbo
-	glRenderbufferStorageMultisample(GL_RENDERBUFFER, numSamples, GL_DEPTH24_STENCIL8, bufferSize.w, bufferSize.h);
-	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthMsaaId);
+	glRenderbufferStorageMultisample(GL_RENDERBUFFER, ctx->numSamples, GL_DEPTH24_STENCIL8, ctx->bufferSize.w, ctx->bufferSize.h);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, ctx->depthMsaaId);
 
 	////////////////////////////////////
 	// MSAA 2D texture
-	glGenTextures(1, &msaaTexId);
+	glGenTextures(1, &ctx->msaaTexId);
 
-	glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, msaaTexId);
-	glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, numSamples, GL_SRGB8_ALPHA8, bufferSize.w, bufferSize.h, GL_TRUE);
+	glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, ctx->msaaTexId);
+	glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, ctx->numSamples, GL_SRGB8_ALPHA8, ctx->bufferSize.w, ctx->bufferSize.h, GL_TRUE);
 
 	// Start with MSAA disabled
 	glDisable(GL_MULTISAMPLE);
@@ -189,8 +272,8 @@ int OVR_CreateSwapTextureSetGL() {
 
 	////////////////////////////////////
 	// Depth texture (no MSAA)
-	glGenTextures(1, &depthTexId);
-	glBindTexture(GL_TEXTURE_2D, depthTexId);
+	glGenTextures(1, &ctx->depthTexId);
+	glBindTexture(GL_TEXTURE_2D, ctx->depthTexId);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -203,15 +286,15 @@ int OVR_CreateSwapTextureSetGL() {
 		internalFormat = GL_DEPTH_COMPONENT32F;
 		type = GL_FLOAT;
 	}
-	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, bufferSize.w, bufferSize.h, 0, GL_DEPTH_COMPONENT, type, NULL);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, ctx->bufferSize.w, ctx->bufferSize.h, 0, GL_DEPTH_COMPONENT, type, NULL);
 	
 
 	// Instead of rendering in an FBO in XVR, we setup an FBO right here, for Msaa and for the Oculus
-	glGenFramebuffers(1, &fboMsaaId);
-	glGenFramebuffers(1, &fboOculusId);
+	glGenFramebuffers(1, &ctx->fboMsaaId);
+	glGenFramebuffers(1, &ctx->fboOculusId);
 
 	// Get XVR fbo ID which is currently bound
-	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &fboXvrId);
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &ctx->fboXvrId);
 
 	return result;
 }
@@ -219,140 +302,556 @@ int OVR_CreateSwapTextureSetGL() {
 // Like OVR_CreateSwapTextureSetGL but we can specify the number of samples for MSAA
 // Default number of samples for MSAA is 4
 int OVR_CreateSwapTextureSetGLWithMSAASamples(int aNumSamples) {
-	numSamples = aNumSamples;
+	ctx->numSamples = aNumSamples;
+	ctx->maxSamples = aNumSamples;
 	return OVR_CreateSwapTextureSetGL();
 }
 
 int OVR_PrepareFrameRendering() {
 	// Initialize VR structures, filling out description.
-	EyeRenderDesc[0] = ovr_GetRenderDesc(HMD, ovrEye_Left, hmdDesc.DefaultEyeFov[0]);
-	EyeRenderDesc[1] = ovr_GetRenderDesc(HMD, ovrEye_Right, hmdDesc.DefaultEyeFov[1]);
-	hmdToEyeViewOffset[0] = EyeRenderDesc[0].HmdToEyeViewOffset;
-	hmdToEyeViewOffset[1] = EyeRenderDesc[1].HmdToEyeViewOffset;
+	ctx->EyeRenderDesc[0] = ctx->HMD->GetRenderDesc(ovrEye_Left, ctx->hmdDesc.DefaultEyeFov[0]);
+	ctx->EyeRenderDesc[1] = ctx->HMD->GetRenderDesc(ovrEye_Right, ctx->hmdDesc.DefaultEyeFov[1]);
+	ctx->hmdToEyeViewOffset[0] = ctx->EyeRenderDesc[0].HmdToEyeViewOffset;
+	ctx->hmdToEyeViewOffset[1] = ctx->EyeRenderDesc[1].HmdToEyeViewOffset;
 
 	// Turn off vsync to let the compositor do its magic
 	wglSwapIntervalEXT(0);
 
 	// Initialize our single full screen Fov layer.
-	layer.Header.Type = ovrLayerType_EyeFov;
-	layer.Header.Flags = ovrLayerFlag_TextureOriginAtBottomLeft;   // Because OpenGL.
-	layer.ColorTexture[0] = TextureSet;
-	layer.ColorTexture[1] = TextureSet;
-	layer.Fov[0] = EyeRenderDesc[0].Fov;
-	layer.Fov[1] = EyeRenderDesc[1].Fov;
-	layer.Viewport[0] = Recti(0, 0, bufferSize.w / 2, bufferSize.h);
-	layer.Viewport[1] = Recti(bufferSize.w / 2, 0, bufferSize.w / 2, bufferSize.h);
+	ctx->layer.Header.Type = ovrLayerType_EyeFov;
+	ctx->layer.Header.Flags = ovrLayerFlag_TextureOriginAtBottomLeft;   // Because OpenGL.
+	ctx->layer.ColorTexture[0] = ctx->TextureSet;
+	ctx->layer.ColorTexture[1] = ctx->TextureSet;
+	ctx->layer.Fov[0] = ctx->EyeRenderDesc[0].Fov;
+	ctx->layer.Fov[1] = ctx->EyeRenderDesc[1].Fov;
+	ctx->layer.Viewport[0] = Recti(0, 0, ctx->bufferSize.w / 2, ctx->bufferSize.h);
+	ctx->layer.Viewport[1] = Recti(ctx->bufferSize.w / 2, 0, ctx->bufferSize.w / 2, ctx->bufferSize.h);
 	// ld.RenderPose is updated later per frame.
 
 	return 0;
 }
 
 int OVR_PrepareOGLContext() {
+	TelemetryScope scope(ctx->telemetry, OVR_Phase_PrepareOGLContext);
+	if (ctx->adaptiveQuality) {
+		UpdateAdaptiveQuality();
+	}
+	UpdateRenderViewports();
+
 	// Get eye poses, feeding in correct IPD offset
-	ViewOffset[0] = EyeRenderDesc[0].HmdToEyeViewOffset;
-	ViewOffset[1] = EyeRenderDesc[1].HmdToEyeViewOffset;
+	ctx->ViewOffset[0] = ctx->EyeRenderDesc[0].HmdToEyeViewOffset;
+	ctx->ViewOffset[1] = ctx->EyeRenderDesc[1].HmdToEyeViewOffset;
 
 	// NOTE: We have to use the same tracking state that we use to render the scene!! 
 	// We might otherwise introduce lag...
-	ovr_CalcEyePoses(trackingState.HeadPose.ThePose, ViewOffset, EyeRenderPose);
-
-	// Increment to use next texture, just before writing
-	TextureSet->CurrentIndex = (TextureSet->CurrentIndex + 1) % TextureSet->TextureCount;
+	ovr_CalcEyePoses(ctx->trackingState.HeadPose.ThePose, ctx->ViewOffset, ctx->EyeRenderPose);
+	ctx->eyeMatrices.UpdateViews(ctx->EyeRenderPose);
+	ctx->eyeMatrices.UpdateProjections(ctx->hmdDesc.DefaultEyeFov, ctx->clipNear, ctx->clipFar);
+
+	// Increment to use next texture, just before writing. With the submit thread running,
+	// CurrentIndex belongs to the frame being submitted, so we keep our own.
+	int textureIndex;
+	if (ctx->frameSubmitter) {
+		ctx->renderTextureIndex = (ctx->renderTextureIndex + 1) % ctx->TextureSet->TextureCount;
+		textureIndex = ctx->renderTextureIndex;
+	}
+	else {
+		ctx->TextureSet->CurrentIndex = (ctx->TextureSet->CurrentIndex + 1) % ctx->TextureSet->TextureCount;
+		textureIndex = ctx->TextureSet->CurrentIndex;
+	}
 
-	auto tex = reinterpret_cast<ovrGLTexture*>(&TextureSet->Textures[TextureSet->CurrentIndex]);
+	auto tex = reinterpret_cast<ovrGLTexture*>(&ctx->TextureSet->Textures[textureIndex]);
 
 	// Update XVR fbo viewport size
-	glBindFramebuffer(GL_FRAMEBUFFER, fboXvrId);
-	glGetIntegerv(GL_VIEWPORT, XVRViewportRect);
+	glBindFramebuffer(GL_FRAMEBUFFER, ctx->fboXvrId);
+	glGetIntegerv(GL_VIEWPORT, ctx->XVRViewportRect);
 
 	// Set Oculus fbo
-	glBindFramebuffer(GL_FRAMEBUFFER, fboOculusId);
+	glBindFramebuffer(GL_FRAMEBUFFER, ctx->fboOculusId);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex->OGL.TexId, 0);
 
-	if (useMSAA)
+	if (ctx->useMSAA)
 	{
 		// Prepare MSAA fbo for rendering
-		glBindFramebuffer(GL_FRAMEBUFFER, fboMsaaId);
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D_MULTISAMPLE, msaaTexId, 0);
-		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthMsaaId);
+		glBindFramebuffer(GL_FRAMEBUFFER, ctx->fboMsaaId);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D_MULTISAMPLE, ctx->msaaTexId, 0);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, ctx->depthMsaaId);
 	}
 	else
 	{
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexId, 0);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, ctx->depthTexId, 0);
 	}
 	
 	
 
-	// Change viewport to the size of the Oculus fbo
-	glViewport(0, 0, bufferSize.w, bufferSize.h);
+	// Change viewport to the part of the Oculus fbo rendered this frame
+	glViewport(0, 0, ctx->renderSize.w, ctx->renderSize.h);
 
 	// Clean MSAA buffer
 	glClearColor(0, 0.25, 0, 1);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	glEnable(GL_FRAMEBUFFER_SRGB);
 
-	return TextureSet->CurrentIndex;
+	if (ctx->adaptiveQuality) {
+		ctx->gpuTimer.Begin();
+		ctx->renderStartNanos = Timer::GetTicksNanos();
+	}
+
+	return textureIndex;
 }
 
+// NOTE: the blits are only queued here, so this measures the CPU side of the resolve and
+// mirror. GPU time shows up in the next phase that has to wait for the GPU.
 int OVR_CleanOGLContext() {
-	if (useMSAA)
+	TelemetryScope scope(ctx->telemetry, OVR_Phase_CleanOGLContext);
+	if (ctx->useMSAA)
 	{
 		// Blit MSAA texture to the Oculus FBO
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboOculusId);   // Set the Oculus buffer as the draw buffer
-		glBindFramebuffer(GL_READ_FRAMEBUFFER, fboMsaaId); // Make multisampled FBO the read framebuffer
-		glBlitFramebuffer(0, 0, bufferSize.w, bufferSize.h, 0, 0, bufferSize.w, bufferSize.h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
-
-		// Blit MSAA texture to the back buffer so it shows in the XVR FBO
-		glViewport(0, 0, XVRViewportRect[2], XVRViewportRect[3]); // Change viewport to the size of the XVR window
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboXvrId); // Set XVR buffer as the draw buffer for the mirroring
-		// Now we read from the Oculus buffer since reading from the MSAA buffer and blitting into a buffer of a different size
-		// gives an error
-		glBindFramebuffer(GL_READ_FRAMEBUFFER, fboOculusId);
-		glBlitFramebuffer(0, 0, bufferSize.w, bufferSize.h, 0, 0, XVRViewportRect[2], XVRViewportRect[3], GL_COLOR_BUFFER_BIT, GL_NEAREST);
-
-		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
-	}
-	else
-	{
-		// Blit MSAA texture to the back buffer so it shows in the XVR FBO
-		glViewport(0, 0, XVRViewportRect[2], XVRViewportRect[3]); // Change viewport to the size of the XVR window
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboXvrId); // Set XVR buffer as the draw buffer for the mirroring
-		// Now we read from the Oculus buffer since reading from the MSAA buffer and blitting into a buffer of a different size
-		// gives an error
-		glBindFramebuffer(GL_READ_FRAMEBUFFER, fboOculusId);
-		glBlitFramebuffer(0, 0, bufferSize.w, bufferSize.h, 0, 0, XVRViewportRect[2], XVRViewportRect[3], GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, ctx->fboOculusId);   // Set the Oculus buffer as the draw buffer
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, ctx->fboMsaaId); // Make multisampled FBO the read framebuffer
+		glBlitFramebuffer(0, 0, ctx->renderSize.w, ctx->renderSize.h, 0, 0, ctx->renderSize.w, ctx->renderSize.h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
 	}
+
+	// Mirror to the XVR FBO so it shows in the window, as the mirror policy says.
+	// We read from the Oculus buffer since reading from the MSAA buffer and blitting into a buffer
+	// of a different size gives an error
+	glViewport(0, 0, ctx->XVRViewportRect[2], ctx->XVRViewportRect[3]); // Change viewport to the size of the XVR window
+	ctx->mirror.Update(ctx->fboOculusId, ctx->renderSize, ctx->fboXvrId, Sizei(ctx->XVRViewportRect[2], ctx->XVRViewportRect[3]));
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
 	
 	// Some clean up
-	glBindFramebuffer(GL_FRAMEBUFFER, fboXvrId); // Set the XVR buffer as the draw buffer
+	glBindFramebuffer(GL_FRAMEBUFFER, ctx->fboXvrId); // Set the XVR buffer as the draw buffer
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, 0, 0);
+
+	if (ctx->adaptiveQuality) {
+		ctx->gpuTimer.End();
+		ctx->cpuRenderNanos = Timer::GetTicksNanos() - ctx->renderStartNanos;
+	}
 	return 0;
 }
 
 int OVR_SubmitFrame() {
+	if (ctx->telemetry.IsEnabled()) {
+		ctx->telemetry.MarkFrame(Timer::GetTicksNanos());
+	}
+	TelemetryScope scope(ctx->telemetry, OVR_Phase_SubmitFrame);
+
+	// Hand the frame to the submit thread; only waits if the engine is too far ahead
+	if (ctx->frameSubmitter) {
+		QueuedFrame frame;
+		frame.FrameIndex = ctx->frameIndex++;
+		frame.TextureIndex = ctx->renderTextureIndex;
+		frame.EyeRenderPose[0] = ctx->EyeRenderPose[0];
+		frame.EyeRenderPose[1] = ctx->EyeRenderPose[1];
+		frame.HmdToEyeViewOffset[0] = ctx->ViewOffset[0];
+		frame.HmdToEyeViewOffset[1] = ctx->ViewOffset[1];
+		frame.Viewport[0] = ctx->layer.Viewport[0];
+		frame.Viewport[1] = ctx->layer.Viewport[1];
+		return ctx->frameSubmitter->Enqueue(frame);
+	}
+
 	// Set up positional data.
 	ovrViewScaleDesc viewScaleDesc;
 	viewScaleDesc.HmdSpaceToWorldScaleInMeters = 1.0f;
-	viewScaleDesc.HmdToEyeViewOffset[0] = ViewOffset[0];
-	viewScaleDesc.HmdToEyeViewOffset[1] = ViewOffset[1];
+	viewScaleDesc.HmdToEyeViewOffset[0] = ctx->ViewOffset[0];
+	viewScaleDesc.HmdToEyeViewOffset[1] = ctx->ViewOffset[1];
 
-	layer.RenderPose[0] = EyeRenderPose[0];
-	layer.RenderPose[1] = EyeRenderPose[1];
+	ctx->layer.RenderPose[0] = ctx->EyeRenderPose[0];
+	ctx->layer.RenderPose[1] = ctx->EyeRenderPose[1];
 
-	ovrLayerHeader* layers = &layer.Header;
-	ovrResult result = ovr_SubmitFrame(HMD, 0, &viewScaleDesc, &layers, 1);
+	ovrLayerHeader* layers = &ctx->layer.Header;
+	ovrResult result = ctx->HMD->SubmitFrame(0, &viewScaleDesc, &layers, 1);
 
 	return result;
 }
 
 void OVR_SetMultisampleAA(int isMultisampleOn) {
 	if (isMultisampleOn) {
-		useMSAA = true;
+		ctx->useMSAA = true;
 		glEnable(GL_MULTISAMPLE);
 	}
 	else {
-		useMSAA = false;
+		ctx->useMSAA = false;
 		glDisable(GL_MULTISAMPLE);
 	}
+	// The controller works below the new setting from now on
+	if (ctx->adaptiveQuality) {
+		if (ctx->useMSAA && ctx->numSamples != ctx->maxSamples) {
+			ResizeMsaaBuffers(ctx->maxSamples);
+		}
+		ctx->qualityController.Reset(ctx->useMSAA ? ctx->maxSamples : 0, ctx->qualityController.GetMinScale());
+	}
+}
+
+
+int OVR_SetClippingPlanes(float zNear, float zFar) {
+	if (zNear <= 0.0f || zFar <= zNear) {
+		return ovrError_InvalidParameter;
+	}
+	ctx->clipNear = zNear;
+	ctx->clipFar = zFar;
+	return 0;
+}
+
+// Samples the tracking state and fills the whole snapshot in one call. This replaces
+// OVR_GetTrackingState + OVR_GetSensorPredictedOrientation + OVR_GetSensorPredictedPosition
+// and hands out the eye poses and projections that would otherwise be rebuilt in script.
+// The sampled state is kept, so OVR_PrepareOGLContext renders with the same pose.
+int OVR_GetTrackingSnapshot(OVR_TrackingSnapshot *snapshot) {
+	if (!snapshot || snapshot->Size < 2 * sizeof(unsigned int)) {
+		return ovrError_InvalidParameter;
+	}
+
+	OVR_GetTrackingState();
+
+	OVR_TrackingSnapshot s;
+	s.Version = OVR_TRACKING_SNAPSHOT_VERSION;
+	s.Size = min(snapshot->Size, (unsigned int)sizeof(OVR_TrackingSnapshot));
+
+	const ovrPoseStatef &head = ctx->trackingState.HeadPose;
+	s.HeadPose = head.ThePose;
+	s.AngularVelocity = head.AngularVelocity;
+	s.LinearVelocity = head.LinearVelocity;
+	s.AngularAcceleration = head.AngularAcceleration;
+	s.LinearAcceleration = head.LinearAcceleration;
+
+	ovrVector3f eyeOffset[2] = { ctx->EyeRenderDesc[0].HmdToEyeViewOffset, ctx->EyeRenderDesc[1].HmdToEyeViewOffset };
+	ovr_CalcEyePoses(head.ThePose, eyeOffset, s.EyePose);
+
+	ctx->eyeMatrices.UpdateProjections(ctx->hmdDesc.DefaultEyeFov, ctx->clipNear, ctx->clipFar);
+	for (int eye = 0; eye < 2; ++eye) {
+		s.EyeProjection[eye] = ctx->eyeMatrices.GetProjection(eye);
+	}
+
+	s.StatusFlags = ctx->trackingState.StatusFlags;
+	s.SampleTimeSeconds = head.TimeInSeconds;
+	s.DisplayMidpointSeconds = ctx->frameTiming.DisplayMidpointSeconds;
+
+	// Only write as much as the caller's version of the struct can hold
+	memcpy(snapshot, &s, s.Size);
+	return 0;
+}
+
+double OVR_GetTimeInSeconds() {
+	return ctx->HMD ? ctx->HMD->GetTimeInSeconds() : ovr_GetTimeInSeconds();
+}
+
+// Starts polling the tracker on a background thread at rateHz (1-1000)
+int OVR_StartTrackingSampler(int rateHz) {
+	if (!ctx->HMD || !ctx->HMD->IsCreated()) {
+		return ovrError_InvalidHmd;
+	}
+	if (rateHz <= 0) {
+		return ovrError_InvalidParameter;
+	}
+	OVR_StopTrackingSampler();
+
+	ctx->trackingSampler = *new TrackingSampler(ctx->HMD, rateHz);
+	if (!ctx->trackingSampler->Start()) {
+		ctx->trackingSampler.Clear();
+		return ovrError_Initialize;
+	}
+	return 0;
+}
+
+int OVR_StopTrackingSampler() {
+	if (ctx->trackingSampler) {
+		ctx->trackingSampler->Stop();
+		ctx->trackingSampler.Clear();
+	}
+	return 0;
+}
+
+// Rate the sampler was started with and the rate it measured over the last full second
+// (0 during the first second), to check that the requested rate is actually reached
+int OVR_GetTrackingSamplerRate(int &requestedHz, int &measuredHz) {
+	if (!ctx->trackingSampler) {
+		return ovrError_NotInitialized;
+	}
+	requestedHz = ctx->trackingSampler->GetRequestedRateHz();
+	measuredHz = ctx->trackingSampler->GetMeasuredRateHz();
+	return 0;
 }
+
+// Like OVR_GetTrackingState, but reads the head pose from the sampler history instead of
+// querying the tracker. The pose is interpolated or extrapolated to absTime; pass 0 to get
+// it at the predicted display time of the next frame. Never blocks on the tracker.
+int OVR_GetSampledTrackingState(double absTime) {
+	if (!ctx->trackingSampler) {
+		return OVR_GetTrackingState();
+	}
+
+	ctx->frameTiming = ctx->HMD->GetFrameTiming(ctx->frameIndex);
+	if (absTime <= 0.0) {
+		absTime = ctx->frameTiming.DisplayMidpointSeconds;
+	}
+
+	ovrPoseStatef pose;
+	if (!ctx->trackingSampler->GetPoseAtTime(absTime, pose)) {
+		return OVR_GetTrackingState();
+	}
+	ctx->trackingState.HeadPose = pose;
+	if (ctx->trackingRecorder) {
+		ctx->trackingRecorder->Record(ctx->HMD->GetTimeInSeconds(), ctx->trackingState, ctx->frameTiming);
+	}
+	return 0;
+}
+
+// Selects the backend used by the exports. Must be called before OVR_Initialize.
+int OVR_SelectBackend(int type) {
+	if (ctx->HMD) {
+		return ovrError_Reinitialization;
+	}
+	if (type != OVR_Backend_LibOVR && type != OVR_Backend_Simulated && type != OVR_Backend_Replay) {
+		return ovrError_InvalidParameter;
+	}
+	ctx->backendType = type;
+	return 0;
+}
+
+// Plays the tracking recording at path back instead of using the Rift.
+// Must be called before OVR_Initialize.
+int OVR_SelectReplayBackend(const char *path) {
+	if (!path) {
+		return ovrError_InvalidParameter;
+	}
+	int result = OVR_SelectBackend(OVR_Backend_Replay);
+	if (OVR_SUCCESS(result)) {
+		ctx->replayPath = path;
+	}
+	return result;
+}
+
+// Records every tracking state the DLL hands to the engine into the file at path.
+// The file is written by a background thread; see TrackingRecording.h for the format.
+int OVR_StartRecording(const char *path) {
+	if (!path) {
+		return ovrError_InvalidParameter;
+	}
+	OVR_StopRecording();
+
+	ctx->trackingRecorder = new TrackingRecorder();
+	if (!ctx->trackingRecorder->Open(path)) {
+		delete ctx->trackingRecorder;
+		ctx->trackingRecorder = nullptr;
+		return ovrError_InvalidParameter;
+	}
+	return 0;
+}
+
+// Finishes the recording. Returns the number of states dropped because the writer fell behind.
+int OVR_StopRecording() {
+	int dropped = 0;
+	if (ctx->trackingRecorder) {
+		ctx->trackingRecorder->Close();
+		dropped = (int)ctx->trackingRecorder->GetDroppedCount();
+		delete ctx->trackingRecorder;
+		ctx->trackingRecorder = nullptr;
+	}
+	return dropped;
+}
+
+// Turns the per-phase timing on or off. It is on by default.
+int OVR_SetTelemetryEnabled(int enabled) {
+	ctx->telemetry.SetEnabled(enabled != 0);
+	return 0;
+}
+
+int OVR_ResetTelemetry() {
+	ctx->telemetry.Reset();
+	return 0;
+}
+
+// Percentiles of one OVR_TelemetryPhase, in milliseconds. Returns the number of samples.
+int OVR_GetPhaseLatency(int phase, float &p50, float &p99, float &p999) {
+	if (phase < 0 || phase >= OVR_Phase_Count) {
+		return ovrError_InvalidParameter;
+	}
+	const LatencyHistogram &h = ctx->telemetry.GetPhase(phase);
+	p50 = (float)(h.GetPercentile(0.5) / 1e6);
+	p99 = (float)(h.GetPercentile(0.99) / 1e6);
+	p999 = (float)(h.GetPercentile(0.999) / 1e6);
+	return (int)h.GetCount();
+}
+
+// Writes the histograms of every phase to a JSON file
+int OVR_SaveTelemetry(const char *path) {
+	if (!path) {
+		return ovrError_InvalidParameter;
+	}
+	return ctx->telemetry.Save(path) ? 0 : ovrError_InvalidParameter;
+}
+
+// Creates a new context and returns its handle (1 or more). The default context, which the
+// exports run on until another one is selected, has handle 0.
+// To render for the HMD of an existing context, pass its handle as shareHmdWith; its HMD
+// must be created. The new context still needs its own OVR_Initialize, swap texture set
+// and frame setup, and only one of the contexts should submit frames. Pass -1 to give the
+// new context its own backend, set up with OVR_SelectBackend, OVR_Initialize and OVR_Create.
+int OVR_CreateContext(int shareHmdWith) {
+	OculusContext* owner = nullptr;
+	if (shareHmdWith >= 0) {
+		OculusContext* other = GetContext(shareHmdWith);
+		if (!other || !other->HMD || !other->HMD->IsCreated()) {
+			return ovrError_InvalidHmd;
+		}
+		owner = other->HmdOwner;
+	}
+
+	for (int handle = 1; handle < MaxContexts; ++handle) {
+		if (!contexts[handle]) {
+			OculusContext* context = new OculusContext();
+			if (owner) {
+				context->HMD = owner->HMD;
+				context->HmdOwner = owner;
+				context->backendType = owner->backendType;
+				context->hmdDesc = owner->hmdDesc;
+			}
+			contexts[handle] = context;
+			return handle;
+		}
+	}
+	return ovrError_MemoryAllocationFailure;
+}
+
+// Makes the context the one all other exports run on
+int OVR_SelectContext(int handle) {
+	OculusContext* context = GetContext(handle);
+	if (!context) {
+		return ovrError_InvalidParameter;
+	}
+	ctx = context;
+	return 0;
+}
+
+int OVR_GetCurrentContext() {
+	for (int handle = 0; handle < MaxContexts; ++handle) {
+		if (contexts[handle] == ctx) {
+			return handle;
+		}
+	}
+	return 0;
+}
+
+// Releases everything the context holds, as OVR_Destroy does, and frees the handle.
+// If it was the current context, the default context becomes current.
+int OVR_DestroyContext(int handle) {
+	OculusContext* context = GetContext(handle);
+	if (handle == 0 || !context) {
+		return ovrError_InvalidParameter;
+	}
+
+	OculusContext* current = ctx;
+	ctx = context;
+	int result = OVR_Destroy();
+	ctx = (current == context) ? &defaultContext : current;
+	if (!OVR_SUCCESS(result)) {
+		return result;
+	}
+
+	delete context;
+	contexts[handle] = nullptr;
+	return 0;
+}
+
+// Copies the view and projection matrices of the frame being rendered, as computed by
+// OVR_PrepareOGLContext. Each array receives 32 floats: the left eye's column-major 4x4
+// matrix followed by the right eye's, ready for glLoadMatrixf. Views are in tracking space.
+int OVR_GetEyeMatrices(float *viewMatrices, float *projectionMatrices) {
+	if (!viewMatrices || !projectionMatrices) {
+		return ovrError_InvalidParameter;
+	}
+	if (!ctx->eyeMatrices.HasViews()) {
+		return ovrError_NotInitialized;
+	}
+	ctx->eyeMatrices.CopyViews(viewMatrices);
+	ctx->eyeMatrices.CopyProjections(projectionMatrices);
+	return 0;
+}
+
+// Moves ovr_SubmitFrame to a dedicated thread. OVR_SubmitFrame then only queues the frame and
+// the engine may start the next one while the compositor waits; it is allowed queueAhead
+// (1-2) frames ahead. Each frame is rendered into its own swap texture slot, so the swap
+// texture set needs at least queueAhead + 2 textures. Call after OVR_PrepareFrameRendering,
+// from the engine thread with its GL context current. OVR_SubmitFrame returns the result of
+// the last completed submit while this is on.
+int OVR_StartAsyncSubmit(int queueAhead) {
+	if (!ctx->HMD || !ctx->TextureSet) {
+		return ovrError_NotInitialized;
+	}
+	if (queueAhead < 1 || queueAhead > FrameSubmitter::MaxQueueAhead ||
+		ctx->TextureSet->TextureCount < queueAhead + 2) {
+		return ovrError_InvalidParameter;
+	}
+	OVR_StopAsyncSubmit();
+
+	ctx->frameSubmitter = *new FrameSubmitter(ctx->HMD, ctx->TextureSet, ctx->layer, queueAhead);
+	if (!ctx->frameSubmitter->Begin()) {
+		ctx->frameSubmitter.Clear();
+		return ovrError_Initialize;
+	}
+	ctx->renderTextureIndex = ctx->TextureSet->CurrentIndex;
+	ctx->frameIndex = 1;
+	return 0;
+}
+
+// Submits the frames still queued and goes back to submitting on the engine thread
+int OVR_StopAsyncSubmit() {
+	if (ctx->frameSubmitter) {
+		ctx->frameSubmitter->Stop();
+		ctx->frameSubmitter.Clear();
+		ctx->TextureSet->CurrentIndex = ctx->renderTextureIndex;
+		ctx->frameIndex = 0;
+	}
+	return 0;
+}
+
+// Lets the DLL hold the frame rate under load: when the measured CPU or GPU frame time gets
+// close to the frame budget, MSAA samples are stepped down first, then the rendered viewport
+// is scaled down inside the swap texture, to minScale (0.1-1) at most. Quality comes back
+// when the load goes down. Call after OVR_CreateSwapTextureSetGL with the GL context current.
+int OVR_SetAdaptiveQuality(int enabled, float minScale) {
+	if (enabled) {
+		if (!ctx->TextureSet) {
+			return ovrError_NotInitialized;
+		}
+		if (minScale < 0.1f || minScale > 1.0f) {
+			return ovrError_InvalidParameter;
+		}
+		ctx->qualityController.Reset(ctx->useMSAA ? ctx->maxSamples : 0, minScale);
+		ctx->gpuTimer.Init();
+		ctx->cpuRenderNanos = 0;
+		ctx->gpuRenderNanos = 0;
+		ctx->adaptiveQuality = true;
+	}
+	else if (ctx->adaptiveQuality) {
+		// Back to what the engine asked for
+		ctx->adaptiveQuality = false;
+		ctx->gpuTimer.Shutdown();
+		if (ctx->numSamples != ctx->maxSamples) {
+			ResizeMsaaBuffers(ctx->maxSamples);
+		}
+		OVR_SetMultisampleAA(ctx->qualityController.GetMaxSamples() > 0);
+	}
+	return 0;
+}
+
+// Current viewport scale and MSAA sample count (0 when MSAA is off)
+int OVR_GetAdaptiveQuality(float &viewportScale, int &msaaSamples) {
+	viewportScale = ctx->adaptiveQuality ? ctx->qualityController.GetViewportScale() : 1.0f;
+	msaaSamples = ctx->useMSAA ? (int)ctx->numSamples : 0;
+	return 0;
+}
+
+// Sets what OVR_CleanOGLContext copies to the XVR window: mode is an OVR_MirrorMode, the mirror
+// is refreshed every interval frames (1 = every frame) and, if width and height are not 0,
+// kept at that fixed resolution. Anything but every frame at full resolution goes through a
+// cached mirror texture, so most frames do not read the eye buffer at all.
+int OVR_SetMirrorPolicy(int mode, int interval, int width, int height) {
+	if (mode < OVR_Mirror_BothEyes || mode > OVR_Mirror_Off || interval < 1 || width < 0 || height < 0) {
+		return ovrError_InvalidParameter;
+	}
+	ctx->mirror.SetPolicy(mode, interval, width, height);
+	return 0;
+}
\ No newline at end of file
@@ -7,6 +7,39 @@
 #define VALIDATE(x, msg) if (!(x)) { MessageBoxA(NULL, (msg), "OculusRoomTiny", MB_ICONERROR | MB_OK); exit(-1); }
 #endif
 
+// Version of the OVR_TrackingSnapshot layout. Bump it whenever fields are appended.
+#define OVR_TRACKING_SNAPSHOT_VERSION 1
+
+// Everything the engine needs from the tracker for one frame, filled in by a single
+// call to OVR_GetTrackingSnapshot. The caller sets Size to sizeof(OVR_TrackingSnapshot)
+// as it knows it; the DLL never writes past that size, so older callers keep working
+// when new fields are appended at the end.
+#pragma pack(push, 4)
+struct OVR_TrackingSnapshot {
+	// Header
+	unsigned int Version;           // Layout version written by the DLL
+	unsigned int Size;              // In: size of the caller's buffer. Out: bytes written
+
+	// Head pose and derivatives
+	ovrPosef     HeadPose;
+	ovrVector3f  AngularVelocity;
+	ovrVector3f  LinearVelocity;
+	ovrVector3f  AngularAcceleration;
+	ovrVector3f  LinearAcceleration;
+
+	// Eye poses from ovr_CalcEyePoses and OpenGL projection matrices (row-major)
+	ovrPosef     EyePose[2];
+	ovrMatrix4f  EyeProjection[2];
+
+	// Tracking status (ovrStatusBits)
+	unsigned int StatusFlags;
+
+	// Timing
+	double       SampleTimeSeconds;      // Absolute time of the head pose sample
+	double       DisplayMidpointSeconds; // Time the pose was predicted for
+};
+#pragma pack(pop)
+
 // Rift functions
 extern "C" __declspec(dllexport) int OVR_Initialize();
 extern "C" __declspec(dllexport) float OVR_Create();
@@ -26,6 +59,31 @@ extern "C" __declspec(dllexport) int OVR_PrepareOGLContext();
 extern "C" __declspec(dllexport) int OVR_CleanOGLContext();
 extern "C" __declspec(dllexport) int OVR_SubmitFrame();
 extern "C" __declspec(dllexport) void OVR_SetMultisampleAA(int isMultisampleOn);
+extern "C" __declspec(dllexport) int OVR_SetClippingPlanes(float zNear, float zFar);
+extern "C" __declspec(dllexport) int OVR_GetTrackingSnapshot(OVR_TrackingSnapshot *snapshot);
+extern "C" __declspec(dllexport) double OVR_GetTimeInSeconds();
+extern "C" __declspec(dllexport) int OVR_StartTrackingSampler(int rateHz);
+extern "C" __declspec(dllexport) int OVR_StopTrackingSampler();
+extern "C" __declspec(dllexport) int OVR_GetTrackingSamplerRate(int &requestedHz, int &measuredHz);
+extern "C" __declspec(dllexport) int OVR_GetSampledTrackingState(double absTime);
+extern "C" __declspec(dllexport) int OVR_SelectBackend(int type);
+extern "C" __declspec(dllexport) int OVR_SelectReplayBackend(const char *path);
+extern "C" __declspec(dllexport) int OVR_StartRecording(const char *path);
+extern "C" __declspec(dllexport) int OVR_StopRecording();
+extern "C" __declspec(dllexport) int OVR_SetTelemetryEnabled(int enabled);
+extern "C" __declspec(dllexport) int OVR_ResetTelemetry();
+extern "C" __declspec(dllexport) int OVR_GetPhaseLatency(int phase, float &p50, float &p99, float &p999);
+extern "C" __declspec(dllexport) int OVR_SaveTelemetry(const char *path);
+extern "C" __declspec(dllexport) int OVR_CreateContext(int shareHmdWith);
+extern "C" __declspec(dllexport) int OVR_SelectContext(int handle);
+extern "C" __declspec(dllexport) int OVR_GetCurrentContext();
+extern "C" __declspec(dllexport) int OVR_DestroyContext(int handle);
+extern "C" __declspec(dllexport) int OVR_GetEyeMatrices(float *viewMatrices, float *projectionMatrices);
+extern "C" __declspec(dllexport) int OVR_StartAsyncSubmit(int queueAhead);
+extern "C" __declspec(dllexport) int OVR_StopAsyncSubmit();
+extern "C" __declspec(dllexport) int OVR_SetAdaptiveQuality(int enabled, float minScale);
+extern "C" __declspec(dllexport) int OVR_GetAdaptiveQuality(float &viewportScale, int &msaaSamples);
+extern "C" __declspec(dllexport) int OVR_SetMirrorPolicy(int mode, int interval, int width, int height);
 
 int SetAndClearRenderSurface();
 void UnsetRenderSurface();
\ No newline at end of file
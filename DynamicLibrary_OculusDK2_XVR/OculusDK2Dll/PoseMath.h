@@ -0,0 +1,24 @@
+// PoseMath.h
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#pragma once
+
+#include <Extras/OVR_Math.h>
+
+// Linear interpolation between two pose states, t in [0, 1]
+inline ovrPoseStatef LerpPoseState(const ovrPoseStatef &a, const ovrPoseStatef &b, float t) {
+	using OVR::Quatf;
+	using OVR::Vector3f;
+
+	ovrPoseStatef result = b;
+	result.ThePose.Orientation = Quatf(a.ThePose.Orientation).Lerp(Quatf(b.ThePose.Orientation), t);
+	result.ThePose.Position = Vector3f(a.ThePose.Position).Lerp(Vector3f(b.ThePose.Position), t);
+	result.AngularVelocity = Vector3f(a.AngularVelocity).Lerp(Vector3f(b.AngularVelocity), t);
+	result.LinearVelocity = Vector3f(a.LinearVelocity).Lerp(Vector3f(b.LinearVelocity), t);
+	result.AngularAcceleration = Vector3f(a.AngularAcceleration).Lerp(Vector3f(b.AngularAcceleration), t);
+	result.LinearAcceleration = Vector3f(a.LinearAcceleration).Lerp(Vector3f(b.LinearAcceleration), t);
+	result.TimeInSeconds = a.TimeInSeconds + (b.TimeInSeconds - a.TimeInSeconds) * t;
+	return result;
+}
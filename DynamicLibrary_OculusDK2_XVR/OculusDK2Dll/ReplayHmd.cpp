@@ -0,0 +1,60 @@
+// ReplayHmd.cpp : HMD backend that plays back a tracking recording.
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include "stdafx.h"
+
+#include <math.h>
+
+#include "PoseMath.h"
+#include "ReplayHmd.h"
+
+ReplayHmd::ReplayHmd(const char *path) :
+	Path(path ? path : "")
+{
+}
+
+ovrResult ReplayHmd::Initialize() {
+	if (!Recording.Open(Path.ToCStr())) {
+		return ovrError_Initialize;
+	}
+	return SimulatedHmd::Initialize();
+}
+
+void ReplayHmd::Shutdown() {
+	Recording.Close();
+	SimulatedHmd::Shutdown();
+}
+
+ovrPoseStatef ReplayHmd::GetHeadPose(double absTime) {
+	const double start = Recording.GetStartTime();
+	const double duration = Recording.GetEndTime() - start;
+
+	// Map absTime onto the recording, looping at the end
+	double t = absTime - StartTime;
+	if (duration > 0.0) {
+		t = fmod(t, duration);
+		if (t < 0.0) {
+			t += duration;
+		}
+	}
+	else {
+		t = 0.0;
+	}
+	const double recordTime = start + t;
+
+	const uint64_t i = Recording.FindRecord(recordTime);
+	ovrPoseStatef pose = Recording.GetRecord(i).State.HeadPose;
+
+	if (i + 1 < Recording.GetRecordCount()) {
+		const ovrPoseStatef &next = Recording.GetRecord(i + 1).State.HeadPose;
+		const double span = next.TimeInSeconds - pose.TimeInSeconds;
+		if (span > 0.0) {
+			pose = LerpPoseState(pose, next, (float)((recordTime - pose.TimeInSeconds) / span));
+		}
+	}
+
+	pose.TimeInSeconds = absTime;
+	return pose;
+}
@@ -0,0 +1,30 @@
+// ReplayHmd.h
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#pragma once
+
+#include <Kernel/OVR_String.h>
+
+#include "SimulatedHmd.h"
+#include "TrackingRecording.h"
+
+// Simulated HMD whose head motion comes from a tracking recording made with
+// OVR_StartRecording. The recording is memory-mapped and played back in a loop,
+// starting when the backend is initialized.
+class ReplayHmd : public SimulatedHmd
+{
+public:
+	explicit ReplayHmd(const char *path);
+
+	virtual ovrResult Initialize();
+	virtual void Shutdown();
+
+protected:
+	virtual ovrPoseStatef GetHeadPose(double absTime);
+
+private:
+	OVR::String Path;
+	TrackingRecording Recording;
+};
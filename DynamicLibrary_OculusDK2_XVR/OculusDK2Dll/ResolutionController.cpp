@@ -0,0 +1,92 @@
+// ResolutionController.cpp
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include "stdafx.h"
+
+#include "ResolutionController.h"
+
+const double ResolutionController::HighWater = 0.9;
+const double ResolutionController::LowWater = 0.7;
+const float  ResolutionController::ScaleStep = 0.1f;
+const float  ResolutionController::DefaultMinScale = 0.5f;
+
+// Weight of the newest frame in the smoothed cost
+static const double CostSmoothing = 0.3;
+
+
+ResolutionController::ResolutionController() {
+	Reset(0, DefaultMinScale);
+}
+
+void ResolutionController::Reset(int maxSamples, float minScale) {
+	MaxSamples = (maxSamples > 1) ? maxSamples : 0;
+	MinScale = (minScale >= 0.1f && minScale <= 1.0f) ? minScale : DefaultMinScale;
+
+	ViewportScale = 1.0f;
+	SampleCount = MaxSamples;
+
+	SmoothedCost = 0.0;
+	FramesOver = 0;
+	FramesUnder = 0;
+	Cooldown = CooldownFrames;
+}
+
+bool ResolutionController::Update(double cpuSeconds, double gpuSeconds, double budgetSeconds) {
+	if (budgetSeconds <= 0.0) {
+		return false;
+	}
+
+	double cost = max(cpuSeconds, gpuSeconds) / budgetSeconds;
+	SmoothedCost = (SmoothedCost == 0.0) ? cost : SmoothedCost + CostSmoothing * (cost - SmoothedCost);
+
+	if (Cooldown > 0) {
+		Cooldown--;
+		return false;
+	}
+
+	FramesOver = (SmoothedCost > HighWater) ? FramesOver + 1 : 0;
+	FramesUnder = (SmoothedCost < LowWater) ? FramesUnder + 1 : 0;
+
+	bool changed = false;
+	if (FramesOver >= DownFrames) {
+		changed = StepDown();
+	}
+	else if (FramesUnder >= UpFrames) {
+		changed = StepUp();
+	}
+
+	if (changed) {
+		FramesOver = 0;
+		FramesUnder = 0;
+		Cooldown = CooldownFrames;
+		// The old cost does not describe the new settings
+		SmoothedCost = 0.0;
+	}
+	return changed;
+}
+
+bool ResolutionController::StepDown() {
+	if (SampleCount > 0) {
+		SampleCount = (SampleCount > 2) ? max(2, SampleCount / 2) : 0;
+		return true;
+	}
+	if (ViewportScale > MinScale) {
+		ViewportScale = max(MinScale, ViewportScale - ScaleStep);
+		return true;
+	}
+	return false;
+}
+
+bool ResolutionController::StepUp() {
+	if (ViewportScale < 1.0f) {
+		ViewportScale = min(1.0f, ViewportScale + ScaleStep);
+		return true;
+	}
+	if (SampleCount < MaxSamples) {
+		SampleCount = (SampleCount == 0) ? 2 : min(SampleCount * 2, MaxSamples);
+		return true;
+	}
+	return false;
+}
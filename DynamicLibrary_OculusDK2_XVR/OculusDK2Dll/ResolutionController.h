@@ -0,0 +1,60 @@
+// ResolutionController.h
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#pragma once
+
+// Closed-loop quality control driven by the measured frame cost. When the slower of CPU and
+// GPU time stays close to the frame budget, MSAA is stepped down first (8 -> 4 -> 2 -> off),
+// then the rendered viewport is shrunk inside the swap texture. When there is headroom again
+// for a while, quality comes back in reverse order.
+//
+// Stepping down reacts within a few frames, stepping up waits much longer, and every change
+// is followed by a cool-down so the new settings are measured before the next decision.
+class ResolutionController
+{
+public:
+	// Fractions of the frame budget
+	static const double HighWater;   // Above this the frame is at risk
+	static const double LowWater;    // Below this there is room for more quality
+
+	enum {
+		DownFrames = 3,        // Consecutive frames above HighWater before stepping down
+		UpFrames = 90,         // Consecutive frames below LowWater before stepping up
+		CooldownFrames = 15    // Frames ignored after every change
+	};
+
+	static const float ScaleStep;
+	static const float DefaultMinScale;
+
+	ResolutionController();
+
+	// Starts again from full quality. maxSamples is the MSAA sample count to use when there
+	// is headroom (0 for no MSAA), minScale the smallest viewport scale allowed.
+	void Reset(int maxSamples, float minScale);
+
+	// Feeds the cost of one frame. gpuSeconds is 0 if unknown. Returns true if the
+	// viewport scale or the sample count changed.
+	bool Update(double cpuSeconds, double gpuSeconds, double budgetSeconds);
+
+	float GetViewportScale() const { return ViewportScale; }
+	int   GetSampleCount() const { return SampleCount; }
+	int   GetMaxSamples() const { return MaxSamples; }
+	float GetMinScale() const { return MinScale; }
+
+private:
+	bool StepDown();
+	bool StepUp();
+
+	int   MaxSamples;
+	float MinScale;
+
+	float ViewportScale;
+	int   SampleCount;
+
+	double SmoothedCost;
+	int    FramesOver;
+	int    FramesUnder;
+	int    Cooldown;
+};
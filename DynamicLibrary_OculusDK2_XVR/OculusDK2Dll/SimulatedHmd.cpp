@@ -0,0 +1,205 @@
+// SimulatedHmd.cpp : HMD backend that runs without a Rift.
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include "stdafx.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <GL/CAPI_GLE.h>
+#include <Extras/OVR_Math.h>
+#include <Kernel/OVR_Std.h>
+#include <Kernel/OVR_Timer.h>
+
+#include "SimulatedHmd.h"
+
+using namespace OVR;
+
+const float SimulatedHmd::RefreshRate = 75.0f;
+const float SimulatedHmd::PixelsPerTanAngle = 549.0f;
+
+// Synthetic motion: yaw sweep and sideways sway
+static const float YawAmplitude = 0.5f;       // radians
+static const float YawPeriod = 8.0f;          // seconds
+static const float SwayAmplitude = 0.05f;     // meters
+static const float SwayPeriod = 5.0f;         // seconds
+
+// Half the DK2 default IPD
+static const float HalfIPD = 0.032f;
+
+SimulatedHmd::SimulatedHmd() :
+	StartTime(0.0),
+	Created(false),
+	SubmittedFrames(0)
+{
+	memset(&Desc, 0, sizeof(Desc));
+}
+
+ovrResult SimulatedHmd::Initialize() {
+	StartTime = Timer::GetSeconds();
+	return ovrSuccess;
+}
+
+void SimulatedHmd::Shutdown() {
+}
+
+ovrResult SimulatedHmd::Create(ovrHmdDesc &desc) {
+	memset(&Desc, 0, sizeof(Desc));
+	Desc.Type = ovrHmd_DK2;
+	OVR_strcpy(Desc.ProductName, sizeof(Desc.ProductName), "Simulated Rift DK2");
+	OVR_strcpy(Desc.Manufacturer, sizeof(Desc.Manufacturer), "OculusDK2Dll");
+	Desc.AvailableHmdCaps = ovrHmdCap_DebugDevice;
+	Desc.DefaultHmdCaps = ovrHmdCap_DebugDevice;
+	Desc.AvailableTrackingCaps = ovrTrackingCap_Orientation | ovrTrackingCap_MagYawCorrection | ovrTrackingCap_Position;
+	Desc.DefaultTrackingCaps = Desc.AvailableTrackingCaps;
+	for (int eye = 0; eye < 2; ++eye) {
+		// DK2 defaults; the lenses are slightly off-center towards the nose
+		ovrFovPort fov;
+		fov.UpTan = 1.3316f;
+		fov.DownTan = 1.3316f;
+		fov.LeftTan = (eye == ovrEye_Left) ? 1.0586f : 1.0924f;
+		fov.RightTan = (eye == ovrEye_Left) ? 1.0924f : 1.0586f;
+		Desc.DefaultEyeFov[eye] = fov;
+		Desc.MaxEyeFov[eye] = fov;
+	}
+	Desc.Resolution.w = 1920;
+	Desc.Resolution.h = 1080;
+	Desc.DisplayRefreshRate = RefreshRate;
+
+	Created = true;
+	SubmittedFrames = 0;
+	desc = Desc;
+	return ovrSuccess;
+}
+
+void SimulatedHmd::Destroy() {
+	Created = false;
+}
+
+bool SimulatedHmd::IsCreated() const {
+	return Created;
+}
+
+ovrResult SimulatedHmd::ConfigureTracking(unsigned int requestedTrackingCaps, unsigned int requiredTrackingCaps) {
+	OVR_UNUSED(requestedTrackingCaps);
+	if (requiredTrackingCaps & ~Desc.AvailableTrackingCaps) {
+		return ovrError_InvalidParameter;
+	}
+	return ovrSuccess;
+}
+
+ovrPoseStatef SimulatedHmd::GetHeadPose(double absTime) {
+	const float t = (float)(absTime - StartTime);
+	const float yawW = 2.0f * MATH_FLOAT_PI / YawPeriod;
+	const float swayW = 2.0f * MATH_FLOAT_PI / SwayPeriod;
+
+	const float yaw = YawAmplitude * sinf(yawW * t);
+
+	ovrPoseStatef pose;
+	memset(&pose, 0, sizeof(pose));
+	pose.ThePose.Orientation = Quatf(Vector3f(0, 1, 0), yaw);
+	pose.ThePose.Position = Vector3f(SwayAmplitude * sinf(swayW * t), 0, 0);
+	pose.AngularVelocity = Vector3f(0, YawAmplitude * yawW * cosf(yawW * t), 0);
+	pose.LinearVelocity = Vector3f(SwayAmplitude * swayW * cosf(swayW * t), 0, 0);
+	pose.AngularAcceleration = Vector3f(0, -yawW * yawW * yaw, 0);
+	pose.LinearAcceleration = Vector3f(-swayW * swayW * pose.ThePose.Position.x, 0, 0);
+	pose.TimeInSeconds = absTime;
+	return pose;
+}
+
+ovrTrackingState SimulatedHmd::GetTrackingState(double absTime) {
+	ovrTrackingState state;
+	memset(&state, 0, sizeof(state));
+	state.HeadPose = GetHeadPose(absTime);
+	state.CameraPose = Posef::Identity();
+	state.LeveledCameraPose = Posef::Identity();
+	state.StatusFlags = ovrStatus_OrientationTracked | ovrStatus_PositionTracked |
+		ovrStatus_CameraPoseTracked | ovrStatus_PositionConnected | ovrStatus_HmdConnected;
+	return state;
+}
+
+ovrFrameTiming SimulatedHmd::GetFrameTiming(unsigned int frameIndex) {
+	const double interval = 1.0 / RefreshRate;
+	const double now = GetTimeInSeconds();
+
+	// Next vsync after now; the midpoint is half a frame later
+	const unsigned int displayFrame = (unsigned int)((now - StartTime) / interval) + 1;
+
+	ovrFrameTiming timing;
+	timing.DisplayMidpointSeconds = StartTime + (displayFrame + 0.5) * interval;
+	timing.FrameIntervalSeconds = interval;
+	timing.AppFrameIndex = frameIndex;
+	timing.DisplayFrameIndex = displayFrame;
+	return timing;
+}
+
+double SimulatedHmd::GetTimeInSeconds() {
+	return Timer::GetSeconds();
+}
+
+ovrSizei SimulatedHmd::GetFovTextureSize(ovrEyeType eye, ovrFovPort fov, float pixelsPerDisplayPixel) {
+	OVR_UNUSED(eye);
+	ovrSizei size;
+	size.w = (int)ceilf((fov.LeftTan + fov.RightTan) * PixelsPerTanAngle * pixelsPerDisplayPixel);
+	size.h = (int)ceilf((fov.UpTan + fov.DownTan) * PixelsPerTanAngle * pixelsPerDisplayPixel);
+	return size;
+}
+
+ovrEyeRenderDesc SimulatedHmd::GetRenderDesc(ovrEyeType eye, ovrFovPort fov) {
+	ovrEyeRenderDesc desc;
+	desc.Eye = eye;
+	desc.Fov = fov;
+	desc.DistortedViewport = Recti(eye * Desc.Resolution.w / 2, 0, Desc.Resolution.w / 2, Desc.Resolution.h);
+	desc.PixelsPerTanAngleAtCenter = Vector2f(PixelsPerTanAngle, PixelsPerTanAngle);
+	desc.HmdToEyeViewOffset = Vector3f((eye == ovrEye_Left) ? -HalfIPD : HalfIPD, 0, 0);
+	return desc;
+}
+
+ovrResult SimulatedHmd::CreateSwapTextureSetGL(GLuint format, int width, int height, ovrSwapTextureSet **textureSet) {
+	if (!textureSet || width <= 0 || height <= 0) {
+		return ovrError_InvalidParameter;
+	}
+
+	ovrGLTexture* textures = new ovrGLTexture[SwapTextureCount];
+	for (int i = 0; i < SwapTextureCount; ++i) {
+		memset(&textures[i], 0, sizeof(ovrGLTexture));
+		textures[i].OGL.Header.API = ovrRenderAPI_OpenGL;
+		textures[i].OGL.Header.TextureSize = Sizei(width, height);
+
+		glGenTextures(1, &textures[i].OGL.TexId);
+		glBindTexture(GL_TEXTURE_2D, textures[i].OGL.TexId);
+		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	}
+
+	ovrSwapTextureSet* set = new ovrSwapTextureSet;
+	set->Textures = &textures[0].Texture;
+	set->TextureCount = SwapTextureCount;
+	set->CurrentIndex = 0;
+
+	*textureSet = set;
+	return ovrSuccess;
+}
+
+void SimulatedHmd::DestroySwapTextureSet(ovrSwapTextureSet *textureSet) {
+	if (!textureSet) {
+		return;
+	}
+	ovrGLTexture* textures = reinterpret_cast<ovrGLTexture*>(textureSet->Textures);
+	for (int i = 0; i < textureSet->TextureCount; ++i) {
+		glDeleteTextures(1, &textures[i].OGL.TexId);
+	}
+	delete[] textures;
+	delete textureSet;
+}
+
+ovrResult SimulatedHmd::SubmitFrame(unsigned int frameIndex, const ovrViewScaleDesc *viewScaleDesc,
+	ovrLayerHeader const * const *layers, unsigned int layerCount) {
+	OVR_UNUSED2(frameIndex, viewScaleDesc);
+	if (!Created || (layerCount > 0 && !layers)) {
+		return ovrError_InvalidParameter;
+	}
+	++SubmittedFrames;
+	return ovrSuccess;
+}
@@ -0,0 +1,62 @@
+// SimulatedHmd.h
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#pragma once
+
+#include "HmdBackend.h"
+#include "FrameSubmitter.h"
+
+// A DK2-like HMD that needs neither the headset nor the Oculus runtime. Head motion is
+// synthetic (a slow yaw sweep with some sideways sway), swap textures are plain GL
+// textures and submitted frames are only counted. Used to run and time the DLL's
+// frame loop on machines without a Rift.
+class SimulatedHmd : public HmdBackend
+{
+public:
+	// DK2 panel refresh rate
+	static const float RefreshRate;
+	// Display pixels per unit of tan(angle) at the center of the lens, as on DK2
+	static const float PixelsPerTanAngle;
+	// Number of textures per simulated swap texture set: enough for OVR_StartAsyncSubmit
+	// with the deepest queue it accepts
+	enum { SwapTextureCount = FrameSubmitter::MaxQueueAhead + 2 };
+
+	SimulatedHmd();
+
+	virtual ovrResult Initialize();
+	virtual void Shutdown();
+
+	virtual ovrResult Create(ovrHmdDesc &desc);
+	virtual void Destroy();
+	virtual bool IsCreated() const;
+
+	virtual ovrResult ConfigureTracking(unsigned int requestedTrackingCaps, unsigned int requiredTrackingCaps);
+	virtual ovrTrackingState GetTrackingState(double absTime);
+	virtual ovrFrameTiming GetFrameTiming(unsigned int frameIndex);
+	virtual double GetTimeInSeconds();
+
+	virtual ovrSizei GetFovTextureSize(ovrEyeType eye, ovrFovPort fov, float pixelsPerDisplayPixel);
+	virtual ovrEyeRenderDesc GetRenderDesc(ovrEyeType eye, ovrFovPort fov);
+
+	virtual ovrResult CreateSwapTextureSetGL(GLuint format, int width, int height, ovrSwapTextureSet **textureSet);
+	virtual void DestroySwapTextureSet(ovrSwapTextureSet *textureSet);
+
+	virtual ovrResult SubmitFrame(unsigned int frameIndex, const ovrViewScaleDesc *viewScaleDesc,
+		ovrLayerHeader const * const *layers, unsigned int layerCount);
+
+	// Number of frames accepted by SubmitFrame since Create
+	unsigned int GetSubmittedFrameCount() const { return SubmittedFrames; }
+
+protected:
+	// Head pose and derivatives at absTime. Override to feed other motion than the synthetic one.
+	virtual ovrPoseStatef GetHeadPose(double absTime);
+
+	double StartTime;
+
+private:
+	bool Created;
+	ovrHmdDesc Desc;
+	unsigned int SubmittedFrames;
+};
@@ -0,0 +1,244 @@
+// TrackingRecording.cpp : Tracking session recorder and reader.
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include "stdafx.h"
+
+#include <string.h>
+
+#include "TrackingRecording.h"
+
+using namespace OVR;
+
+
+//-------------------------------------------------------------------------------------
+// TrackingRecorder
+
+TrackingRecorder::TrackingRecorder() :
+	ReadPos(0),
+	WritePos(0),
+	DroppedCount(0)
+{
+	memset(&Header, 0, sizeof(Header));
+}
+
+TrackingRecorder::~TrackingRecorder() {
+	Close();
+}
+
+bool TrackingRecorder::Open(const char *path) {
+	if (!File.Open(path, File::Open_Write | File::Open_Truncate | File::Open_Create | File::Open_Buffered)) {
+		return false;
+	}
+
+	memset(&Header, 0, sizeof(Header));
+	memcpy(Header.Magic, TRACKING_RECORDING_MAGIC, sizeof(Header.Magic));
+	Header.Version = TRACKING_RECORDING_VERSION;
+	Header.HeaderSize = sizeof(TrackingRecordingHeader);
+	Header.RecordSize = sizeof(TrackingRecord);
+	Header.IndexStride = IndexStride;
+	File.Write((const uint8_t*)&Header, sizeof(Header));
+
+	Index.Clear();
+	ReadPos = 0;
+	WritePos = 0;
+	DroppedCount = 0;
+
+	SetExitFlag(false);
+	return Start();
+}
+
+void TrackingRecorder::Close() {
+	if (!File.IsValid()) {
+		return;
+	}
+
+	SetExitFlag(true);
+	Join();
+	Drain();
+
+	// Index, then the final header
+	Header.IndexOffset = (uint64_t)File.LTell();
+	Header.IndexCount = (uint32_t)Index.GetSize();
+	if (Header.IndexCount > 0) {
+		File.Write((const uint8_t*)&Index[0], (int)(Index.GetSize() * sizeof(TrackingIndexEntry)));
+	}
+	File.LSeek(0);
+	File.Write((const uint8_t*)&Header, sizeof(Header));
+	File.Close();
+}
+
+void TrackingRecorder::Record(double recordTime, const ovrTrackingState &state, const ovrFrameTiming &timing) {
+	const uint32_t write = WritePos.Load_Acquire();
+	if (write - ReadPos.Load_Acquire() >= (uint32_t)QueueSize) {
+		++DroppedCount;
+		return;
+	}
+
+	TrackingRecord &record = Queue[write & (QueueSize - 1)];
+	record.RecordTimeSeconds = recordTime;
+	record.State = state;
+	record.Timing = timing;
+
+	WritePos.Store_Release(write + 1);
+}
+
+int TrackingRecorder::Drain() {
+	uint32_t read = ReadPos.Load_Acquire();
+	const uint32_t write = WritePos.Load_Acquire();
+	const int count = (int)(write - read);
+
+	while (read != write) {
+		// Write contiguous runs of the ring in one call
+		const uint32_t first = read & (QueueSize - 1);
+		uint32_t run = write - read;
+		if (first + run > (uint32_t)QueueSize) {
+			run = QueueSize - first;
+		}
+
+		for (uint32_t i = 0; i < run; ++i) {
+			if ((Header.RecordCount + i) % IndexStride == 0) {
+				TrackingIndexEntry entry;
+				entry.TimeInSeconds = Queue[first + i].State.HeadPose.TimeInSeconds;
+				entry.RecordNumber = Header.RecordCount + i;
+				Index.PushBack(entry);
+			}
+		}
+		File.Write((const uint8_t*)&Queue[first], (int)(run * sizeof(TrackingRecord)));
+
+		Header.RecordCount += run;
+		read += run;
+		ReadPos.Store_Release(read);
+	}
+	return count;
+}
+
+int TrackingRecorder::Run() {
+	SetThreadName("OculusDK2Dll Tracking Recorder");
+
+	while (!GetExitFlag()) {
+		Drain();
+		Thread::MSleep(WriterPeriodMs);
+	}
+	return 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+// TrackingRecording
+
+TrackingRecording::TrackingRecording() :
+	Records(nullptr),
+	RecordCount(0),
+	Index(nullptr),
+	IndexCount(0),
+	IndexStride(0)
+{
+}
+
+bool TrackingRecording::Open(const char *path) {
+	Close();
+
+	if (!File.Open(path) || File.GetSize() < sizeof(TrackingRecordingHeader)) {
+		Close();
+		return false;
+	}
+
+	const uint8_t* data = File.GetData();
+	const TrackingRecordingHeader* header = (const TrackingRecordingHeader*)data;
+	if (memcmp(header->Magic, TRACKING_RECORDING_MAGIC, sizeof(header->Magic)) != 0 ||
+		header->Version != TRACKING_RECORDING_VERSION ||
+		header->RecordSize != sizeof(TrackingRecord) ||
+		header->HeaderSize < sizeof(TrackingRecordingHeader) ||
+		header->HeaderSize > File.GetSize()) {
+		Close();
+		return false;
+	}
+
+	const size_t available = (File.GetSize() - header->HeaderSize) / sizeof(TrackingRecord);
+	Records = (const TrackingRecord*)(data + header->HeaderSize);
+
+	// Compare against the space left after IndexOffset, so a huge offset or count can't wrap
+	if (header->IndexOffset != 0 &&
+		header->RecordCount <= available &&
+		header->IndexOffset <= File.GetSize() &&
+		header->IndexCount <= (File.GetSize() - header->IndexOffset) / sizeof(TrackingIndexEntry)) {
+		RecordCount = header->RecordCount;
+		Index = (const TrackingIndexEntry*)(data + header->IndexOffset);
+		IndexCount = header->IndexCount;
+		IndexStride = header->IndexStride;
+
+		// FindRecord searches between two entries' records: they must be in the file and in order.
+		// A damaged index is dropped and the records are searched without it.
+		for (uint32_t i = 0; i < IndexCount; ++i) {
+			if (Index[i].RecordNumber >= RecordCount ||
+				(i > 0 && Index[i].RecordNumber < Index[i - 1].RecordNumber)) {
+				Index = nullptr;
+				IndexCount = 0;
+				IndexStride = 0;
+				break;
+			}
+		}
+	}
+	else {
+		// Not closed cleanly: use whatever complete records made it to disk
+		RecordCount = available;
+	}
+
+	if (RecordCount == 0) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void TrackingRecording::Close() {
+	File.Close();
+	Records = nullptr;
+	RecordCount = 0;
+	Index = nullptr;
+	IndexCount = 0;
+	IndexStride = 0;
+}
+
+double TrackingRecording::GetStartTime() const {
+	return Records[0].State.HeadPose.TimeInSeconds;
+}
+
+double TrackingRecording::GetEndTime() const {
+	return Records[RecordCount - 1].State.HeadPose.TimeInSeconds;
+}
+
+uint64_t TrackingRecording::FindRecord(double absTime) const {
+	uint64_t lo = 0;
+	uint64_t hi = RecordCount;
+
+	// Narrow the search down to one index stride first
+	if (Index && IndexCount > 0 && IndexStride > 0) {
+		uint32_t a = 0, b = IndexCount;
+		while (b - a > 1) {
+			uint32_t mid = (a + b) / 2;
+			if (Index[mid].TimeInSeconds <= absTime) {
+				a = mid;
+			}
+			else {
+				b = mid;
+			}
+		}
+		lo = Index[a].RecordNumber;
+		hi = (b < IndexCount) ? Index[b].RecordNumber : RecordCount;
+	}
+
+	// Last record with time <= absTime in [lo, hi)
+	while (hi - lo > 1) {
+		uint64_t mid = lo + (hi - lo) / 2;
+		if (Records[mid].State.HeadPose.TimeInSeconds <= absTime) {
+			lo = mid;
+		}
+		else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
@@ -0,0 +1,126 @@
+// TrackingRecording.h
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#pragma once
+
+#include <Kernel/OVR_Threads.h>
+#include <Kernel/OVR_Atomic.h>
+#include <Kernel/OVR_Array.h>
+#include <Kernel/OVR_SysFile.h>
+#include <Kernel/OVR_MappedFile.h>
+#include "OVR_CAPI.h"
+
+// Binary tracking recording (.otrk)
+//
+//   TrackingRecordingHeader
+//   TrackingRecord[RecordCount]          fixed size, sorted by time
+//   TrackingIndexEntry[IndexCount]       one entry every IndexStride records
+//
+// The header is written again with the final counts and the index offset when the
+// recording is closed. A recording that was not closed (crash) has IndexOffset 0; its
+// records can still be read, the count is then derived from the file size.
+
+#define TRACKING_RECORDING_MAGIC   "OTRK"
+#define TRACKING_RECORDING_VERSION 1
+
+#pragma pack(push, 8)
+
+struct TrackingRecordingHeader {
+	char     Magic[4];
+	uint32_t Version;
+	uint32_t HeaderSize;     // sizeof(TrackingRecordingHeader), records start right after
+	uint32_t RecordSize;     // sizeof(TrackingRecord)
+	uint64_t RecordCount;
+	uint64_t IndexOffset;    // File offset of the index, 0 if not closed cleanly
+	uint32_t IndexCount;
+	uint32_t IndexStride;    // Records between two index entries
+};
+
+struct TrackingRecord {
+	double           RecordTimeSeconds;  // When the DLL received the state
+	ovrTrackingState State;
+	ovrFrameTiming   Timing;             // Frame timing the state was predicted for
+};
+
+struct TrackingIndexEntry {
+	double   TimeInSeconds;  // HeadPose.TimeInSeconds of the record
+	uint64_t RecordNumber;
+};
+
+#pragma pack(pop)
+
+
+// Writes a recording from the render thread without blocking it. Record() only copies
+// the state into a fixed-size queue; a background thread writes the queue to disk in
+// batches. When the writer falls behind the queue fills up and records are dropped.
+class TrackingRecorder : public OVR::Thread
+{
+public:
+	enum {
+		QueueSize = 1024,   // Must be a power of two
+		IndexStride = 64,
+		WriterPeriodMs = 10
+	};
+
+	TrackingRecorder();
+	~TrackingRecorder();
+
+	// Creates the file and starts the writer thread
+	bool Open(const char *path);
+	// Writes what is queued, appends the index and finalizes the header
+	void Close();
+
+	// Render thread only
+	void Record(double recordTime, const ovrTrackingState &state, const ovrFrameTiming &timing);
+
+	unsigned int GetDroppedCount() const { return DroppedCount; }
+
+protected:
+	virtual int Run();
+
+private:
+	// Writes all queued records; returns the number written
+	int Drain();
+
+	OVR::SysFile File;
+	TrackingRecordingHeader Header;
+	OVR::Array<TrackingIndexEntry> Index;
+
+	// Single producer, single consumer queue
+	TrackingRecord Queue[QueueSize];
+	OVR::AtomicInt<uint32_t> ReadPos;
+	OVR::AtomicInt<uint32_t> WritePos;
+	unsigned int DroppedCount;
+};
+
+
+// Read access to a memory-mapped recording
+class TrackingRecording
+{
+public:
+	TrackingRecording();
+
+	bool Open(const char *path);
+	void Close();
+
+	bool IsOpen() const { return Records != nullptr; }
+	uint64_t GetRecordCount() const { return RecordCount; }
+	const TrackingRecord& GetRecord(uint64_t i) const { return Records[i]; }
+
+	// Head pose time of the first and last record
+	double GetStartTime() const;
+	double GetEndTime() const;
+
+	// Number of the last record whose head pose time is <= absTime (0 if none)
+	uint64_t FindRecord(double absTime) const;
+
+private:
+	OVR::MappedFile File;
+	const TrackingRecord* Records;
+	uint64_t RecordCount;
+	const TrackingIndexEntry* Index;
+	uint32_t IndexCount;
+	uint32_t IndexStride;
+};
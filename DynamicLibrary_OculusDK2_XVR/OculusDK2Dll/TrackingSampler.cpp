@@ -0,0 +1,107 @@
+// TrackingSampler.cpp : Background tracking sampler used by the OVR_*Sampler* exports.
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#include "stdafx.h"
+#include <mmsystem.h>
+
+#include <Extras/OVR_Math.h>
+
+#include "PoseMath.h"
+#include "TrackingSampler.h"
+
+#pragma comment(lib, "winmm.lib")
+
+using namespace OVR;
+
+const double TrackingSampler::MaxExtrapolationSeconds = 0.1;
+
+TrackingSampler::TrackingSampler(HmdBackend *hmd, int rateHz) :
+	HMD(hmd),
+	RateHz(rateHz < 1 ? 1 : (rateHz > 1000 ? 1000 : rateHz)),
+	PeriodSeconds(0.0),
+	MeasuredRateHz(0)
+{
+	PeriodSeconds = 1.0 / RateHz;
+}
+
+void TrackingSampler::Stop() {
+	SetExitFlag(true);
+	Join();
+}
+
+int TrackingSampler::Run() {
+	SetThreadName("OculusDK2Dll Tracking Sampler");
+
+	// Sleep resolution is the system timer tick, ~15.6ms by default, which would cap the
+	// sampler near 64Hz whatever rate was asked for
+	timeBeginPeriod(1);
+
+	double nextSample = HMD->GetTimeInSeconds();
+	double windowStart = nextSample;
+	int windowSamples = 0;
+
+	while (!GetExitFlag()) {
+		// Sample the current pose, not a predicted one: prediction is done on read
+		double now = HMD->GetTimeInSeconds();
+		ovrTrackingState state = HMD->GetTrackingState(now);
+		History.Push(state.HeadPose);
+
+		if (now - windowStart >= 1.0) {
+			MeasuredRateHz.Store_Release((int)(windowSamples / (now - windowStart) + 0.5));
+			windowStart = now;
+			windowSamples = 0;
+		}
+		++windowSamples;
+
+		// Keep to the schedule rather than adding the period to the time each sample took,
+		// but don't try to catch up after a long stall
+		nextSample += PeriodSeconds;
+		now = HMD->GetTimeInSeconds();
+		if (nextSample < now - PeriodSeconds) {
+			nextSample = now;
+		}
+		int sleepMs = (int)((nextSample - now) * 1000.0 + 0.5);
+		Thread::MSleep(sleepMs > 0 ? sleepMs : 0);
+	}
+
+	timeEndPeriod(1);
+	return 0;
+}
+
+bool TrackingSampler::GetPoseAtTime(double absTime, ovrPoseStatef &pose) const {
+	ovrPoseStatef newer;
+	if (!History.GetRecent(0, &newer)) {
+		return false;
+	}
+
+	// Past the newest sample: extrapolate with the sampled velocities
+	if (absTime >= newer.TimeInSeconds) {
+		double dt = absTime - newer.TimeInSeconds;
+		if (dt > MaxExtrapolationSeconds) {
+			dt = MaxExtrapolationSeconds;
+		}
+		Posef predicted = Posef(newer.ThePose).TimeIntegrate(newer.LinearVelocity, newer.AngularVelocity, (float)dt);
+		pose = newer;
+		pose.ThePose = predicted;
+		pose.TimeInSeconds = newer.TimeInSeconds + dt;
+		return true;
+	}
+
+	// Otherwise walk back until the sample right before absTime and interpolate
+	ovrPoseStatef older;
+	for (int age = 1; History.GetRecent(age, &older); ++age) {
+		if (older.TimeInSeconds <= absTime) {
+			double span = newer.TimeInSeconds - older.TimeInSeconds;
+			float t = (span > 0.0) ? (float)((absTime - older.TimeInSeconds) / span) : 1.0f;
+			pose = LerpPoseState(older, newer, t);
+			return true;
+		}
+		newer = older;
+	}
+
+	// Older than anything we kept
+	pose = newer;
+	return true;
+}
@@ -0,0 +1,48 @@
+// TrackingSampler.h
+
+// Author: Ausias Pomes
+// Date: 16/10/2026
+
+#pragma once
+
+#include <Kernel/OVR_Threads.h>
+#include <Kernel/OVR_Lockless.h>
+#include <Kernel/OVR_Atomic.h>
+#include "HmdBackend.h"
+
+// Background thread that polls the head pose at a fixed rate and keeps a short, lock-free
+// history of it. The render thread can then ask for the pose at any time without waiting
+// on the tracking query: between two samples the pose is interpolated, after the newest
+// sample it is extrapolated with the sampled velocities.
+class TrackingSampler : public OVR::Thread
+{
+public:
+	// 256 samples are half a second at 500Hz
+	enum { HistorySize = 256 };
+
+	// Longest time the pose is extrapolated past the newest sample
+	static const double MaxExtrapolationSeconds;
+
+	TrackingSampler(HmdBackend *hmd, int rateHz);
+
+	// Fills pose with the head pose at absTime. Returns false if nothing was sampled yet.
+	bool GetPoseAtTime(double absTime, ovrPoseStatef &pose) const;
+
+	int GetRequestedRateHz() const { return RateHz; }
+	// Samples taken over the last full second, 0 until the first second has passed
+	int GetMeasuredRateHz() const { return MeasuredRateHz.Load_Acquire(); }
+
+	// Stops the thread and waits for it to finish
+	void Stop();
+
+protected:
+	virtual int Run();
+
+private:
+	HmdBackend* HMD;
+	int RateHz;
+	double PeriodSeconds;
+	OVR::AtomicInt<int> MeasuredRateHz;
+
+	OVR::LocklessHistory<ovrPoseStatef, HistorySize> History;
+};
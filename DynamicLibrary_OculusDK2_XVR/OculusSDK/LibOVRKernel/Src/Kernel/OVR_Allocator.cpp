@@ -59,8 +59,13 @@ namespace OVR {
 //-----------------------------------------------------------------------------------
 // ***** Allocator
 
+static Allocator* pInstalledAllocator = nullptr;
+
 Allocator* Allocator::GetInstance()
 {
+    if (pInstalledAllocator)
+        return pInstalledAllocator;
+
     static Allocator* pAllocator = nullptr;
 
     if(!pAllocator)
@@ -86,6 +91,11 @@ Allocator* Allocator::GetInstance()
     return pAllocator;
 }
 
+void Allocator::SetInstance(Allocator* allocator)
+{
+    pInstalledAllocator = allocator;
+}
+
 // Default AlignedAlloc implementation will delegate to Alloc/Free after doing rounding.
 void* Allocator::AllocAligned(size_t size, size_t align)
 {
@@ -32,6 +32,9 @@ limitations under the License.
 #include "OVR_Atomic.h"
 #include "stdlib.h"
 #include "stdint.h"
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    #include <utility>
+#endif
 
 
 //-----------------------------------------------------------------------------------
@@ -132,6 +135,24 @@ OVR_FORCE_INLINE T*  ConstructAlt(void *p, const S1& src1, const S2& src2)
     return ::new(p) T(src1, src2);
 }
 
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+// Move-constructs from source, leaving it in its moved-from state.
+template <class T>
+OVR_FORCE_INLINE T*  Construct(void *p, T&& source)
+{
+    return ::new(p) T(std::move(source));
+}
+
+#if !defined(OVR_CPP_NO_VARIADIC_TEMPLATES)
+// Constructs in place with any constructor of T.
+template <class T, class... Args>
+OVR_FORCE_INLINE T*  ConstructEmplace(void *p, Args&&... args)
+{
+    return ::new(p) T(std::forward<Args>(args)...);
+}
+#endif
+#endif
+
 // Note: These ConstructArray functions don't properly support the case of a C++ exception occurring midway 
 // during construction, as they don't deconstruct the successfully constructed array elements before returning.
 template <class T>
@@ -169,6 +190,36 @@ OVR_FORCE_INLINE void DestructArray(T *pobj, size_t count)
 }
 
 
+//-----------------------------------------------------------------------------------
+// ***** IsTriviallyRelocatable
+//
+// IsTriviallyRelocatable<T>::Value is true for types whose objects can be moved to
+// another address with memcpy, the old copy being discarded without its destructor
+// running. Containers use it to grow and shift elements with memcpy/memmove.
+//
+// Trivially copyable types qualify, where the compiler can tell. Many other types do
+// as well, as long as they hold no pointers into themselves and don't register their
+// address anywhere (Ptr<T>, for instance); declare those with
+// OVR_DECLARE_TRIVIALLY_RELOCATABLE, or with a partial specialization for templates.
+
+#if defined(__clang__) || (defined(OVR_CC_GNU) && (OVR_CC_VERSION >= 500)) || (defined(OVR_CC_MSVC) && (OVR_CC_VERSION >= 1900))
+    #define OVR_IS_TRIVIALLY_COPYABLE(T) __is_trivially_copyable(T)
+#elif defined(OVR_CC_GNU) || defined(OVR_CC_MSVC)
+    #define OVR_IS_TRIVIALLY_COPYABLE(T) (__has_trivial_copy(T) && __has_trivial_destructor(T))
+#else
+    #define OVR_IS_TRIVIALLY_COPYABLE(T) false
+#endif
+
+template <class T>
+struct IsTriviallyRelocatable
+{
+    enum { Value = OVR_IS_TRIVIALLY_COPYABLE(T) };
+};
+
+#define OVR_DECLARE_TRIVIALLY_RELOCATABLE(T) \
+    namespace OVR { template <> struct IsTriviallyRelocatable<T> { enum { Value = true }; }; }
+
+
 //-----------------------------------------------------------------------------------
 // ***** Allocator
 
@@ -195,6 +246,12 @@ public:
     // This pointer is used for most of the memory allocations.
     static Allocator* GetInstance();
 
+private:
+    // Installs the allocator returned by GetInstance; see System::Init.
+    static void SetInstance(Allocator* allocator);
+
+public:
+
 
     // *** Standard Alignment Alloc/Free
 
@@ -590,7 +647,8 @@ void deletea_Impl(T* pTArray)
 #define OVR_ALLOC_ALIGNED(s,a)  OVR::Allocator::GetInstance()->AllocAligned((s),(a))
 #define OVR_FREE_ALIGNED(p)     OVR::Allocator::GetInstance()->FreeAligned((p))
 
-#ifdef OVR_BUILD_DEBUG
+// Defining OVR_HEAP_PROFILER passes file and line in all builds, for HeapProfiler.
+#if defined(OVR_BUILD_DEBUG) || defined(OVR_HEAP_PROFILER)
 #define OVR_ALLOC(s)            OVR::Allocator::GetInstance()->AllocDebug((s), __FILE__, __LINE__)
 #define OVR_ALLOC_DEBUG(s,f,l)  OVR::Allocator::GetInstance()->AllocDebug((s), f, l)
 #else
@@ -97,6 +97,18 @@ struct ArrayDataBase
     ArrayDataBase(const SizePolicy& p)
         : Data(0), Size(0), Policy(p) {}
 
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    // Takes over the buffer of a, which is left empty.
+    ArrayDataBase(SelfType&& a)
+        : Data(a.Data), Size(a.Size), Policy(a.Policy)
+    {
+        Policy.SetCapacity(a.Policy.GetCapacity());
+        a.Data = 0;
+        a.Size = 0;
+        a.Policy.SetCapacity(0);
+    }
+#endif
+
     ~ArrayDataBase() 
     {
         if (Data)
@@ -123,6 +135,20 @@ struct ArrayDataBase
         Policy.SetCapacity(0);
     }
 
+    // Releases our buffer and takes over the buffer of a, which is left empty.
+    void MoveFrom(SelfType& a)
+    {
+        if (&a == this)
+            return;
+        ClearAndRelease();
+        Data = a.Data;
+        Size = a.Size;
+        Policy.SetCapacity(a.Policy.GetCapacity());
+        a.Data = 0;
+        a.Size = 0;
+        a.Policy.SetCapacity(0);
+    }
+
     void Reserve(size_t newCapacity)
     {
         if (Policy.NeverShrinking() && newCapacity < GetCapacity())
@@ -158,7 +184,11 @@ struct ArrayDataBase
                     s = (Size < newCapacity) ? Size : newCapacity;
                     for (i = 0; i < s; ++i)
                     {
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+                        Allocator::Construct(&newData[i], std::move(Data[i]));
+#else
                         Allocator::Construct(&newData[i], Data[i]);
+#endif
                         Allocator::Destruct(&Data[i]);
                     }
                     for (i = s; i < Size; ++i)
@@ -234,6 +264,11 @@ struct ArrayData : ArrayDataBase<T, Allocator, SizePolicy>
     ArrayData(const SelfType& a)
         : BaseType(a.Policy) { Append(a.Data, a.Size); }
 
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    ArrayData(SelfType&& a)
+        : BaseType(std::move(a)) { }
+#endif
+
 
     void Resize(size_t newSize)
     {
@@ -250,6 +285,26 @@ struct ArrayData : ArrayDataBase<T, Allocator, SizePolicy>
         Allocator::Construct(this->Data + this->Size - 1, val);
     }
 
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    void PushBack(ValueType&& val)
+    {
+        BaseType::ResizeNoConstruct(this->Size + 1);
+        OVR_ASSERT(this->Data != NULL);
+        Allocator::Construct(this->Data + this->Size - 1, std::move(val));
+    }
+
+#if !defined(OVR_CPP_NO_VARIADIC_TEMPLATES)
+    template<class... Args>
+    ValueType& EmplaceBack(Args&&... args)
+    {
+        BaseType::ResizeNoConstruct(this->Size + 1);
+        OVR_ASSERT(this->Data != NULL);
+        Allocator::ConstructEmplace(this->Data + this->Size - 1, std::forward<Args>(args)...);
+        return this->Data[this->Size - 1];
+    }
+#endif
+#endif
+
     template<class S>
     void PushBackAlt(const S& val)
     {
@@ -294,6 +349,11 @@ struct ArrayDataCC : ArrayDataBase<T, Allocator, SizePolicy>
     ArrayDataCC(const SelfType& a)
         : BaseType(a.Policy), DefaultValue(a.DefaultValue) { Append(a.Data, a.Size); }
 
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    ArrayDataCC(SelfType&& a)
+        : BaseType(std::move(a)), DefaultValue(a.DefaultValue) { }
+#endif
+
 
     void Resize(size_t newSize)
     {
@@ -309,6 +369,26 @@ struct ArrayDataCC : ArrayDataBase<T, Allocator, SizePolicy>
         Allocator::Construct(this->Data + this->Size - 1, val);
     }
 
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    void PushBack(ValueType&& val)
+    {
+        BaseType::ResizeNoConstruct(this->Size + 1);
+        OVR_ASSERT(this->Data != NULL);
+        Allocator::Construct(this->Data + this->Size - 1, std::move(val));
+    }
+
+#if !defined(OVR_CPP_NO_VARIADIC_TEMPLATES)
+    template<class... Args>
+    ValueType& EmplaceBack(Args&&... args)
+    {
+        BaseType::ResizeNoConstruct(this->Size + 1);
+        OVR_ASSERT(this->Data != NULL);
+        Allocator::ConstructEmplace(this->Data + this->Size - 1, std::forward<Args>(args)...);
+        return this->Data[this->Size - 1];
+    }
+#endif
+#endif
+
     template<class S>
     void PushBackAlt(const S& val)
     {
@@ -370,6 +450,10 @@ public:
         : Data(size) {}
     ArrayBase(const SelfType& a)
         : Data(a.Data) {}
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    ArrayBase(SelfType&& a)
+        : Data(std::move(a.Data)) {}
+#endif
 
     ArrayBase(const ValueType& defval)
         : Data(defval) {}
@@ -441,6 +525,24 @@ public:
         Data.PushBack(val);
     }
 
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    // Moves val into the array; a Ptr is handed over without touching the
+    // reference count.
+    void    PushBack(ValueType&& val)
+    {
+        Data.PushBack(std::move(val));
+    }
+
+#if !defined(OVR_CPP_NO_VARIADIC_TEMPLATES)
+    // Constructs a new last element in place from args and returns it.
+    template<class... Args>
+    ValueType& EmplaceBack(Args&&... args)
+    {
+        return Data.EmplaceBack(std::forward<Args>(args)...);
+    }
+#endif
+#endif
+
     template<class S>
     void PushBackAlt(const S& val)
     {
@@ -463,7 +565,11 @@ public:
     ValueType Pop()
     {
         OVR_ASSERT((Data.Data) && (Data.Size > 0));
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+        ValueType t = std::move(Back());
+#else
         ValueType t = Back();
+#endif
         PopBack();
         return t;
     }
@@ -488,6 +594,15 @@ public:
         return *this;
     }
 
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    // Array move. Takes over the contents of a, which is left empty.
+    const SelfType& operator = (SelfType&& a)
+    {
+        Data.MoveFrom(a.Data);
+        return *this;
+    }
+#endif
+
     // Removing multiple elements from the array.
     void    RemoveMultipleAt(size_t index, size_t num)
     {
@@ -772,6 +887,10 @@ public:
     Array(const SizePolicyType& p) : BaseType() { SetSizePolicy(p); }
     Array(const SelfType& a) : BaseType(a) {}
     const SelfType& operator=(const SelfType& a) { BaseType::operator=(a); return *this; }
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    Array(SelfType&& a) : BaseType(std::move(a)) {}
+    const SelfType& operator=(SelfType&& a) { BaseType::operator=(std::move(a)); return *this; }
+#endif
 };
 
 // ***** ArrayPOD
@@ -794,6 +913,10 @@ public:
     ArrayPOD(const SizePolicyType& p) : BaseType() { SetSizePolicy(p); }
     ArrayPOD(const SelfType& a) : BaseType(a) {}
     const SelfType& operator=(const SelfType& a) { BaseType::operator=(a); return *this; }
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    ArrayPOD(SelfType&& a) : BaseType(std::move(a)) {}
+    const SelfType& operator=(SelfType&& a) { BaseType::operator=(std::move(a)); return *this; }
+#endif
 };
 
 
@@ -816,6 +939,10 @@ public:
     ArrayCPP(const SizePolicyType& p) : BaseType() { SetSizePolicy(p); }
     ArrayCPP(const SelfType& a) : BaseType(a) {}
     const SelfType& operator=(const SelfType& a) { BaseType::operator=(a); return *this; }
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    ArrayCPP(SelfType&& a) : BaseType(std::move(a)) {}
+    const SelfType& operator=(SelfType&& a) { BaseType::operator=(std::move(a)); return *this; }
+#endif
 };
 
 
@@ -840,6 +967,10 @@ public:
     ArrayCC(const ValueType& defval, const SizePolicyType& p) : BaseType(defval) { SetSizePolicy(p); }
     ArrayCC(const SelfType& a) : BaseType(a) {}
     const SelfType& operator=(const SelfType& a) { BaseType::operator=(a); return *this; }
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    ArrayCC(SelfType&& a) : BaseType(std::move(a)) {}
+    const SelfType& operator=(SelfType&& a) { BaseType::operator=(std::move(a)); return *this; }
+#endif
 };
 
 } // OVR
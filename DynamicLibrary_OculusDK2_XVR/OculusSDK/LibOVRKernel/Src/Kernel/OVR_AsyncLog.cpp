@@ -0,0 +1,1245 @@
+/************************************************************************************
+
+Filename    :   OVR_AsyncLog.cpp 
+Content     :   Asynchronous log with per-thread ring buffers
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#include "OVR_AsyncLog.h"
+#include "OVR_Alg.h"
+#include "OVR_Std.h"
+#include "OVR_Timer.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(OVR_OS_MS) && !defined(OVR_OS_MS_MOBILE)
+#include "OVR_Win32_IncludeWindows.h"
+#endif
+
+namespace OVR {
+
+
+// The ring of the calling thread in the log it last logged to. Log ids are never
+// reused, so the ring of a destroyed log is never picked up again.
+static OVR_THREAD_LOCAL uint32_t ThreadRingLogId = 0;
+static OVR_THREAD_LOCAL void*    pThreadRing     = nullptr;
+
+// Live logs, for CrashFlushAll, and the last ids given out. All are guarded by
+// getLiveLock().
+static AsyncLog* pLiveLogs    = nullptr;
+static uint32_t  LastLogId    = 0;
+static uint32_t  LastFormatId = 0;
+
+static Lock& getLiveLock()
+{
+    static Lock liveLock;
+    return liveLock;
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** Ring
+
+// Records are a RecordHeader followed by a payload, padded to Alignment. A record
+// never wraps around the end of the buffer: when it doesn't fit there, a padding
+// record fills the rest and the record starts at offset 0.
+//
+// A binary log file is a sequence of the same records, unpadded. It starts with a
+// Record_Session, and a format is written in a Record_Format before the first
+// Record_Binary that uses it. Values are in the byte order of the machine that
+// wrote the file.
+
+struct AsyncLog::RecordHeader
+{
+    enum {
+        Alignment    = 16,
+        MaxFormatIds = 1 << 20  // Format ids count call sites; files with larger ids are
+                                // rejected rather than trusted to size the format table.
+    };
+
+    enum RecordKind
+    {
+        Record_Text,        // NUL-terminated text, already formatted.
+        Record_Padding,
+        Record_Binary,      // BinaryPayload, then the packed arguments. In files, a uint32_t
+                            // format id takes the place of the BinaryPayload.
+        Record_Format,      // In files: uint32_t format id, then the NUL-terminated format.
+        Record_Session      // In files: SessionInfo.
+    };
+
+    uint32_t Size;          // Bytes, header included.
+    uint16_t Kind;
+    uint16_t MessageType;
+    uint64_t Time;          // Timer::GetTicksNanos; orders records across rings.
+};
+
+struct BinaryPayload
+{
+    const LogFormat* pFormat;
+    uint32_t         ArgsSize;
+};
+
+// Ties record times to the wall clock for the records that follow it.
+struct SessionInfo
+{
+    char     Magic[8];
+    int64_t  BaseTime;      // time_t at BaseTicks.
+    uint64_t BaseTicks;
+};
+
+static const char SessionMagic[8] = { 'O', 'V', 'R', 'B', 'L', 'O', 'G', '1' };
+
+// Single-producer, single-consumer byte ring. Head and Tail run freely and wrap
+// around; only their difference matters. They are kept on separate cache lines so
+// the producer and the writer thread don't contend for one.
+struct AsyncLog::Ring
+{
+    char*               pBuffer;
+    uint32_t            Mask;           // Capacity - 1.
+    bool                Shared;         // Written by several threads under ProducerLock.
+    ThreadId            Owner;
+    Lock                ProducerLock;
+    AtomicInt<uint32_t> Dropped;        // Since the writer last reported it.
+    char                Pad0[64];
+    AtomicInt<uint32_t> Head;
+    char                Pad1[64];
+    AtomicInt<uint32_t> Tail;
+    char                Pad2[64];
+
+    Ring() : pBuffer(nullptr), Mask(0), Shared(false), Owner(0), Dropped(0), Head(0), Tail(0) { }
+
+    RecordHeader* GetRecord(uint32_t position) const
+    {
+        return (RecordHeader*)(pBuffer + (position & Mask));
+    }
+};
+
+
+//-----------------------------------------------------------------------------------
+// ***** Binary Records
+
+// An argument read back from a binary record, in each form a conversion may ask for.
+struct LogArgValue
+{
+    int64_t     Int;
+    uint64_t    UInt;
+    double      Double;
+    const char* String;     // Null unless the argument is a string.
+};
+
+// Reads the argument at p and moves p past it. Returns false at the end of the
+// arguments or if they are cut short.
+static bool readLogArg(const char*& p, const char* end, LogArgValue& arg)
+{
+    if (p >= end)
+        return false;
+
+    int type = (uint8_t)*p++;
+    arg.String = nullptr;
+
+    switch (type)
+    {
+    case LogArg_Int32:
+    case LogArg_UInt32:
+        {
+            if (end - p < 4)
+                return false;
+            uint32_t v;
+            memcpy(&v, p, 4);
+            p += 4;
+            arg.Int    = (type == LogArg_Int32) ? (int64_t)(int32_t)v : (int64_t)v;
+            arg.UInt   = v;     // A negative int printed with %u or %x shows 32 bits, as in printf.
+            arg.Double = (double)arg.Int;
+            return true;
+        }
+
+    case LogArg_Int64:
+    case LogArg_UInt64:
+    case LogArg_Pointer:
+        {
+            if (end - p < 8)
+                return false;
+            uint64_t v;
+            memcpy(&v, p, 8);
+            p += 8;
+            arg.Int    = (int64_t)v;
+            arg.UInt   = v;
+            arg.Double = (type == LogArg_Int64) ? (double)(int64_t)v : (double)v;
+            return true;
+        }
+
+    case LogArg_Double:
+        {
+            if (end - p < 8)
+                return false;
+            double v;
+            memcpy(&v, p, 8);
+            p += 8;
+            arg.Int    = (v > -9.2e18 && v < 9.2e18) ? (int64_t)v : 0;
+            arg.UInt   = (uint64_t)arg.Int;
+            arg.Double = v;
+            return true;
+        }
+
+    case LogArg_String:
+        {
+            uint32_t length;
+            if (end - p < 4)
+                return false;
+            memcpy(&length, p, 4);
+            if ((size_t)(end - p) < (size_t)length + 5)
+                return false;
+            arg.String = p + 4;
+            arg.Int    = 0;
+            arg.UInt   = 0;
+            arg.Double = 0;
+            p += (size_t)length + 5;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Formats a binary message the way Log::FormatLog formats a text one, for a message
+// logged at timer.
+static int formatBinaryMessage(char* buffer, size_t bufferSize, LogMessageType messageType, time_t timer,
+                               const char* format, const char* args, size_t argsSize)
+{
+    int prefixLength = Log::FormatLogPrefix(buffer, bufferSize, messageType, timer);
+
+    // Keep a character for the new line.
+    int length = prefixLength + AsyncLog::FormatBinary(buffer + prefixLength, bufferSize - (size_t)prefixLength - 1,
+                                                       format, args, argsSize);
+
+    bool addNewline = (messageType == Log_Error || messageType == Log_Debug || messageType == Log_Assert);
+    if (addNewline && (length == prefixLength || buffer[length - 1] != '\n'))
+    {
+        buffer[length++] = '\n';
+        buffer[length]   = '\0';
+    }
+    return length;
+}
+
+static uint32_t getFormatId(const LogFormat* format)
+{
+    uint32_t id = format->Id;
+    if (id == 0)
+    {
+        Lock::Locker lock(&getLiveLock());
+        if (format->Id == 0)
+            const_cast<LogFormat*>(format)->Id = ++LastFormatId;
+        id = format->Id;
+    }
+    return id;
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** WriterThread
+
+class AsyncLog::WriterThread : public Thread
+{
+public:
+    WriterThread(AsyncLog* log) : pLog(log) { }
+
+    virtual int Run()
+    {
+        SetThreadName("OVR::AsyncLog");
+        pLog->writerLoop();
+        return 0;
+    }
+
+private:
+    AsyncLog* pLog;
+};
+
+
+//-----------------------------------------------------------------------------------
+// ***** AsyncLog
+
+AsyncLog::AsyncLog(unsigned logMask, size_t ringSize, OverflowPolicy policy) :
+    Log(logMask),
+    LogId(0),
+    RingSize(4096),
+    Policy(policy),
+    RingCount(0),
+    pSharedRing(nullptr),
+    pFile(stdout),
+    OwnsFile(false),
+    Format(Output_Text),
+    pBatch(nullptr),
+    BatchSize(0),
+    BatchUsed(0),
+    BaseTime(time(nullptr)),
+    BaseTicks(Timer::GetTicksNanos()),
+    pFormatWritten(nullptr),
+    FormatWrittenSize(0),
+    pWriter(nullptr),
+    ConsumerBusy(0),
+    TotalDropped(0),
+    Exiting(false),
+    FlushRequest(0),
+    FlushDone(0),
+    pNextLive(nullptr)
+{
+    while (RingSize < ringSize && RingSize < ((size_t)1 << 30))
+        RingSize *= 2;
+
+    // Anything larger than a batch is written on its own, so one ring's worth is plenty.
+    // The extra byte holds a NUL for the debugger output.
+    BatchSize = RingSize;
+    pBatch    = (char*)malloc(BatchSize + 1);
+
+    {
+        Lock::Locker lock(&getLiveLock());
+        LogId     = ++LastLogId;
+        pNextLive = pLiveLogs;
+        pLiveLogs = this;
+    }
+
+    pWriter = new WriterThread(this);
+    if (!pWriter->Start())
+    {
+        // Without a writer, messages are written out by the logging thread.
+        pWriter->Release();
+        pWriter = nullptr;
+    }
+}
+
+AsyncLog::~AsyncLog()
+{
+    if (GetGlobalLog() == this)
+        SetGlobalLog(nullptr);
+
+    {
+        Lock::Locker lock(&getLiveLock());
+        for (AsyncLog** link = &pLiveLogs; *link; link = &(*link)->pNextLive)
+        {
+            if (*link == this)
+            {
+                *link = pNextLive;
+                break;
+            }
+        }
+    }
+
+    if (pWriter)
+    {
+        Exiting = true;
+        WakeEvent.SetEvent();
+        pWriter->Join();
+        pWriter->Release();
+        pWriter = nullptr;
+    }
+
+    // Whatever was logged after the writer's last pass.
+    if (tryLockConsumer(-1))
+    {
+        drain(false);
+        ConsumerBusy.Store_Release(0);
+    }
+
+    if (OwnsFile)
+        fclose(pFile);
+
+    for (int i = 0, count = RingCount.Load_Acquire(); i < count; i++)
+    {
+        free(Rings[i]->pBuffer);
+        Rings[i]->~Ring();
+        free(Rings[i]);
+    }
+    free(pBatch);
+    free(pFormatWritten);
+}
+
+bool AsyncLog::OpenFile(const char* path, bool append, OutputFormat format)
+{
+    FILE* file;
+    if (format == Output_Binary)
+        file = fopen(path, append ? "ab" : "wb");
+    else
+        file = fopen(path, append ? "a" : "w");
+    if (!file)
+        return false;
+
+    // What is queued goes to the old output, so a file never gets both formats.
+    tryLockConsumer(-1);
+    drain(false);
+
+    {
+        Lock::Locker lock(&OutputLock);
+        if (OwnsFile)
+            fclose(pFile);
+        else
+            fflush(pFile);
+        pFile    = file;
+        OwnsFile = true;
+        Format   = format;
+    }
+
+    // Formats are written again to every file.
+    memset(pFormatWritten, 0, FormatWrittenSize);
+    if (format == Output_Binary)
+    {
+        writeSession();
+        writeBatch();
+    }
+
+    ConsumerBusy.Store_Release(0);
+    return true;
+}
+
+void AsyncLog::LogMessageVarg(LogMessageType messageType, const char* fmt, va_list argList)
+{
+    if ((messageType & GetLoggingMask()) == 0)
+        return;
+#ifndef OVR_BUILD_DEBUG
+    if (IsDebugMessage(messageType))
+        return;
+#endif
+
+    char  buffer[MaxLogBufferMessageSize];
+    char* pBuffer = buffer;
+    char* pAllocated = nullptr;
+
+    #if !defined(OVR_CC_MSVC) // Non-Microsoft compilers require you to save a copy of the va_list.
+        va_list argListSaved;
+        va_copy(argListSaved, argList);
+    #endif
+
+    int result = FormatLog(pBuffer, MaxLogBufferMessageSize, messageType, fmt, argList);
+
+    if (result >= MaxLogBufferMessageSize) // If there was insufficient capacity...
+    {
+        // Same as Log::LogMessageVarg: the logging subsystem can't use OVR_ALLOC or new.
+        pAllocated = (char*)malloc(result + 1);
+        pBuffer = pAllocated;
+
+        #if !defined(OVR_CC_MSVC)
+            va_end(argList); // The caller owns argList and will call va_end on it.
+            va_copy(argList, argListSaved);
+        #endif
+
+        FormatLog(pBuffer, (size_t)result + 1, messageType, fmt, argList);
+    }
+
+    #if !defined(OVR_CC_MSVC)
+        va_end(argListSaved);
+    #endif
+
+    if (result < 0 || !pBuffer)
+        return;
+
+    Ring* ring = getThreadRing();
+    if (!ring || !writeRecord(ring, RecordHeader::Record_Text, messageType, pBuffer, (size_t)result + 1, nullptr, 0))
+        writeDirect(pBuffer, (size_t)result, messageType);
+
+    free(pAllocated);
+}
+
+void AsyncLog::writeBinary(const LogFormat& format, const char* args, size_t argsSize)
+{
+    BinaryPayload payload;
+    payload.pFormat  = &format;
+    payload.ArgsSize = (uint32_t)argsSize;
+
+    Ring* ring = getThreadRing();
+    if (ring && writeRecord(ring, RecordHeader::Record_Binary, format.Type, &payload, sizeof(payload), args, argsSize))
+        return;
+
+    // Too large for the ring.
+    char buffer[MaxLogBufferMessageSize];
+    int  length = formatBinaryMessage(buffer, sizeof(buffer), format.Type, time(nullptr), format.Format, args, argsSize);
+    writeDirect(buffer, (size_t)length, format.Type);
+}
+
+void AsyncLog::Flush()
+{
+    if (!pWriter)
+    {
+        if (tryLockConsumer(-1))
+        {
+            drain(false);
+            ConsumerBusy.Store_Release(0);
+        }
+        return;
+    }
+
+    uint32_t ticket = FlushRequest.ExchangeAdd_Sync(1) + 1;
+    WakeEvent.SetEvent();
+
+    Mutex::Locker lock(&FlushMutex);
+    while ((int32_t)(FlushDone - ticket) < 0)
+        FlushCondition.Wait(&FlushMutex, FlushIntervalMs);
+}
+
+AsyncLog::Ring* AsyncLog::getThreadRing()
+{
+    if (ThreadRingLogId == LogId)
+        return (Ring*)pThreadRing;
+
+    ThreadId id   = GetCurrentThreadId();
+    Ring*    ring = nullptr;
+    {
+        Lock::Locker lock(&RingLock);
+
+        // The thread may have logged here before, or reuse the id of a thread that has
+        // exited; either way the ring is free for it.
+        int count = RingCount.Load_Acquire();
+        for (int i = 0; i < count; i++)
+        {
+            if (!Rings[i]->Shared && Rings[i]->Owner == id)
+            {
+                ring = Rings[i];
+                break;
+            }
+        }
+
+        if (!ring)
+        {
+            if (count - (pSharedRing ? 1 : 0) < MaxThreadRings)
+            {
+                ring = createRing(false);
+                if (ring)
+                    ring->Owner = id;
+            }
+            else
+            {
+                if (!pSharedRing)
+                    pSharedRing = createRing(true);
+                ring = pSharedRing;
+            }
+        }
+    }
+
+    if (ring)
+    {
+        ThreadRingLogId = LogId;
+        pThreadRing     = ring;
+    }
+    return ring;
+}
+
+// RingLock must be held.
+AsyncLog::Ring* AsyncLog::createRing(bool shared)
+{
+    void* memory = malloc(sizeof(Ring));
+    char* buffer = (char*)malloc(RingSize);
+    if (!memory || !buffer)
+    {
+        free(memory);
+        free(buffer);
+        return nullptr;
+    }
+
+    Ring* ring    = Construct<Ring>(memory);
+    ring->pBuffer = buffer;
+    ring->Mask    = (uint32_t)RingSize - 1;
+    ring->Shared  = shared;
+
+    int count = RingCount.Load_Acquire();
+    Rings[count] = ring;
+    RingCount.Store_Release(count + 1);
+    return ring;
+}
+
+// Writes a record made of data1 followed by data2. Returns false if it is too large
+// for the ring; a record dropped for lack of space counts as written.
+bool AsyncLog::writeRecord(Ring* ring, unsigned kind, LogMessageType messageType,
+                           const void* data1, size_t size1, const void* data2, size_t size2)
+{
+    const uint32_t capacity = ring->Mask + 1;
+    const size_t   size     = (sizeof(RecordHeader) + size1 + size2 + RecordHeader::Alignment - 1) &
+                              ~(size_t)(RecordHeader::Alignment - 1);
+
+    // At most half the ring, so a record fits after any padding.
+    if (size > capacity / 2)
+        return false;
+
+    if (ring->Shared)
+        ring->ProducerLock.DoLock();
+
+    const uint64_t time = Timer::GetTicksNanos();
+
+    for (int spins = 0; ; spins++)
+    {
+        uint32_t head   = ring->Head.Load_Acquire();
+        uint32_t tail   = ring->Tail.Load_Acquire();
+        uint32_t used   = head - tail;
+        uint32_t toEnd  = capacity - (head & ring->Mask);
+        uint32_t needed = (size <= toEnd) ? (uint32_t)size : toEnd + (uint32_t)size;
+
+        if (capacity - used >= needed)
+        {
+            uint32_t position = head;
+            if (size > toEnd)
+            {
+                RecordHeader* padding = ring->GetRecord(position);
+                padding->Size = toEnd;
+                padding->Kind = RecordHeader::Record_Padding;
+                position += toEnd;
+            }
+
+            RecordHeader* record = ring->GetRecord(position);
+            record->Size        = (uint32_t)size;
+            record->Kind        = (uint16_t)kind;
+            record->MessageType = (uint16_t)messageType;
+            record->Time        = time;
+            memcpy(record + 1, data1, size1);
+            if (size2)
+                memcpy((char*)(record + 1) + size1, data2, size2);
+
+            ring->Head.Store_Release(head + needed);
+
+            // Wake the writer early once the ring is half full; otherwise it comes
+            // around on its own every FlushIntervalMs.
+            if (used < capacity / 2 && used + needed >= capacity / 2)
+                WakeEvent.SetEvent();
+            break;
+        }
+
+        if (Policy == Overflow_Drop || !pWriter || Exiting)
+        {
+            ring->Dropped.ExchangeAdd_NoSync(1);
+            TotalDropped.ExchangeAdd_NoSync(1);
+            break;
+        }
+
+        WakeEvent.SetEvent();
+        if (spins < 64)
+            Thread::YieldCurrentThread();
+        else
+            Thread::MSleep(1);
+    }
+
+    if (ring->Shared)
+        ring->ProducerLock.Unlock();
+    return true;
+}
+
+void AsyncLog::writeDirect(const char* text, size_t length, LogMessageType messageType)
+{
+    Lock::Locker lock(&OutputLock);
+    if (Format == Output_Binary)
+    {
+        RecordHeader header;
+        header.Size        = (uint32_t)(sizeof(header) + length + 1);
+        header.Kind        = RecordHeader::Record_Text;
+        header.MessageType = (uint16_t)messageType;
+        header.Time        = Timer::GetTicksNanos();
+        fwrite(&header, sizeof(header), 1, pFile);
+        length++;
+    }
+    fwrite(text, 1, length, pFile);
+    fflush(pFile);
+}
+
+void AsyncLog::writerLoop()
+{
+    for (;;)
+    {
+        WakeEvent.Wait(FlushIntervalMs);
+        WakeEvent.ResetEvent();
+
+        // Read after the reset, so a request made during the drain wakes us again.
+        bool     exiting = Exiting;
+        uint32_t request = FlushRequest.Load_Acquire();
+
+        if (tryLockConsumer(-1))
+        {
+            drain(false);
+            ConsumerBusy.Store_Release(0);
+        }
+
+        if (request != FlushDone)
+        {
+            Mutex::Locker lock(&FlushMutex);
+            FlushDone = request;
+            FlushCondition.NotifyAll();
+        }
+
+        if (exiting)
+            break;
+    }
+}
+
+// Writes out what the rings hold, oldest record first. Records logged meanwhile are
+// left for the next pass. The consumer lock must be held.
+bool AsyncLog::drain(bool crashing)
+{
+    int      count = RingCount.Load_Acquire();
+    uint32_t tails[MaxThreadRings + 1];
+    uint32_t heads[MaxThreadRings + 1];
+
+    for (int i = 0; i < count; i++)
+    {
+        tails[i] = Rings[i]->Tail.Load_Acquire();
+        heads[i] = Rings[i]->Head.Load_Acquire();
+    }
+
+    bool wrote = false;
+    for (;;)
+    {
+        int      oldest     = -1;
+        uint64_t oldestTime = 0;
+
+        for (int i = 0; i < count; i++)
+        {
+            while (tails[i] != heads[i] &&
+                   Rings[i]->GetRecord(tails[i])->Kind == RecordHeader::Record_Padding)
+            {
+                tails[i] += Rings[i]->GetRecord(tails[i])->Size;
+            }
+
+            if (tails[i] != heads[i])
+            {
+                uint64_t time = Rings[i]->GetRecord(tails[i])->Time;
+                if (oldest < 0 || time < oldestTime)
+                {
+                    oldest     = i;
+                    oldestTime = time;
+                }
+            }
+        }
+        if (oldest < 0)
+            break;
+
+        RecordHeader* record = Rings[oldest]->GetRecord(tails[oldest]);
+        outputRecord(record, crashing);
+
+        tails[oldest] += record->Size;
+        Rings[oldest]->Tail.Store_Release(tails[oldest]);
+        wrote = true;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t dropped = Rings[i]->Dropped.Exchange_Sync(0);
+        if (dropped)
+        {
+            char message[64];
+            int  length = OVR_snprintf(message, sizeof(message), "AsyncLog: %u messages dropped\n", dropped);
+            appendText(message, (size_t)length, Log_Text, Timer::GetTicksNanos(), crashing);
+            wrote = true;
+        }
+    }
+
+    if (wrote)
+    {
+        writeBatch();
+        Lock::Locker lock(&OutputLock);
+        fflush(pFile);
+    }
+    return wrote;
+}
+
+void AsyncLog::outputRecord(const RecordHeader* record, bool crashing)
+{
+    LogMessageType messageType = (LogMessageType)record->MessageType;
+
+    if (record->Kind == RecordHeader::Record_Text)
+    {
+        const char* text = (const char*)(record + 1);
+        appendText(text, strlen(text), messageType, record->Time, crashing);
+    }
+    else if (record->Kind == RecordHeader::Record_Binary)
+    {
+        const BinaryPayload* payload = (const BinaryPayload*)(record + 1);
+        const char*          args    = (const char*)(payload + 1);
+
+        if (Format == Output_Binary)
+        {
+            appendBinary(record, payload->pFormat, args, payload->ArgsSize, crashing);
+            if (messageType != Log_Error || crashing)
+                return;
+        }
+
+        char buffer[MaxLogBufferMessageSize];
+        int  length = formatBinaryMessage(buffer, sizeof(buffer), messageType, getWallTime(record->Time),
+                                          payload->pFormat->Format, args, payload->ArgsSize);
+        if (Format == Output_Binary)
+            DefaultErrorOutput(buffer, length);
+        else
+            appendText(buffer, (size_t)length, messageType, record->Time, crashing);
+    }
+}
+
+void AsyncLog::appendText(const char* text, size_t length, LogMessageType messageType, uint64_t time, bool crashing)
+{
+    if (Format == Output_Binary)
+    {
+        RecordHeader header;
+        header.Size        = (uint32_t)(sizeof(header) + length + 1);
+        header.Kind        = RecordHeader::Record_Text;
+        header.MessageType = (uint16_t)messageType;
+        header.Time        = time;
+        appendBytes(&header, sizeof(header));
+        appendBytes(text, length + 1);
+    }
+    else
+    {
+        appendBytes(text, length);
+    }
+
+    // The system log allocates; in a crash the file is what matters.
+    if (messageType == Log_Error && !crashing)
+        DefaultErrorOutput(text, (int)length);
+}
+
+void AsyncLog::appendBinary(const RecordHeader* record, const LogFormat* format,
+                            const char* args, size_t argsSize, bool crashing)
+{
+    uint32_t id = getFormatId(format);
+
+    if (id >= FormatWrittenSize || !pFormatWritten[id])
+    {
+        size_t       formatLength = strlen(format->Format);
+        RecordHeader header;
+        header.Size        = (uint32_t)(sizeof(header) + sizeof(id) + formatLength + 1);
+        header.Kind        = RecordHeader::Record_Format;
+        header.MessageType = (uint16_t)format->Type;
+        header.Time        = record->Time;
+        appendBytes(&header, sizeof(header));
+        appendBytes(&id, sizeof(id));
+        appendBytes(format->Format, formatLength + 1);
+
+        // In a crash the format may be written twice rather than allocate.
+        if (id >= FormatWrittenSize && id < RecordHeader::MaxFormatIds && !crashing)
+        {
+            uint32_t newSize  = Alg::Min<uint32_t>(Alg::Max<uint32_t>(64, id * 2), RecordHeader::MaxFormatIds);
+            uint8_t* newFlags = (uint8_t*)realloc(pFormatWritten, newSize);
+            if (newFlags)
+            {
+                memset(newFlags + FormatWrittenSize, 0, newSize - FormatWrittenSize);
+                pFormatWritten    = newFlags;
+                FormatWrittenSize = newSize;
+            }
+        }
+        if (id < FormatWrittenSize)
+            pFormatWritten[id] = 1;
+    }
+
+    RecordHeader header;
+    header.Size        = (uint32_t)(sizeof(header) + sizeof(id) + argsSize);
+    header.Kind        = RecordHeader::Record_Binary;
+    header.MessageType = record->MessageType;
+    header.Time        = record->Time;
+    appendBytes(&header, sizeof(header));
+    appendBytes(&id, sizeof(id));
+    appendBytes(args, argsSize);
+}
+
+void AsyncLog::appendBytes(const void* data, size_t size)
+{
+    if (BatchUsed + size > BatchSize)
+        writeBatch();
+
+    if (size > BatchSize)
+    {
+        Lock::Locker lock(&OutputLock);
+        fwrite(data, 1, size, pFile);
+    }
+    else
+    {
+        memcpy(pBatch + BatchUsed, data, size);
+        BatchUsed += size;
+    }
+}
+
+// The consumer lock must be held.
+void AsyncLog::writeSession()
+{
+    SessionInfo info;
+    memcpy(info.Magic, SessionMagic, sizeof(info.Magic));
+    info.BaseTime  = (int64_t)BaseTime;
+    info.BaseTicks = BaseTicks;
+
+    RecordHeader header;
+    header.Size        = (uint32_t)(sizeof(header) + sizeof(info));
+    header.Kind        = RecordHeader::Record_Session;
+    header.MessageType = 0;
+    header.Time        = BaseTicks;
+    appendBytes(&header, sizeof(header));
+    appendBytes(&info, sizeof(info));
+}
+
+time_t AsyncLog::getWallTime(uint64_t ticks) const
+{
+    return BaseTime + (time_t)((int64_t)(ticks - BaseTicks) / 1000000000);
+}
+
+void AsyncLog::writeBatch()
+{
+    if (BatchUsed == 0)
+        return;
+
+    pBatch[BatchUsed] = '\0';
+
+#if defined(OVR_OS_MS)
+    if (Format == Output_Text && OVRIsDebuggerPresent())
+        ::OutputDebugStringA(pBatch);
+#endif
+
+    Lock::Locker lock(&OutputLock);
+    fwrite(pBatch, 1, BatchUsed, pFile);
+    BatchUsed = 0;
+}
+
+bool AsyncLog::tryLockConsumer(int maxSpins)
+{
+    for (int spins = 0; !ConsumerBusy.CompareAndSet_Sync(0, 1); spins++)
+    {
+        if (maxSpins >= 0 && spins >= maxSpins)
+            return false;
+        Thread::YieldCurrentThread();
+    }
+    return true;
+}
+
+void AsyncLog::crashFlush()
+{
+    // If the writer thread is the one that crashed it holds the consumer lock; give
+    // up rather than hang the crash handler.
+    if (tryLockConsumer(1000))
+    {
+        drain(true);
+        ConsumerBusy.Store_Release(0);
+    }
+}
+
+void AsyncLog::CrashFlushAll()
+{
+    // No lock: the crashing thread may hold it.
+    for (AsyncLog* log = pLiveLogs; log; log = log->pNextLive)
+        log->crashFlush();
+}
+
+
+int AsyncLog::FormatBinary(char* buffer, size_t bufferSize, const char* format,
+                           const char* args, size_t argsSize)
+{
+    if (!buffer || bufferSize == 0)
+        return 0;
+
+    char*       out     = buffer;
+    char* const outEnd  = buffer + bufferSize - 1;     // Room for the NUL.
+    const char* argsEnd = args + argsSize;
+    const char* f       = format;
+
+    while (*f && out < outEnd)
+    {
+        if (*f != '%')
+        {
+            *out++ = *f++;
+            continue;
+        }
+        if (f[1] == '%')
+        {
+            *out++ = '%';
+            f += 2;
+            continue;
+        }
+
+        // Rebuild the conversion with the flags, width and precision of the format,
+        // taking '*' values from the arguments.
+        char   spec[48];
+        size_t specLength = 0;
+        spec[specLength++] = *f++;
+
+        while (*f && strchr("-+ #0", *f))
+        {
+            if (specLength < 8)
+                spec[specLength++] = *f;
+            f++;
+        }
+
+        for (int part = 0; part < 2; part++)
+        {
+            if (part == 1)
+            {
+                if (*f != '.')
+                    break;
+                spec[specLength++] = *f++;
+            }
+
+            if (*f == '*')
+            {
+                LogArgValue star;
+                int value = readLogArg(args, argsEnd, star) ? (int)star.Int : 0;
+                specLength += (size_t)OVR_snprintf(spec + specLength, 12, "%d", value);
+                f++;
+            }
+            else
+            {
+                for (int digits = 0; *f >= '0' && *f <= '9'; f++, digits++)
+                {
+                    if (digits < 9)
+                        spec[specLength++] = *f;
+                }
+            }
+        }
+
+        // Length modifiers are replaced by the size the argument was stored with.
+        while (*f && strchr("hlLjztqI", *f))
+        {
+            if (*f == 'I' && ((f[1] == '3' && f[2] == '2') || (f[1] == '6' && f[2] == '4')))
+                f += 2;
+            f++;
+        }
+
+        char conversion = *f;
+        if (!conversion)
+            break;
+        f++;
+
+        LogArgValue arg;
+        bool        haveArg = readLogArg(args, argsEnd, arg);
+        size_t      room    = (size_t)(outEnd - out) + 1;
+        int         written = 0;
+
+        if (!haveArg)
+        {
+            written = OVR_snprintf(out, room, "(missing)");
+        }
+        else
+        {
+            switch (conversion)
+            {
+            case 'd': case 'i':
+                spec[specLength++] = 'l';
+                spec[specLength++] = 'l';
+                spec[specLength++] = conversion;
+                spec[specLength]   = '\0';
+                written = OVR_snprintf(out, room, spec, (long long)arg.Int);
+                break;
+
+            case 'u': case 'o': case 'x': case 'X':
+                spec[specLength++] = 'l';
+                spec[specLength++] = 'l';
+                spec[specLength++] = conversion;
+                spec[specLength]   = '\0';
+                written = OVR_snprintf(out, room, spec, (unsigned long long)arg.UInt);
+                break;
+
+            case 'c':
+                spec[specLength++] = conversion;
+                spec[specLength]   = '\0';
+                written = OVR_snprintf(out, room, spec, (int)arg.Int);
+                break;
+
+            case 'e': case 'E': case 'f': case 'F':
+            case 'g': case 'G': case 'a': case 'A':
+                spec[specLength++] = conversion;
+                spec[specLength]   = '\0';
+                written = OVR_snprintf(out, room, spec, arg.Double);
+                break;
+
+            case 'p':
+                spec[specLength++] = conversion;
+                spec[specLength]   = '\0';
+                written = OVR_snprintf(out, room, spec, (void*)(uintptr_t)arg.UInt);
+                break;
+
+            case 's':
+                spec[specLength++] = conversion;
+                spec[specLength]   = '\0';
+                written = OVR_snprintf(out, room, spec, arg.String ? arg.String : "(bad argument)");
+                break;
+
+            default:    // %n and unknown conversions print nothing.
+                break;
+            }
+        }
+
+        if (written > 0)
+            out += ((size_t)written < room) ? (size_t)written : room - 1;
+    }
+
+    *out = '\0';
+    return (int)(out - buffer);
+}
+
+bool AsyncLog::DecodeBinaryLog(FILE* input, FILE* output)
+{
+    // Text for formats by id; ids start again with every session.
+    char**   formats     = nullptr;
+    uint32_t formatCount = 0;
+    char*    payload     = nullptr;
+    size_t   payloadCapacity = 0;
+    time_t   baseTime    = 0;
+    uint64_t baseTicks   = 0;
+    bool     inSession   = false;
+    bool     result      = true;
+
+    RecordHeader header;
+    while (fread(&header, sizeof(header), 1, input) == 1)
+    {
+        if (header.Size < sizeof(header) || header.Size > (64u << 20))
+        {
+            result = false;
+            break;
+        }
+
+        // One spare byte terminates payloads that are read as text.
+        size_t size = header.Size - sizeof(header);
+        if (size + 1 > payloadCapacity)
+        {
+            char* newPayload = (char*)realloc(payload, size + 1);
+            if (!newPayload)
+            {
+                result = false;
+                break;
+            }
+            payload         = newPayload;
+            payloadCapacity = size + 1;
+        }
+        if (fread(payload, 1, size, input) != size)
+        {
+            result = false;
+            break;
+        }
+        payload[size] = '\0';
+
+        if (header.Kind == RecordHeader::Record_Session)
+        {
+            SessionInfo info;
+            if (size < sizeof(info) || memcmp(payload, SessionMagic, sizeof(SessionMagic)) != 0)
+            {
+                result = false;
+                break;
+            }
+            memcpy(&info, payload, sizeof(info));
+            baseTime  = (time_t)info.BaseTime;
+            baseTicks = info.BaseTicks;
+            inSession = true;
+
+            for (uint32_t i = 0; i < formatCount; i++)
+            {
+                free(formats[i]);
+                formats[i] = nullptr;
+            }
+            continue;
+        }
+
+        if (!inSession)
+        {
+            result = false;
+            break;
+        }
+
+        uint32_t id = 0;
+        if (header.Kind == RecordHeader::Record_Format || header.Kind == RecordHeader::Record_Binary)
+        {
+            if (size < sizeof(id))
+            {
+                result = false;
+                break;
+            }
+            memcpy(&id, payload, sizeof(id));
+            if (id >= RecordHeader::MaxFormatIds)
+            {
+                result = false;
+                break;
+            }
+        }
+
+        switch (header.Kind)
+        {
+        case RecordHeader::Record_Text:
+            fputs(payload, output);
+            break;
+
+        case RecordHeader::Record_Format:
+            {
+                if (id >= formatCount)
+                {
+                    uint32_t newCount   = Alg::Max<uint32_t>(64, id * 2);
+                    char**   newFormats = (char**)realloc(formats, newCount * sizeof(char*));
+                    if (!newFormats)
+                        break;
+                    memset(newFormats + formatCount, 0, (newCount - formatCount) * sizeof(char*));
+                    formats     = newFormats;
+                    formatCount = newCount;
+                }
+                size_t length = size - sizeof(id);
+                char*  text   = (char*)malloc(length + 1);
+                if (text)
+                {
+                    memcpy(text, payload + sizeof(id), length);
+                    text[length] = '\0';
+                }
+                free(formats[id]);
+                formats[id] = text;
+            }
+            break;
+
+        case RecordHeader::Record_Binary:
+            {
+                LogMessageType messageType = (LogMessageType)header.MessageType;
+                time_t         timer       = baseTime + (time_t)((int64_t)(header.Time - baseTicks) / 1000000000);
+                const char*    format      = (id < formatCount) ? formats[id] : nullptr;
+                char           buffer[MaxLogBufferMessageSize];
+
+                if (format)
+                    formatBinaryMessage(buffer, sizeof(buffer), messageType, timer, format,
+                                        payload + sizeof(id), size - sizeof(id));
+                else
+                    OVR_snprintf(buffer, sizeof(buffer), "(unknown format %u)\n", id);
+                fputs(buffer, output);
+            }
+            break;
+
+        default:    // Kinds added later are skipped.
+            break;
+        }
+    }
+
+    if (result && !inSession && !feof(input))
+        result = false;
+    if (result && ferror(input))
+        result = false;
+
+    for (uint32_t i = 0; i < formatCount; i++)
+        free(formats[i]);
+    free(formats);
+    free(payload);
+    return result;
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** AsyncLogExceptionListener
+
+int AsyncLogExceptionListener::HandleException(uintptr_t userValue,
+                                               ExceptionHandler* pExceptionHandler,
+                                               ExceptionInfo* pExceptionInfo,
+                                               const char* reportFilePath)
+{
+    AsyncLog::CrashFlushAll();
+
+    if (pNext)
+        return pNext->HandleException(userValue, pExceptionHandler, pExceptionInfo, reportFilePath);
+    return 0;
+}
+
+
+} // namespace OVR
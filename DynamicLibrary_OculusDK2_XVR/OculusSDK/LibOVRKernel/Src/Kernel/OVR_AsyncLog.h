@@ -0,0 +1,427 @@
+/************************************************************************************
+
+PublicHeader:   OVR_Kernel.h
+Filename    :   OVR_AsyncLog.h 
+Content     :   Asynchronous log with per-thread ring buffers
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+
+#ifndef OVR_AsyncLog_h
+#define OVR_AsyncLog_h
+
+#include "OVR_Types.h"
+#include "OVR_Allocator.h"
+#include "OVR_Log.h"
+#include "OVR_Atomic.h"
+#include "OVR_Threads.h"
+#include "OVR_DebugHelp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace OVR {
+
+
+//-----------------------------------------------------------------------------------
+// ***** LogFormat
+
+// The constant part of a binary log message: its type and printf format. OVR_LOG_BINARY
+// keeps one in static storage at each call site and records refer to it by address.
+// Id is given out by the writer the first time the format goes to a binary file.
+
+struct LogFormat
+{
+    LogMessageType    Type;
+    const char*       Format;
+    volatile uint32_t Id;
+};
+
+
+//-----------------------------------------------------------------------------------
+// ***** LogArgPacker
+
+// Encodes the arguments of a binary log message: each one is a LogArgType byte
+// followed by the value in native byte order. Integers keep their size, floats are
+// widened to double, and strings are copied with their length and terminating NUL.
+
+enum LogArgType
+{
+    LogArg_Int32 = 1,
+    LogArg_UInt32,
+    LogArg_Int64,
+    LogArg_UInt64,
+    LogArg_Double,
+    LogArg_Pointer,
+    LogArg_String     // uint32_t length, then the characters and a NUL.
+};
+
+#if !defined(OVR_CPP_NO_VARIADIC_TEMPLATES)
+
+class LogArgPacker
+{
+public:
+    static size_t GetSize() { return 0; }
+
+    template<class T, class... Rest>
+    static size_t GetSize(const T& arg, const Rest&... rest)
+    { return argSize(arg) + GetSize(rest...); }
+
+    static char*  Pack(char* p) { return p; }
+
+    template<class T, class... Rest>
+    static char*  Pack(char* p, const T& arg, const Rest&... rest)
+    { return Pack(packArg(p, arg), rest...); }
+
+private:
+    template<class T>
+    static size_t intSize(T)                  { return 1 + (sizeof(T) <= 4 ? 4 : 8); }
+
+    template<class T>
+    static char*  packInt(char* p, T value)
+    {
+        const bool isSigned = ((T)-1 < (T)0);
+        if (sizeof(T) <= 4)
+        {
+            *p = (char)(isSigned ? LogArg_Int32 : LogArg_UInt32);
+            int32_t v = (int32_t)value;
+            memcpy(p + 1, &v, 4);
+            return p + 5;
+        }
+        *p = (char)(isSigned ? LogArg_Int64 : LogArg_UInt64);
+        int64_t v = (int64_t)value;
+        memcpy(p + 1, &v, 8);
+        return p + 9;
+    }
+
+    static char*  packDouble(char* p, double value)
+    {
+        *p = (char)LogArg_Double;
+        memcpy(p + 1, &value, 8);
+        return p + 9;
+    }
+
+    static char*  packPointer(char* p, const void* value)
+    {
+        *p = (char)LogArg_Pointer;
+        uint64_t v = (uint64_t)(uintptr_t)value;
+        memcpy(p + 1, &v, 8);
+        return p + 9;
+    }
+
+    static size_t stringSize(const char* s)   { return 1 + 4 + (s ? strlen(s) : 6) + 1; }
+
+    static char*  packString(char* p, const char* s)
+    {
+        if (!s)
+            s = "(null)";
+        uint32_t length = (uint32_t)strlen(s);
+        *p = (char)LogArg_String;
+        memcpy(p + 1, &length, 4);
+        memcpy(p + 5, s, length + 1);
+        return p + 5 + length + 1;
+    }
+
+    static size_t argSize(char v)               { return intSize(v); }
+    static size_t argSize(signed char v)        { return intSize(v); }
+    static size_t argSize(unsigned char v)      { return intSize(v); }
+    static size_t argSize(short v)              { return intSize(v); }
+    static size_t argSize(unsigned short v)     { return intSize(v); }
+    static size_t argSize(int v)                { return intSize(v); }
+    static size_t argSize(unsigned int v)       { return intSize(v); }
+    static size_t argSize(long v)               { return intSize(v); }
+    static size_t argSize(unsigned long v)      { return intSize(v); }
+    static size_t argSize(long long v)          { return intSize(v); }
+    static size_t argSize(unsigned long long v) { return intSize(v); }
+    static size_t argSize(bool)                 { return 5; }
+    static size_t argSize(double)               { return 9; }
+    static size_t argSize(long double)          { return 9; }
+    static size_t argSize(const char* s)        { return stringSize(s); }
+    static size_t argSize(char* s)              { return stringSize(s); }
+    template<class T>
+    static size_t argSize(T*)                   { return 9; }
+
+    static char*  packArg(char* p, char v)               { return packInt(p, v); }
+    static char*  packArg(char* p, signed char v)        { return packInt(p, v); }
+    static char*  packArg(char* p, unsigned char v)      { return packInt(p, v); }
+    static char*  packArg(char* p, short v)              { return packInt(p, v); }
+    static char*  packArg(char* p, unsigned short v)     { return packInt(p, v); }
+    static char*  packArg(char* p, int v)                { return packInt(p, v); }
+    static char*  packArg(char* p, unsigned int v)       { return packInt(p, v); }
+    static char*  packArg(char* p, long v)               { return packInt(p, v); }
+    static char*  packArg(char* p, unsigned long v)      { return packInt(p, v); }
+    static char*  packArg(char* p, long long v)          { return packInt(p, v); }
+    static char*  packArg(char* p, unsigned long long v) { return packInt(p, v); }
+    static char*  packArg(char* p, bool v)               { return packInt(p, (int)v); }
+    static char*  packArg(char* p, double v)             { return packDouble(p, v); }
+    static char*  packArg(char* p, long double v)        { return packDouble(p, (double)v); }
+    static char*  packArg(char* p, const char* s)        { return packString(p, s); }
+    static char*  packArg(char* p, char* s)              { return packString(p, s); }
+    template<class T>
+    static char*  packArg(char* p, T* v)                 { return packPointer(p, v); }
+};
+
+#endif // !defined(OVR_CPP_NO_VARIADIC_TEMPLATES)
+
+
+//-----------------------------------------------------------------------------------
+// ***** AsyncLog
+
+// AsyncLog is a Log that keeps file and console output off the logging thread.
+// LogMessageVarg formats the message and copies it into a ring buffer owned by the
+// calling thread; a background writer thread drains the rings, merges the records in
+// time order, and writes them to the output file in batches. A thread that logs
+// does no I/O and takes no lock, so a slow console or disk can't stall it.
+//
+// Each of the first MaxThreadRings threads that log gets its own single-producer ring.
+// Threads after that share one more ring, guarded by a lock. Rings are freed with the log.
+//
+// When a ring is full, the OverflowPolicy decides what happens. Overflow_Drop discards
+// the message; the writer later reports how many were lost. Overflow_Block waits for
+// the writer to make room. Messages too large for a ring are written synchronously.
+//
+// Observers and the CAPI callback still run synchronously in LogMessageVargInt.
+// An AsyncLog must be destroyed before System::Destroy.
+//
+// Binary messages, logged with OVR_LOG_BINARY, go further: the calling thread stores
+// the address of the static LogFormat and the raw argument bytes, and the printf
+// formatting happens on the writer thread. With Output_Binary it doesn't happen at
+// all; the records are written as they are and DecodeBinaryLog turns the file into
+// text later. This is meant for per-frame diagnostics in release builds.
+//
+// Example usage:
+//     AsyncLog asyncLog(LogMask_All);
+//     asyncLog.OpenFile("OVRLog.txt");
+//     Log::SetGlobalLog(&asyncLog);
+//     ...
+//     Log::SetGlobalLog(nullptr);
+
+class AsyncLog : public Log
+{
+public:
+    enum {
+        DefaultRingSize = 64 * 1024,   // Bytes per thread ring; a power of two.
+        MaxThreadRings  = 64,
+        FlushIntervalMs = 20           // Longest time a message waits in a ring.
+    };
+
+    enum OverflowPolicy
+    {
+        Overflow_Drop,
+        Overflow_Block
+    };
+
+    enum OutputFormat
+    {
+        Output_Text,
+        Output_Binary      // Records as logged; see DecodeBinaryLog.
+    };
+
+    // Output goes to stdout until OpenFile is called.
+    AsyncLog(unsigned logMask = LogMask_Debug, size_t ringSize = DefaultRingSize,
+             OverflowPolicy policy = Overflow_Drop);
+    virtual ~AsyncLog();
+
+    // Sends the output to the file at path (UTF8) instead, as text or as binary
+    // records. Messages already queued go to the previous output first. Returns false
+    // if the file can't be opened.
+    bool            OpenFile(const char* path, bool append = false, OutputFormat format = Output_Text);
+
+    OverflowPolicy  GetOverflowPolicy() const              { return Policy; }
+    void            SetOverflowPolicy(OverflowPolicy policy) { Policy = policy; }
+
+    // Number of messages discarded under Overflow_Drop since the log was created.
+    uint32_t        GetDroppedCount() const                { return TotalDropped.Load_Acquire(); }
+
+    // Returns once every message logged before the call has been written out.
+    void            Flush();
+
+    virtual void    LogMessageVarg(LogMessageType messageType, const char* fmt, va_list argList) OVR_OVERRIDE;
+
+#if !defined(OVR_CPP_NO_VARIADIC_TEMPLATES)
+    // Logs a message whose formatting is deferred; the calling thread only copies
+    // the arguments. Use OVR_LOG_BINARY rather than calling this directly.
+    template<class... Args>
+    void            LogBinary(const LogFormat& format, const Args&... args)
+    {
+        if (!isEnabled(format.Type))
+            return;
+
+        char   buffer[256];
+        size_t size = LogArgPacker::GetSize(args...);
+        char*  data = (size <= sizeof(buffer)) ? buffer : (char*)malloc(size);
+        if (data)
+        {
+            LogArgPacker::Pack(data, args...);
+            writeBinary(format, data, size);
+            if (data != buffer)
+                free(data);
+        }
+    }
+#endif
+
+    // Formats the arguments of a binary message with format, writing at most
+    // bufferSize - 1 characters and a NUL. Returns the strlen written.
+    static int      FormatBinary(char* buffer, size_t bufferSize, const char* format,
+                                 const char* args, size_t argsSize);
+
+    // Writes the text of a file written with Output_Binary to output.
+    // Returns false if the file is not a binary log or is cut short.
+    static bool     DecodeBinaryLog(FILE* input, FILE* output);
+
+    // Writes out what is queued in every AsyncLog from the calling thread, without
+    // allocating or waiting for the writer threads. For crash and signal handlers,
+    // where the writer thread may never run again.
+    static void     CrashFlushAll();
+
+private:
+    class WriterThread;
+    struct Ring;
+    struct RecordHeader;
+
+    bool            isEnabled(LogMessageType messageType) const
+    {
+    #ifndef OVR_BUILD_DEBUG
+        if (IsDebugMessage(messageType))
+            return false;
+    #endif
+        return (messageType & GetLoggingMask()) != 0;
+    }
+
+    Ring*           getThreadRing();
+    Ring*           createRing(bool shared);
+    bool            writeRecord(Ring* ring, unsigned kind, LogMessageType messageType,
+                                const void* data1, size_t size1, const void* data2, size_t size2);
+    void            writeBinary(const LogFormat& format, const char* args, size_t argsSize);
+    void            writeDirect(const char* text, size_t length, LogMessageType messageType);
+
+    // Consumer side, run by the writer thread or CrashFlushAll.
+    void            writerLoop();
+    bool            drain(bool crashing);
+    void            outputRecord(const RecordHeader* record, bool crashing);
+    void            appendText(const char* text, size_t length, LogMessageType messageType, uint64_t time, bool crashing);
+    void            appendBinary(const RecordHeader* record, const LogFormat* format,
+                                 const char* args, size_t argsSize, bool crashing);
+    void            appendBytes(const void* data, size_t size);
+    void            writeSession();
+    void            writeBatch();
+    time_t          getWallTime(uint64_t ticks) const;
+    bool            tryLockConsumer(int maxSpins);
+    void            crashFlush();
+
+    uint32_t        LogId;
+    size_t          RingSize;
+    OverflowPolicy  Policy;
+
+    // Rings[0..RingCount) are live; RingLock guards creation.
+    Ring*           Rings[MaxThreadRings + 1];
+    AtomicInt<int>  RingCount;
+    Ring*           pSharedRing;
+    Lock            RingLock;
+
+    // Output; OutputLock keeps direct writes and batches apart.
+    FILE*           pFile;
+    bool            OwnsFile;
+    OutputFormat    Format;
+    Lock            OutputLock;
+    char*           pBatch;
+    size_t          BatchSize;
+    size_t          BatchUsed;
+
+    // Wall clock time at BaseTicks, to turn record times into dates.
+    time_t          BaseTime;
+    uint64_t        BaseTicks;
+
+    // Format ids already written to the binary file, one byte each.
+    uint8_t*        pFormatWritten;
+    uint32_t        FormatWrittenSize;
+
+    WriterThread*   pWriter;
+    Event           WakeEvent;
+    AtomicInt<int>  ConsumerBusy;
+    AtomicInt<uint32_t> TotalDropped;
+    volatile bool   Exiting;
+
+    // Flush requests are tickets: Flush waits until FlushDone reaches its ticket.
+    AtomicInt<uint32_t> FlushRequest;
+    uint32_t        FlushDone;
+    Mutex           FlushMutex;
+    WaitCondition   FlushCondition;
+
+    // Live logs, for CrashFlushAll.
+    AsyncLog*       pNextLive;
+
+    // Not copyable.
+    AsyncLog(const AsyncLog&);
+    void operator = (const AsyncLog&);
+};
+
+
+//-----------------------------------------------------------------------------------
+// ***** AsyncLogExceptionListener
+
+// Flushes every AsyncLog when ExceptionHandler catches a crash, then passes the
+// exception on to next, if set.
+//
+// Example usage:
+//     exceptionHandler.SetExceptionListener(&asyncLogListener, 0);
+
+class AsyncLogExceptionListener : public ExceptionHandler::ExceptionListener
+{
+public:
+    AsyncLogExceptionListener(ExceptionHandler::ExceptionListener* next = nullptr) : pNext(next) { }
+
+    virtual int HandleException(uintptr_t userValue,
+                                ExceptionHandler* pExceptionHandler,
+                                ExceptionInfo* pExceptionInfo,
+                                const char* reportFilePath) OVR_OVERRIDE;
+
+protected:
+    ExceptionHandler::ExceptionListener* pNext;
+};
+
+
+// Checks the arguments of OVR_LOG_BINARY against its format on compilers that can.
+inline void LogBinaryFormatCheck(const char*, ...) OVR_LOG_VAARG_ATTRIBUTE(1,2);
+inline void LogBinaryFormatCheck(const char*, ...) { }
+
+
+// Logs a printf-style message to an AsyncLog with deferred formatting. fmt must be a
+// string literal; arguments may be integers, floating point values, pointers and
+// strings, which are copied.
+//
+// Example usage:
+//     OVR_LOG_BINARY(pAsyncLog, OVR::Log_Text, "frame %u pose %.3f %.3f %.3f\n", frame, x, y, z);
+
+#if !defined(OVR_CPP_NO_VARIADIC_TEMPLATES)
+    #define OVR_LOG_BINARY(log, messageType, fmt, ...)                                  \
+        do {                                                                            \
+            static OVR::LogFormat ovrLogFormat_ = { messageType, fmt, 0 };              \
+            if (0) OVR::LogBinaryFormatCheck(fmt, ##__VA_ARGS__);                       \
+            (log)->LogBinary(ovrLogFormat_, ##__VA_ARGS__);                             \
+        } while(0)
+#endif
+
+
+} // namespace OVR
+
+#endif // OVR_AsyncLog_h
@@ -32,6 +32,7 @@ limitations under the License.
 
 #include "OVR_String.h" // For CallbackHash
 #include "OVR_Hash.h" // For CallbackHash
+#include "OVR_FlatHash.h" // For CallbackHash
 
 namespace OVR {
 
@@ -258,7 +259,7 @@ bool CallbackListener<DelegateT>::IsListening() const
 template<class DelegateT>
 class CallbackHash : public NewOverrideBase
 {
-    typedef Hash<String, CallbackEmitter<DelegateT>*, String::HashFunctor> HashTable;
+    typedef FlatHash<String, CallbackEmitter<DelegateT>*, String::HashFunctor> HashTable;
 
 public:
     ~CallbackHash()
@@ -1225,6 +1225,27 @@ limitations under the License.
 #endif
 
 
+//-----------------------------------------------------------------------------------
+// ***** OVR_THREAD_LOCAL
+//
+// Declares a thread-local variable, with C++11 thread_local where it is supported and
+// the C extension elsewhere. Since the C extensions run no constructors or destructors,
+// only use it for POD variables with constant initializers.
+//
+// Example usage:
+//     static OVR_THREAD_LOCAL void* pThreadCache = nullptr;
+
+#if !defined(OVR_THREAD_LOCAL)
+    #if !defined(OVR_CPP_NO_THREAD_LOCAL)
+        #define OVR_THREAD_LOCAL thread_local
+    #elif defined(OVR_CC_MSVC)
+        #define OVR_THREAD_LOCAL __declspec(thread)
+    #else
+        #define OVR_THREAD_LOCAL __thread
+    #endif
+#endif
+
+
 // -----------------------------------------------------------------------------------
 // ***** OVR_ALIGNAS / OVR_ALIGNOF
 //
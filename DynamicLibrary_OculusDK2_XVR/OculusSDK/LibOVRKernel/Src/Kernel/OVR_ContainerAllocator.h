@@ -73,6 +73,14 @@ public:
         *(T*)p = source;
     }
 
+#if !defined(OVR_CPP_NO_VARIADIC_TEMPLATES)
+    template <class... Args>
+    static void ConstructEmplace(void *p, Args&&... args)
+    {
+        OVR::ConstructEmplace<T>(p, std::forward<Args>(args)...);
+    }
+#endif
+
     // Same as above, but allows for a different type of constructor.
     template <class S> 
     static void ConstructAlt(void *p, const S& source)
@@ -134,6 +142,21 @@ public:
         OVR::Construct<T>(p, source);
     }
 
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    static void Construct(void* p, T&& source)
+    {
+        OVR::Construct<T>(p, std::move(source));
+    }
+
+#if !defined(OVR_CPP_NO_VARIADIC_TEMPLATES)
+    template <class... Args>
+    static void ConstructEmplace(void* p, Args&&... args)
+    {
+        OVR::ConstructEmplace<T>(p, std::forward<Args>(args)...);
+    }
+#endif
+#endif
+
     // Same as above, but allows for a different type of constructor.
     template <class S> 
     static void ConstructAlt(void* p, const S& source)
@@ -207,6 +230,21 @@ public:
         OVR::Construct<T>(p, source);        
     }
 
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    static void Construct(void* p, T&& source)
+    {
+        OVR::Construct<T>(p, std::move(source));
+    }
+
+#if !defined(OVR_CPP_NO_VARIADIC_TEMPLATES)
+    template <class... Args>
+    static void ConstructEmplace(void* p, Args&&... args)
+    {
+        OVR::ConstructEmplace<T>(p, std::forward<Args>(args)...);
+    }
+#endif
+#endif
+
     // Same as above, but allows for a different type of constructor.
     template <class S> 
     static void ConstructAlt(void* p, const S& source)
@@ -249,18 +287,30 @@ public:
 
     static void CopyArrayForward(T* dst, const T* src, size_t count)
     {
+        if (IsMovable())
+        {
+            memmove((void*)dst, (const void*)src, count * sizeof(T));
+            return;
+        }
         for(size_t i = 0; i < count; ++i)
             dst[i] = src[i];
     }
 
     static void CopyArrayBackward(T* dst, const T* src, size_t count)
     {
+        if (IsMovable())
+        {
+            memmove((void*)dst, (const void*)src, count * sizeof(T));
+            return;
+        }
         for(size_t i = count; i; --i)
             dst[i-1] = src[i-1];
     }
 
+    // Types declared trivially relocatable are moved around with memcpy like
+    // ConstructorMov does; everything else is copied element by element.
     static bool IsMovable()
-    { return false; }
+    { return IsTriviallyRelocatable<T>::Value != 0; }
 };
 
 
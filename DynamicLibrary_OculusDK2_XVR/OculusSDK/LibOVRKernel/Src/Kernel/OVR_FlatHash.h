@@ -0,0 +1,704 @@
+/************************************************************************************
+
+PublicHeader:   OVR_Kernel.h
+Filename    :   OVR_FlatHash.h
+Content     :   Open-addressing hash table with SIMD-probed control bytes
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#ifndef OVR_FlatHash_h
+#define OVR_FlatHash_h
+
+#include "OVR_Types.h"
+#include "OVR_Alg.h"
+#include "OVR_ContainerAllocator.h"
+#include "OVR_Hash.h"
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define OVR_FLATHASH_SSE2
+    #include <emmintrin.h>
+#elif (defined(OVR_CPU_ARM_NEON) || defined(__ARM_NEON)) && (defined(__GNUC__) || defined(__clang__))
+    #define OVR_FLATHASH_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace OVR {
+
+
+//-----------------------------------------------------------------------------------
+// ***** MixHash
+
+// Hashes an object's in-memory representation like FixedSizeHash, but eight bytes
+// at a time through a 64-bit multiply-xorshift mixer rather than byte by byte; a key
+// of up to eight bytes costs a single mix. Like FixedSizeHash, it requires keys
+// without padding bytes.
+
+template<class C>
+class MixHash
+{
+public:
+    static OVR_FORCE_INLINE uint64_t Mix(uint64_t x)
+    {
+        x ^= x >> 32;
+        x *= 0xd6e8feb86659fd93ULL;
+        x ^= x >> 32;
+        x *= 0xd6e8feb86659fd93ULL;
+        x ^= x >> 32;
+        return x;
+    }
+
+    // The full 64 bits, on 32-bit targets too; for hashes that are stored.
+    static OVR_FORCE_INLINE uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0)
+    {
+        const uint8_t* p = (const uint8_t*)data;
+        uint64_t       h = seed ^ ((uint64_t)size * 0x9e3779b97f4a7c15ULL);
+        uint64_t       word;
+
+        for (; size >= 8; size -= 8, p += 8)
+        {
+            memcpy(&word, p, 8);
+            h = Mix(h ^ word);
+        }
+        if (size)
+        {
+            word = 0;
+            memcpy(&word, p, size);
+            h = Mix(h ^ word);
+        }
+        return h;
+    }
+
+    static OVR_FORCE_INLINE size_t Hash(const void* data, size_t size, uint64_t seed = 0)
+    {
+        return (size_t)Hash64(data, size, seed);
+    }
+
+    size_t operator()(const C& data) const
+    {
+        return Hash(&data, sizeof(C));
+    }
+};
+
+
+//-----------------------------------------------------------------------------------
+// ***** FlatHashGroup
+
+// Control byte of every slot in a FlatHashSet: 7 bits of the hash of a full slot, or
+// one of these negative values.
+enum FlatHashControl
+{
+    FlatHash_Empty   = -128,
+    FlatHash_Deleted = -2
+};
+
+// A group of Width consecutive control bytes, compared all at once. A match is a
+// bit mask with one bit per matching slot, 1 << (lane << LaneShift).
+
+#if defined(OVR_FLATHASH_SSE2)
+
+class FlatHashGroup
+{
+public:
+    typedef uint32_t MaskType;
+    enum { Width = 16, LaneShift = 0 };
+
+    explicit FlatHashGroup(const int8_t* ctrl)
+        : Ctrl(_mm_loadu_si128((const __m128i*)ctrl)) { }
+
+    MaskType Match(int8_t h2) const
+    { return (MaskType)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), Ctrl)); }
+    MaskType MatchEmpty() const
+    { return Match(FlatHash_Empty); }
+    // Empty or deleted slots: the ones with the sign bit set.
+    MaskType MatchFree() const
+    { return (MaskType)_mm_movemask_epi8(Ctrl); }
+
+    static int LowestLane(MaskType mask)  { return Alg::CountTrailing0Bits(mask); }
+    static int HighestLane(MaskType mask) { return Alg::UpperBit(mask); }
+
+private:
+    __m128i Ctrl;
+};
+
+#elif defined(OVR_FLATHASH_NEON)
+
+class FlatHashGroup
+{
+public:
+    typedef uint64_t MaskType;
+    enum { Width = 16, LaneShift = 2 };
+
+    explicit FlatHashGroup(const int8_t* ctrl)
+        : Ctrl(vld1q_s8(ctrl)) { }
+
+    MaskType Match(int8_t h2) const
+    { return toMask(vceqq_s8(Ctrl, vdupq_n_s8(h2))); }
+    MaskType MatchEmpty() const
+    { return Match(FlatHash_Empty); }
+    MaskType MatchFree() const
+    { return toMask(vreinterpretq_u8_s8(vshrq_n_s8(Ctrl, 7))); }
+
+    static int LowestLane(MaskType mask)  { return __builtin_ctzll(mask) >> LaneShift; }
+    static int HighestLane(MaskType mask) { return (63 - __builtin_clzll(mask)) >> LaneShift; }
+
+private:
+    // NEON has no movemask; narrowing each 16-bit pair by 4 bits leaves a nibble per
+    // byte, of which one bit is kept.
+    static MaskType toMask(uint8x16_t bytes)
+    {
+        uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(bytes), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ULL;
+    }
+
+    int8x16_t Ctrl;
+};
+
+#else
+
+class FlatHashGroup
+{
+public:
+    typedef uint32_t MaskType;
+    enum { Width = 16, LaneShift = 0 };
+
+    explicit FlatHashGroup(const int8_t* ctrl) : pCtrl(ctrl) { }
+
+    MaskType Match(int8_t h2) const
+    {
+        MaskType mask = 0;
+        for (int i = 0; i < Width; i++)
+            mask |= (MaskType)(pCtrl[i] == h2) << i;
+        return mask;
+    }
+    MaskType MatchEmpty() const
+    { return Match(FlatHash_Empty); }
+    MaskType MatchFree() const
+    {
+        MaskType mask = 0;
+        for (int i = 0; i < Width; i++)
+            mask |= (MaskType)(pCtrl[i] < 0) << i;
+        return mask;
+    }
+
+    static int LowestLane(MaskType mask)  { return Alg::CountTrailing0Bits(mask); }
+    static int HighestLane(MaskType mask) { return Alg::UpperBit(mask); }
+
+private:
+    const int8_t* pCtrl;
+};
+
+#endif
+
+
+//-----------------------------------------------------------------------------------
+// ***** FlatHashSet
+
+// FlatHashSet is an open-addressing alternative to HashSet, in the style of
+// SwissTable. Values are stored inline in a slot array, and every slot has a control
+// byte holding 7 bits of its hash, or marking it empty or deleted. A lookup hashes
+// the key, then compares a whole group of 16 control bytes against those 7 bits with
+// one SIMD compare (SSE2 or NEON), and only looks at the values whose byte matched;
+// it stops at the first group that has an empty slot. Groups are probed
+// quadratically.
+//
+// The table keeps at most 7/8 of its slots full or deleted. Removed values leave a
+// deleted marker only when a probe could have passed over their slot; the markers
+// are dropped when the table is rebuilt. Removing never moves other values, so an
+// iterator stays valid across Iterator::Remove. Inserting may rebuild the table and
+// invalidates iterators and pointers to values.
+//
+// Its interface is that of HashSet, so it can also be the Container of a Hash; see
+// FlatHash below. HashF should mix well: it only goes through a multiply before
+// its bits are used.
+
+template<class C, class HashF = MixHash<C>,
+         class AltHashF = HashF,
+         class Allocator = ContainerAllocator<C> >
+class FlatHashSet
+{
+    typedef FlatHashGroup::MaskType MaskType;
+
+    enum {
+        Width       = FlatHashGroup::Width,
+        MinCapacity = Width
+    };
+
+public:
+    OVR_MEMORY_REDEFINE_NEW(FlatHashSet)
+
+    typedef FlatHashSet<C, HashF, AltHashF, Allocator>    SelfType;
+
+    FlatHashSet() : pCtrl(NULL), pSlots(NULL), Capacity(0), Size(0), GrowthLeft(0) { }
+    FlatHashSet(int sizeHint) : pCtrl(NULL), pSlots(NULL), Capacity(0), Size(0), GrowthLeft(0)
+    { SetCapacity(sizeHint); }
+    FlatHashSet(const SelfType& src) : pCtrl(NULL), pSlots(NULL), Capacity(0), Size(0), GrowthLeft(0)
+    { Assign(src); }
+
+    ~FlatHashSet() { Clear(); }
+
+    void operator = (const SelfType& src) { if (&src != this) Assign(src); }
+
+    void Assign(const SelfType& src)
+    {
+        Clear();
+        if (!src.IsEmpty())
+        {
+            SetCapacity(src.GetSize());
+            for (ConstIterator it = src.Begin(); it != src.End(); ++it)
+                Add(*it);
+        }
+    }
+
+    // Remove all entries and release the table.
+    void Clear()
+    {
+        if (pCtrl)
+        {
+            for (size_t i = 0; i < Capacity; i++)
+            {
+                if (pCtrl[i] >= 0)
+                    pSlots[i].~C();
+            }
+            Allocator::Free(pCtrl);
+            pCtrl      = NULL;
+            pSlots     = NULL;
+            Capacity   = 0;
+            Size       = 0;
+            GrowthLeft = 0;
+        }
+    }
+
+    bool    IsEmpty() const     { return Size == 0; }
+    size_t  GetSize() const     { return Size; }
+    int     GetSizeI() const    { return (int)Size; }
+
+    // Set a new or existing value under the key.
+    template<class CRef>
+    void Set(const CRef& key)
+    {
+        size_t   hashValue = HashF()(key);
+        intptr_t index     = findIndexCore(key, hashValue);
+        if (index >= 0)
+            pSlots[index] = key;
+        else
+            add(key, hashValue);
+    }
+
+    // Add a value without checking whether the key is already present.
+    template<class CRef>
+    inline void Add(const CRef& key)
+    {
+        add(key, HashF()(key));
+    }
+
+    template<class K>
+    void RemoveAlt(const K& key)
+    {
+        intptr_t index = findIndexCore(key, AltHashF()(key));
+        if (index >= 0)
+            removeAt((size_t)index);
+    }
+
+    template<class CRef>
+    void Remove(const CRef& key)
+    {
+        RemoveAlt(key);
+    }
+
+    template<class K>
+    C* Get(const K& key)
+    {
+        intptr_t index = findIndexCore(key, HashF()(key));
+        return (index >= 0) ? &pSlots[index] : 0;
+    }
+
+    template<class K>
+    const C* Get(const K& key) const
+    {
+        intptr_t index = findIndexCore(key, HashF()(key));
+        return (index >= 0) ? &pSlots[index] : 0;
+    }
+
+    template<class K>
+    C* GetAlt(const K& key)
+    {
+        intptr_t index = findIndexCore(key, AltHashF()(key));
+        return (index >= 0) ? &pSlots[index] : 0;
+    }
+
+    template<class K>
+    const C* GetAlt(const K& key) const
+    {
+        intptr_t index = findIndexCore(key, AltHashF()(key));
+        return (index >= 0) ? &pSlots[index] : 0;
+    }
+
+    template<class K>
+    bool GetAlt(const K& key, C* pval) const
+    {
+        intptr_t index = findIndexCore(key, AltHashF()(key));
+        if (index >= 0)
+        {
+            if (pval)
+                *pval = pSlots[index];
+            return true;
+        }
+        return false;
+    }
+
+    // Hint the capacity to >= n.
+    void Resize(size_t n)
+    {
+        SetCapacity(n);
+    }
+
+    // Size the table so that it can contain the given number of values without
+    // being rebuilt.
+    void SetCapacity(size_t newSize)
+    {
+        if (newSize < Size)
+            newSize = Size;
+
+        size_t capacity = MinCapacity;
+        while (growthLimit(capacity) < newSize)
+            capacity *= 2;
+        if (capacity != Capacity)
+            rehash(capacity);
+    }
+
+    // Iterator API, like HashSet.
+    struct ConstIterator
+    {
+        const C&    operator * () const
+        {
+            OVR_ASSERT(!IsEnd());
+            return pHash->pSlots[Index];
+        }
+
+        const C*    operator -> () const
+        {
+            OVR_ASSERT(!IsEnd());
+            return &pHash->pSlots[Index];
+        }
+
+        void    operator ++ ()
+        {
+            if (!IsEnd())
+                Index = pHash->nextFull(Index + 1);
+        }
+
+        bool    operator == (const ConstIterator& it) const
+        {
+            if (IsEnd() && it.IsEnd())
+                return true;
+            return (pHash == it.pHash) && (Index == it.Index);
+        }
+
+        bool    operator != (const ConstIterator& it) const
+        {
+            return ! (*this == it);
+        }
+
+        bool    IsEnd() const
+        {
+            return (pHash == NULL) || (Index >= (intptr_t)pHash->Capacity);
+        }
+
+        ConstIterator()
+            : pHash(NULL), Index(0)
+        { }
+
+    public:
+        ConstIterator(const SelfType* h, intptr_t index)
+            : pHash(h), Index(index)
+        { }
+
+        const SelfType* GetContainer() const
+        {
+            return pHash;
+        }
+        intptr_t GetIndex() const
+        {
+            return Index;
+        }
+
+    protected:
+        friend class FlatHashSet<C, HashF, AltHashF, Allocator>;
+
+        const SelfType* pHash;
+        intptr_t        Index;
+    };
+
+    friend struct ConstIterator;
+
+    struct Iterator : public ConstIterator
+    {
+        C&  operator*() const
+        {
+            OVR_ASSERT(!ConstIterator::IsEnd());
+            return const_cast<SelfType*>(ConstIterator::pHash)->pSlots[ConstIterator::Index];
+        }
+
+        C*  operator->() const
+        {
+            return &(operator*());
+        }
+
+        Iterator()
+            : ConstIterator(NULL, 0)
+        { }
+
+        // Removes the current value; the iterator can still be incremented.
+        void Remove()
+        {
+            OVR_ASSERT(!ConstIterator::IsEnd());
+            const_cast<SelfType*>(ConstIterator::pHash)->removeAt((size_t)ConstIterator::Index);
+        }
+
+        template <class K>
+        void RemoveAlt(const K& key)
+        {
+            OVR_ASSERT(operator*() == key);
+            OVR_UNUSED(key);
+            Remove();
+        }
+
+    private:
+        friend class FlatHashSet<C, HashF, AltHashF, Allocator>;
+
+        Iterator(SelfType* h, intptr_t i0)
+            : ConstIterator(h, i0)
+        { }
+    };
+
+    friend struct Iterator;
+
+    Iterator        Begin()         { return Iterator(this, nextFull(0)); }
+    Iterator        End()           { return Iterator(NULL, 0); }
+
+    ConstIterator   Begin() const   { return const_cast<SelfType*>(this)->Begin(); }
+    ConstIterator   End() const     { return const_cast<SelfType*>(this)->End(); }
+
+    template<class K>
+    Iterator Find(const K& key)
+    {
+        intptr_t index = findIndexCore(key, HashF()(key));
+        return (index >= 0) ? Iterator(this, index) : Iterator(NULL, 0);
+    }
+
+    template<class K>
+    Iterator FindAlt(const K& key)
+    {
+        intptr_t index = findIndexCore(key, AltHashF()(key));
+        return (index >= 0) ? Iterator(this, index) : Iterator(NULL, 0);
+    }
+
+    template<class K>
+    ConstIterator Find(const K& key) const       { return const_cast<SelfType*>(this)->Find(key); }
+
+    template<class K>
+    ConstIterator FindAlt(const K& key) const    { return const_cast<SelfType*>(this)->FindAlt(key); }
+
+private:
+    static size_t growthLimit(size_t capacity) { return capacity - capacity / 8; }
+
+    // Spreads the hash so that both the probe start (high bits) and the control byte
+    // (low 7 bits) depend on all of it.
+    static OVR_FORCE_INLINE size_t scramble(size_t hashValue)
+    {
+        uint64_t x = (uint64_t)hashValue * 0x9e3779b97f4a7c15ULL;
+        return (size_t)(x ^ (x >> 32));
+    }
+
+    static int8_t h2(size_t h) { return (int8_t)(h & 0x7F); }
+
+    // Control bytes are followed by a copy of the first Width of them, so that a group
+    // can be loaded at any slot index.
+    void setCtrl(size_t index, int8_t value)
+    {
+        pCtrl[index] = value;
+        if (index < (size_t)Width)
+            pCtrl[Capacity + index] = value;
+    }
+
+    intptr_t nextFull(intptr_t index) const
+    {
+        while ((size_t)index < Capacity && pCtrl[index] < 0)
+            index++;
+        return index;
+    }
+
+    template<class K>
+    intptr_t findIndexCore(const K& key, size_t hashValue) const
+    {
+        if (Size == 0)
+            return -1;
+
+        size_t h     = scramble(hashValue);
+        size_t mask  = Capacity - 1;
+        size_t pos   = (h >> 7) & mask;
+        int8_t match = h2(h);
+
+        for (size_t step = Width; ; step += Width)
+        {
+            FlatHashGroup group(pCtrl + pos);
+            for (MaskType m = group.Match(match); m; m &= m - 1)
+            {
+                size_t index = (pos + FlatHashGroup::LowestLane(m)) & mask;
+                if (pSlots[index] == key)
+                    return (intptr_t)index;
+            }
+            if (group.MatchEmpty())
+                return -1;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    // First empty or deleted slot on the probe sequence of h.
+    size_t findFree(size_t h) const
+    {
+        size_t mask = Capacity - 1;
+        size_t pos  = (h >> 7) & mask;
+
+        for (size_t step = Width; ; step += Width)
+        {
+            MaskType m = FlatHashGroup(pCtrl + pos).MatchFree();
+            if (m)
+                return (pos + FlatHashGroup::LowestLane(m)) & mask;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    template<class CRef>
+    void add(const CRef& key, size_t hashValue)
+    {
+        if (GrowthLeft == 0)
+        {
+            // Rebuild at the same size if deleted markers take most of the room.
+            size_t capacity = Capacity ? Capacity : (size_t)MinCapacity;
+            if (Size >= growthLimit(capacity) / 2)
+                capacity *= 2;
+            rehash(capacity);
+        }
+
+        size_t h     = scramble(hashValue);
+        size_t index = findFree(h);
+        if (pCtrl[index] == FlatHash_Empty)
+            GrowthLeft--;
+        setCtrl(index, h2(h));
+        new (&pSlots[index]) C(key);
+        Size++;
+    }
+
+    void removeAt(size_t index)
+    {
+        OVR_ASSERT(index < Capacity && pCtrl[index] >= 0);
+        pSlots[index].~C();
+        Size--;
+
+        // If every group containing the slot has an empty slot, no probe ever went past
+        // it and it can be marked empty again.
+        size_t   before      = (index - Width) & (Capacity - 1);
+        MaskType emptyAfter  = FlatHashGroup(pCtrl + index).MatchEmpty();
+        MaskType emptyBefore = FlatHashGroup(pCtrl + before).MatchEmpty();
+        bool     neverFull   = emptyBefore && emptyAfter &&
+                               ((Width - 1 - FlatHashGroup::HighestLane(emptyBefore)) +
+                                FlatHashGroup::LowestLane(emptyAfter)) < Width;
+
+        setCtrl(index, neverFull ? (int8_t)FlatHash_Empty : (int8_t)FlatHash_Deleted);
+        if (neverFull)
+            GrowthLeft++;
+    }
+
+    // Moves every value to a new table of the given capacity, a power of two.
+    void rehash(size_t capacity)
+    {
+        OVR_ASSERT(capacity >= (size_t)MinCapacity && (capacity & (capacity - 1)) == 0);
+
+        int8_t* oldCtrl     = pCtrl;
+        C*      oldSlots    = pSlots;
+        size_t  oldCapacity = Capacity;
+
+        // Capacity + Width is a multiple of 16, which keeps the slots aligned.
+        pCtrl = (int8_t*)Allocator::Alloc(capacity + Width + capacity * sizeof(C));
+        pSlots = (C*)(pCtrl + capacity + Width);
+        memset(pCtrl, FlatHash_Empty, capacity + Width);
+        Capacity   = capacity;
+        GrowthLeft = growthLimit(capacity) - Size;
+
+        for (size_t i = 0; i < oldCapacity; i++)
+        {
+            if (oldCtrl[i] >= 0)
+            {
+                size_t h     = scramble(HashF()(oldSlots[i]));
+                size_t index = findFree(h);
+                setCtrl(index, h2(h));
+                new (&pSlots[index]) C(oldSlots[i]);
+                oldSlots[i].~C();
+            }
+        }
+
+        if (oldCtrl)
+            Allocator::Free(oldCtrl);
+    }
+
+    int8_t* pCtrl;
+    C*      pSlots;
+    size_t  Capacity;   // 0, or a power of two of at least MinCapacity.
+    size_t  Size;
+    size_t  GrowthLeft; // Empty slots that can still be filled before a rebuild.
+};
+
+
+//-----------------------------------------------------------------------------------
+// ***** FlatHash
+
+// Hash stored in a FlatHashSet; a drop-in replacement for Hash<C, U> with the same
+// interface. Pointers to values and iterators are invalidated by inserts.
+
+template<class C, class U, class HashF = MixHash<C>, class Allocator = ContainerAllocator<C> >
+class FlatHash
+    : public Hash<C, U, HashF, Allocator, HashNode<C,U,HashF>,
+                  HashsetNodeEntry<HashNode<C,U,HashF>, typename HashNode<C,U,HashF>::NodeHashF>,
+                  FlatHashSet<HashNode<C,U,HashF>, typename HashNode<C,U,HashF>::NodeHashF,
+                              typename HashNode<C,U,HashF>::NodeAltHashF, Allocator> >
+{
+public:
+    typedef FlatHash<C, U, HashF, Allocator>                                    SelfType;
+    typedef Hash<C, U, HashF, Allocator, HashNode<C,U,HashF>,
+                 HashsetNodeEntry<HashNode<C,U,HashF>, typename HashNode<C,U,HashF>::NodeHashF>,
+                 FlatHashSet<HashNode<C,U,HashF>, typename HashNode<C,U,HashF>::NodeHashF,
+                             typename HashNode<C,U,HashF>::NodeAltHashF, Allocator> > BaseType;
+
+    // Delegated constructors.
+    FlatHash()                                            { }
+    FlatHash(int sizeHint) : BaseType(sizeHint)           { }
+    FlatHash(const SelfType& src) : BaseType(src)         { }
+    ~FlatHash()                                           { }
+    void operator = (const SelfType& src)                 { BaseType::operator = (src); }
+};
+
+
+} // namespace OVR
+
+#endif // OVR_FlatHash_h
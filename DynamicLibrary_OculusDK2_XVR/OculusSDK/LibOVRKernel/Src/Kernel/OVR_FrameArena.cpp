@@ -0,0 +1,354 @@
+/************************************************************************************
+
+Filename    :   OVR_FrameArena.cpp
+Content     :   Bump allocators for per-frame and scoped memory
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#include "OVR_FrameArena.h"
+#include "OVR_Std.h"
+#include <string.h>
+
+namespace OVR {
+
+
+static OVR_THREAD_LOCAL LinearArena* pCurrentArenaTLS = nullptr;
+
+
+//-----------------------------------------------------------------------------------
+// ***** LinearArena
+
+LinearArena::LinearArena(size_t blockSize)
+    : BlockSize(alignSize(blockSize)),
+      pFirst(nullptr),
+      pCurrent(nullptr),
+      pTop(nullptr),
+      pEnd(nullptr),
+      ScopeDepth(0)
+{
+}
+
+LinearArena::~LinearArena()
+{
+    OVR_ASSERT(pCurrentArenaTLS != this);
+
+    while (pFirst)
+    {
+        Block* next = pFirst->pNext;
+        OVR_FREE_ALIGNED(pFirst);
+        pFirst = next;
+    }
+}
+
+LinearArena::Block* LinearArena::allocBlock(size_t size)
+{
+    Block* block = (Block*)OVR_ALLOC_ALIGNED(HeaderSize + size, Alignment);
+    if (block)
+    {
+        block->pNext = nullptr;
+        block->Size  = size;
+    }
+    return block;
+}
+
+void LinearArena::setBlock(Block* block, char* top)
+{
+    pCurrent = block;
+    pTop     = top;
+    pEnd     = block->GetData() + block->Size;
+}
+
+void* LinearArena::Alloc(size_t size)
+{
+    size = alignSize(size);
+    if (size <= (size_t)(pEnd - pTop))
+    {
+        void* p = pTop;
+        pTop += size;
+        return p;
+    }
+    return allocSlow(size);
+}
+
+void* LinearArena::allocSlow(size_t size)
+{
+    // Blocks after the current one are left over from a Rewind; use the next one if it
+    // is big enough, otherwise put a new block in front of it.
+    Block* next = pCurrent ? pCurrent->pNext : pFirst;
+    if (!next || next->Size < size)
+    {
+        Block* block = allocBlock(Alg::Max(BlockSize, size));
+        if (!block)
+            return nullptr;
+        block->pNext = next;
+        if (pCurrent)
+            pCurrent->pNext = block;
+        else
+            pFirst = block;
+        next = block;
+    }
+
+    setBlock(next, next->GetData() + size);
+    return next->GetData();
+}
+
+void* LinearArena::Realloc(void* p, size_t oldSize, size_t newSize)
+{
+    if (!p)
+        return Alloc(newSize);
+
+    if (isLast(p, oldSize) && alignSize(newSize) <= (size_t)(pEnd - (char*)p))
+    {
+        pTop = (char*)p + alignSize(newSize);
+        return p;
+    }
+
+    void* newP = Alloc(newSize);
+    if (newP)
+        memcpy(newP, p, Alg::Min(oldSize, newSize));
+    return newP;
+}
+
+void LinearArena::Free(void* p, size_t size)
+{
+    if (p && isLast(p, size))
+        pTop = (char*)p;
+}
+
+void LinearArena::Reset()
+{
+    if (!pFirst)
+        return;
+
+    // A round that spilled into more blocks gets a single block of the combined size,
+    // so that the next round fits in it.
+    if (pFirst->pNext)
+    {
+        size_t total = 0;
+        while (pFirst)
+        {
+            Block* next = pFirst->pNext;
+            total += pFirst->Size;
+            OVR_FREE_ALIGNED(pFirst);
+            pFirst = next;
+        }
+
+        pFirst = allocBlock(total);
+        if (!pFirst)
+        {
+            pCurrent = nullptr;
+            pTop = pEnd = nullptr;
+            return;
+        }
+    }
+
+    setBlock(pFirst, pFirst->GetData());
+}
+
+LinearArena::Marker LinearArena::GetMarker() const
+{
+    Marker marker;
+    marker.pBlock = pCurrent;
+    marker.pTop   = pTop;
+    return marker;
+}
+
+void LinearArena::Rewind(const Marker& marker)
+{
+    if (marker.pBlock)
+    {
+        setBlock((Block*)marker.pBlock, marker.pTop);
+    }
+    else if (pFirst)
+    {
+        // Taken before the first allocation.
+        setBlock(pFirst, pFirst->GetData());
+    }
+}
+
+char* LinearArena::StrDup(const char* str)
+{
+    return StrDup(str, OVR_strlen(str));
+}
+
+char* LinearArena::StrDup(const char* str, size_t length)
+{
+    char* p = (char*)Alloc(length + 1);
+    if (p)
+    {
+        memcpy(p, str, length);
+        p[length] = 0;
+    }
+    return p;
+}
+
+char* LinearArena::Printf(const char* format, ...)
+{
+    va_list argList;
+    va_start(argList, format);
+    char* p = VPrintf(format, argList);
+    va_end(argList);
+    return p;
+}
+
+char* LinearArena::VPrintf(const char* format, va_list argList)
+{
+    // Format straight into the free space of the current block, and only if the text
+    // doesn't fit there allocate its exact size and format again.
+    va_list argListSaved;
+    OVR_VA_COPY(argListSaved, argList);
+
+    size_t space  = (size_t)(pEnd - pTop);
+    int    length = OVR_vsnprintf(pTop, space, format, argList);
+    char*  p      = nullptr;
+
+    if (length >= 0)
+    {
+        // If it fit, this returns the text already in place.
+        p = (char*)Alloc(length + 1);
+        if (p && (size_t)length >= space)
+            OVR_vsnprintf(p, length + 1, format, argListSaved);
+    }
+
+    va_end(argListSaved);
+    return p;
+}
+
+size_t LinearArena::GetUsedBytes() const
+{
+    if (!pCurrent)
+        return 0;
+
+    // The unused tail of a block left for a larger allocation counts as used.
+    size_t used = 0;
+    for (Block* block = pFirst; block != pCurrent; block = block->pNext)
+        used += block->Size;
+    return used + (size_t)(pTop - pCurrent->GetData());
+}
+
+size_t LinearArena::GetReservedBytes() const
+{
+    size_t reserved = 0;
+    for (Block* block = pFirst; block; block = block->pNext)
+        reserved += block->Size;
+    return reserved;
+}
+
+LinearArena* LinearArena::GetCurrent()
+{
+    return pCurrentArenaTLS;
+}
+
+void LinearArena::setCurrent(LinearArena* arena)
+{
+    pCurrentArenaTLS = arena;
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** ContainerAllocatorBase_Arena
+
+// Every allocation is preceded by a header naming the arena it came from (null for the
+// heap), the arena's scope depth then, and its size, which the arena needs to resize or
+// give back the block.
+struct ArenaAllocHeader
+{
+    LinearArena* pArena;
+    size_t       Size;
+    int          ScopeDepth;
+};
+
+static const size_t ArenaHeaderSize =
+    (sizeof(ArenaAllocHeader) + LinearArena::Alignment - 1) & ~(size_t)(LinearArena::Alignment - 1);
+
+static inline ArenaAllocHeader* getArenaHeader(void* p)
+{
+    return (ArenaAllocHeader*)((char*)p - ArenaHeaderSize);
+}
+
+void* ContainerAllocatorBase_Arena::Alloc(size_t size)
+{
+    LinearArena*      arena  = LinearArena::GetCurrent();
+    ArenaAllocHeader* header = arena ? (ArenaAllocHeader*)arena->Alloc(ArenaHeaderSize + size)
+                                     : (ArenaAllocHeader*)OVR_ALLOC(ArenaHeaderSize + size);
+    if (!header)
+        return nullptr;
+
+    header->pArena     = arena;
+    header->Size       = size;
+    header->ScopeDepth = arena ? arena->GetScopeDepth() : 0;
+    return (char*)header + ArenaHeaderSize;
+}
+
+void* ContainerAllocatorBase_Arena::Realloc(void* p, size_t newSize)
+{
+    if (!p)
+        return Alloc(newSize);
+
+    ArenaAllocHeader* header = getArenaHeader(p);
+    LinearArena*      arena  = header->pArena;
+    if (!arena)
+    {
+        header = (ArenaAllocHeader*)OVR_REALLOC(header, ArenaHeaderSize + newSize);
+    }
+    else if (arena->GetScopeDepth() == header->ScopeDepth)
+    {
+        header = (ArenaAllocHeader*)arena->Realloc(header, ArenaHeaderSize + header->Size,
+                                                   ArenaHeaderSize + newSize);
+    }
+    else if (newSize <= header->Size)
+    {
+        // Shrinking keeps the block where it is.
+    }
+    else
+    {
+        // A scratch scope was opened on the arena after p was allocated; p outlives it.
+        ArenaAllocHeader* heapHeader = (ArenaAllocHeader*)OVR_ALLOC(ArenaHeaderSize + newSize);
+        if (heapHeader)
+        {
+            memcpy((char*)heapHeader + ArenaHeaderSize, p, header->Size);
+            heapHeader->pArena     = nullptr;
+            heapHeader->ScopeDepth = 0;
+        }
+        header = heapHeader;
+    }
+    if (!header)
+        return nullptr;
+
+    header->Size = newSize;
+    return (char*)header + ArenaHeaderSize;
+}
+
+void ContainerAllocatorBase_Arena::Free(void *p)
+{
+    if (!p)
+        return;
+
+    ArenaAllocHeader* header = getArenaHeader(p);
+    if (!header->pArena)
+        OVR_FREE(header);
+    else if (header->pArena->GetScopeDepth() == header->ScopeDepth)
+        header->pArena->Free(header, ArenaHeaderSize + header->Size);
+}
+
+
+} // namespace OVR
@@ -0,0 +1,323 @@
+/************************************************************************************
+
+PublicHeader:   OVR_Kernel.h
+Filename    :   OVR_FrameArena.h
+Content     :   Bump allocators for per-frame and scoped memory, and container
+                allocators that place Array and Hash storage in them
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#ifndef OVR_FrameArena_h
+#define OVR_FrameArena_h
+
+#include "OVR_Types.h"
+#include "OVR_Allocator.h"
+#include "OVR_Alg.h"
+#include "OVR_ContainerAllocator.h"
+#include "OVR_Array.h"
+#include "OVR_Hash.h"
+#include <stdarg.h>
+
+namespace OVR {
+
+
+//-----------------------------------------------------------------------------------
+// ***** LinearArena
+
+// LinearArena hands out memory by bumping a pointer through a list of blocks taken
+// from the kernel allocator. Individual allocations are not freed; the arena is
+// emptied at once by Reset, or back to a marker by Rewind. The last allocation can
+// still be grown or given back in place, which is what growing arrays need.
+//
+// Blocks are kept across Reset. If a round needed more than one block, Reset replaces
+// them with a single block large enough for all of it, so once an arena has seen its
+// high-water mark it makes no more heap calls.
+//
+// An arena is used by one thread at a time.
+
+class LinearArena : public NewOverrideBase
+{
+public:
+    enum {
+        Alignment        = 16,
+        DefaultBlockSize = 64 * 1024
+    };
+
+    // A position in the arena, for Rewind.
+    struct Marker
+    {
+        void* pBlock;
+        char* pTop;
+    };
+
+    LinearArena(size_t blockSize = DefaultBlockSize);
+    ~LinearArena();
+
+    // Returns Alignment-aligned memory; size 0 returns a valid pointer.
+    void*   Alloc(size_t size);
+
+    // Resizes p, previously returned with oldSize. If p is the last allocation it is
+    // resized in place when it fits, otherwise the data is copied to a new allocation.
+    // Either way the result lands at the top of the arena, so p must not predate a
+    // rewinding ArenaScope that is still open on this arena.
+    void*   Realloc(void* p, size_t oldSize, size_t newSize);
+
+    // Gives the memory back if p is the last allocation; otherwise does nothing.
+    void    Free(void* p, size_t size);
+
+    // Releases every allocation.
+    void    Reset();
+
+    Marker  GetMarker() const;
+    // Releases every allocation made since marker was taken.
+    void    Rewind(const Marker& marker);
+
+    // Copies of strings in arena memory, for text that lives as long as the arena.
+    char*   StrDup(const char* str);
+    char*   StrDup(const char* str, size_t length);
+    char*   Printf(const char* format, ...);
+    char*   VPrintf(const char* format, va_list argList);
+
+    // Bytes handed out since the last Reset, and bytes held in blocks.
+    size_t  GetUsedBytes() const;
+    size_t  GetReservedBytes() const;
+
+    // Number of rewinding ArenaScopes open on this arena.
+    int     GetScopeDepth() const { return ScopeDepth; }
+
+    // The arena that ArenaScope made current on the calling thread, or null.
+    static LinearArena* GetCurrent();
+
+private:
+    friend class ArenaScope;
+
+    struct Block
+    {
+        Block* pNext;
+        size_t Size;    // Bytes of data following the header.
+
+        char*  GetData() { return (char*)this + HeaderSize; }
+    };
+
+    enum { HeaderSize = (sizeof(Block) + Alignment - 1) & ~(Alignment - 1) };
+
+    // Sizes are rounded up to keep every allocation aligned; 0 takes one unit.
+    static size_t alignSize(size_t size)
+    { return size ? (size + Alignment - 1) & ~(size_t)(Alignment - 1) : (size_t)Alignment; }
+
+    static Block* allocBlock(size_t size);
+    void*   allocSlow(size_t size);
+    void    setBlock(Block* block, char* top);
+    bool    isLast(const void* p, size_t size) const
+    { return (char*)p + alignSize(size) == pTop; }
+
+    static void setCurrent(LinearArena* arena);
+
+    size_t  BlockSize;
+    Block*  pFirst;
+    Block*  pCurrent;
+    char*   pTop;
+    char*   pEnd;
+    int     ScopeDepth;
+
+    // Not copyable.
+    LinearArena(const LinearArena&);
+    void operator = (const LinearArena&);
+};
+
+
+//-----------------------------------------------------------------------------------
+// ***** FrameArena
+
+// FrameArena is a pair of LinearArenas used in turns, one per frame. BeginFrame
+// switches to the other arena and resets it, so memory allocated in a frame stays
+// valid through the next one; data can be handed from one frame to the next (to a
+// render thread running a frame behind, for instance) without copies.
+
+class FrameArena : public NewOverrideBase
+{
+public:
+    FrameArena(size_t blockSize = LinearArena::DefaultBlockSize)
+        : ArenaA(blockSize), ArenaB(blockSize), pCurrent(&ArenaA), pPrevious(&ArenaB) { }
+
+    // Starts a new frame; memory from two frames ago is released.
+    void BeginFrame()
+    {
+        Alg::Swap(pCurrent, pPrevious);
+        pCurrent->Reset();
+    }
+
+    LinearArena& GetCurrent()  { return *pCurrent; }
+    LinearArena& GetPrevious() { return *pPrevious; }
+
+    void* Alloc(size_t size)   { return pCurrent->Alloc(size); }
+
+    template<class T>
+    T*    AllocArray(size_t count) { return (T*)pCurrent->Alloc(sizeof(T) * count); }
+
+private:
+    LinearArena  ArenaA;
+    LinearArena  ArenaB;
+    LinearArena* pCurrent;
+    LinearArena* pPrevious;
+};
+
+
+//-----------------------------------------------------------------------------------
+// ***** ArenaScope
+
+// ArenaScope makes arena the current arena of the calling thread until it goes out of
+// scope, when the previous one is restored. The arena containers below allocate from
+// the current arena.
+//
+// With rewind set, the arena is also rewound to where it was when the scope was
+// entered, which makes a scratch scope: containers declared after the ArenaScope are
+// destroyed before it and their memory is given back. Without it the allocations stay
+// in the arena, e.g. in a frame arena until it is reset.
+
+class ArenaScope
+{
+public:
+    ArenaScope(LinearArena& arena, bool rewind = true)
+        : pArena(&arena), pPrevious(LinearArena::GetCurrent()), Rewind(rewind)
+    {
+        Start = arena.GetMarker();
+        if (Rewind)
+            arena.ScopeDepth++;
+        LinearArena::setCurrent(pArena);
+    }
+    ~ArenaScope()
+    {
+        LinearArena::setCurrent(pPrevious);
+        if (Rewind)
+        {
+            pArena->Rewind(Start);
+            pArena->ScopeDepth--;
+        }
+    }
+
+private:
+    LinearArena*        pArena;
+    LinearArena*        pPrevious;
+    LinearArena::Marker Start;
+    bool                Rewind;
+
+    ArenaScope(const ArenaScope&);
+    void operator = (const ArenaScope&);
+};
+
+
+//-----------------------------------------------------------------------------------
+// ***** Arena Container Allocators
+
+// Allocator policies for Array and Hash that take memory from the current arena of the
+// calling thread, or from the heap if there is none. Each allocation records the arena
+// it came from and the arena's scope depth at the time. A container can be freed from
+// any scope. It is resized in its own arena only while no newer rewinding scope is open
+// on that arena; inside such a scope the grown memory would sit above the scope's
+// marker and be reused once it rewinds, so growing there moves the container to the heap.
+//
+// Arena memory is not owned by the container: a container must not outlive the arena
+// scope or frame it allocated in.
+
+class ContainerAllocatorBase_Arena
+{
+public:
+    static void* Alloc(size_t size);
+    static void* Realloc(void* p, size_t newSize);
+    static void  Free(void *p);
+};
+
+template<class T>
+class ContainerAllocator_Arena : public ContainerAllocatorBase_Arena, public ConstructorMov<T>
+{
+};
+
+template<class T>
+class ContainerAllocator_ArenaPOD : public ContainerAllocatorBase_Arena, public ConstructorPOD<T>
+{
+};
+
+
+// Arrays and hashes that allocate from the current arena.
+
+template<class T, class SizePolicy=ArrayDefaultPolicy>
+class ArrayArena : public ArrayBase<ArrayData<T, ContainerAllocator_Arena<T>, SizePolicy> >
+{
+public:
+    typedef T                                                                   ValueType;
+    typedef ContainerAllocator_Arena<T>                                         AllocatorType;
+    typedef SizePolicy                                                          SizePolicyType;
+    typedef ArrayArena<T, SizePolicy>                                           SelfType;
+    typedef ArrayBase<ArrayData<T, ContainerAllocator_Arena<T>, SizePolicy> >  BaseType;
+
+    ArrayArena() : BaseType() {}
+    explicit ArrayArena(size_t size) : BaseType(size) {}
+    ArrayArena(const SizePolicyType& p) : BaseType() { SetSizePolicy(p); }
+    ArrayArena(const SelfType& a) : BaseType(a) {}
+    const SelfType& operator=(const SelfType& a) { BaseType::operator=(a); return *this; }
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    ArrayArena(SelfType&& a) : BaseType(std::move(a)) {}
+    const SelfType& operator=(SelfType&& a) { BaseType::operator=(std::move(a)); return *this; }
+#endif
+};
+
+template<class T, class SizePolicy=ArrayDefaultPolicy>
+class ArrayArenaPOD : public ArrayBase<ArrayData<T, ContainerAllocator_ArenaPOD<T>, SizePolicy> >
+{
+public:
+    typedef T                                                                     ValueType;
+    typedef ContainerAllocator_ArenaPOD<T>                                        AllocatorType;
+    typedef SizePolicy                                                            SizePolicyType;
+    typedef ArrayArenaPOD<T, SizePolicy>                                          SelfType;
+    typedef ArrayBase<ArrayData<T, ContainerAllocator_ArenaPOD<T>, SizePolicy> > BaseType;
+
+    ArrayArenaPOD() : BaseType() {}
+    explicit ArrayArenaPOD(size_t size) : BaseType(size) {}
+    ArrayArenaPOD(const SizePolicyType& p) : BaseType() { SetSizePolicy(p); }
+    ArrayArenaPOD(const SelfType& a) : BaseType(a) {}
+    const SelfType& operator=(const SelfType& a) { BaseType::operator=(a); return *this; }
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    ArrayArenaPOD(SelfType&& a) : BaseType(std::move(a)) {}
+    const SelfType& operator=(SelfType&& a) { BaseType::operator=(std::move(a)); return *this; }
+#endif
+};
+
+template<class C, class U, class HashF = FixedSizeHash<C> >
+class HashArena : public Hash<C, U, HashF, ContainerAllocator_Arena<C> >
+{
+public:
+    typedef HashArena<C, U, HashF>                       SelfType;
+    typedef Hash<C, U, HashF, ContainerAllocator_Arena<C> > BaseType;
+
+    // Delegated constructors.
+    HashArena()                                           { }
+    HashArena(int sizeHint) : BaseType(sizeHint)          { }
+    HashArena(const SelfType& src) : BaseType(src)        { }
+    ~HashArena()                                          { }
+    void operator = (const SelfType& src)                 { BaseType::operator = (src); }
+};
+
+
+} // namespace OVR
+
+#endif // OVR_FrameArena_h
@@ -0,0 +1,503 @@
+/************************************************************************************
+
+Filename    :   OVR_HeapProfiler.cpp
+Content     :   Sampling heap profiler attributing allocations to call sites
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#include "OVR_HeapProfiler.h"
+#include "OVR_DebugHelp.h"
+#include "OVR_Timer.h"
+#include "OVR_JSON.h"
+#include "OVR_Array.h"
+#include "OVR_Std.h"
+#include <math.h>
+#include <string.h>
+
+namespace OVR {
+
+
+struct ThreadSampler
+{
+    int64_t  BytesLeft;
+    uint32_t Seed;      // 0 until the thread first allocates.
+};
+
+static OVR_THREAD_LOCAL ThreadSampler SamplerTLS;
+
+static SymbolLookup ProfilerSymbols;
+
+
+struct HeapProfiler::LiveSample
+{
+    void*  Ptr;
+    int    Site;
+    size_t Size;
+    double Weight;
+    double Time;
+};
+
+
+static uint32_t hashPointer(const void* p)
+{
+    uint64_t key = (uint64_t)(uintptr_t)p;
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (uint32_t)key;
+}
+
+// Exponentially distributed distance to the next sample, with mean interval.
+static int64_t nextSampleDistance(uint32_t& seed, size_t interval)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    double u = ((seed >> 8) + 1) / 16777216.0;     // (0, 1]
+    int64_t distance = (int64_t)(-log(u) * (double)interval);
+    return (distance > 0) ? distance : 1;
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** HeapProfiler
+
+HeapProfiler::HeapProfiler(Allocator* target, size_t sampleInterval, bool captureBacktraces)
+    : pTarget(target ? target : &DefaultTarget),
+      SampleInterval(sampleInterval),
+      CaptureBacktraces(false),
+      SiteCount(0),
+      LiveSampleCount(0),
+      DroppedSamples(0)
+{
+    // Zero-filled by the OS.
+    pSites     = (SiteStats*)SafeMMapAlloc(MaxSites * sizeof(SiteStats));
+    pSiteIndex = (uint16_t*)SafeMMapAlloc(SiteIndexSize * sizeof(uint16_t));
+    pSamples   = (LiveSample*)SafeMMapAlloc(SampleTableSize * sizeof(LiveSample));
+
+    pSites[MaxSites - 1].File = "(other sites)";
+
+    SetCaptureBacktraces(captureBacktraces);
+}
+
+HeapProfiler::~HeapProfiler()
+{
+    SetCaptureBacktraces(false);
+
+    SafeMMapFree(pSites, MaxSites * sizeof(SiteStats));
+    SafeMMapFree(pSiteIndex, SiteIndexSize * sizeof(uint16_t));
+    SafeMMapFree(pSamples, SampleTableSize * sizeof(LiveSample));
+}
+
+void HeapProfiler::SetSampleInterval(size_t sampleInterval)
+{
+    SampleInterval = sampleInterval;
+}
+
+void HeapProfiler::SetCaptureBacktraces(bool enabled)
+{
+    if (enabled == CaptureBacktraces)
+        return;
+
+    if (enabled)
+    {
+        if (!SymbolLookup::Initialize())
+            return;
+        ProfilerSymbols.Refresh();
+    }
+    else
+    {
+        SymbolLookup::Shutdown();
+    }
+    CaptureBacktraces = enabled;
+}
+
+void* HeapProfiler::Alloc(size_t size)
+{
+    return AllocDebug(size, nullptr, 0);
+}
+
+void* HeapProfiler::AllocDebug(size_t size, const char* file, unsigned line)
+{
+    void*  p = pTarget->AllocDebug(size, file, line);
+    double weight;
+    if (p && shouldSample(size, weight))
+        recordAlloc(p, size, weight, file, line);
+    return p;
+}
+
+void* HeapProfiler::Realloc(void* p, size_t newSize)
+{
+    if (!p)
+        return Alloc(newSize);
+
+    // The new block is a new allocation; if the old one was sampled its site takes it.
+    // The old sample goes only once the realloc has succeeded, since a failed realloc
+    // leaves the block live. The lock is held across the call so that no other thread
+    // can record a new block at the address the realloc freed before it is gone.
+    const char* file = nullptr;
+    unsigned    line = 0;
+    void*       newP;
+    if (maybeSampled(p))
+    {
+        double now = Timer::GetSeconds();
+
+        Lock::Locker locker(&ProfileLock);
+        newP = pTarget->Realloc(p, newSize);
+        if (newP)
+            removeSample(p, now, &file, &line);
+    }
+    else
+    {
+        newP = pTarget->Realloc(p, newSize);
+    }
+
+    double weight;
+    if (newP && shouldSample(newSize, weight))
+        recordAlloc(newP, newSize, weight, file, line);
+    return newP;
+}
+
+void HeapProfiler::Free(void *p)
+{
+    if (p && maybeSampled(p))
+        recordFree(p, nullptr, nullptr);
+    pTarget->Free(p);
+}
+
+void* HeapProfiler::AllocAligned(size_t size, size_t align)
+{
+    void*  p = pTarget->AllocAligned(size, align);
+    double weight;
+    if (p && shouldSample(size, weight))
+        recordAlloc(p, size, weight, nullptr, 0);
+    return p;
+}
+
+void HeapProfiler::FreeAligned(void* p)
+{
+    if (p && maybeSampled(p))
+        recordFree(p, nullptr, nullptr);
+    pTarget->FreeAligned(p);
+}
+
+uint32_t HeapProfiler::filterSlot(const void* p)
+{
+    return hashPointer(p) & (FilterSize - 1);
+}
+
+bool HeapProfiler::shouldSample(size_t size, double& weight)
+{
+    size_t interval = SampleInterval;
+    if (interval == 0)
+    {
+        weight = 1.0;
+        return true;
+    }
+
+    ThreadSampler& sampler = SamplerTLS;
+    if (sampler.Seed == 0)
+    {
+        sampler.Seed      = hashPointer(&sampler) | 1;
+        sampler.BytesLeft = nextSampleDistance(sampler.Seed, interval);
+    }
+
+    sampler.BytesLeft -= (int64_t)size;
+    if (sampler.BytesLeft > 0)
+        return false;
+
+    sampler.BytesLeft = nextSampleDistance(sampler.Seed, interval);
+
+    // An allocation of size bytes is sampled with probability 1 - exp(-size / interval);
+    // it stands for the inverse of that many allocations.
+    double sizeD = (size > 0) ? (double)size : 1.0;
+    weight = 1.0 / (1.0 - exp(-sizeD / (double)interval));
+    return true;
+}
+
+void HeapProfiler::recordAlloc(void* p, size_t size, double weight, const char* file, unsigned line)
+{
+    void* callstack[MaxFrames];
+    int   frameCount = 0;
+    if (CaptureBacktraces)
+        frameCount = (int)ProfilerSymbols.GetBacktrace(callstack, MaxFrames, 3);
+
+    double now = Timer::GetSeconds();
+
+    Lock::Locker locker(&ProfileLock);
+
+    SiteStats& site = pSites[findSite(file, line, callstack, frameCount)];
+    site.Samples++;
+    site.AllocCount += weight;
+    site.AllocBytes += weight * (double)size;
+
+    if (LiveSampleCount >= MaxLiveSamples)
+    {
+        DroppedSamples++;
+        return;
+    }
+
+    site.LiveCount += weight;
+    site.LiveBytes += weight * (double)size;
+
+    uint32_t mask = SampleTableSize - 1;
+    uint32_t i    = hashPointer(p) & mask;
+    while (pSamples[i].Ptr)
+        i = (i + 1) & mask;
+
+    LiveSample& sample = pSamples[i];
+    sample.Ptr    = p;
+    sample.Site   = (int)(&site - pSites);
+    sample.Size   = size;
+    sample.Weight = weight;
+    sample.Time   = now;
+    LiveSampleCount++;
+
+    FilterCounts[filterSlot(p)].ExchangeAdd_Sync(1);
+}
+
+void HeapProfiler::recordFree(void* p, const char** file, unsigned* line)
+{
+    double now = Timer::GetSeconds();
+
+    Lock::Locker locker(&ProfileLock);
+    removeSample(p, now, file, line);
+}
+
+void HeapProfiler::removeSample(void* p, double now, const char** file, unsigned* line)
+{
+    uint32_t mask = SampleTableSize - 1;
+    uint32_t i    = hashPointer(p) & mask;
+    while (pSamples[i].Ptr != p)
+    {
+        // Another pointer with the same filter slot.
+        if (!pSamples[i].Ptr)
+            return;
+        i = (i + 1) & mask;
+    }
+
+    LiveSample& sample = pSamples[i];
+    SiteStats&  site   = pSites[sample.Site];
+    site.LiveCount     -= sample.Weight;
+    site.LiveBytes     -= sample.Weight * (double)sample.Size;
+    site.FreedSamples++;
+    site.TotalLifetime += now - sample.Time;
+    if (file)
+    {
+        *file = site.File;
+        *line = site.Line;
+    }
+
+    // Backward-shift deletion keeps the probe sequences intact without tombstones.
+    uint32_t j = i;
+    for (;;)
+    {
+        j = (j + 1) & mask;
+        if (!pSamples[j].Ptr)
+            break;
+        uint32_t home = hashPointer(pSamples[j].Ptr) & mask;
+        bool     movable = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+        if (movable)
+        {
+            pSamples[i] = pSamples[j];
+            i = j;
+        }
+    }
+    pSamples[i].Ptr = nullptr;
+    LiveSampleCount--;
+
+    FilterCounts[filterSlot(p)].ExchangeAdd_Sync(-1);
+}
+
+int HeapProfiler::findSite(const char* file, unsigned line, void** callstack, int frameCount)
+{
+    uint32_t hash = hashPointer(file) ^ (line * 0x9e3779b9u);
+    for (int f = 0; f < frameCount; f++)
+        hash = (hash * 31) ^ hashPointer(callstack[f]);
+
+    uint32_t mask = SiteIndexSize - 1;
+    uint32_t i    = hash & mask;
+    for (; pSiteIndex[i]; i = (i + 1) & mask)
+    {
+        SiteStats& site = pSites[pSiteIndex[i] - 1];
+        if (site.File == file && site.Line == line && site.FrameCount == frameCount &&
+            memcmp(site.Callstack, callstack, frameCount * sizeof(void*)) == 0)
+        {
+            return pSiteIndex[i] - 1;
+        }
+    }
+
+    if (SiteCount >= MaxSites - 1)
+        return MaxSites - 1;
+
+    SiteStats& site = pSites[SiteCount];
+    site.File       = file;
+    site.Line       = line;
+    site.FrameCount = frameCount;
+    memcpy(site.Callstack, callstack, frameCount * sizeof(void*));
+    pSiteIndex[i] = (uint16_t)++SiteCount;
+    return SiteCount - 1;
+}
+
+void HeapProfiler::Reset()
+{
+    Lock::Locker locker(&ProfileLock);
+
+    for (int i = 0; i < MaxSites; i++)
+    {
+        SiteStats& site   = pSites[i];
+        site.Samples       = 0;
+        site.AllocCount    = 0.0;
+        site.AllocBytes    = 0.0;
+        site.FreedSamples  = 0;
+        site.TotalLifetime = 0.0;
+    }
+    DroppedSamples = 0;
+}
+
+static double getSortValue(const HeapProfiler::SiteStats& site, HeapProfiler::SortKey key)
+{
+    switch (key)
+    {
+    case HeapProfiler::Sort_AllocCount: return site.AllocCount;
+    case HeapProfiler::Sort_LiveBytes:  return site.LiveBytes;
+    default:                            return site.AllocBytes;
+    }
+}
+
+int HeapProfiler::GetTopSites(SiteStats* sites, int count, SortKey key)
+{
+    Lock::Locker locker(&ProfileLock);
+
+    // Insertion into a sorted list of count entries; count is small.
+    int found = 0;
+    for (int i = 0; i < MaxSites; i++)
+    {
+        if (i == SiteCount)
+            i = MaxSites - 1;
+
+        double value = getSortValue(pSites[i], key);
+        if (value <= 0.5)
+            continue;
+
+        int pos = found;
+        while (pos > 0 && getSortValue(sites[pos - 1], key) < value)
+            pos--;
+        if (pos >= count)
+            continue;
+
+        int last = (found < count) ? found : count - 1;
+        memmove(sites + pos + 1, sites + pos, (last - pos) * sizeof(SiteStats));
+        sites[pos] = pSites[i];
+        if (found < count)
+            found++;
+    }
+    return found;
+}
+
+JSON* HeapProfiler::createReport(int count, SortKey key)
+{
+    ArrayPOD<SiteStats> top;
+    top.Resize(count);
+    int found = (count > 0) ? GetTopSites(&top[0], count, key) : 0;
+
+    const bool symbolLookupWasInitialized = SymbolLookup::IsInitialized();
+    const bool symbolLookupAvailable = SymbolLookup::Initialize();
+    if (!symbolLookupWasInitialized)
+        ProfilerSymbols.Refresh();
+
+    static const char* keyNames[] = { "allocBytes", "allocCount", "liveBytes" };
+
+    JSON* report = JSON::CreateObject();
+    report->AddNumberItem("sampleInterval", (double)SampleInterval);
+    report->AddStringItem("sortedBy", keyNames[key]);
+    report->AddNumberItem("droppedSamples", (double)DroppedSamples);
+
+    JSON* sites = JSON::CreateArray();
+    for (int i = 0; i < found; i++)
+    {
+        const SiteStats& stats = top[i];
+
+        JSON* site = JSON::CreateObject();
+        site->AddStringItem("file", stats.File ? stats.File : "");
+        site->AddIntItem("line", (int)stats.Line);
+        site->AddNumberItem("samples", (double)stats.Samples);
+        site->AddNumberItem("allocCount", floor(stats.AllocCount + 0.5));
+        site->AddNumberItem("allocBytes", floor(stats.AllocBytes + 0.5));
+        site->AddNumberItem("liveCount", floor(stats.LiveCount + 0.5));
+        site->AddNumberItem("liveBytes", floor(stats.LiveBytes + 0.5));
+        site->AddNumberItem("averageLifetimeMs", stats.GetAverageLifetime() * 1000.0);
+
+        if (stats.FrameCount)
+        {
+            JSON* callstack = JSON::CreateArray();
+            for (int f = 0; f < stats.FrameCount; f++)
+            {
+                char       frame[OVR_MAX_PATH + 160];
+                SymbolInfo symbolInfo;
+
+                if (symbolLookupAvailable && ProfilerSymbols.LookupSymbol((uint64_t)stats.Callstack[f], symbolInfo) &&
+                    (symbolInfo.filePath[0] || symbolInfo.function[0]))
+                {
+                    if (symbolInfo.filePath[0])
+                        OVR_sprintf(frame, sizeof(frame), "%s(%d): %s", symbolInfo.filePath, symbolInfo.fileLineNumber,
+                                    symbolInfo.function[0] ? symbolInfo.function : "(unknown function)");
+                    else
+                        OVR_sprintf(frame, sizeof(frame), "%p: %s", stats.Callstack[f], symbolInfo.function);
+                }
+                else
+                {
+                    OVR_sprintf(frame, sizeof(frame), "%p", stats.Callstack[f]);
+                }
+                callstack->AddArrayString(frame);
+            }
+            site->AddItem("callstack", callstack);
+        }
+
+        sites->AddArrayElement(site);
+    }
+    report->AddItem("sites", sites);
+
+    if (!symbolLookupWasInitialized && symbolLookupAvailable)
+        SymbolLookup::Shutdown();
+
+    return report;
+}
+
+String HeapProfiler::GetReportJSON(int count, SortKey key)
+{
+    JSON*  report = createReport(count, key);
+    String text   = report->Stringify(true);
+    report->Release();
+    return text;
+}
+
+bool HeapProfiler::SaveReportJSON(const char* path, int count, SortKey key)
+{
+    JSON* report = createReport(count, key);
+    bool  saved  = report->Save(path);
+    report->Release();
+    return saved;
+}
+
+
+} // namespace OVR
@@ -0,0 +1,174 @@
+/************************************************************************************
+
+PublicHeader:   OVR_Kernel.h
+Filename    :   OVR_HeapProfiler.h
+Content     :   Sampling heap profiler attributing allocations to call sites
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#ifndef OVR_HeapProfiler_h
+#define OVR_HeapProfiler_h
+
+#include "OVR_Types.h"
+#include "OVR_Allocator.h"
+#include "OVR_Atomic.h"
+#include "OVR_String.h"
+
+namespace OVR {
+
+class JSON;
+
+
+//-----------------------------------------------------------------------------------
+// ***** HeapProfiler
+
+// HeapProfiler is an Allocator that forwards to another one and attributes a sample of
+// the allocations to their call sites: how many allocations and bytes each site makes,
+// how many are still live, and how long the freed ones lived. Install it with
+// System::Init(log, &profiler) before any other kernel object is created.
+//
+// A call site is the file and line passed to AllocDebug, plus the backtrace if
+// backtrace capture is on. OVR_ALLOC passes them in debug builds, or in any build
+// compiled with OVR_HEAP_PROFILER defined. Allocations made through containers all
+// share the file and line of ContainerAllocator, so backtraces are needed to tell
+// those apart.
+//
+// Sampling is by bytes: each thread counts down a random number of bytes with mean
+// SampleInterval and samples the allocation that reaches zero, so big allocations are
+// always seen and small ones are seen in proportion to their size. Unsampled
+// allocations cost a thread-local subtraction. Counts reported for a site are
+// estimates scaled up from its samples. A SampleInterval of 0 records every
+// allocation exactly.
+//
+// Free needs to know whether a pointer was sampled; a small table of counters hashed
+// by address tells it without locking in almost all cases.
+
+class HeapProfiler : public Allocator
+{
+public:
+    enum {
+        MaxSites              = 4096,         // The last site collects whatever doesn't fit.
+        MaxLiveSamples        = 65536,        // Sampled allocations tracked for lifetime.
+        MaxFrames             = 16,
+        DefaultSampleInterval = 512 * 1024
+    };
+
+    struct SiteStats
+    {
+        const char* File;               // Null when the allocation came without one.
+        unsigned    Line;
+        int         FrameCount;
+        void*       Callstack[MaxFrames];
+
+        uint64_t    Samples;
+        double      AllocCount;         // Estimated allocations and bytes since Reset.
+        double      AllocBytes;
+        double      LiveCount;          // Estimated allocations and bytes not yet freed.
+        double      LiveBytes;
+        uint64_t    FreedSamples;
+        double      TotalLifetime;      // Seconds, summed over FreedSamples.
+
+        double      GetAverageLifetime() const
+        { return FreedSamples ? TotalLifetime / (double)FreedSamples : 0.0; }
+    };
+
+    enum SortKey
+    {
+        Sort_AllocBytes,
+        Sort_AllocCount,
+        Sort_LiveBytes
+    };
+
+    // target is the allocator doing the work; null uses a DefaultAllocator.
+    HeapProfiler(Allocator* target = nullptr, size_t sampleInterval = DefaultSampleInterval,
+                 bool captureBacktraces = false);
+    virtual ~HeapProfiler();
+
+    virtual void*   Alloc(size_t size);
+    virtual void*   AllocDebug(size_t size, const char* file, unsigned line);
+    virtual void*   Realloc(void* p, size_t newSize);
+    virtual void    Free(void *p);
+    virtual void*   AllocAligned(size_t size, size_t align);
+    virtual void    FreeAligned(void* p);
+
+    // Sampling can be changed while running; threads pick up a new interval with
+    // their next sample.
+    void            SetSampleInterval(size_t sampleInterval);
+    size_t          GetSampleInterval() const { return SampleInterval; }
+    void            SetCaptureBacktraces(bool enabled);
+
+    // Clears the allocation counts and lifetimes of every site, e.g. between a scene
+    // load and the frames after it. Live allocations are still tracked.
+    void            Reset();
+
+    // Copies the count sites that rank highest by key into sites, and returns how
+    // many were copied.
+    int             GetTopSites(SiteStats* sites, int count, SortKey key = Sort_AllocBytes);
+
+    // Top sites as a JSON document; callstacks are symbolized when symbols are
+    // available.
+    String          GetReportJSON(int count = 20, SortKey key = Sort_AllocBytes);
+    bool            SaveReportJSON(const char* path, int count = 20, SortKey key = Sort_AllocBytes);
+
+private:
+    struct LiveSample;
+
+    bool            shouldSample(size_t size, double& weight);
+    void            recordAlloc(void* p, size_t size, double weight, const char* file, unsigned line);
+    void            recordFree(void* p, const char** file, unsigned* line);
+    void            removeSample(void* p, double now, const char** file, unsigned* line); // ProfileLock held
+    bool            maybeSampled(const void* p) const
+    { return FilterCounts[filterSlot(p)].Load_Acquire() != 0; }
+
+    JSON*           createReport(int count, SortKey key);
+    int             findSite(const char* file, unsigned line, void** callstack, int frameCount);
+    static uint32_t filterSlot(const void* p);
+
+    enum {
+        FilterSize        = 16384,
+        SiteIndexSize     = MaxSites * 2,
+        SampleTableSize   = MaxLiveSamples * 2
+    };
+
+    DefaultAllocator  DefaultTarget;
+    Allocator*        pTarget;
+    volatile size_t   SampleInterval;
+    volatile bool     CaptureBacktraces;
+
+    // Counts of sampled live pointers per address hash, checked by Free without locking.
+    AtomicInt<int>    FilterCounts[FilterSize];
+
+    // Guarded by ProfileLock; kept in pages from SafeMMapAlloc so that the profiler
+    // never allocates through itself.
+    Lock              ProfileLock;
+    SiteStats*        pSites;
+    int               SiteCount;
+    uint16_t*         pSiteIndex;       // Open-addressed; site index + 1, 0 when empty.
+    LiveSample*       pSamples;         // Open-addressed by pointer.
+    int               LiveSampleCount;
+    uint64_t          DroppedSamples;   // Samples not tracked because the table was full.
+};
+
+
+} // namespace OVR
+
+#endif // OVR_HeapProfiler_h
@@ -57,86 +57,324 @@ limitations under the License.
 #include <limits.h>
 #include <ctype.h>
 #include "OVR_JSON.h"
+#include "OVR_JSONStream.h"
+#include "OVR_JSONBinary.h"
+#include "OVR_MappedFile.h"
 #include "OVR_SysFile.h"
 #include "OVR_Log.h"
+#include "OVR_FrameArena.h"
+
+#if defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define OVR_JSON_SSE2
+    #include <emmintrin.h>
+    #if defined(__GNUC__) || defined(__clang__)
+        #define OVR_JSON_AVX2
+        #define OVR_JSON_TARGET_AVX2 __attribute__((target("avx2")))
+        #include <immintrin.h>
+    #elif defined(_MSC_VER) && (_MSC_VER >= 1700)
+        #define OVR_JSON_AVX2
+        #define OVR_JSON_TARGET_AVX2
+        #include <immintrin.h>
+        #include <intrin.h>
+    #endif
+#elif (defined(OVR_CPU_ARM_NEON) || defined(__ARM_NEON)) && (defined(__GNUC__) || defined(__clang__))
+    #define OVR_JSON_NEON
+    #include <arm_neon.h>
+#endif
 
 
 namespace OVR {
 
 
 //-----------------------------------------------------------------------------
-// Create a new copy of a string
-static char* JSON_strdup(const char* str)
+// ***** Text scanning
+
+// Most of the time spent parsing JSON text goes into walking over whitespace and
+// over the plain characters of strings. findNonSpace returns the first byte at or
+// after p that is not whitespace, and findStringSpecial the first quote, backslash
+// or null; both stop at the null terminator.
+//
+// The vector versions test a whole block of bytes at once. They only load aligned
+// blocks, starting with the one that holds p, so they may read past the terminator
+// but never into the next page. Those reads are hidden from the address sanitizer.
+// The best version the CPU supports is picked on first use. The function pointers are
+// atomic because parsers on several threads may get there at once; an acquire load
+// is a plain load on x86 and one instruction on ARM.
+
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ >= 5))
+    #define OVR_JSON_NO_SANITIZE __attribute__((no_sanitize_address))
+#else
+    #define OVR_JSON_NO_SANITIZE
+#endif
+
+typedef const char* ScanFunction(const char* p);
+
+static const char* findNonSpace_Scalar(const char* p)
 {
-    size_t len  = OVR_strlen(str) + 1;
-    char* copy = (char*)OVR_ALLOC(len);
-    if (!copy)
-        return 0;
-    memcpy(copy, str, len);
-    return copy;
+    // Whitespace is any byte from 1 to ' '.
+    while ((uint8_t)(*p - 1) < ' ')
+        p++;
+    return p;
 }
 
+static const char* findStringSpecial_Scalar(const char* p)
+{
+    while (*p && (*p != '\"') && (*p != '\\'))
+        p++;
+    return p;
+}
 
-//-----------------------------------------------------------------------------
-// Render the number from the given item into a string.
-static char* PrintInt(int valueint)
+#if defined(OVR_JSON_SSE2)
+
+OVR_JSON_NO_SANITIZE static const char* findNonSpace_SSE2(const char* p)
+{
+    const __m128i space  = _mm_set1_epi8(' ');
+    const __m128i zero   = _mm_setzero_si128();
+    const size_t  offset = (uintptr_t)p & 15;
+    const char*   block  = p - offset;
+    uint32_t      valid  = (0xFFFFu << offset) & 0xFFFFu;   // Skips the bytes before p.
+
+    for (;; block += 16, valid = 0xFFFFu)
+    {
+        __m128i  bytes = _mm_load_si128((const __m128i*)block);
+        // max(byte, ' ') == ' ' for bytes up to ' ', the null included.
+        uint32_t low   = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(bytes, space), space));
+        uint32_t nul   = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero));
+        uint32_t stop  = ~(low & ~nul) & valid;
+        if (stop)
+            return block + Alg::CountTrailing0Bits(stop);
+    }
+}
+
+OVR_JSON_NO_SANITIZE static const char* findStringSpecial_SSE2(const char* p)
+{
+    const __m128i quote     = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i zero      = _mm_setzero_si128();
+    const size_t  offset    = (uintptr_t)p & 15;
+    const char*   block     = p - offset;
+    uint32_t      valid     = (0xFFFFu << offset) & 0xFFFFu;
+
+    for (;; block += 16, valid = 0xFFFFu)
+    {
+        __m128i  bytes   = _mm_load_si128((const __m128i*)block);
+        __m128i  special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, quote),
+                                                     _mm_cmpeq_epi8(bytes, backslash)),
+                                        _mm_cmpeq_epi8(bytes, zero));
+        uint32_t stop    = (uint32_t)_mm_movemask_epi8(special) & valid;
+        if (stop)
+            return block + Alg::CountTrailing0Bits(stop);
+    }
+}
+
+#endif // OVR_JSON_SSE2
+
+#if defined(OVR_JSON_AVX2)
+
+OVR_JSON_TARGET_AVX2 OVR_JSON_NO_SANITIZE static const char* findNonSpace_AVX2(const char* p)
 {
-    char *str;
-    str = (char*)OVR_ALLOC(21);    // 2^64+1 can be represented in 21 chars.
-    if (str)
+    const __m256i space  = _mm256_set1_epi8(' ');
+    const __m256i zero   = _mm256_setzero_si256();
+    const size_t  offset = (uintptr_t)p & 31;
+    const char*   block  = p - offset;
+    uint32_t      valid  = 0xFFFFFFFFu << offset;
+
+    for (;; block += 32, valid = 0xFFFFFFFFu)
     {
-        OVR_sprintf(str, 21, "%d", valueint);
+        __m256i  bytes = _mm256_load_si256((const __m256i*)block);
+        uint32_t low   = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(bytes, space), space));
+        uint32_t nul   = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, zero));
+        uint32_t stop  = ~(low & ~nul) & valid;
+        if (stop)
+            return block + Alg::CountTrailing0Bits(stop);
     }
-    return str;
 }
 
+OVR_JSON_TARGET_AVX2 OVR_JSON_NO_SANITIZE static const char* findStringSpecial_AVX2(const char* p)
+{
+    const __m256i quote     = _mm256_set1_epi8('\"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i zero      = _mm256_setzero_si256();
+    const size_t  offset    = (uintptr_t)p & 31;
+    const char*   block     = p - offset;
+    uint32_t      valid     = 0xFFFFFFFFu << offset;
+
+    for (;; block += 32, valid = 0xFFFFFFFFu)
+    {
+        __m256i  bytes   = _mm256_load_si256((const __m256i*)block);
+        __m256i  special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, quote),
+                                                           _mm256_cmpeq_epi8(bytes, backslash)),
+                                           _mm256_cmpeq_epi8(bytes, zero));
+        uint32_t stop    = (uint32_t)_mm256_movemask_epi8(special) & valid;
+        if (stop)
+            return block + Alg::CountTrailing0Bits(stop);
+    }
+}
+
+// AVX2 needs support from both the CPU and the OS, which must save the YMM registers.
+static bool cpuHasAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    if (!(info[2] & (1 << 27)) || ((_xgetbv(0) & 6) != 6))  // OSXSAVE, then XMM and YMM state.
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif // OVR_JSON_AVX2
+
+#if defined(OVR_JSON_NEON)
+
+// NEON has no movemask; narrowing each 16-bit pair by 4 bits leaves a nibble per byte.
+static inline uint64_t neonMask(uint8x16_t bytes)
+{
+    uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(bytes), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+}
+
+OVR_JSON_NO_SANITIZE static const char* findNonSpace_NEON(const char* p)
+{
+    const uint8x16_t space  = vdupq_n_u8(' ');
+    const uint8x16_t zero   = vdupq_n_u8(0);
+    const size_t     offset = (uintptr_t)p & 15;
+    const char*      block  = p - offset;
+    uint64_t         valid  = ~0ULL << (offset * 4);
+
+    for (;; block += 16, valid = ~0ULL)
+    {
+        uint8x16_t bytes = vld1q_u8((const uint8_t*)block);
+        // Bytes above ' ', or the null.
+        uint64_t   stop  = neonMask(vorrq_u8(vcgtq_u8(bytes, space), vceqq_u8(bytes, zero))) & valid;
+        if (stop)
+            return block + (__builtin_ctzll(stop) >> 2);
+    }
+}
+
+OVR_JSON_NO_SANITIZE static const char* findStringSpecial_NEON(const char* p)
+{
+    const uint8x16_t quote     = vdupq_n_u8('\"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t zero      = vdupq_n_u8(0);
+    const size_t     offset    = (uintptr_t)p & 15;
+    const char*      block     = p - offset;
+    uint64_t         valid     = ~0ULL << (offset * 4);
+
+    for (;; block += 16, valid = ~0ULL)
+    {
+        uint8x16_t bytes = vld1q_u8((const uint8_t*)block);
+        uint64_t   stop  = neonMask(vorrq_u8(vorrq_u8(vceqq_u8(bytes, quote), vceqq_u8(bytes, backslash)),
+                                             vceqq_u8(bytes, zero))) & valid;
+        if (stop)
+            return block + (__builtin_ctzll(stop) >> 2);
+    }
+}
+
+#endif // OVR_JSON_NEON
+
+// Null until selectScanFunctions has run; a zero pointer needs no constructor to have
+// run, so parsing during static initialization works too.
+static AtomicPtr<ScanFunction> pFindNonSpace;
+static AtomicPtr<ScanFunction> pFindStringSpecial;
+
+// Threads that get here at the same time store the same pointers.
+static void selectScanFunctions()
+{
+    ScanFunction* nonSpace = findNonSpace_Scalar;
+    ScanFunction* special  = findStringSpecial_Scalar;
+
+#if defined(OVR_JSON_SSE2)
+    nonSpace = findNonSpace_SSE2;
+    special  = findStringSpecial_SSE2;
+#elif defined(OVR_JSON_NEON)
+    nonSpace = findNonSpace_NEON;
+    special  = findStringSpecial_NEON;
+#endif
+#if defined(OVR_JSON_AVX2)
+    if (cpuHasAVX2())
+    {
+        nonSpace = findNonSpace_AVX2;
+        special  = findStringSpecial_AVX2;
+    }
+#endif
+
+    pFindStringSpecial.Store_Release(special);
+    pFindNonSpace.Store_Release(nonSpace);
+}
+
+static inline const char* findNonSpace(const char* p)
+{
+    ScanFunction* scan = pFindNonSpace.Load_Acquire();
+    if (!scan)
+    {
+        selectScanFunctions();
+        scan = pFindNonSpace.Load_Acquire();
+    }
+    return scan(p);
+}
+
+static inline const char* findStringSpecial(const char* p)
+{
+    ScanFunction* scan = pFindStringSpecial.Load_Acquire();
+    if (!scan)
+    {
+        selectScanFunctions();
+        scan = pFindStringSpecial.Load_Acquire();
+    }
+    return scan(p);
+}
+
+
+//-----------------------------------------------------------------------------
+// ***** JSONText
 
 //-----------------------------------------------------------------------------
-// Render the number from the given item into a string.
-static char* PrintNumber(double d)
+// Render the number into buffer and return its length.
+size_t JSONText::FormatNumber(double d, char* buffer, size_t bufferSize)
 {
-    char *str;
     int valueint = (int)d;
 
     if ((fabs(((double)valueint)-d) <= DBL_EPSILON) && (d <= INT_MAX) && (d >= INT_MIN))
     {
-        return PrintInt(valueint);
+        OVR_sprintf(buffer, bufferSize, "%d", valueint);
     }
     else
     {
-        const size_t kCapacity = 64;
+        // The JSON Standard, section 7.8.3, specifies that decimals are always expressed with '.' and 
+        // not some locale-specific decimal such as ',' or ' '. However, since we are using the C standard
+        // library below to write a floating point number, we need to make sure that it's writing a '.' 
+        // and not something else. We can't change the locale (even temporarily) here, as it will affect 
+        // the whole process by default. That are compiler-specific ways to change this per-thread, but 
+        // below we implement the simple solution of simply fixing the decimal after the string was written.
+
+        if ((fabs(floor(d)-d) <= DBL_EPSILON) && (fabs(d) < 1.0e60))
+            OVR_sprintf(buffer, bufferSize, "%.0f", d);
+        else if ((fabs(d) < 1.0e-6) || (fabs(d) > 1.0e9))
+            OVR_sprintf(buffer, bufferSize, "%e", d);
+        else
+            OVR_sprintf(buffer, bufferSize, "%f", d);
 
-        str=(char*)OVR_ALLOC(kCapacity);    // This is a nice tradeoff.
-        if (str)
+        // Convert any found ',' or ''' char to '.'. This will happen only if the locale was set to write a ',' 
+        // instead of a '.' for the decimal point. Decimal points are represented only by one of these
+        // three characters in practice.
+        for(char* p = buffer; *p; p++)
         {
-            // The JSON Standard, section 7.8.3, specifies that decimals are always expressed with '.' and 
-            // not some locale-specific decimal such as ',' or ' '. However, since we are using the C standard
-            // library below to write a floating point number, we need to make sure that it's writing a '.' 
-            // and not something else. We can't change the locale (even temporarily) here, as it will affect 
-            // the whole process by default. That are compiler-specific ways to change this per-thread, but 
-            // below we implement the simple solution of simply fixing the decimal after the string was written.
-
-            if ((fabs(floor(d)-d) <= DBL_EPSILON) && (fabs(d) < 1.0e60))
-                OVR_sprintf(str, kCapacity, "%.0f", d);
-            else if ((fabs(d) < 1.0e-6) || (fabs(d) > 1.0e9))
-                OVR_sprintf(str, kCapacity, "%e", d);
-            else
-                OVR_sprintf(str, kCapacity, "%f", d);
-
-            // Convert any found ',' or ''' char to '.'. This will happen only if the locale was set to write a ',' 
-            // instead of a '.' for the decimal point. Decimal points are represented only by one of these
-            // three characters in practice.
-            for(char* p = str; *p; p++)
+            if((*p == ',') || (*p == '\''))
             {
-                if((*p == ',') || (*p == '\''))
-                {
-                    *p = '.';
-                    break;
-                }
+                *p = '.';
+                break;
             }
         }
     }
-    return str;
+    return OVR_strlen(buffer);
 }
 
 
@@ -151,6 +389,215 @@ const char* AssignError(const char** perror, const char *errorMessage)
     return 0;
 }
 
+//-----------------------------------------------------------------------------
+// ***** JSONArena
+
+// Holds the nodes of a tree parsed with Alloc_Arena. The arena counts the nodes
+// allocated from it and frees its blocks when the last of them is deleted, so
+// nodes detached from the tree stay valid for as long as they are referenced.
+
+class JSONArena : public NewOverrideBase
+{
+public:
+    JSONArena(size_t blockSize) : Memory(blockSize), NodeCount(0) { }
+
+    // Nodes are only allocated while parsing, from one thread.
+    void* AllocNode(size_t size)
+    {
+        NodeCount.ExchangeAdd_NoSync(1);
+        return Memory.Alloc(size);
+    }
+
+    void  FreeNode()
+    {
+        if (NodeCount.ExchangeAdd_Sync(-1) == 1)
+            delete this;
+    }
+
+private:
+    LinearArena    Memory;
+    AtomicInt<int> NodeCount;
+};
+
+// Every node is preceded by a header holding its arena, or null for heap nodes.
+// The header is a full allocation unit so that nodes keep the allocator alignment.
+static const size_t NodeHeaderSize = 16;
+
+static JSONArena*& nodeArena(void* header)
+{
+    return *(JSONArena**)header;
+}
+
+
+//-----------------------------------------------------------------------------
+// ***** JSON::ItemIndex
+
+// The children of a node in order, for access by position, and for objects a
+// linear-probing table of child positions keyed by name hash. Lookups by name
+// probe in insertion order, so the first of several children with the same name
+// is found, as with a walk of the list.
+
+struct JSON::ItemIndex
+{
+    unsigned   Count;
+    unsigned   Capacity;
+    JSON**     pItems;
+    uint32_t*  pHashes;     // Name hash of each child; null unless names are indexed.
+    uint32_t*  pSlots;      // Child position + 1, or 0 for an empty slot.
+    unsigned   SlotMask;
+
+    static ItemIndex* Create(bool indexNames, unsigned capacity);
+    static void       Destroy(ItemIndex* index);
+
+    bool    Append(JSON* item);
+    JSON*   Find(const char* name) const;
+
+private:
+    bool    growItems();
+    bool    growSlots();
+    void    insertSlot(unsigned position);
+};
+
+static uint32_t hashName(const char* name, size_t length)
+{
+    return (uint32_t)String::BernsteinHashFunction(name, length);
+}
+
+JSON::ItemIndex* JSON::ItemIndex::Create(bool indexNames, unsigned capacity)
+{
+    ItemIndex* index = (ItemIndex*)OVR_ALLOC(sizeof(ItemIndex));
+    if (!index)
+        return 0;
+
+    capacity        = Alg::Max(capacity, (unsigned)IndexMinItems);
+    index->Count    = 0;
+    index->Capacity = capacity;
+    index->pItems   = (JSON**)OVR_ALLOC(capacity * sizeof(JSON*));
+    index->pHashes  = 0;
+    index->pSlots   = 0;
+    index->SlotMask = 0;
+
+    bool ok = (index->pItems != 0);
+    if (ok && indexNames)
+    {
+        unsigned slotCount = 1;
+        while (slotCount < capacity * 2)
+            slotCount <<= 1;
+
+        index->pHashes  = (uint32_t*)OVR_ALLOC(capacity * sizeof(uint32_t));
+        index->pSlots   = (uint32_t*)OVR_ALLOC(slotCount * sizeof(uint32_t));
+        index->SlotMask = slotCount - 1;
+        ok = index->pHashes && index->pSlots;
+        if (ok)
+            memset(index->pSlots, 0, slotCount * sizeof(uint32_t));
+    }
+
+    if (!ok)
+    {
+        Destroy(index);
+        return 0;
+    }
+    return index;
+}
+
+void JSON::ItemIndex::Destroy(ItemIndex* index)
+{
+    if (index)
+    {
+        OVR_FREE(index->pItems);
+        OVR_FREE(index->pHashes);
+        OVR_FREE(index->pSlots);
+        OVR_FREE(index);
+    }
+}
+
+// Adds item at the end; returns false if out of memory, leaving the index unusable.
+bool JSON::ItemIndex::Append(JSON* item)
+{
+    if (Count == Capacity && !growItems())
+        return false;
+
+    pItems[Count] = item;
+    if (pSlots)
+    {
+        if ((Count + 1) * 2 > SlotMask + 1 && !growSlots())
+            return false;
+        pHashes[Count] = hashName(item->Name.ToCStr(), item->Name.GetSize());
+        insertSlot(Count);
+    }
+    Count++;
+    return true;
+}
+
+JSON* JSON::ItemIndex::Find(const char* name) const
+{
+    if (!pSlots)
+    {
+        // Names are not indexed; this is not an object.
+        for (unsigned i = 0; i < Count; i++)
+        {
+            if (OVR_strcmp(pItems[i]->Name, name) == 0)
+                return pItems[i];
+        }
+        return 0;
+    }
+
+    uint32_t hash = hashName(name, OVR_strlen(name));
+    for (unsigned slot = hash & SlotMask; pSlots[slot]; slot = (slot + 1) & SlotMask)
+    {
+        unsigned position = pSlots[slot] - 1;
+        if ((pHashes[position] == hash) && (OVR_strcmp(pItems[position]->Name, name) == 0))
+            return pItems[position];
+    }
+    return 0;
+}
+
+bool JSON::ItemIndex::growItems()
+{
+    unsigned capacity = Capacity * 2;
+    JSON**   items    = (JSON**)OVR_REALLOC(pItems, capacity * sizeof(JSON*));
+    if (!items)
+        return false;
+    pItems = items;
+
+    if (pHashes)
+    {
+        uint32_t* hashes = (uint32_t*)OVR_REALLOC(pHashes, capacity * sizeof(uint32_t));
+        if (!hashes)
+            return false;
+        pHashes = hashes;
+    }
+    Capacity = capacity;
+    return true;
+}
+
+// Doubles the slot table and reinserts the children in order.
+bool JSON::ItemIndex::growSlots()
+{
+    unsigned  slotCount = (SlotMask + 1) * 2;
+    uint32_t* slots     = (uint32_t*)OVR_ALLOC(slotCount * sizeof(uint32_t));
+    if (!slots)
+        return false;
+
+    memset(slots, 0, slotCount * sizeof(uint32_t));
+    OVR_FREE(pSlots);
+    pSlots   = slots;
+    SlotMask = slotCount - 1;
+
+    for (unsigned i = 0; i < Count; i++)
+        insertSlot(i);
+    return true;
+}
+
+void JSON::ItemIndex::insertSlot(unsigned position)
+{
+    unsigned slot = pHashes[position] & SlotMask;
+    while (pSlots[slot])
+        slot = (slot + 1) & SlotMask;
+    pSlots[slot] = position + 1;
+}
+
+
 //-----------------------------------------------------------------------------
 // ***** JSON Node class
 
@@ -168,17 +615,138 @@ JSON::~JSON()
         child->Release();
         child = Children.GetFirst();
     }
+
+    ItemIndex::Destroy(pIndex);
+}
+
+void* JSON::operator new(size_t size)
+{
+    return operator new(size, __FILE__, __LINE__);
+}
+
+void* JSON::operator new(size_t size, const char* file, int line)
+{
+    OVR_UNUSED2(file, line);
+    void* header = OVR_ALLOC_DEBUG(NodeHeaderSize + size, file, line);
+    if (!header)
+        return header;
+    nodeArena(header) = 0;
+    return (char*)header + NodeHeaderSize;
+}
+
+void JSON::operator delete(void* p)
+{
+    if (!p)
+        return;
+
+    RefCountImplCore::checkInvalidDelete((JSON*)p);
+
+    void*      header = (char*)p - NodeHeaderSize;
+    JSONArena* arena  = nodeArena(header);
+    if (arena)
+        arena->FreeNode();
+    else
+        OVR_FREE(header);
+}
+
+void JSON::operator delete(void* p, const char* file, int line)
+{
+    OVR_UNUSED2(file, line);
+    operator delete(p);
+}
+
+// Creates a node in arena, or on the heap if arena is null.
+JSON* JSON::createNode(JSONArena* arena)
+{
+    if (!arena)
+        return new JSON();
+
+    void* header = arena->AllocNode(NodeHeaderSize + sizeof(JSON));
+    nodeArena(header) = arena;
+    return ::new((char*)header + NodeHeaderSize) JSON();
+}
+
+// Creates the root node for a parse. For Alloc_Arena the arena's blocks are sized
+// from the length of the text; it adds blocks if needed.
+JSON* JSON::createRoot(AllocMode mode, size_t textSize)
+{
+    JSONArena* arena = 0;
+    if (mode == Alloc_Arena)
+    {
+        arena = new JSONArena(Alg::Clamp<size_t>(textSize * 4, 4096, 1024 * 1024));
+        if (!arena)
+            return 0;
+    }
+    return createNode(arena);
+}
+
+// Creates a node for parsed content, in the same arena as this node if it has one.
+JSON* JSON::createChild()
+{
+    return createNode(nodeArena((char*)this - NodeHeaderSize));
 }
 
 //-----------------------------------------------------------------------------
-// Parse the input text to generate a number, and populate the result into item
+// Powers of ten for the usual exponents. They are computed by pow itself, so a
+// number is scaled the same whether its power comes from the table or from pow.
+struct PowersOfTen
+{
+    enum {
+        MinExponent = -64,
+        MaxExponent = 64
+    };
+
+    double  Values[MaxExponent - MinExponent + 1];
+    bool    Ready;      // Zero until the static constructor has run.
+
+    PowersOfTen()
+    {
+        for (int e = MinExponent; e <= MaxExponent; e++)
+            Values[e - MinExponent] = pow(10.0, (double)e);
+        Ready = true;
+    }
+
+    double Get(double exponent) const
+    {
+        if (Ready && (exponent >= MinExponent) && (exponent <= MaxExponent))
+            return Values[(int)exponent - MinExponent];
+        return pow(10.0, exponent);
+    }
+};
+
+static PowersOfTen PowersOf10;
+
+// Adds the digits at num to *n, one n = n*10 + digit step each, and returns the
+// position after them with their count in *count. Until the value reaches 2^53
+// every step is exact, so those digits are summed as an integer instead.
+static const char* parseDigits(const char* num, double* n, int* count)
+{
+    const uint64_t maxExact = (((uint64_t)1 << 53) - 10) / 10;
+    const char*    start    = num;
+
+    if (*n <= (double)maxExact)
+    {
+        uint64_t m = (uint64_t)*n;
+        while ((*num >= '0') && (*num <= '9') && (m <= maxExact))
+            m = (m * 10) + (*num++ - '0');
+        *n = (double)m;
+    }
+    while ((*num >= '0') && (*num <= '9'))
+        *n = (*n * 10.0) + (*num++ - '0');
+
+    *count = (int)(num - start);
+    return num;
+}
+
+//-----------------------------------------------------------------------------
+// Parse the input text to generate a number
 // Returns the text position after the parsed number
-const char* JSON::parseNumber(const char *num)
+const char* JSONText::ParseNumber(const char *num, double* value)
 {
-    const char* num_start = num;
     double      n=0, scale=0;
     int         subscale     = 0,
-                signsubscale = 1;
+                signsubscale = 1,
+                digits;
     bool        positiveSign = true;
     const char  decimalSeparator = '.';  // The JSON standard specifies that numbers use '.' regardless of locale.
 
@@ -195,22 +763,14 @@ const char* JSON::parseNumber(const char *num)
 
     if (*num>='1' && *num<='9')    
     {
-        do
-        {
-            n = (n*10.0) + (*num++ - '0');
-        }
-        while (*num>='0' && *num<='9');    // Number?
+        num = parseDigits(num, &n, &digits);    // Number?
     }
 
     if ((*num=='.' || *num==decimalSeparator) && num[1]>='0' && num[1]<='9')
     {
         num++;
-        do
-        {
-            n=(n*10.0)+(*num++ -'0');
-            scale--;
-        }
-        while (*num>='0' && *num<='9');  // Fractional part?
+        num = parseDigits(num, &n, &digits);    // Fractional part?
+        scale -= digits;
     }
 
     if (*num=='e' || *num=='E')        // Exponent?
@@ -233,19 +793,28 @@ const char* JSON::parseNumber(const char *num)
     }
 
     // Number = +/- number.fraction * 10^+/- exponent
-    n *= pow(10.0, (scale + subscale*signsubscale));
+    n *= PowersOf10.Get(scale + subscale*signsubscale);
 
     if (!positiveSign)
     {
         n = -n;
     }
 
+    *value = n;
+    return num;
+}
+
+// Parse the input text to generate a number, and populate the result into item
+// Returns the text position after the parsed number
+const char* JSON::parseNumber(const char *num)
+{
+    const char* end = JSONText::ParseNumber(num, &dValue);
+
     // Assign parsed value.
     Type = JSON_Number;
-    dValue = n;
-    Value.AssignString(num_start, num - num_start);
+    Value.AssignString(num, end - num);
 
-    return num;
+    return end;
 }
 
 // Parses a hex string up to the specified number of digits.
@@ -274,44 +843,62 @@ const char* ParseHex(unsigned* val, unsigned digits, const char* str)
 }
 
 //-----------------------------------------------------------------------------
-// Parses the input text into a string item and returns the text position after
+// Returns how long we need for the un-escaped string, roughly.
+size_t JSONText::MeasureString(const char* str)
+{
+    const char* ptr = str+1;
+    size_t      len = 0;
+
+    while (*ptr!='\"' && *ptr)
+    {
+        if (*ptr == '\\')
+        {
+            ptr++;
+            len++;
+            if (*ptr) ptr++;    // Skip escaped quotes.
+        }
+        else
+        {
+            const char* end = findStringSpecial(ptr);
+            len += end - ptr;
+            ptr  = end;
+        }
+    }
+    return len;
+}
+
+//-----------------------------------------------------------------------------
+const char* JSONText::FindStringSpecial(const char* str)
+{
+    return findStringSpecial(str);
+}
+
+//-----------------------------------------------------------------------------
+// Un-escapes the string at str into out and returns the text position after
 // the parsed string
-const char* JSON::parseString(const char* str, const char** perror)
+const char* JSONText::ParseString(const char* str, char* out, size_t* outLength)
 {
     const char* ptr = str+1;
     const char* p;
-    char*       ptr2;
-    char*       out;
-    int         len=0;
+    char*       ptr2 = out;
+    int         len;
     unsigned    uc, uc2;
-    
-    if (*str!='\"')
-    {
-        return AssignError(perror, "Syntax Error: Missing quote");
-    }
-    
-    while (*ptr!='\"' && *ptr && ++len)
-    {   
-        if (*ptr++ == '\\') ptr++;    // Skip escaped quotes.
-    }
-    
-    // This is how long we need for the string, roughly.
-    out=(char*)OVR_ALLOC(len+1);
-    if (!out)
-        return 0;
-    
-    ptr = str+1;
-    ptr2= out;
 
     while (*ptr!='\"' && *ptr)
     {
         if (*ptr!='\\')
         {
-            *ptr2++ = *ptr++;
+            // Copy the run of plain characters at once.
+            const char* end = findStringSpecial(ptr);
+            memcpy(ptr2, ptr, end - ptr);
+            ptr2 += end - ptr;
+            ptr   = end;
         }
         else
         {
             ptr++;
+            if (!*ptr)
+                break;    // The text ends in the escape.
             switch (*ptr)
             {
                 case 'b': *ptr2++ = '\b';    break;
@@ -383,92 +970,70 @@ const char* JSON::parseString(const char* str, const char** perror)
     *ptr2 = 0;
     if (*ptr=='\"')
         ptr++;
-    
-    // Make a copy of the string 
-    Value=out;
-    OVR_FREE(out);
-    Type=JSON_String;
 
+    *outLength = ptr2 - out;
     return ptr;
 }
 
 //-----------------------------------------------------------------------------
-// Render the string provided to an escaped version that can be printed.
-char* PrintString(const char* str)
+// Parses the input text into a string item and returns the text position after
+// the parsed string
+const char* JSON::parseString(const char* str, const char** perror)
 {
-    const char *ptr;
-    char *ptr2,*out;
-    int len=0;
-    unsigned char token;
-    
-    if (!str)
-        return JSON_strdup("");
-    ptr=str;
-    
-    token=*ptr;
-    while (token && ++len)\
+    char        localBuffer[256];
+    char*       out;
+    size_t      len;
+
+    if (*str!='\"')
     {
-        if (strchr("\"\\\b\f\n\r\t",token))
-            len++;
-        else if (token<32) 
-            len+=5;
-        ptr++;
-        token=*ptr;
+        return AssignError(perror, "Syntax Error: Missing quote");
     }
-    
-    int buff_size = len+3;
-    out=(char*)OVR_ALLOC(buff_size);
+
+    // Most strings are short enough to be un-escaped on the stack.
+    len = JSONText::MeasureString(str);
+    if (len < sizeof(localBuffer))
+        out = localBuffer;
+    else
+        out = (char*)OVR_ALLOC(len+1);
     if (!out)
         return 0;
 
-    ptr2 = out;
-    ptr  = str;
-    *ptr2++ = '\"';
+    const char* ptr = JSONText::ParseString(str, out, &len);
 
-    while (*ptr)
-    {
-        if ((unsigned char)*ptr>31 && *ptr!='\"' && *ptr!='\\') 
-            *ptr2++=*ptr++;
-        else
-        {
-            *ptr2++='\\';
-            switch (token=*ptr++)
-            {
-                case '\\':    *ptr2++='\\';    break;
-                case '\"':    *ptr2++='\"';    break;
-                case '\b':    *ptr2++='b';    break;
-                case '\f':    *ptr2++='f';    break;
-                case '\n':    *ptr2++='n';    break;
-                case '\r':    *ptr2++='r';    break;
-                case '\t':    *ptr2++='t';    break;
-                default: 
-                    OVR_sprintf(ptr2, buff_size - (ptr2-out), "u%04x",token);
-                    ptr2+=5;
-                    break;    // Escape and print.
-            }
-        }
-    }
-    *ptr2++='\"';
-    *ptr2++=0;
-    return out;
+    // Make a copy of the string 
+    Value.AssignString(out, len);
+    if (out != localBuffer)
+        OVR_FREE(out);
+    Type=JSON_String;
+
+    return ptr;
 }
 
 //-----------------------------------------------------------------------------
 // Utility to jump whitespace and cr/lf
-static const char* skip(const char* in)
+const char* JSONText::SkipWhitespace(const char* in)
 {
-    while (in && *in && (unsigned char)*in<=' ') 
-        in++; 
-    return in;
+    // Tokens are mostly separated by no whitespace or by a single space; longer runs
+    // are indentation.
+    if (!in || ((uint8_t)(in[0] - 1) >= ' '))
+        return in;
+    if ((uint8_t)(in[1] - 1) >= ' ')
+        return in + 1;
+    return findNonSpace(in + 2);
+}
+
+static inline const char* skip(const char* in)
+{
+    return JSONText::SkipWhitespace(in);
 }
 
 //-----------------------------------------------------------------------------
 // Parses the supplied buffer of JSON text and returns a JSON object tree
 // The returned object must be Released after use
-JSON* JSON::Parse(const char* buff, const char** perror)
+JSON* JSON::Parse(const char* buff, const char** perror, AllocMode mode)
 {
     const char* end = 0;
-    JSON*       json = new JSON();
+    JSON*       json = createRoot(mode, buff ? OVR_strlen(buff) : 0);
     
     if (!json)
     {
@@ -488,7 +1053,7 @@ JSON* JSON::Parse(const char* buff, const char** perror)
 
 //-----------------------------------------------------------------------------
 // This version works for buffers that are not null terminated strings.
-JSON* JSON::ParseBuffer(const char *buff, int len, const char** perror)
+JSON* JSON::ParseBuffer(const char *buff, int len, const char** perror, AllocMode mode)
 {
     // Our JSON parser does not support length-based parsing,
     // so ensure it is null-terminated.
@@ -496,7 +1061,7 @@ JSON* JSON::ParseBuffer(const char *buff, int len, const char** perror)
     memcpy(termStr, buff, len);
     termStr[len] = '\0';
 
-    JSON *objJson = Parse(termStr, perror);
+    JSON *objJson = Parse(termStr, perror, mode);
 
     delete[]termStr;
 
@@ -552,30 +1117,6 @@ const char* JSON::parseValue(const char* buff, const char** perror)
     return AssignError(perror, "Syntax Error: Invalid syntax");
 }
 
-//-----------------------------------------------------------------------------
-// Render a value to text. 
-char* JSON::PrintValue(int depth, bool fmt)
-{
-    char *out=0;
-
-    switch (Type)
-    {
-        case JSON_Null:        out = JSON_strdup("null");    break;
-        case JSON_Bool:
-            if ((int)dValue == 0)
-                out = JSON_strdup("false");
-            else
-                out = JSON_strdup("true");
-            break;
-        case JSON_Number:    out = PrintNumber(dValue); break;
-        case JSON_String:    out = PrintString(Value); break;
-        case JSON_Array:    out = PrintArray(depth, fmt); break;
-        case JSON_Object:    out = PrintObject(depth, fmt); break;
-        case JSON_None: OVR_ASSERT_LOG(false, ("Bad JSON type.")); break;
-    }
-    return out;
-}
-
 //-----------------------------------------------------------------------------
 // Build an array object from input text and returns the text position after
 // the parsed array
@@ -593,7 +1134,7 @@ const char* JSON::parseArray(const char* buff, const char** perror)
     if (*buff==']')
         return buff+1;    // empty array.
 
-    child = new JSON();
+    child = createChild();
     if (!child)
         return 0;         // memory fail
     Children.PushBack(child);
@@ -604,7 +1145,7 @@ const char* JSON::parseArray(const char* buff, const char** perror)
 
     while (*buff==',')
     {
-        JSON *new_item = new JSON();
+        JSON *new_item = createChild();
         if (!new_item)
             return AssignError(perror, "Error: Failed to allocate memory");
         
@@ -621,90 +1162,6 @@ const char* JSON::parseArray(const char* buff, const char** perror)
     return AssignError(perror, "Syntax Error: Missing ending bracket");
 }
 
-//-----------------------------------------------------------------------------
-// Render an array to text.  The returned text must be freed
-char* JSON::PrintArray(int depth, bool fmt)
-{
-    char **  entries;
-    char *   out = 0, *ptr,*ret;
-    intptr_t len = 5;
-    
-    bool fail = false;
-    
-    // How many entries in the array? 
-    int numentries = GetItemCount();
-    if (!numentries)
-    {
-        out=(char*)OVR_ALLOC(3);
-        if (out)
-            OVR_strcpy(out, 3, "[]");
-        return out;
-    }
-    // Allocate an array to hold the values for each
-    entries=(char**)OVR_ALLOC(numentries*sizeof(char*));
-    if (!entries)
-        return 0;
-    memset(entries,0,numentries*sizeof(char*));
-
-    //// Retrieve all the results:
-    JSON* child = Children.GetFirst();
-    for (int i=0; i<numentries; i++)
-    {
-        //JSON* child = Children[i];
-        ret=child->PrintValue(depth+1, fmt);
-        entries[i]=ret;
-        if (ret)
-            len+=OVR_strlen(ret)+2+(fmt?1:0);
-        else
-        {
-            fail = true;
-            break;
-        }
-        child = Children.GetNext(child);
-    }
-    
-    // If we didn't fail, try to malloc the output string 
-    if (!fail)
-        out=(char*)OVR_ALLOC(len);
-    // If that fails, we fail. 
-    if (!out)
-        fail = true;
-
-    // Handle failure.
-    if (fail)
-    {
-        for (int i=0; i<numentries; i++) 
-        {
-            if (entries[i])
-                OVR_FREE(entries[i]);
-        }
-        OVR_FREE(entries);
-        return 0;
-    }
-    
-    // Compose the output array.
-    *out='[';
-    ptr=out+1;
-    *ptr=0;
-    for (int i=0; i<numentries; i++)
-    {
-        OVR_strcpy(ptr, len - (ptr-out), entries[i]);
-        ptr+=OVR_strlen(entries[i]);
-        if (i!=numentries-1)
-        {
-            *ptr++=',';
-            if (fmt)
-                *ptr++=' ';
-            *ptr=0;
-        }
-        OVR_FREE(entries[i]);
-    }
-    OVR_FREE(entries);
-    *ptr++=']';
-    *ptr++=0;
-    return out;    
-}
-
 //-----------------------------------------------------------------------------
 // Build an object from the supplied text and returns the text position after
 // the parsed object
@@ -720,7 +1177,9 @@ const char* JSON::parseObject(const char* buff, const char** perror)
     if (*buff=='}')
         return buff+1;    // empty array.
     
-    JSON* child = new JSON();
+    JSON* child = createChild();
+    if (!child)
+        return 0; // memory fail
     Children.PushBack(child);
 
     buff=skip(child->parseString(skip(buff), perror));
@@ -740,7 +1199,7 @@ const char* JSON::parseObject(const char* buff, const char** perror)
     
     while (*buff==',')
     {
-        child = new JSON();
+        child = createChild();
         if (!child)
             return 0; // memory fail
         
@@ -770,184 +1229,33 @@ const char* JSON::parseObject(const char* buff, const char** perror)
     return AssignError(perror, "Syntax Error: Missing closing brace");
 }
 
-//-----------------------------------------------------------------------------
-// Render an object to text.  The returned string must be freed
-char* JSON::PrintObject(int depth, bool fmt)
-{
-    char**   entries = 0, **names = 0;
-    char*    out = 0;
-    char*    ptr, *ret, *str;
-    intptr_t len = 7, i = 0, j;
-    bool     fail = false;
-    
-    // Count the number of entries.
-    int numentries = GetItemCount();
-    
-    // Explicitly handle empty object case
-    if (numentries == 0)
-    {
-        out=(char*)OVR_ALLOC(fmt?depth+4:4);
-        if (!out)
-            return 0;
-        ptr=out;
-        *ptr++='{';
-        
-        if (fmt)
-        {
-#ifdef OVR_OS_WIN32
-            *ptr++ = '\r';
-#endif
-            *ptr++ = '\n';
-            for (i=0;i<depth-1;i++)
-                *ptr++='\t';
-        }
-        *ptr++='}';
-        *ptr++=0;
-        return out;
-    }
-    // Allocate space for the names and the objects
-    entries=(char**)OVR_ALLOC(numentries*sizeof(char*));
-    if (!entries)
-        return 0;
-    names=(char**)OVR_ALLOC(numentries*sizeof(char*));
-    
-    if (!names)
-    {
-        OVR_FREE(entries);
-        return 0;
-    }
-    memset(entries,0,sizeof(char*)*numentries);
-    memset(names,0,sizeof(char*)*numentries);
-
-    // Collect all the results into our arrays:
-    depth++;
-    if (fmt)
-        len+=depth;
-
-    JSON* child = Children.GetFirst();
-    while (!Children.IsNull(child))
-    {
-        names[i]     = str = PrintString(child->Name);
-        entries[i++] = ret = child->PrintValue(depth, fmt);
-
-        if (str && ret)
-        {
-            len += OVR_strlen(ret)+OVR_strlen(str)+2+(fmt?3+depth:0);
-        }
-        else
-        {
-            fail = true;
-            break;
-        }
-        
-        child = Children.GetNext(child);
-    }
-    
-    // Try to allocate the output string
-    if (!fail)
-        out=(char*)OVR_ALLOC(len);
-    if (!out)
-        fail=true;
-
-    // Handle failure
-    if (fail)
-    {
-        for (i=0;i<numentries;i++)
-        {
-            if (names[i])
-                OVR_FREE(names[i]);
-            
-            if (entries[i])
-                OVR_FREE(entries[i]);}
-        
-        OVR_FREE(names);
-        OVR_FREE(entries);
-        return 0;
-    }
-    
-    // Compose the output:
-    *out = '{';
-    ptr  = out+1;
-    if (fmt)
-    {
-#ifdef OVR_OS_WIN32
-        *ptr++ = '\r';
-#endif
-        *ptr++ = '\n';
-    }
-    *ptr = 0;
-    
-    for (i=0; i<numentries; i++)
-    {
-        if (fmt)
-        {
-            for (j = 0; j < depth; j++)
-            {
-                *ptr++ = '\t';
-            }
-        }
-        OVR_strcpy(ptr, len - (ptr-out), names[i]);
-        ptr   += OVR_strlen(names[i]);
-        *ptr++ =':';
-        
-        if (fmt)
-        {
-            *ptr++ = '\t';
-        }
-        
-        OVR_strcpy(ptr, len - (ptr-out), entries[i]);
-        ptr+=OVR_strlen(entries[i]);
-        
-        if (i != numentries - 1)
-        {
-            *ptr++ = ',';
-        }
-        
-        if (fmt)
-        {
-#ifdef OVR_OS_WIN32
-            *ptr++ = '\r';
-#endif
-            *ptr++ = '\n';
-        }
-        *ptr = 0;
-        
-        OVR_FREE(names[i]);
-        OVR_FREE(entries[i]);
-    }
-    
-    OVR_FREE(names);
-    OVR_FREE(entries);
-    
-    if (fmt)
-    {
-        for (i = 0; i < depth - 1; i++)
-        {
-            *ptr++ = '\t';
-        }
-    }
-    *ptr++='}';
-    *ptr++=0;
-    
-    return out;    
-}
-
-
-
 // Returns the number of child items in the object
-// Counts the number of items in the object.
+// Counts the number of items in the object; nodes with many children are indexed.
 unsigned JSON::GetItemCount() const
 {
+    ItemIndex* index = getIndex();
+    if (index)
+        return index->Count;
+
     unsigned count = 0;
     for (const JSON* p = Children.GetFirst(); !Children.IsNull(p); p = Children.GetNext(p))
     {
         count++;
     }
+
+    if (count >= IndexMinItems)
+        buildIndex();
     return count;
 }
 
 JSON* JSON::GetItemByIndex(unsigned index)
 {
+    ItemIndex* itemIndex = getIndex();
+    if (!itemIndex && (index >= IndexMinItems))
+        itemIndex = buildIndex();
+    if (itemIndex)
+        return (index < itemIndex->Count) ? itemIndex->pItems[index] : 0;
+
     unsigned i     = 0;
     JSON*    child = 0;
 
@@ -973,11 +1281,17 @@ JSON* JSON::GetItemByIndex(unsigned index)
 // Returns the child item with the given name or NULL if not found
 JSON* JSON::GetItemByName(const char* name)
 {
-    JSON* child = 0;
+    ItemIndex* index = getIndex();
+    if (index)
+        return index->Find(name);
+
+    unsigned count = 0;
+    JSON*    child = 0;
 
     if (!Children.IsEmpty())
     {
         child = Children.GetFirst();
+        count = 1;
 
         while (OVR_strcmp(child->Name, name) != 0)
         {   
@@ -987,12 +1301,61 @@ JSON* JSON::GetItemByName(const char* name)
                 break;
             }
             child = child->GetNext();
+            count++;
         }
     }
 
+    // A long walk: index the children for the next lookup.
+    if (count >= IndexMinItems)
+        buildIndex();
+
     return child;
 }
 
+void JSON::InvalidateIndex()
+{
+    ItemIndex* index = pIndex.Exchange_Sync(0);
+    ItemIndex::Destroy(index);
+}
+
+JSON::ItemIndex* JSON::getIndex() const
+{
+    return pIndex.Load_Acquire();
+}
+
+// Builds the index of the children. Readers that share a tree may race to build it;
+// the first one to finish installs its index and the others discard theirs.
+JSON::ItemIndex* JSON::buildIndex() const
+{
+    ItemIndex* index = ItemIndex::Create(Type == JSON_Object, IndexMinItems);
+    if (!index)
+        return 0;
+
+    for (const JSON* child = Children.GetFirst(); !Children.IsNull(child); child = Children.GetNext(child))
+    {
+        if (!index->Append(const_cast<JSON*>(child)))
+        {
+            ItemIndex::Destroy(index);
+            return 0;
+        }
+    }
+
+    if (!pIndex.CompareAndSet_Sync(0, index))
+    {
+        ItemIndex::Destroy(index);
+        index = pIndex.Load_Acquire();
+    }
+    return index;
+}
+
+// Keeps the index, if there is one, current after item was added at the end.
+void JSON::indexAppend(JSON* item)
+{
+    ItemIndex* index = getIndex();
+    if (index && !index->Append(item))
+        InvalidateIndex();
+}
+
 //-----------------------------------------------------------------------------
 // Adds a new item to the end of the child list
 void JSON::AddItem(const char *string, JSON *item)
@@ -1001,6 +1364,7 @@ void JSON::AddItem(const char *string, JSON *item)
     {
         item->Name = string;
         Children.PushBack(item);
+        indexAppend(item);
     }
 }
 
@@ -1049,6 +1413,7 @@ void JSON::RemoveLast()
     JSON* child = Children.GetLast();
     if (!Children.IsNull(child))
     {
+        InvalidateIndex();
         child->RemoveNode();
         child->Release();
     }
@@ -1177,6 +1542,7 @@ void JSON::AddArrayElement(JSON *item)
     if (item)
     {
         Children.PushBack(item);
+        indexAppend(item);
     }
 }
 
@@ -1188,6 +1554,8 @@ void JSON::InsertArrayElement(int index, JSON *item)
         return;
     }
 
+    InvalidateIndex();
+
     if (index == 0)
     {
         Children.PushFront(item);
@@ -1237,7 +1605,7 @@ const char* JSON::GetArrayString(int index)
     if (Type == JSON_Array)
     {
         JSON* number = GetItemByIndex(index);
-        return number ? number->Value : 0;
+        return number ? number->Value.ToCStr() : 0;
     }
 
     return 0;
@@ -1262,13 +1630,15 @@ JSON* JSON::Copy()
 
 char* JSON::PrintValue(bool fmt)
 {
-    return PrintValue(0, fmt);
+    JSONWriter writer(fmt);
+    writer.WriteValue(this);
+    return writer.DetachText();
 }
 
 //-----------------------------------------------------------------------------
 // Loads and parses the given JSON file pathname and returns a JSON object tree.
 // The returned object must be Released after use.
-JSON* JSON::Load(const char* path, const char** perror)
+JSON* JSON::Load(const char* path, const char** perror, AllocMode mode)
 {
     SysFile f;
     if (!f.Open(path, File::Open_Read, File::Mode_Read))
@@ -1291,7 +1661,7 @@ JSON* JSON::Load(const char* path, const char** perror)
     // Ensure the result is null-terminated since Parse() expects null-terminated input.
     buff[len] = '\0';
 
-    JSON* json = JSON::Parse((char*)buff, perror);
+    JSON* json = JSON::Parse((char*)buff, perror, mode);
     OVR_FREE(buff);
     return json;
 }
@@ -1304,31 +1674,131 @@ bool JSON::Save(const char* path)
     if (!f.Open(path, File::Open_Write | File::Open_Create | File::Open_Truncate, File::Mode_Write))
         return false;
 
-    char* text = PrintValue(0, true);
-    if (text)
+    JSONWriter writer(&f, true);
+    writer.WriteValue(this);
+    bool ok = writer.Flush();
+    f.Close();
+    return ok;
+}
+
+//-----------------------------------------------------------------------------
+// Reads a JSON tree from CBOR data
+JSON* JSON::ParseBinary(const void* data, size_t size, const char** perror, AllocMode mode)
+{
+    JSON* json = createRoot(mode, size);
+    if (!json)
     {
-        intptr_t len   = OVR_strlen(text);
-        OVR_ASSERT(len <= (intptr_t)(int)len);
+        AssignError(perror, "Error: Failed to allocate memory");
+        return 0;
+    }
 
-        int   bytes = f.Write((uint8_t*)text, (int)len);
-        f.Close();
-        OVR_FREE(text);
-        return (bytes == len);
+    CBORReader reader(data, size);
+    reader.Next();
+    if (json->readBinary(reader) && (reader.Next() == JSONToken_End))
+    {
+        if (perror)
+            *perror = 0;
+        return json;
     }
-    else
+
+    AssignError(perror, reader.GetError() ? reader.GetError() : "Error: Failed to allocate memory");
+    json->Release();
+    return 0;
+}
+
+bool JSON::readBinary(CBORReader& reader)
+{
+    switch (reader.GetToken())
     {
+    case JSONToken_Null:
+        Type = JSON_Null;
+        return true;
+
+    case JSONToken_Bool:
+        Type   = JSON_Bool;
+        dValue = reader.GetBool() ? 1. : 0.;
+        Value  = reader.GetBool() ? "true" : "false";
+        return true;
+
+    case JSONToken_Number:
+        Type   = JSON_Number;
+        dValue = reader.GetNumber();
+        return true;
+
+    case JSONToken_String:
+        Type = JSON_String;
+        Value.AssignString(reader.GetString(), reader.GetStringLength());
+        return true;
+
+    case JSONToken_BeginArray:
+        Type = JSON_Array;
+        while (reader.Next() != JSONToken_EndArray)
+        {
+            JSON* child = createChild();
+            if (!child)
+                return false;
+            Children.PushBack(child);
+            if (!child->readBinary(reader))
+                return false;
+        }
+        return true;
+
+    case JSONToken_BeginObject:
+        Type = JSON_Object;
+        while (reader.Next() == JSONToken_Name)
+        {
+            JSON* child = createChild();
+            if (!child)
+                return false;
+            Children.PushBack(child);
+            child->Name.AssignString(reader.GetString(), reader.GetStringLength());
+            reader.Next();
+            if (!child->readBinary(reader))
+                return false;
+        }
+        return reader.GetToken() == JSONToken_EndObject;
+
+    default:
         return false;
     }
 }
 
+//-----------------------------------------------------------------------------
+// Maps a CBOR file and reads the JSON tree in it
+JSON* JSON::LoadBinary(const char* path, const char** perror, AllocMode mode)
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        AssignError(perror, "Failed to open file");
+        return NULL;
+    }
+    return ParseBinary(file.GetData(), file.GetSize(), perror, mode);
+}
+
+//-----------------------------------------------------------------------------
+// Writes the JSON object to the given file path as CBOR
+bool JSON::SaveBinary(const char* path)
+{
+    SysFile f;
+    if (!f.Open(path, File::Open_Write | File::Open_Create | File::Open_Truncate, File::Mode_Write))
+        return false;
+
+    CBORWriter writer(&f);
+    writer.WriteSelfDescribeTag();
+    writer.WriteValue(this);
+    bool ok = writer.Flush();
+    f.Close();
+    return ok;
+}
+
 //-----------------------------------------------------------------------------
 // Serializes the JSON object to a String
 String JSON::Stringify(bool fmt)
 {
-    char* text = PrintValue(0, fmt);
-    String copy(text);
-    OVR_FREE(text);
-    return copy;
+    JSONWriter writer(fmt);
+    writer.WriteValue(this);
+    return String(writer.GetText(), writer.GetLength());
 }
 
 
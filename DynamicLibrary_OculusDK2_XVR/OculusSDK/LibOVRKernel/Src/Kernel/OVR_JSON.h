@@ -32,6 +32,7 @@ limitations under the License.
 #include "OVR_RefCount.h"
 #include "OVR_String.h"
 #include "OVR_List.h"
+#include "OVR_Atomic.h"
 
 namespace OVR {  
 
@@ -48,17 +49,69 @@ enum JSONItemType
     JSON_Object    = 6
 };
 
+//-----------------------------------------------------------------------------
+// ***** JSONText
+
+// Scanning and formatting of JSON text, shared by JSON, JSONReader and JSONWriter.
+// The scanning functions expect null-terminated text.
+
+namespace JSONText
+{
+    enum {
+        MaxNumberLength = 64    // Buffer size for FormatNumber.
+    };
+
+    // Returns the first position at or after in that is not whitespace.
+    const char* SkipWhitespace(const char* in);
+
+    // Parses the number at num into *value; returns the position after it.
+    const char* ParseNumber(const char* num, double* value);
+
+    // Returns the most bytes that the string whose opening quote is at str can
+    // take un-escaped, not counting the null.
+    size_t      MeasureString(const char* str);
+
+    // Returns the first quote, backslash or null at or after str.
+    const char* FindStringSpecial(const char* str);
+
+    // Un-escapes the string whose opening quote is at str into out, which must have
+    // room for MeasureString(str) + 1 bytes, and null-terminates it. Returns the
+    // position after the closing quote and the length in *outLength.
+    const char* ParseString(const char* str, char* out, size_t* outLength);
+
+    // Writes number as JSON text; returns its length.
+    size_t      FormatNumber(double number, char* buffer, size_t bufferSize);
+}
+
+
+class JSONArena;
+class CBORReader;
+
 //-----------------------------------------------------------------------------
 // ***** JSON
 
 // JSON object represents a JSON node that can be either a root of the JSON tree
 // or a child item. Every node has a type that describes what is is.
 // New JSON trees are typically loaded JSON::Load or created with JSON::Parse.
+//
+// Lookups by name and by index walk the children only for small nodes. Once a lookup
+// passes IndexMinItems children, the node builds an index of them: an array for
+// access by position and, for objects, a hash table of names. Items added at the end
+// keep the index current; inserting or removing items drops it, to be rebuilt by the
+// next lookup. Renaming a child or editing the child list through ListNode calls is
+// not tracked: call InvalidateIndex afterwards.
+//
+// Parse, ParseBuffer and Load can place the parsed nodes in an arena (Alloc_Arena)
+// instead of allocating each one. The tree works as usual and nodes can be added,
+// removed or kept alive on their own; the arena is freed with the last of its nodes.
 
 class JSON : public RefCountBase<JSON>, public ListNode<JSON>
 {
 protected:
+    struct ItemIndex;
+
     List<JSON>      Children;
+    mutable AtomicPtr<ItemIndex> pIndex;  // Built on demand; see buildIndex.
 
 public:
     JSONItemType    Type;       // Type of this JSON node.
@@ -69,6 +122,17 @@ public:
 public:
     ~JSON();
 
+    enum {
+        IndexMinItems = 8   // Nodes with fewer children are searched without an index.
+    };
+
+    // Node allocation used by Parse, ParseBuffer and Load.
+    enum AllocMode
+    {
+        Alloc_Heap,     // Each node is allocated on its own.
+        Alloc_Arena     // Nodes are packed into blocks shared by the tree.
+    };
+
     // *** Creation of NEW JSON objects
 
     static JSON*    CreateObject() { return new JSON(JSON_Object);}
@@ -81,18 +145,29 @@ public:
 
     // Creates a new JSON object from parsing string.
     // Returns null pointer and fills in *perror in case of parse error.
-    static JSON*    Parse(const char* buff, const char** perror = 0);
+    static JSON*    Parse(const char* buff, const char** perror = 0, AllocMode mode = Alloc_Heap);
 
 	// This version works for buffers that are not null terminated strings.
-	static JSON*	ParseBuffer(const char *buff, int len, const char** perror = 0);
+	static JSON*	ParseBuffer(const char *buff, int len, const char** perror = 0, AllocMode mode = Alloc_Heap);
 
     // Loads and parses a JSON object from a file.
     // Returns 0 and assigns perror with error message on fail.
-    static JSON*    Load(const char* path, const char** perror = 0);
+    static JSON*    Load(const char* path, const char** perror = 0, AllocMode mode = Alloc_Heap);
 
     // Saves a JSON object to a file.
     bool            Save(const char* path);
 
+    // Creates a JSON object from its binary (CBOR) form; see OVR_JSONBinary.h.
+    // Numbers keep their value but not their text, as with CreateNumber.
+    // Returns null pointer and fills in *perror in case of error.
+    static JSON*    ParseBinary(const void* data, size_t size, const char** perror = 0, AllocMode mode = Alloc_Heap);
+
+    // Maps a binary JSON file into memory and reads it.
+    static JSON*    LoadBinary(const char* path, const char** perror = 0, AllocMode mode = Alloc_Heap);
+
+    // Saves a JSON object to a file in binary form.
+    bool            SaveBinary(const char* path);
+
     // Return the String representation of a JSON object.
     String          Stringify(bool fmt);
 
@@ -104,11 +179,15 @@ public:
     JSON*           GetFirstItem()           { return (!Children.IsEmpty()) ? Children.GetFirst() : 0; }
     JSON*           GetLastItem()            { return (!Children.IsEmpty()) ? Children.GetLast() : 0; }
 
-    // Counts the number of items in the object; these methods are inefficient.
+    // Counts the number of items in the object. Lookups are constant time once
+    // the node has been indexed.
     unsigned        GetItemCount() const;
     JSON*           GetItemByIndex(unsigned i);
     JSON*           GetItemByName(const char* name);
 
+    // Drops the child index after changes the node can't see; see above.
+    void            InvalidateIndex();
+
 	// Accessors by name
 	double			GetNumberByName(const char *name, double defValue = 0.0);
 	int				GetIntByName(const char *name, int defValue = 0);
@@ -141,7 +220,7 @@ public:
     void            AddArrayInt(int n)              { AddArrayElement(CreateInt(n)); }
     void            AddArrayString(const char* s)   { AddArrayElement(CreateString(s)); }
 
-    // Accessed array elements; currently inefficient.
+    // Accessed array elements; constant time once the array has been indexed.
     int             GetArraySize();
     double          GetArrayNumber(int index);
     const char*     GetArrayString(int index);
@@ -149,10 +228,33 @@ public:
     JSON*           Copy();  // Create a copy of this object
 
     // Return text value of JSON. Use OVR_FREE when done with return value
+    // JSONWriter writes large trees without holding all the text.
     char*           PrintValue(bool fmt);
 protected:
     JSON(JSONItemType itemType = JSON_Object);
 
+    // Nodes are allocated behind a header that records their arena, if any,
+    // so that Release can give arena nodes back to it.
+#ifdef OVR_DEFINE_NEW
+#undef new
+#endif
+    void*           operator new(size_t size);
+    void*           operator new(size_t size, const char* file, int line);
+    void            operator delete(void* p);
+    void            operator delete(void* p, const char* file, int line);
+#ifdef OVR_DEFINE_NEW
+#define new OVR_DEFINE_NEW
+#endif
+
+    static JSON*    createNode(JSONArena* arena);
+    static JSON*    createRoot(AllocMode mode, size_t textSize);
+    JSON*           createChild();
+
+    // Child index helpers.
+    ItemIndex*      getIndex() const;
+    ItemIndex*      buildIndex() const;
+    void            indexAppend(JSON* item);
+
     // JSON Parsing helper functions.
     const char*     parseValue(const char *buff, const char** perror);
     const char*     parseNumber(const char *num);
@@ -160,9 +262,10 @@ protected:
     const char*     parseObject(const char* value, const char** perror);
     const char*     parseString(const char* str, const char** perror);
 
-    char*           PrintValue(int depth, bool fmt);
-    char*           PrintObject(int depth, bool fmt);
-    char*           PrintArray(int depth, bool fmt);
+    // CBOR reading helper; reads the value at the current token of reader, and its
+    // children.
+    friend class CBORReader;
+    bool            readBinary(CBORReader& reader);
 };
 
 
@@ -0,0 +1,641 @@
+/************************************************************************************
+
+Filename    :   OVR_JSONBinary.cpp
+Content     :   Binary (CBOR) encoding of JSON documents
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#include "OVR_JobSystem.h"
+
+#include "OVR_JSONBinary.h"
+#include "OVR_Log.h"
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+#include <string.h>
+
+namespace OVR {
+
+
+// The initial byte of a CBOR item has the major type in its top 3 bits. The low 5
+// bits hold small arguments, the size of a larger argument that follows, or
+// Info_Indefinite. Simple values use them for false, true, null and the floats.
+enum CBORInfo
+{
+    Info_OneByte    = 24,
+    Info_Half       = 25,
+    Info_Float      = 26,
+    Info_Double     = 27,
+    Info_Indefinite = 31,
+
+    Info_False      = 20,
+    Info_True       = 21,
+    Info_Null       = 22,
+    Info_Undefined  = 23
+};
+
+static const uint8_t CBORBreak = 0xFF;
+
+static uint8_t initialByte(CBORMajorType major, unsigned info)
+{
+    return (uint8_t)((major << 5) | info);
+}
+
+// IEEE half-precision to double; RFC 7049, appendix D.
+static double halfToDouble(uint16_t half)
+{
+    int    exponent = (half >> 10) & 0x1F;
+    double mantissa = half & 0x3FF;
+    double value;
+
+    if (exponent == 0)
+        value = ldexp(mantissa, -24);
+    else if (exponent != 31)
+        value = ldexp(mantissa + 1024, exponent - 25);
+    else if (mantissa == 0)
+        value = HUGE_VAL;
+    else
+    {
+        uint64_t nan = 0x7FF8000000000000ULL;
+        memcpy(&value, &nan, sizeof(value));
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+
+//-----------------------------------------------------------------------------
+// ***** CBORReader
+
+CBORReader::CBORReader(const void* data, size_t size) :
+    pData((const uint8_t*)data),
+    Token(JSONToken_None),
+    pString(0),
+    StringLength(0),
+    Number(0.),
+    ItemCount(0),
+    pError(0)
+{
+    pPos = pData;
+    pEnd = pData + (data ? size : 0);
+}
+
+JSONToken CBORReader::setError(const char* error)
+{
+    if (!pError)
+        pError = error;
+    return Token = JSONToken_Error;
+}
+
+JSONToken CBORReader::Next()
+{
+    if ((Token == JSONToken_End) || (Token == JSONToken_Error))
+        return Token;
+
+    if (Levels.IsEmpty())
+    {
+        if (Token == JSONToken_None)
+            return readItem(false);
+
+        // The root value has been read.
+        if (pPos != pEnd)
+            return setError("Syntax Error: Data after the end of the document");
+        return Token = JSONToken_End;
+    }
+
+    Level& level = Levels.Back();
+    if ((level.Remaining == 0) || ((level.Remaining < 0) && (pPos < pEnd) && (*pPos == CBORBreak)))
+    {
+        if (level.Remaining < 0)
+        {
+            pPos++;
+            if (!level.NameNext)
+                return setError("Syntax Error: Missing value after name");
+        }
+        bool object = level.Object;
+        Levels.PopBack();
+        return Token = object ? JSONToken_EndObject : JSONToken_EndArray;
+    }
+
+    if (level.Remaining > 0)
+        level.Remaining--;
+
+    bool name = level.Object && level.NameNext;
+    if (level.Object)
+        level.NameNext = !level.NameNext;
+    return readItem(name);
+}
+
+// Reads the initial byte of an item and the argument that follows it, if any.
+bool CBORReader::readHead(uint8_t* major, uint8_t* info, uint64_t* argument)
+{
+    if (pPos >= pEnd)
+    {
+        setError("Syntax Error: Unexpected end of data");
+        return false;
+    }
+
+    *major    = *pPos >> 5;
+    *info     = *pPos & 0x1F;
+    *argument = *info;
+    pPos++;
+
+    if ((*info < Info_OneByte) || (*info == Info_Indefinite))
+        return true;
+    if (*info > Info_Double)
+    {
+        setError("Syntax Error: Invalid CBOR item");
+        return false;
+    }
+
+    size_t bytes = (size_t)1 << (*info - Info_OneByte);
+    if ((size_t)(pEnd - pPos) < bytes)
+    {
+        setError("Syntax Error: Unexpected end of data");
+        return false;
+    }
+
+    *argument = 0;
+    for (size_t i = 0; i < bytes; i++)
+        *argument = (*argument << 8) | pPos[i];
+    pPos += bytes;
+    return true;
+}
+
+JSONToken CBORReader::readItem(bool name)
+{
+    uint8_t  major, info;
+    uint64_t argument;
+
+    // Tags qualify the item that follows; the JSON model has no use for them.
+    do
+    {
+        if (!readHead(&major, &info, &argument))
+            return Token;
+    }
+    while (major == CBOR_Tag);
+
+    if (name && (major != CBOR_Text) && (major != CBOR_Bytes))
+        return setError("Syntax Error: Object member name is not a string");
+    if ((info == Info_Indefinite) && ((major < CBOR_Bytes) || (major == CBOR_Simple)))
+        return setError("Syntax Error: Invalid CBOR item");
+
+    switch (major)
+    {
+    case CBOR_Unsigned:
+        Number = (double)argument;
+        return Token = JSONToken_Number;
+
+    case CBOR_Negative:
+        // -1 - argument, which doesn't overflow as a double.
+        Number = (argument != ~(uint64_t)0) ? -(double)(argument + 1) : -18446744073709551616.0;
+        return Token = JSONToken_Number;
+
+    case CBOR_Bytes:
+    case CBOR_Text:
+        if (info == Info_Indefinite)
+            return setError("Error: Chunked CBOR strings are not supported");
+        if (argument > (uint64_t)(pEnd - pPos))
+            return setError("Syntax Error: Unexpected end of data");
+        pString      = (const char*)pPos;
+        StringLength = (size_t)argument;
+        pPos        += StringLength;
+        return Token = name ? JSONToken_Name : JSONToken_String;
+
+    case CBOR_Array:
+        return beginLevel(false, info, argument);
+
+    case CBOR_Map:
+        return beginLevel(true, info, argument);
+
+    default:
+        switch (info)
+        {
+        case Info_False:
+        case Info_True:
+            Number = (info == Info_True) ? 1. : 0.;
+            return Token = JSONToken_Bool;
+
+        case Info_Null:
+        case Info_Undefined:
+            return Token = JSONToken_Null;
+
+        case Info_Half:
+            Number = halfToDouble((uint16_t)argument);
+            return Token = JSONToken_Number;
+
+        case Info_Float:
+        {
+            uint32_t bits = (uint32_t)argument;
+            float    value;
+            memcpy(&value, &bits, sizeof(value));
+            Number = value;
+            return Token = JSONToken_Number;
+        }
+
+        case Info_Double:
+            memcpy(&Number, &argument, sizeof(Number));
+            return Token = JSONToken_Number;
+
+        default:
+            return setError("Syntax Error: Unexpected CBOR simple value");
+        }
+    }
+}
+
+JSONToken CBORReader::beginLevel(bool object, uint8_t info, uint64_t count)
+{
+    if (Levels.GetSize() >= MaxDepth)
+        return setError("Syntax Error: Objects and arrays are nested too deeply");
+
+    Level level;
+    level.Object   = object;
+    level.NameNext = true;
+
+    if (info == Info_Indefinite)
+    {
+        level.Remaining = -1;
+        ItemCount       = -1;
+    }
+    else
+    {
+        // Every item takes at least a byte, which bounds a sane count.
+        uint64_t available = (uint64_t)(pEnd - pPos);
+        if ((count > available) || (object && (count * 2 > available)))
+            return setError("Syntax Error: Unexpected end of data");
+
+        level.Remaining = (int64_t)(object ? count * 2 : count);
+        ItemCount       = (count > (uint64_t)INT_MAX) ? INT_MAX : (int)count;
+    }
+
+    Levels.PushBack(level);
+    return Token = object ? JSONToken_BeginObject : JSONToken_BeginArray;
+}
+
+bool CBORReader::SkipValue()
+{
+    if (Token == JSONToken_Name)
+        Next();
+
+    if ((Token == JSONToken_BeginObject) || (Token == JSONToken_BeginArray))
+    {
+        size_t depth = Levels.GetSize();
+        while (Levels.GetSize() >= depth)
+        {
+            if (Next() == JSONToken_Error)
+                return false;
+        }
+    }
+    return Token != JSONToken_Error;
+}
+
+JSON* CBORReader::ReadValue()
+{
+    String name;
+    bool   named = (Token == JSONToken_Name);
+    if (named)
+    {
+        name.AssignString(pString, StringLength);
+        Next();
+    }
+
+    JSON* node = JSON::createRoot(JSON::Alloc_Heap, 0);
+    if (node && !node->readBinary(*this))
+    {
+        node->Release();
+        return 0;
+    }
+    if (node && named)
+        node->Name = name;
+    return node;
+}
+
+bool CBORReader::Accept(JSONHandler& handler)
+{
+    for (;;)
+    {
+        bool ok = true;
+
+        switch (Next())
+        {
+        case JSONToken_BeginObject: ok = handler.OnBeginObject();                      break;
+        case JSONToken_EndObject:   ok = handler.OnEndObject();                        break;
+        case JSONToken_BeginArray:  ok = handler.OnBeginArray();                       break;
+        case JSONToken_EndArray:    ok = handler.OnEndArray();                         break;
+        case JSONToken_Name:        ok = handler.OnName(pString, StringLength);        break;
+        case JSONToken_String:      ok = handler.OnString(pString, StringLength);      break;
+        case JSONToken_Number:      ok = handler.OnNumber(Number);                     break;
+        case JSONToken_Bool:        ok = handler.OnBool(GetBool());                    break;
+        case JSONToken_Null:        ok = handler.OnNull();                             break;
+        case JSONToken_End:         return true;
+        default:                    return false;
+        }
+
+        if (!ok)
+            return false;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// ***** CBORWriter
+
+CBORWriter::CBORWriter() :
+    pBuffer(0),
+    Capacity(0),
+    Used(0),
+    pFile(0),
+    Failed(false)
+{
+}
+
+CBORWriter::CBORWriter(File* file, size_t bufferSize) :
+    pBuffer((uint8_t*)OVR_ALLOC(bufferSize)),
+    Capacity(bufferSize),
+    Used(0),
+    pFile(file),
+    Failed(false)
+{
+    if (!pBuffer)
+    {
+        Capacity = 0;
+        Failed   = true;
+    }
+}
+
+CBORWriter::~CBORWriter()
+{
+    if (pFile)
+        Flush();
+    OVR_FREE(pBuffer);
+}
+
+bool CBORWriter::Flush()
+{
+    if (pFile && !Failed && Used)
+    {
+        if (pFile->Write(pBuffer, (int)Used) != (int)Used)
+            Failed = true;
+        Used = 0;
+    }
+    return !Failed;
+}
+
+uint8_t* CBORWriter::DetachData()
+{
+    OVR_ASSERT(!pFile);
+    if (Failed || (!pBuffer && !reserve(1)))
+        return 0;
+
+    uint8_t* data = pBuffer;
+    pBuffer  = 0;
+    Capacity = 0;
+    Used     = 0;
+    Levels.Clear();
+    return data;
+}
+
+void CBORWriter::Reset()
+{
+    Used   = 0;
+    Failed = false;
+    Levels.Clear();
+}
+
+// Makes room for size more bytes; a file writer's buffer is flushed, a memory
+// writer's buffer grows. Returns false if output is being dropped.
+bool CBORWriter::reserve(size_t size)
+{
+    if (Failed)
+        return false;
+    if (Used + size <= Capacity)
+        return true;
+
+    if (pFile)
+    {
+        OVR_ASSERT(size <= Capacity);
+        return Flush();
+    }
+
+    size_t   capacity = Alg::Max(Alg::Max(Used + size, Capacity * 2), (size_t)256);
+    uint8_t* buffer   = (uint8_t*)OVR_REALLOC(pBuffer, capacity);
+    if (!buffer)
+    {
+        Failed = true;
+        return false;
+    }
+    pBuffer  = buffer;
+    Capacity = capacity;
+    return true;
+}
+
+void CBORWriter::write(const void* data, size_t length)
+{
+    if (pFile && (length > Capacity))
+    {
+        // Too large for the buffer; write it through.
+        if (Flush() && (pFile->Write((const uint8_t*)data, (int)length) != (int)length))
+            Failed = true;
+        return;
+    }
+
+    if (reserve(length))
+    {
+        memcpy(pBuffer + Used, data, length);
+        Used += length;
+    }
+}
+
+// Writes initial followed by the low bytes of value, big-endian.
+void CBORWriter::writeFixed(uint8_t initial, uint64_t value, size_t bytes)
+{
+    uint8_t item[9];
+    item[0] = initial;
+    for (size_t i = bytes; i > 0; i--, value >>= 8)
+        item[i] = (uint8_t)value;
+    write(item, bytes + 1);
+}
+
+// Writes an item head with argument in the fewest bytes.
+void CBORWriter::writeHead(CBORMajorType major, uint64_t argument)
+{
+    if (argument < Info_OneByte)
+        put(initialByte(major, (unsigned)argument));
+    else if (argument <= 0xFF)
+        writeFixed(initialByte(major, Info_OneByte), argument, 1);
+    else if (argument <= 0xFFFF)
+        writeFixed(initialByte(major, Info_OneByte + 1), argument, 2);
+    else if (argument <= 0xFFFFFFFF)
+        writeFixed(initialByte(major, Info_OneByte + 2), argument, 4);
+    else
+        writeFixed(initialByte(major, Info_OneByte + 3), argument, 8);
+}
+
+void CBORWriter::WriteSelfDescribeTag()
+{
+    writeHead(CBOR_Tag, CBOR_SelfDescribeTag);
+}
+
+void CBORWriter::BeginObject(int count)
+{
+    if (count < 0)
+        put(initialByte(CBOR_Map, Info_Indefinite));
+    else
+        writeHead(CBOR_Map, (uint64_t)count);
+    Levels.PushBack(count < 0);
+}
+
+void CBORWriter::EndObject()
+{
+    OVR_ASSERT(!Levels.IsEmpty());
+    if (Levels.Back())
+        put(CBORBreak);
+    Levels.PopBack();
+}
+
+void CBORWriter::BeginArray(int count)
+{
+    if (count < 0)
+        put(initialByte(CBOR_Array, Info_Indefinite));
+    else
+        writeHead(CBOR_Array, (uint64_t)count);
+    Levels.PushBack(count < 0);
+}
+
+void CBORWriter::EndArray()
+{
+    OVR_ASSERT(!Levels.IsEmpty());
+    if (Levels.Back())
+        put(CBORBreak);
+    Levels.PopBack();
+}
+
+void CBORWriter::WriteName(const char* name)
+{
+    WriteString(name, name ? OVR_strlen(name) : 0);
+}
+
+void CBORWriter::WriteName(const char* name, size_t length)
+{
+    WriteString(name, length);
+}
+
+void CBORWriter::WriteString(const char* str)
+{
+    WriteString(str, str ? OVR_strlen(str) : 0);
+}
+
+void CBORWriter::WriteString(const char* str, size_t length)
+{
+    writeHead(CBOR_Text, length);
+    write(str, length);
+}
+
+void CBORWriter::WriteNumber(double number)
+{
+    uint64_t bits;
+    memcpy(&bits, &number, sizeof(bits));
+
+    // Whole numbers are written as integers, except -0, whose sign would be lost.
+    if ((number == floor(number)) && (fabs(number) < 9.2e18) && (bits != 0x8000000000000000ULL))
+    {
+        WriteInt((int64_t)number);
+        return;
+    }
+
+    // Other numbers as a float if that holds them exactly, or else as a double.
+    if ((fabs(number) <= FLT_MAX) && ((double)(float)number == number))
+    {
+        float    value = (float)number;
+        uint32_t floatBits;
+        memcpy(&floatBits, &value, sizeof(floatBits));
+        writeFixed(initialByte(CBOR_Simple, Info_Float), floatBits, 4);
+    }
+    else
+    {
+        writeFixed(initialByte(CBOR_Simple, Info_Double), bits, 8);
+    }
+}
+
+void CBORWriter::WriteInt(int64_t number)
+{
+    if (number >= 0)
+        writeHead(CBOR_Unsigned, (uint64_t)number);
+    else
+        writeHead(CBOR_Negative, (uint64_t)(-(number + 1)));
+}
+
+void CBORWriter::WriteBool(bool value)
+{
+    put(initialByte(CBOR_Simple, value ? Info_True : Info_False));
+}
+
+void CBORWriter::WriteNull()
+{
+    put(initialByte(CBOR_Simple, Info_Null));
+}
+
+void CBORWriter::WriteValue(JSON* node)
+{
+    switch (node->Type)
+    {
+        case JSON_Null:     WriteNull();                                            break;
+        case JSON_Bool:     WriteBool((int)node->dValue != 0);                      break;
+        case JSON_Number:   WriteNumber(node->dValue);                              break;
+        case JSON_String:   WriteString(node->Value.ToCStr(), node->Value.GetSize()); break;
+
+        case JSON_Array:
+        case JSON_Object:
+        {
+            // Counted by walking the children, which GetItemCount might index.
+            int count = 0;
+            for (JSON* child = node->GetFirstItem(); child; child = node->GetNextItem(child))
+                count++;
+
+            if (node->Type == JSON_Array)
+            {
+                BeginArray(count);
+                for (JSON* child = node->GetFirstItem(); child; child = node->GetNextItem(child))
+                    WriteValue(child);
+                EndArray();
+            }
+            else
+            {
+                BeginObject(count);
+                for (JSON* child = node->GetFirstItem(); child; child = node->GetNextItem(child))
+                {
+                    WriteName(child->Name.ToCStr(), child->Name.GetSize());
+                    WriteValue(child);
+                }
+                EndObject();
+            }
+            break;
+        }
+
+        case JSON_None:
+            OVR_ASSERT_LOG(false, ("Bad JSON type."));
+            WriteNull();
+            break;
+    }
+}
+
+
+} // namespace OVR
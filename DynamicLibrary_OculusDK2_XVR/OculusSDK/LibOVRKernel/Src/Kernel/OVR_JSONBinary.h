@@ -0,0 +1,250 @@
+/************************************************************************************
+
+PublicHeader:   None
+Filename    :   OVR_JSONBinary.h
+Content     :   Binary (CBOR) encoding of JSON documents
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+
+#ifndef OVR_JSONBinary_h
+#define OVR_JSONBinary_h
+
+#include "OVR_JSON.h"
+#include "OVR_JSONStream.h"
+#include "OVR_File.h"
+#include "OVR_Array.h"
+
+namespace OVR {
+
+
+// JSON documents in binary form are CBOR (RFC 7049), which maps one to one onto the
+// JSON model: objects are maps with text keys, arrays, text strings, numbers, true,
+// false and null. Whole numbers are stored as integers and other numbers as the
+// smallest float that holds them exactly, so numbers keep their exact double value.
+// Files written by JSON::SaveBinary start with the CBOR self-describe tag, which
+// tools use to tell CBOR from other data.
+
+enum CBORMajorType
+{
+    CBOR_Unsigned   = 0,
+    CBOR_Negative   = 1,
+    CBOR_Bytes      = 2,
+    CBOR_Text       = 3,
+    CBOR_Array      = 4,
+    CBOR_Map        = 5,
+    CBOR_Tag        = 6,
+    CBOR_Simple     = 7     // false, true, null, floats and the break code.
+};
+
+enum {
+    CBOR_SelfDescribeTag = 55799
+};
+
+
+//-----------------------------------------------------------------------------
+// ***** CBORReader
+
+// CBORReader reads a CBOR document in memory one token at a time, in the same
+// tokens as JSONReader. It copies nothing: names and strings are views into the
+// data, so the data must outlive them. This suits a MappedFile, which is read in
+// place and paged in as the reader gets to it.
+//
+// Besides what CBORWriter writes, the reader accepts tags, which are skipped, byte
+// strings, read as strings, half-precision floats, and undefined, read as null.
+// Chunked strings are not supported since they can't be viewed in place.
+//
+// Example usage:
+//     MappedFile file;
+//     file.Open("Stats.cbor");
+//     CBORReader reader(file.GetData(), file.GetSize());
+//     while (reader.Next() == JSONToken_Name)   // Members of the root object...
+//     {
+//         String name(reader.GetString(), reader.GetStringLength());
+//         ...
+//     }
+
+class CBORReader
+{
+public:
+    enum {
+        MaxDepth = 512  // Deeper documents are a syntax error; ReadValue recurses per level.
+    };
+
+    // Reads size bytes at data, which must stay valid while the reader and the
+    // strings it returns are in use.
+    CBORReader(const void* data, size_t size);
+
+    // Reads the next token and returns it. After End or Error, returns the same again.
+    JSONToken   Next();
+
+    JSONToken   GetToken() const        { return Token; }
+    // Name or String, as a view into the data. Not null-terminated.
+    const char* GetString() const       { return pString; }
+    size_t      GetStringLength() const { return StringLength; }
+    double      GetNumber() const       { return Number; }
+    bool        GetBool() const         { return Number != 0.; }
+    // Number of items of the object or array that was just begun, or -1 if the
+    // data doesn't say up front.
+    int         GetItemCount() const    { return ItemCount; }
+    // Number of objects and arrays that are open.
+    int         GetDepth() const        { return (int)Levels.GetSize(); }
+    const char* GetError() const        { return pError; }
+    // Position of the next token in the data.
+    size_t      GetOffset() const       { return pPos - pData; }
+
+    // Skips the value that starts at the current token, or that follows it if it is
+    // a Name; after an object or array, the current token is its end. Returns false
+    // on error.
+    bool        SkipValue();
+
+    // Reads the value that starts at, or follows, the current token into a new tree,
+    // which is named if the current token is a Name. Returns null on error.
+    JSON*       ReadValue();
+
+    // Reads the rest of the document into handler. Returns false on error or if the
+    // handler stopped.
+    bool        Accept(JSONHandler& handler);
+
+private:
+    struct Level
+    {
+        int64_t     Remaining;      // Items left to read, or -1 until the break code.
+        bool        Object;
+        bool        NameNext;       // Objects alternate between names and values.
+    };
+
+    bool        readHead(uint8_t* major, uint8_t* info, uint64_t* argument);
+    JSONToken   readItem(bool name);
+    JSONToken   beginLevel(bool object, uint8_t info, uint64_t count);
+    JSONToken   setError(const char* error);
+
+    const uint8_t*  pData;
+    const uint8_t*  pPos;
+    const uint8_t*  pEnd;
+
+    JSONToken       Token;
+    ArrayPOD<Level> Levels;
+    const char*     pString;
+    size_t          StringLength;
+    double          Number;
+    int             ItemCount;
+    const char*     pError;
+
+    // Not copyable.
+    CBORReader(const CBORReader&);
+    void operator = (const CBORReader&);
+};
+
+
+//-----------------------------------------------------------------------------
+// ***** CBORWriter
+
+// CBORWriter writes CBOR as it is produced, either into a buffer that it owns and
+// reuses after Reset, or to a File through a buffer. It has the calls of JSONWriter,
+// and reads back with CBORReader.
+//
+// Objects and arrays begun with their item count have it written up front, which
+// lets readers size them; ones begun without a count are closed by a break code,
+// for when the count isn't known until the end.
+//
+// Example usage:
+//     CBORWriter writer(file);
+//     writer.BeginObject();
+//     writer.WriteName("frames");
+//     writer.BeginArray(frameCount);
+//     for (...)
+//         writer.WriteNumber(frameTime);
+//     writer.EndArray();
+//     writer.EndObject();
+//     writer.Flush();
+
+class CBORWriter
+{
+public:
+    enum {
+        DefaultBufferSize = 16 * 1024
+    };
+
+    // Writes to memory; the data is in GetData.
+    CBORWriter();
+    // Writes to file, flushing the buffer when it is full and on destruction.
+    CBORWriter(File* file, size_t bufferSize = DefaultBufferSize);
+    ~CBORWriter();
+
+    // Writes the self-describe tag that marks the data as CBOR; goes first.
+    void        WriteSelfDescribeTag();
+
+    // Count is the number of members or items, or -1 if not known yet.
+    void        BeginObject(int count = -1);
+    void        EndObject();
+    void        BeginArray(int count = -1);
+    void        EndArray();
+    // Starts a member of the current object; its value is written next.
+    void        WriteName(const char* name);
+    void        WriteName(const char* name, size_t length);
+    void        WriteString(const char* str);
+    void        WriteString(const char* str, size_t length);
+    void        WriteNumber(double number);
+    void        WriteInt(int64_t number);
+    void        WriteBool(bool value);
+    void        WriteNull();
+    // Writes node and its children.
+    void        WriteValue(JSON* node);
+
+    // Writes buffered data to the file. Returns false if any write has failed.
+    bool        Flush();
+    // True if memory ran out or a file write failed; further output is dropped.
+    bool        HasError() const        { return Failed; }
+
+    // Data written to memory.
+    const uint8_t* GetData() const      { OVR_ASSERT(!pFile); return pBuffer; }
+    size_t      GetSize() const         { return Used; }
+    // Returns the data in memory allocated with OVR_ALLOC, to be freed with OVR_FREE,
+    // and leaves the writer empty. Returns null on error.
+    uint8_t*    DetachData();
+    // Empties the writer for a new document, keeping its buffer.
+    void        Reset();
+
+private:
+    void        writeHead(CBORMajorType major, uint64_t argument);
+    void        writeFixed(uint8_t initial, uint64_t value, size_t bytes);
+    bool        reserve(size_t size);
+    void        write(const void* data, size_t length);
+    void        put(uint8_t byte)           { if (reserve(1)) pBuffer[Used++] = byte; }
+
+    uint8_t*        pBuffer;
+    size_t          Capacity;
+    size_t          Used;
+    File*           pFile;
+    bool            Failed;
+    ArrayPOD<bool>  Levels;         // For each open object or array, whether it ends with a break.
+
+    // Not copyable.
+    CBORWriter(const CBORWriter&);
+    void operator = (const CBORWriter&);
+};
+
+
+} // namespace OVR
+
+#endif // OVR_JSONBinary_h
@@ -0,0 +1,803 @@
+/************************************************************************************
+
+Filename    :   OVR_JSONStream.cpp
+Content     :   Streaming JSON reader and writer
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#include "OVR_JobSystem.h"
+
+#include "OVR_JSONStream.h"
+#include "OVR_Log.h"
+
+namespace OVR {
+
+
+//-----------------------------------------------------------------------------
+// ***** JSONReader
+
+JSONReader::JSONReader(const char* text) :
+    pPos(text ? text : ""),
+    pBuffer(0),
+    BufferSize(0),
+    pFile(0),
+    FileEnd(true),
+    Token(JSONToken_None),
+    ExpectNext(Expect_Value),
+    pString(0),
+    StringLength(0),
+    StringCapacity(0),
+    Number(0.),
+    pError(0)
+{
+    pEnd = pPos + OVR_strlen(pPos);
+}
+
+JSONReader::JSONReader(File* file, size_t bufferSize) :
+    pBuffer((char*)OVR_ALLOC(bufferSize + 1)),
+    BufferSize(bufferSize),
+    pFile(file),
+    FileEnd(false),
+    Token(JSONToken_None),
+    ExpectNext(Expect_Value),
+    pString(0),
+    StringLength(0),
+    StringCapacity(0),
+    Number(0.),
+    pError(0)
+{
+    if (!pBuffer)
+    {
+        BufferSize = 0;
+        FileEnd    = true;
+        pPos = pEnd = "";
+        setError("Error: Failed to allocate memory");
+        return;
+    }
+    pBuffer[0] = 0;
+    pPos = pEnd = pBuffer;
+}
+
+JSONReader::~JSONReader()
+{
+    if (pFile)
+        OVR_FREE(pBuffer);
+    OVR_FREE(pString);
+}
+
+// Moves the text from pPos to the start of the buffer and reads more after it,
+// growing the buffer if it is full. Returns false at the end of the input.
+bool JSONReader::fill()
+{
+    if (FileEnd)
+        return false;
+
+    size_t kept = pEnd - pPos;
+    memmove(pBuffer, pPos, kept);
+
+    if (kept == BufferSize)
+    {
+        char* buffer = (char*)OVR_REALLOC(pBuffer, BufferSize * 2 + 1);
+        if (!buffer)
+        {
+            FileEnd = true;
+            setError("Error: Failed to allocate memory");
+            return false;
+        }
+        pBuffer     = buffer;
+        BufferSize *= 2;
+    }
+
+    int bytes = pFile->Read((uint8_t*)pBuffer + kept, (int)(BufferSize - kept));
+    if (bytes <= 0)
+    {
+        bytes   = 0;
+        FileEnd = true;
+    }
+
+    pPos = pBuffer;
+    pEnd = pBuffer + kept + bytes;
+    pBuffer[kept + bytes] = 0;
+    return bytes > 0;
+}
+
+// Skips whitespace and returns the next character, or 0 at the end.
+char JSONReader::peek()
+{
+    for (;;)
+    {
+        pPos = JSONText::SkipWhitespace(pPos);
+        if ((pPos < pEnd) || !fill())
+            return *pPos;
+    }
+}
+
+JSONToken JSONReader::setError(const char* error)
+{
+    if (!pError)
+        pError = error;
+    return Token = JSONToken_Error;
+}
+
+bool JSONReader::setString(const char* text, size_t length)
+{
+    if (length + 1 > StringCapacity)
+    {
+        size_t capacity = Alg::Max(length + 1, StringCapacity * 2);
+        char*  str      = (char*)OVR_REALLOC(pString, capacity);
+        if (!str)
+            return false;
+        pString        = str;
+        StringCapacity = capacity;
+    }
+    if (text)
+        memcpy(pString, text, length);
+    pString[length] = 0;
+    StringLength    = length;
+    return true;
+}
+
+JSONToken JSONReader::Next()
+{
+    if ((Token == JSONToken_End) || (Token == JSONToken_Error))
+        return Token;
+
+    char c = peek();
+
+    if (ExpectNext == Expect_CommaOrClose)
+    {
+        if (c != ',')
+            return closeLevel(c);
+
+        pPos++;
+        ExpectNext = (Levels.Back() == '{') ? Expect_Name : Expect_Value;
+        c = peek();
+    }
+    else if ((ExpectNext == Expect_NameOrClose) || (ExpectNext == Expect_ValueOrClose))
+    {
+        if ((c == '}') || (c == ']'))
+            return closeLevel(c);
+
+        ExpectNext = (ExpectNext == Expect_NameOrClose) ? Expect_Name : Expect_Value;
+    }
+    else if (ExpectNext == Expect_End)
+    {
+        // Like JSON::Parse, ignore anything after the root value.
+        return Token = JSONToken_End;
+    }
+
+    if (ExpectNext == Expect_Name)
+    {
+        if (c != '\"')
+            return setError("Syntax Error: Missing quote");
+        if (!readString())
+            return Token;
+        if (peek() != ':')
+            return setError("Syntax Error: Missing colon");
+
+        pPos++;
+        ExpectNext = Expect_Value;
+        return Token = JSONToken_Name;
+    }
+
+    return readValue(c);
+}
+
+JSONToken JSONReader::readValue(char c)
+{
+    switch (c)
+    {
+    case '{':
+    case '[':
+        if (Levels.GetSize() >= MaxDepth)
+            return setError("Syntax Error: Objects and arrays are nested too deeply");
+        pPos++;
+        Levels.PushBack(c);
+        ExpectNext = (c == '{') ? Expect_NameOrClose : Expect_ValueOrClose;
+        return Token = (c == '{') ? JSONToken_BeginObject : JSONToken_BeginArray;
+
+    case '\"':
+        if (!readString())
+            return Token;
+        endValue();
+        return Token = JSONToken_String;
+
+    case 't':
+    case 'f':
+    case 'n':
+        while ((pEnd - pPos < 5) && fill())
+            ;
+        if (!OVR_strncmp(pPos, "null", 4))
+        {
+            pPos  += 4;
+            Number = 0.;
+            endValue();
+            return Token = JSONToken_Null;
+        }
+        if (!OVR_strncmp(pPos, "false", 5))
+        {
+            pPos  += 5;
+            Number = 0.;
+            endValue();
+            return Token = JSONToken_Bool;
+        }
+        if (!OVR_strncmp(pPos, "true", 4))
+        {
+            pPos  += 4;
+            Number = 1.;
+            endValue();
+            return Token = JSONToken_Bool;
+        }
+        break;
+
+    default:
+        if ((c == '-') || ((c >= '0') && (c <= '9')))
+        {
+            if (!readNumber())
+                return Token;
+            endValue();
+            return Token = JSONToken_Number;
+        }
+        break;
+    }
+
+    return setError("Syntax Error: Invalid syntax");
+}
+
+JSONToken JSONReader::closeLevel(char c)
+{
+    if (Levels.IsEmpty() || (c != ((Levels.Back() == '{') ? '}' : ']')))
+    {
+        if (!Levels.IsEmpty() && (Levels.Back() == '{'))
+            return setError("Syntax Error: Missing closing brace");
+        return setError("Syntax Error: Missing ending bracket");
+    }
+
+    pPos++;
+    Levels.PopBack();
+    endValue();
+    return Token = (c == '}') ? JSONToken_EndObject : JSONToken_EndArray;
+}
+
+// Reads the string at pPos into pString.
+bool JSONReader::readString()
+{
+    size_t length;
+
+    if (pFile)
+    {
+        // Make sure the whole string is in the buffer. The scan stops at the closing
+        // quote, or at a null as JSONText::ParseString does.
+        size_t i = 1;
+        for (;;)
+        {
+            for (; pPos + i < pEnd; i++)
+            {
+                i = JSONText::FindStringSpecial(pPos + i) - pPos;
+                if (pPos[i] != '\\')
+                    break;
+                i++;
+            }
+            if ((pPos + i < pEnd) || !fill())
+                break;
+        }
+        length = i;
+    }
+    else
+    {
+        length = JSONText::MeasureString(pPos);
+    }
+
+    if (!setString(0, length))
+    {
+        setError("Error: Failed to allocate memory");
+        return false;
+    }
+    pPos = JSONText::ParseString(pPos, pString, &StringLength);
+    return true;
+}
+
+// Reads the number at pPos into Number, and its text into pString.
+bool JSONReader::readNumber()
+{
+    if (pFile)
+    {
+        // Make sure all the characters that can be part of the number are buffered.
+        size_t i = 0;
+        for (;;)
+        {
+            while ((pPos + i < pEnd) && pPos[i] && strchr("+-.0123456789eE", pPos[i]))
+                i++;
+            if ((pPos + i < pEnd) || !fill())
+                break;
+        }
+    }
+
+    const char* end = JSONText::ParseNumber(pPos, &Number);
+    if (!setString(pPos, end - pPos))
+    {
+        setError("Error: Failed to allocate memory");
+        return false;
+    }
+    pPos = end;
+    return true;
+}
+
+bool JSONReader::SkipValue()
+{
+    if (Token == JSONToken_Name)
+        Next();
+
+    if ((Token == JSONToken_BeginObject) || (Token == JSONToken_BeginArray))
+    {
+        size_t depth = Levels.GetSize();
+        while (Levels.GetSize() >= depth)
+        {
+            if (Next() == JSONToken_Error)
+                return false;
+        }
+    }
+    return Token != JSONToken_Error;
+}
+
+JSON* JSONReader::ReadValue()
+{
+    if (Token != JSONToken_Name)
+        return readNode();
+
+    String name(pString, StringLength);
+    Next();
+    JSON* node = readNode();
+    if (node)
+        node->Name = name;
+    return node;
+}
+
+// Builds a tree from the value starting at the current token.
+JSON* JSONReader::readNode()
+{
+    JSON* node = 0;
+
+    switch (Token)
+    {
+    case JSONToken_Null:
+        return JSON::CreateNull();
+
+    case JSONToken_Bool:
+        return JSON::CreateBool(GetBool());
+
+    case JSONToken_Number:
+        node = JSON::CreateNumber(Number);
+        if (node)
+            node->Value.AssignString(pString, StringLength);
+        return node;
+
+    case JSONToken_String:
+        node = JSON::CreateString(0);
+        if (node)
+            node->Value.AssignString(pString, StringLength);
+        return node;
+
+    case JSONToken_BeginArray:
+        node = JSON::CreateArray();
+        while (node && (Next() != JSONToken_EndArray))
+        {
+            JSON* item = readNode();
+            if (!item)
+            {
+                node->Release();
+                return 0;
+            }
+            node->AddArrayElement(item);
+        }
+        return node;
+
+    case JSONToken_BeginObject:
+        node = JSON::CreateObject();
+        while (node && (Next() == JSONToken_Name))
+        {
+            String name(pString, StringLength);
+            Next();
+            JSON* item = readNode();
+            if (!item)
+            {
+                node->Release();
+                return 0;
+            }
+            node->AddItem(name, item);
+        }
+        if (node && (Token != JSONToken_EndObject))
+        {
+            node->Release();
+            return 0;
+        }
+        return node;
+
+    default:
+        return 0;
+    }
+}
+
+bool JSONReader::Accept(JSONHandler& handler)
+{
+    for (;;)
+    {
+        bool ok = true;
+
+        switch (Next())
+        {
+        case JSONToken_BeginObject: ok = handler.OnBeginObject();                      break;
+        case JSONToken_EndObject:   ok = handler.OnEndObject();                        break;
+        case JSONToken_BeginArray:  ok = handler.OnBeginArray();                       break;
+        case JSONToken_EndArray:    ok = handler.OnEndArray();                         break;
+        case JSONToken_Name:        ok = handler.OnName(pString, StringLength);        break;
+        case JSONToken_String:      ok = handler.OnString(pString, StringLength);      break;
+        case JSONToken_Number:      ok = handler.OnNumber(Number);                     break;
+        case JSONToken_Bool:        ok = handler.OnBool(GetBool());                    break;
+        case JSONToken_Null:        ok = handler.OnNull();                             break;
+        case JSONToken_End:         return true;
+        default:                    return false;
+        }
+
+        if (!ok)
+            return false;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// ***** JSONWriter
+
+JSONWriter::JSONWriter(bool format) :
+    pBuffer(0),
+    Capacity(0),
+    Used(0),
+    pFile(0),
+    Format(format),
+    Failed(false)
+{
+}
+
+JSONWriter::JSONWriter(File* file, bool format, size_t bufferSize) :
+    pBuffer((char*)OVR_ALLOC(bufferSize + 1)),
+    Capacity(bufferSize),
+    Used(0),
+    pFile(file),
+    Format(format),
+    Failed(false)
+{
+    if (!pBuffer)
+    {
+        Capacity = 0;
+        Failed   = true;
+    }
+}
+
+JSONWriter::~JSONWriter()
+{
+    if (pFile)
+        Flush();
+    OVR_FREE(pBuffer);
+}
+
+bool JSONWriter::Flush()
+{
+    if (pFile && !Failed && Used)
+    {
+        if (pFile->Write((const uint8_t*)pBuffer, (int)Used) != (int)Used)
+            Failed = true;
+        Used = 0;
+    }
+    return !Failed;
+}
+
+const char* JSONWriter::GetText() const
+{
+    OVR_ASSERT(!pFile);
+    if (!pBuffer)
+        return "";
+    // The buffer always has room for the null.
+    pBuffer[Used] = 0;
+    return pBuffer;
+}
+
+char* JSONWriter::DetachText()
+{
+    OVR_ASSERT(!pFile);
+    if (Failed || (!pBuffer && !reserve(1)))
+        return 0;
+
+    char* text = pBuffer;
+    text[Used] = 0;
+    pBuffer    = 0;
+    Capacity   = 0;
+    Used       = 0;
+    Levels.Clear();
+    return text;
+}
+
+void JSONWriter::Reset()
+{
+    Used   = 0;
+    Failed = false;
+    Levels.Clear();
+}
+
+// Makes room for size more bytes; a file writer's buffer is flushed, a memory
+// writer's buffer grows. Buffers have one byte more than Capacity, for the null.
+// Returns false if output is being dropped.
+bool JSONWriter::reserve(size_t size)
+{
+    if (Failed)
+        return false;
+    if (Used + size <= Capacity)
+        return true;
+
+    if (pFile)
+    {
+        OVR_ASSERT(size <= Capacity);
+        return Flush();
+    }
+
+    size_t capacity = Alg::Max(Alg::Max(Used + size, Capacity * 2), (size_t)256);
+    char*  buffer   = (char*)OVR_REALLOC(pBuffer, capacity + 1);
+    if (!buffer)
+    {
+        Failed = true;
+        return false;
+    }
+    pBuffer  = buffer;
+    Capacity = capacity;
+    return true;
+}
+
+void JSONWriter::write(const char* text, size_t length)
+{
+    if (pFile && (length > Capacity))
+    {
+        // Too large for the buffer; write it through.
+        if (Flush() && (pFile->Write((const uint8_t*)text, (int)length) != (int)length))
+            Failed = true;
+        return;
+    }
+
+    if (reserve(length))
+    {
+        memcpy(pBuffer + Used, text, length);
+        Used += length;
+    }
+}
+
+void JSONWriter::newLine()
+{
+#ifdef OVR_OS_WIN32
+    put('\r');
+#endif
+    put('\n');
+}
+
+void JSONWriter::indent(size_t depth)
+{
+    for (size_t i = 0; i < depth; i++)
+        put('\t');
+}
+
+// Writes str quoted, escaping quotes, backslashes and control characters.
+void JSONWriter::writeEscaped(const char* str, size_t length)
+{
+    const char* end = str + length;
+    const char* run = str;
+
+    put('\"');
+    for (const char* p = str; p < end; p++)
+    {
+        unsigned char c = (unsigned char)*p;
+        if ((c > 31) && (c != '\"') && (c != '\\'))
+            continue;
+
+        write(run, p - run);
+        run = p + 1;
+
+        char escape[8];
+        escape[0] = '\\';
+        switch (c)
+        {
+            case '\\':    escape[1] = '\\';   break;
+            case '\"':    escape[1] = '\"';   break;
+            case '\b':    escape[1] = 'b';    break;
+            case '\f':    escape[1] = 'f';    break;
+            case '\n':    escape[1] = 'n';    break;
+            case '\r':    escape[1] = 'r';    break;
+            case '\t':    escape[1] = 't';    break;
+            default:
+                OVR_sprintf(escape + 1, sizeof(escape) - 1, "u%04x", c);
+                write(escape, 6);
+                continue;
+        }
+        write(escape, 2);
+    }
+    write(run, end - run);
+    put('\"');
+}
+
+// Writes the separator before a value in an array.
+void JSONWriter::beginValue()
+{
+    if (Levels.IsEmpty() || (Levels.Back() & Level_Object))
+        return;
+
+    if (Levels.Back() & Level_HasItems)
+    {
+        put(',');
+        if (Format)
+            put(' ');
+    }
+    Levels.Back() |= Level_HasItems;
+}
+
+// Objects are laid out as JSON::Stringify does, with one member per line indented
+// by depth; an empty object is closed one tab to the left.
+void JSONWriter::BeginObject()
+{
+    beginValue();
+    put('{');
+    if (Format)
+        newLine();
+    Levels.PushBack(Level_Object);
+}
+
+void JSONWriter::EndObject()
+{
+    OVR_ASSERT(!Levels.IsEmpty() && (Levels.Back() & Level_Object));
+
+    uint8_t level = Levels.Back();
+    Levels.PopBack();
+    if (Format)
+    {
+        size_t depth = Levels.GetSize();
+        if (level & Level_HasItems)
+        {
+            newLine();
+            indent(depth);
+        }
+        else if (depth)
+        {
+            indent(depth - 1);
+        }
+    }
+    put('}');
+}
+
+void JSONWriter::BeginArray()
+{
+    beginValue();
+    put('[');
+    Levels.PushBack(0);
+}
+
+void JSONWriter::EndArray()
+{
+    OVR_ASSERT(!Levels.IsEmpty() && !(Levels.Back() & Level_Object));
+
+    Levels.PopBack();
+    put(']');
+}
+
+void JSONWriter::WriteName(const char* name)
+{
+    OVR_ASSERT(!Levels.IsEmpty() && (Levels.Back() & Level_Object));
+
+    if (Levels.Back() & Level_HasItems)
+    {
+        put(',');
+        if (Format)
+            newLine();
+    }
+    Levels.Back() |= Level_HasItems;
+
+    if (Format)
+        indent(Levels.GetSize());
+    writeEscaped(name, name ? OVR_strlen(name) : 0);
+    put(':');
+    if (Format)
+        put('\t');
+}
+
+void JSONWriter::WriteString(const char* str)
+{
+    WriteString(str, str ? OVR_strlen(str) : 0);
+}
+
+void JSONWriter::WriteString(const char* str, size_t length)
+{
+    beginValue();
+    writeEscaped(str, length);
+}
+
+void JSONWriter::WriteNumber(double number)
+{
+    char   text[JSONText::MaxNumberLength];
+    size_t length = JSONText::FormatNumber(number, text, sizeof(text));
+
+    beginValue();
+    write(text, length);
+}
+
+void JSONWriter::WriteInt(int number)
+{
+    char text[16];
+    OVR_sprintf(text, sizeof(text), "%d", number);
+
+    beginValue();
+    write(text, OVR_strlen(text));
+}
+
+void JSONWriter::WriteBool(bool value)
+{
+    beginValue();
+    if (value)
+        write("true", 4);
+    else
+        write("false", 5);
+}
+
+void JSONWriter::WriteNull()
+{
+    beginValue();
+    write("null", 4);
+}
+
+void JSONWriter::WriteValue(JSON* node)
+{
+    switch (node->Type)
+    {
+        case JSON_Null:     WriteNull();                                            break;
+        case JSON_Bool:     WriteBool((int)node->dValue != 0);                      break;
+        case JSON_Number:   WriteNumber(node->dValue);                              break;
+        case JSON_String:   WriteString(node->Value.ToCStr(), node->Value.GetSize()); break;
+
+        case JSON_Array:
+            BeginArray();
+            for (JSON* child = node->GetFirstItem(); child; child = node->GetNextItem(child))
+                WriteValue(child);
+            EndArray();
+            break;
+
+        case JSON_Object:
+            BeginObject();
+            for (JSON* child = node->GetFirstItem(); child; child = node->GetNextItem(child))
+            {
+                WriteName(child->Name);
+                WriteValue(child);
+            }
+            EndObject();
+            break;
+
+        case JSON_None:
+            OVR_ASSERT_LOG(false, ("Bad JSON type."));
+            WriteNull();
+            break;
+    }
+}
+
+
+} // namespace OVR
@@ -0,0 +1,281 @@
+/************************************************************************************
+
+PublicHeader:   None
+Filename    :   OVR_JSONStream.h
+Content     :   Streaming JSON reader and writer
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+
+#ifndef OVR_JSONStream_h
+#define OVR_JSONStream_h
+
+#include "OVR_JSON.h"
+#include "OVR_File.h"
+#include "OVR_Array.h"
+
+namespace OVR {
+
+
+// JSONToken is an item read by JSONReader.
+enum JSONToken
+{
+    JSONToken_None,
+    JSONToken_BeginObject,
+    JSONToken_EndObject,
+    JSONToken_BeginArray,
+    JSONToken_EndArray,
+    JSONToken_Name,         // Name of the next object member, in GetString.
+    JSONToken_String,       // In GetString.
+    JSONToken_Number,       // In GetNumber; GetString has the text.
+    JSONToken_Bool,         // In GetBool.
+    JSONToken_Null,
+    JSONToken_End,          // End of the document.
+    JSONToken_Error         // GetError has the message.
+};
+
+
+//-----------------------------------------------------------------------------
+// ***** JSONHandler
+
+// Receives the items of a document from JSONReader::Accept. Each callback returns
+// false to stop reading.
+
+class JSONHandler
+{
+public:
+    virtual ~JSONHandler() { }
+
+    virtual bool OnBeginObject()                                { return true; }
+    virtual bool OnEndObject()                                  { return true; }
+    virtual bool OnBeginArray()                                 { return true; }
+    virtual bool OnEndArray()                                   { return true; }
+    virtual bool OnName(const char* name, size_t length)        { OVR_UNUSED2(name, length); return true; }
+    virtual bool OnString(const char* value, size_t length)     { OVR_UNUSED2(value, length); return true; }
+    virtual bool OnNumber(double value)                         { OVR_UNUSED(value); return true; }
+    virtual bool OnBool(bool value)                             { OVR_UNUSED(value); return true; }
+    virtual bool OnNull()                                       { return true; }
+};
+
+
+//-----------------------------------------------------------------------------
+// ***** JSONReader
+
+// JSONReader reads a JSON document one token at a time, without building a tree.
+// It reads either text in memory or a File through a buffer, so a document of any
+// size is read in bounded memory: the buffer only grows to hold the longest string
+// or number. Parts of the document can still be read into JSON trees with ReadValue.
+//
+// Numbers and strings are decoded as by JSON::Parse.
+//
+// Example usage:
+//     JSONReader reader(file);
+//     while (reader.Next() == JSONToken_Name)   // Members of the root object...
+//     {
+//         if (!OVR_strcmp(reader.GetString(), "frames") && (reader.Next() == JSONToken_BeginArray))
+//         {
+//             while (reader.Next() == JSONToken_BeginObject)
+//             {
+//                 Ptr<JSON> frame = *reader.ReadValue();
+//                 ...
+//             }
+//         }
+//         else
+//             reader.SkipValue();
+//     }
+
+class JSONReader
+{
+public:
+    enum {
+        DefaultBufferSize = 64 * 1024,
+        MaxDepth          = 512         // Open objects and arrays, as in CBORReader.
+    };
+
+    // Reads null-terminated text, which must stay valid while the reader is in use.
+    JSONReader(const char* text);
+    // Reads file from its current position.
+    JSONReader(File* file, size_t bufferSize = DefaultBufferSize);
+    ~JSONReader();
+
+    // Reads the next token and returns it. After End or Error, returns the same again.
+    JSONToken   Next();
+
+    JSONToken   GetToken() const        { return Token; }
+    // Name, String or the text of a Number, null-terminated. Valid until Next is called.
+    const char* GetString() const       { return pString; }
+    size_t      GetStringLength() const { return StringLength; }
+    double      GetNumber() const       { return Number; }
+    bool        GetBool() const         { return Number != 0.; }
+    // Number of objects and arrays that are open.
+    int         GetDepth() const        { return (int)Levels.GetSize(); }
+    const char* GetError() const        { return pError; }
+
+    // Skips the value that starts at the current token, or that follows it if it is
+    // a Name; after an object or array, the current token is its end. Returns false
+    // on error.
+    bool        SkipValue();
+
+    // Reads the value that starts at, or follows, the current token into a new tree,
+    // which is named if the current token is a Name. Returns null on error.
+    JSON*       ReadValue();
+
+    // Reads the rest of the document into handler. Returns false on error or if the
+    // handler stopped.
+    bool        Accept(JSONHandler& handler);
+
+private:
+    enum Expect
+    {
+        Expect_Value,
+        Expect_ValueOrClose,        // Array start.
+        Expect_Name,
+        Expect_NameOrClose,         // Object start.
+        Expect_CommaOrClose,
+        Expect_End
+    };
+
+    char        peek();
+    bool        fill();
+    JSONToken   readValue(char c);
+    bool        readString();
+    bool        readNumber();
+    bool        setString(const char* text, size_t length);
+    JSONToken   closeLevel(char c);
+    JSONToken   setError(const char* error);
+    void        endValue()  { ExpectNext = Levels.IsEmpty() ? Expect_End : Expect_CommaOrClose; }
+    JSON*       readNode();
+
+    // Text in [pPos, pEnd), followed by a null.
+    const char*     pPos;
+    const char*     pEnd;
+    char*           pBuffer;        // Owned when reading a file.
+    size_t          BufferSize;
+    File*           pFile;
+    bool            FileEnd;
+
+    JSONToken       Token;
+    Expect          ExpectNext;
+    ArrayPOD<char>  Levels;         // '{' or '[' for each open object or array.
+    char*           pString;
+    size_t          StringLength;
+    size_t          StringCapacity;
+    double          Number;
+    const char*     pError;
+
+    // Not copyable.
+    JSONReader(const JSONReader&);
+    void operator = (const JSONReader&);
+};
+
+
+//-----------------------------------------------------------------------------
+// ***** JSONWriter
+
+// JSONWriter writes JSON text as it is produced, either into a buffer that it owns
+// and reuses after Reset, or to a File through a buffer. Formatted output has the
+// same layout as JSON::Stringify(true).
+//
+// Example usage:
+//     JSONWriter writer(file, true);
+//     writer.BeginObject();
+//     writer.WriteName("frames");
+//     writer.BeginArray();
+//     for (...)
+//         writer.WriteNumber(frameTime);
+//     writer.EndArray();
+//     writer.EndObject();
+//     writer.Flush();
+
+class JSONWriter
+{
+public:
+    enum {
+        DefaultBufferSize = 16 * 1024
+    };
+
+    // Writes to memory; the text is in GetText.
+    JSONWriter(bool format = false);
+    // Writes to file, flushing the buffer when it is full and on destruction.
+    JSONWriter(File* file, bool format = false, size_t bufferSize = DefaultBufferSize);
+    ~JSONWriter();
+
+    void        BeginObject();
+    void        EndObject();
+    void        BeginArray();
+    void        EndArray();
+    // Starts a member of the current object; its value is written next.
+    void        WriteName(const char* name);
+    void        WriteString(const char* str);
+    void        WriteString(const char* str, size_t length);
+    void        WriteNumber(double number);
+    void        WriteInt(int number);
+    void        WriteBool(bool value);
+    void        WriteNull();
+    // Writes node and its children.
+    void        WriteValue(JSON* node);
+
+    // Writes buffered text to the file. Returns false if any write has failed.
+    bool        Flush();
+    // True if memory ran out or a file write failed; further output is dropped.
+    bool        HasError() const        { return Failed; }
+
+    // Text written to memory, null-terminated.
+    const char* GetText() const;
+    size_t      GetLength() const       { return Used; }
+    // Returns the text in memory allocated with OVR_ALLOC, to be freed with OVR_FREE,
+    // and leaves the writer empty. Returns null on error.
+    char*       DetachText();
+    // Empties the writer for a new document, keeping its buffer.
+    void        Reset();
+
+private:
+    void        beginValue();
+    void        newLine();
+    void        indent(size_t depth);
+    bool        reserve(size_t size);
+    void        write(const char* text, size_t length);
+    void        put(char c)                 { if (reserve(1)) pBuffer[Used++] = c; }
+    void        writeEscaped(const char* str, size_t length);
+
+    enum {
+        Level_Object   = 1,
+        Level_HasItems = 2
+    };
+
+    char*           pBuffer;
+    size_t          Capacity;
+    size_t          Used;
+    File*           pFile;
+    bool            Format;
+    bool            Failed;
+    ArrayPOD<uint8_t> Levels;       // Level_ flags for each open object or array.
+
+    // Not copyable.
+    JSONWriter(const JSONWriter&);
+    void operator = (const JSONWriter&);
+};
+
+
+} // namespace OVR
+
+#endif // OVR_JSONStream_h
@@ -0,0 +1,453 @@
+/************************************************************************************
+
+Filename    :   OVR_JobSystem.cpp
+Content     :   Work-stealing job scheduler
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#include "OVR_JobSystem.h"
+#include "OVR_Alg.h"
+
+namespace OVR {
+
+
+//-----------------------------------------------------------------------------------
+// ***** WorkDeque
+
+// Chase-Lev deque of fixed capacity. The owner thread pushes and pops at the bottom,
+// other threads steal from the top; only the last remaining job is contended, and
+// that is resolved with a single compare-and-set on Top. Indices run freely and
+// wrap around; only their differences matter.
+
+class JobSystem::WorkDeque : public NewOverrideBase
+{
+public:
+    WorkDeque() : Top(0), Bottom(0) { }
+
+    bool IsEmpty() const
+    {
+        return (int32_t)(Bottom.Load_Acquire() - Top.Load_Acquire()) <= 0;
+    }
+
+    // Owner only. Returns false if the deque is full.
+    bool Push(const Job& job)
+    {
+        uint32_t b = Bottom.Load_Acquire();
+        uint32_t t = Top.Load_Acquire();
+        if ((int32_t)(b - t) >= (int32_t)DequeCapacity)
+            return false;
+
+        Jobs[b & (DequeCapacity - 1)] = job;
+        // Full barrier, so a worker about to sleep either sees this job or is seen
+        // as sleeping by the caller (JobSystem::push).
+        Bottom.Exchange_Sync(b + 1);
+        return true;
+    }
+
+    // Owner only.
+    bool Pop(Job& job)
+    {
+        uint32_t b = Bottom.Load_Acquire() - 1;
+        Bottom.Exchange_Sync(b);
+        uint32_t t = Top.Load_Acquire();
+
+        if ((int32_t)(b - t) < 0)
+        {
+            Bottom.Store_Release(b + 1);
+            return false;
+        }
+
+        job = Jobs[b & (DequeCapacity - 1)];
+        if (b != t)
+            return true;
+
+        // Last job; race the thieves for it.
+        bool won = Top.CompareAndSet_Sync(t, t + 1);
+        Bottom.Store_Release(b + 1);
+        return won;
+    }
+
+    // Any thread.
+    bool Steal(Job& job)
+    {
+        // The read-modify-write orders the load of Top before the load of Bottom.
+        uint32_t t = Top.ExchangeAdd_Sync(0);
+        uint32_t b = Bottom.Load_Acquire();
+        if ((int32_t)(b - t) <= 0)
+            return false;
+
+        job = Jobs[t & (DequeCapacity - 1)];
+        return Top.CompareAndSet_Sync(t, t + 1);
+    }
+
+private:
+    AtomicInt<uint32_t> Top;
+    AtomicInt<uint32_t> Bottom;
+    Job                 Jobs[DequeCapacity];
+};
+
+
+//-----------------------------------------------------------------------------------
+// ***** Worker
+
+class JobSystem::Worker : public Thread
+{
+public:
+    Worker(JobSystem* system, int slot) : pSystem(system), Slot(slot) { }
+
+    virtual int Run()
+    {
+        SetThreadName("OVR::JobWorker");
+        pSystem->SlotThreads[Slot] = GetCurrentThreadId();
+        pSystem->StartedWorkers.ExchangeAdd_Sync(1);
+        pSystem->workerLoop(Slot);
+        return 0;
+    }
+
+private:
+    JobSystem* pSystem;
+    int        Slot;
+};
+
+
+//-----------------------------------------------------------------------------------
+// ***** JobSystem
+
+struct JobSystem::ParallelForData
+{
+    JobSystem*        pSystem;
+    Job::FunctionType Function;
+    void*             Data;
+    int               GrainSize;
+    JobCounter        Counter;
+};
+
+JobSystem::JobSystem(int workerCount)
+    : StartedWorkers(0),
+      InjectedCount(0),
+      DependentCount(0),
+      SleepingWorkers(0),
+      Exiting(false)
+{
+    if (workerCount <= 0)
+        workerCount = Thread::GetCPUCount() - 1;
+    // Always keep a worker, so jobs nobody waits on still run.
+    WorkerCount = Alg::Clamp(workerCount, 1, (int)MaxWorkers);
+    SlotCount   = WorkerCount + 1;
+
+    for (int i = 0; i < SlotCount; i++)
+    {
+        Deques[i]      = new WorkDeque;
+        SlotThreads[i] = 0;
+    }
+    SlotThreads[WorkerCount] = GetCurrentThreadId();
+
+    for (int i = 0; i < WorkerCount; i++)
+    {
+        Workers[i] = new Worker(this, i);
+        Workers[i]->Start();
+    }
+
+    // getSlot() reads SlotThreads without a lock, so every worker must have stored
+    // its id before the first job can be queued.
+    while (StartedWorkers.Load_Acquire() < WorkerCount)
+        Thread::YieldCurrentThread();
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        Mutex::Locker lock(&SleepMutex);
+        Exiting = true;
+        SleepCondition.NotifyAll();
+    }
+
+    for (int i = 0; i < WorkerCount; i++)
+    {
+        Workers[i]->Join();
+        Workers[i]->Release();
+    }
+
+    // Jobs still queued at this point are dropped.
+    OVR_ASSERT(!hasWork() && DependentCount == 0);
+    for (int i = 0; i < SlotCount; i++)
+        delete Deques[i];
+}
+
+int JobSystem::getSlot() const
+{
+    ThreadId id = GetCurrentThreadId();
+    for (int i = 0; i < SlotCount; i++)
+    {
+        if (SlotThreads[i] == id)
+            return i;
+    }
+    return -1;
+}
+
+bool JobSystem::hasWork() const
+{
+    if (InjectedCount.Load_Acquire() > 0)
+        return true;
+    for (int i = 0; i < SlotCount; i++)
+    {
+        if (!Deques[i]->IsEmpty())
+            return true;
+    }
+    return false;
+}
+
+void JobSystem::Run(const Job* jobs, int count, JobCounter* counter, JobCounter* dependency)
+{
+    if (count <= 0)
+        return;
+    if (counter)
+        counter->Value.ExchangeAdd_Sync(count);
+
+    if (dependency)
+    {
+        // finish() only lets a counter with dependents reach zero under this lock.
+        Lock::Locker lock(&DependentLock);
+        if (!dependency->IsDone())
+        {
+            for (int i = 0; i < count; i++)
+            {
+                DependentJob d;
+                d.J            = jobs[i];
+                d.J.Counter    = counter;
+                d.Dependency   = dependency;
+                Dependents.PushBack(d);
+            }
+            DependentCount.ExchangeAdd_Sync(count);
+            return;
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        Job job     = jobs[i];
+        job.Counter = counter;
+        push(job);
+    }
+}
+
+void JobSystem::push(const Job& job)
+{
+    int slot = getSlot();
+    if (slot >= 0)
+    {
+        if (!Deques[slot]->Push(job))
+        {
+            // Deque is full; running the job now is always safe.
+            execute(job);
+            return;
+        }
+    }
+    else
+    {
+        Lock::Locker lock(&InjectLock);
+        Injected.PushBack(job);
+        InjectedCount.ExchangeAdd_Sync(1);
+    }
+
+    if (SleepingWorkers.Load_Acquire() > 0)
+    {
+        Mutex::Locker lock(&SleepMutex);
+        SleepCondition.Notify();
+    }
+}
+
+bool JobSystem::take(int slot, Job& job)
+{
+    if (slot >= 0 && Deques[slot]->Pop(job))
+        return true;
+
+    if (InjectedCount.Load_Acquire() > 0)
+    {
+        Lock::Locker lock(&InjectLock);
+        if (Injected.GetSize() > 0)
+        {
+            job = Injected.Back();
+            Injected.PopBack();
+            InjectedCount.ExchangeAdd_Sync(-1);
+            return true;
+        }
+    }
+
+    // Start stealing next to our own slot so thieves spread over the victims.
+    for (int i = 1; i <= SlotCount; i++)
+    {
+        int victim = (slot + i + SlotCount) % SlotCount;
+        if (victim != slot && Deques[victim]->Steal(job))
+            return true;
+    }
+    return false;
+}
+
+void JobSystem::execute(const Job& job)
+{
+    job.Function(job.Data, job.Begin, job.End);
+    finish(job.Counter);
+}
+
+void JobSystem::finish(JobCounter* counter)
+{
+    if (!counter)
+        return;
+
+    // Jobs of the batch are still running: nothing can be released yet.
+    for (;;)
+    {
+        int value = counter->Value.Load_Acquire();
+        if (value <= 1)
+            break;
+        if (counter->Value.CompareAndSet_Sync(value, value - 1))
+            return;
+    }
+
+    // The last job takes the dependents off the list before the counter reaches zero
+    // and under the lock Run() checks the dependency with. So no dependent is left
+    // queued on a counter that is done, and a counter destroyed after its batch and
+    // reallocated at the same address can't pick up someone else's dependents.
+    ArrayPOD<Job> ready;
+    {
+        Lock::Locker lock(&DependentLock);
+        if (DependentCount.Load_Acquire() > 0)
+        {
+            for (size_t i = 0; i < Dependents.GetSize(); )
+            {
+                if (Dependents[i].Dependency == counter)
+                {
+                    ready.PushBack(Dependents[i].J);
+                    Dependents[i] = Dependents.Back();
+                    Dependents.PopBack();
+                }
+                else
+                {
+                    i++;
+                }
+            }
+            DependentCount.ExchangeAdd_Sync(-(int)ready.GetSize());
+        }
+
+        // The decrement to zero is the last access to the counter: a waiter may
+        // destroy it as soon as it sees zero.
+        counter->Value.ExchangeAdd_Sync(-1);
+    }
+
+    for (size_t i = 0; i < ready.GetSize(); i++)
+        push(ready[i]);
+}
+
+void JobSystem::Wait(JobCounter* counter)
+{
+    int slot = getSlot();
+    int idle = 0;
+
+    while (!counter->IsDone())
+    {
+        Job job;
+        if (take(slot, job))
+        {
+            execute(job);
+            idle = 0;
+        }
+        else if (++idle < 64)
+        {
+            Thread::YieldCurrentThread();
+        }
+        else
+        {
+            // The remaining jobs are running elsewhere; stop burning the core.
+            Thread::MSleep(0);
+        }
+    }
+}
+
+void JobSystem::workerLoop(int slot)
+{
+    int idle = 0;
+
+    while (!Exiting)
+    {
+        Job job;
+        if (take(slot, job))
+        {
+            execute(job);
+            idle = 0;
+            continue;
+        }
+        if (++idle < 64)
+        {
+            Thread::YieldCurrentThread();
+            continue;
+        }
+        idle = 0;
+
+        // Announce the sleep before the last look for work; pairs with push().
+        SleepingWorkers.ExchangeAdd_Sync(1);
+        {
+            Mutex::Locker lock(&SleepMutex);
+            if (!Exiting && !hasWork())
+                SleepCondition.Wait(&SleepMutex);
+        }
+        SleepingWorkers.ExchangeAdd_Sync(-1);
+    }
+}
+
+void JobSystem::parallelForJob(void* data, int begin, int end)
+{
+    ParallelForData* p = (ParallelForData*)data;
+
+    // Hand the upper half to the pool until the range is small enough to run here.
+    while (end - begin > p->GrainSize)
+    {
+        int middle = begin + (end - begin) / 2;
+        p->pSystem->Run(Job(parallelForJob, data, middle, end), &p->Counter);
+        end = middle;
+    }
+    p->Function(p->Data, begin, end);
+}
+
+void JobSystem::ParallelFor(int begin, int end, int grainSize, Job::FunctionType fn, void* data)
+{
+    if (grainSize < 1)
+        grainSize = 1;
+    if (end - begin <= grainSize)
+    {
+        if (end > begin)
+            fn(data, begin, end);
+        return;
+    }
+
+    ParallelForData p;
+    p.pSystem   = this;
+    p.Function  = fn;
+    p.Data      = data;
+    p.GrainSize = grainSize;
+
+    parallelForJob(&p, begin, end);
+    Wait(&p.Counter);
+}
+
+
+} // namespace OVR
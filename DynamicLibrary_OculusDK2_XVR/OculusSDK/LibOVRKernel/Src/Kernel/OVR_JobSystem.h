@@ -0,0 +1,185 @@
+/************************************************************************************
+
+PublicHeader:   OVR_Kernel.h
+Filename    :   OVR_JobSystem.h
+Content     :   Work-stealing job scheduler
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#ifndef OVR_JobSystem_h
+#define OVR_JobSystem_h
+
+#include "OVR_Types.h"
+#include "OVR_Atomic.h"
+#include "OVR_Array.h"
+#include "OVR_Threads.h"
+
+namespace OVR {
+
+class JobCounter;
+class JobSystem;
+
+
+//-----------------------------------------------------------------------------------
+// ***** Job
+
+// A unit of work: Function(Data, Begin, End). Begin and End are free for the caller
+// to use; ParallelFor passes the index range of the chunk in them. When the job has
+// run, Counter (if any) is decremented.
+
+struct Job
+{
+    typedef void (*FunctionType)(void* data, int begin, int end);
+
+    FunctionType Function;
+    void*        Data;
+    int          Begin;
+    int          End;
+    JobCounter*  Counter;
+
+    Job() : Function(0), Data(0), Begin(0), End(0), Counter(0) { }
+    Job(FunctionType fn, void* data, int begin = 0, int end = 0)
+        : Function(fn), Data(data), Begin(begin), End(end), Counter(0) { }
+};
+
+
+//-----------------------------------------------------------------------------------
+// ***** JobCounter
+
+// Counts the jobs of a batch that have not finished yet. JobSystem::Run increments
+// it, every finished job decrements it; a batch is done when it reaches zero.
+//
+// A counter can also be passed as the dependency of another batch, which is then
+// held back until the counter reaches zero. A counter must outlive its jobs.
+
+class JobCounter : public NewOverrideBase
+{
+    friend class JobSystem;
+
+public:
+    JobCounter() : Value(0) { }
+    ~JobCounter() { OVR_ASSERT(IsDone()); }
+
+    bool IsDone() const    { return Value.Load_Acquire() == 0; }
+    int  GetValue() const  { return Value.Load_Acquire(); }
+
+private:
+    AtomicInt<int> Value;
+};
+
+
+//-----------------------------------------------------------------------------------
+// ***** JobSystem
+
+// JobSystem runs jobs on a fixed pool of worker threads, one per CPU core minus the
+// thread that creates it, which takes part in the work whenever it waits on a counter.
+//
+// Each worker owns a Chase-Lev deque: it pushes and pops jobs at the bottom without
+// locking, and idle workers steal from the top of other deques. Jobs submitted by the
+// workers or the creating thread go to their own deque; any other thread submits through
+// a small locked queue. Idle workers spin briefly and then sleep until work is pushed.
+//
+// Wait() never blocks while there is work to do: the waiting thread runs queued jobs
+// (its own first, then stolen ones) until the counter reaches zero, so jobs can submit
+// and wait on sub-jobs without deadlocking the pool.
+
+class JobSystem : public NewOverrideBase
+{
+public:
+    enum {
+        MaxWorkers    = 64,
+        DequeCapacity = 1024   // Jobs per worker deque; a full deque runs new jobs inline.
+    };
+
+    // workerCount of 0 sizes the pool from Thread::GetCPUCount().
+    JobSystem(int workerCount = 0);
+    ~JobSystem();
+
+    int  GetWorkerCount() const { return WorkerCount; }
+
+    // Queues count jobs. counter, if set, is incremented by count and decremented as
+    // each job finishes. If dependency is set, the jobs are queued only once it has
+    // reached zero.
+    void Run(const Job* jobs, int count, JobCounter* counter = 0, JobCounter* dependency = 0);
+    void Run(const Job& job, JobCounter* counter = 0, JobCounter* dependency = 0)
+    { Run(&job, 1, counter, dependency); }
+
+    // Runs other jobs until counter reaches zero.
+    void Wait(JobCounter* counter);
+
+    // Calls fn(data, b, e) over [begin, end) split in chunks of at least grainSize
+    // indices and returns once all of them have run. Ranges are split in halves on
+    // demand, so idle workers steal big chunks first.
+    void ParallelFor(int begin, int end, int grainSize, Job::FunctionType fn, void* data);
+
+private:
+    class Worker;
+    class WorkDeque;
+    struct ParallelForData;
+
+    struct DependentJob
+    {
+        Job         J;
+        JobCounter* Dependency;
+    };
+
+    static void parallelForJob(void* data, int begin, int end);
+
+    // Index of the deque owned by the calling thread, -1 for foreign threads.
+    int  getSlot() const;
+
+    void push(const Job& job);
+    bool take(int slot, Job& job);
+    void execute(const Job& job);
+    void finish(JobCounter* counter);
+    bool hasWork() const;
+    void workerLoop(int slot);
+
+    int            WorkerCount;
+    int            SlotCount;          // Workers plus the creating thread.
+    Worker*        Workers[MaxWorkers];
+    WorkDeque*     Deques[MaxWorkers + 1];
+    ThreadId       SlotThreads[MaxWorkers + 1];  // Written once by each worker at start.
+    AtomicInt<int> StartedWorkers;
+
+    // Jobs submitted by threads that don't own a deque.
+    Lock           InjectLock;
+    ArrayPOD<Job>  Injected;
+    AtomicInt<int> InjectedCount;
+
+    // Jobs held back until their dependency counter reaches zero. They are released
+    // by the counter's last job, before its final decrement.
+    Lock                   DependentLock;
+    ArrayPOD<DependentJob> Dependents;
+    AtomicInt<int>         DependentCount;
+
+    AtomicInt<int> SleepingWorkers;
+    Mutex          SleepMutex;
+    WaitCondition  SleepCondition;
+
+    volatile bool  Exiting;
+};
+
+
+} // namespace OVR
+
+#endif // OVR_JobSystem_h
@@ -109,6 +109,90 @@ public:
 };
 
 
+// ***** LocklessHistory
+
+// Generalization of LocklessUpdater for single producer cases where consumers need
+// the last few updates rather than only the most recent one (pose history used for
+// interpolation, timing samples).
+//
+// Each slot carries its own begin/end markers holding the index of the update
+// written into it, so readers can tell whether the slot still contains the update
+// they asked for. Readers never block the producer and never retry: if a slot was
+// overwritten while being copied out, the read simply fails.
+//
+// Capacity must be a power of two so that slot indices survive index wrap-around.
+
+template<class T, int Capacity>
+class LocklessHistory
+{
+public:
+    LocklessHistory() : Head(0)
+    {
+        OVR_COMPILER_ASSERT(Capacity > 1 && (Capacity & (Capacity - 1)) == 0);
+    }
+
+    // Producer only.
+    void Push(const T& value)
+    {
+        const uint32_t index = Head.Load_Acquire();
+        Slot& slot = Slots[index & (Capacity - 1)];
+
+        slot.UpdateBegin.Exchange_Sync(index);
+        slot.Value = value;
+        slot.UpdateEnd.Store_Release(index);
+
+        Head.Store_Release(index + 1);
+    }
+
+    // Total number of updates pushed so far (wraps at 2^32).
+    uint32_t GetHead() const
+    {
+        return Head.Load_Acquire();
+    }
+
+    // Number of updates that can currently be read back.
+    // Keeps one slot in reserve for the update the producer may be writing.
+    int GetCount() const
+    {
+        const uint32_t head = Head.Load_Acquire();
+        return (head < (uint32_t)(Capacity - 1)) ? (int)head : (Capacity - 1);
+    }
+
+    // Copies out the update 'age' steps back from the newest one (0 = newest).
+    // Returns false if there is no such update or it was overwritten meanwhile.
+    bool GetRecent(int age, T* value) const
+    {
+        if (age < 0 || age >= GetCount())
+        {
+            return false;
+        }
+
+        const uint32_t index = Head.Load_Acquire() - 1 - (uint32_t)age;
+        const Slot&    slot  = Slots[index & (Capacity - 1)];
+
+        if (slot.UpdateEnd.Load_Acquire() != index)
+        {
+            return false;
+        }
+        *value = slot.Value;
+        return (slot.UpdateBegin.Load_Acquire() == index);
+    }
+
+private:
+    struct Slot
+    {
+        Slot() : UpdateBegin(~0u), UpdateEnd(~0u) { }
+
+        AtomicInt<uint32_t> UpdateBegin;
+        AtomicInt<uint32_t> UpdateEnd;
+        T                   Value;
+    };
+
+    AtomicInt<uint32_t> Head;
+    Slot                Slots[Capacity];
+};
+
+
 #pragma pack(push, 8)
 
 // Padded out version stored in the updater slots
@@ -270,23 +270,12 @@ void OVR::Log::LogMessage(LogMessageType messageType, const char* pfmt, ...)
 }
 
 
-// Return behavior is the same as ISO C vsnprintf: returns the required strlen of buffer (which will
-// be >= bufferSize if bufferSize is insufficient) or returns a negative value because the input was bad.
-int Log::FormatLog(char* buffer, size_t bufferSize, LogMessageType messageType,
-                    const char* fmt, va_list argList)
+int Log::FormatLogPrefix(char* buffer, size_t bufferSize, LogMessageType messageType, time_t timer)
 {
-    const char bareMinString[] = "01/01/15_08:00:00: Assert: \n";
-    OVR_UNUSED(bareMinString);
-    OVR_ASSERT(buffer && (bufferSize >= sizeof(bareMinString)));
-    if(!buffer || (bufferSize < sizeof(bareMinString)))
-        return -1;
-
-    int addNewline = 1;
+    OVR_ASSERT(buffer && (bufferSize >= 28));
     int prefixLength = 0;
 
     // Prepend short timestamp to the message
-    time_t timer;
-    time(&timer);
     if (timer != -1)
     {
         tm timeData;
@@ -294,8 +283,8 @@ int Log::FormatLog(char* buffer, size_t bufferSize, LogMessageType messageType,
         if (err == 0)
         {
             // We're guaranteed to have enough space in the buffer because of
-            // the minimum size check at the top of this function (so any
-            // bytesWritten > 0 is a success case here).
+            // the minimum size check in FormatLog (so any bytesWritten > 0 is
+            // a success case here).
             int bytesWritten = OVR_snprintf(buffer, bufferSize, "%02i/%02i/%02i %02i:%02i:%02i: ",
                                             timeData.tm_mon+1, timeData.tm_mday,
                                             timeData.tm_year % 100,
@@ -312,11 +301,26 @@ int Log::FormatLog(char* buffer, size_t bufferSize, LogMessageType messageType,
     case Log_Error:      OVR_strcpy(buffer+prefixLength, bufferSize-prefixLength, "Error: ");  prefixLength += 7; break;
     case Log_Debug:      OVR_strcpy(buffer+prefixLength, bufferSize-prefixLength, "Debug: ");  prefixLength += 7; break;
     case Log_Assert:     OVR_strcpy(buffer+prefixLength, bufferSize-prefixLength, "Assert: "); prefixLength += 8; break;
-    case Log_Text:       buffer[prefixLength] = 0; addNewline = 0; break;
-    case Log_DebugText:  buffer[prefixLength] = 0; addNewline = 0; break;
-    default:             buffer[prefixLength] = 0; addNewline = 0; break;
+    default:             buffer[prefixLength] = 0; break;
     }
 
+    return prefixLength;
+}
+
+// Return behavior is the same as ISO C vsnprintf: returns the required strlen of buffer (which will
+// be >= bufferSize if bufferSize is insufficient) or returns a negative value because the input was bad.
+int Log::FormatLog(char* buffer, size_t bufferSize, LogMessageType messageType,
+                    const char* fmt, va_list argList)
+{
+    const char bareMinString[] = "01/01/15_08:00:00: Assert: \n";
+    OVR_UNUSED(bareMinString);
+    OVR_ASSERT(buffer && (bufferSize >= sizeof(bareMinString)));
+    if(!buffer || (bufferSize < sizeof(bareMinString)))
+        return -1;
+
+    int addNewline   = (messageType == Log_Error || messageType == Log_Debug || messageType == Log_Assert) ? 1 : 0;
+    int prefixLength = FormatLogPrefix(buffer, bufferSize, messageType, time(nullptr));
+
     char*  buffer2       = buffer + prefixLength;
     size_t size2         = bufferSize - (size_t)prefixLength;
     int    messageLength = OVR_vsnprintf(buffer2, size2, fmt, argList);
@@ -380,21 +384,31 @@ void Log::DefaultLogOutput(const char* formattedText, LogMessageType messageType
 
     if (messageType == Log_Error)
     {
+        DefaultErrorOutput(formattedText, bufferSize);
+    }
+}
+
+void Log::DefaultErrorOutput(const char* formattedText, int bufferSize)
+{
+    OVR_UNUSED2(formattedText, bufferSize);
+
 #if defined(OVR_OS_WIN32)
-        if (!ReportEventW(hEventSource, EVENTLOG_ERROR_TYPE, 0, 0, NULL, 1, 0, &wideBuff, NULL))
-        {
-            OVR_ASSERT(false);
-        }
+    std::wstring wideText = UTF8StringToUCSString(formattedText, bufferSize);
+    const wchar_t* wideBuff = wideText.c_str();
+
+    if (!ReportEventW(hEventSource, EVENTLOG_ERROR_TYPE, 0, 0, NULL, 1, 0, &wideBuff, NULL))
+    {
+        OVR_ASSERT(false);
+    }
 #elif defined(OVR_OS_MS) // Any other Microsoft OSs
-        // TBD
+    // TBD
 #elif defined(OVR_OS_ANDROID)
-        // TBD
+    // TBD
 #elif defined(OVR_OS_MAC) || defined(OVR_OS_LINUX)
-        syslog(LOG_ERR, "%s", formattedText);
+    syslog(LOG_ERR, "%s", formattedText);
 #else
-        // TBD
+    // TBD
 #endif
-    }
 }
 
 //static
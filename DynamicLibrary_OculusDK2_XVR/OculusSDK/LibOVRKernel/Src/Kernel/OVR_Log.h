@@ -32,6 +32,7 @@ limitations under the License.
 #include "OVR_Delegates.h"
 #include "OVR_Callbacks.h"
 #include <stdarg.h>
+#include <time.h>
 
 namespace OVR {
 
@@ -162,11 +163,19 @@ public:
     static int      FormatLog(char* buffer, size_t bufferSize, LogMessageType messageType,
                               const char* fmt, va_list argList);
 
+    // Writes the timestamp and message type prefix that FormatLog puts before the text,
+    // for a message logged at timer. Returns its strlen. bufferSize must be at least 28.
+    static int      FormatLogPrefix(char* buffer, size_t bufferSize, LogMessageType messageType, time_t timer);
+
     // Default log output implementation used by by LogMessageVarg.
     // Debug flag may be used to re-direct output on some platforms, but doesn't
     // necessarily disable it in release builds; that is the job of the called.    
     void            DefaultLogOutput(const char* textBuffer, LogMessageType messageType, int bufferSize = -1);
 
+    // Reports an error message to the system log (event log, syslog), as
+    // DefaultLogOutput does for Log_Error messages.
+    void            DefaultErrorOutput(const char* textBuffer, int bufferSize = -1);
+
     // Determines if the specified message type is for debugging only.
     static bool     IsDebugMessage(LogMessageType messageType)
     {
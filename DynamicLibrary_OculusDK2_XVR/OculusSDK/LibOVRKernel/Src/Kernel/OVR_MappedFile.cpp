@@ -0,0 +1,167 @@
+/************************************************************************************
+
+Filename    :   OVR_MappedFile.cpp
+Content     :   Read-only memory-mapped files
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#include "OVR_MappedFile.h"
+
+#if defined(OVR_OS_MS)
+#include "OVR_Win32_IncludeWindows.h"
+#else
+#include <sys/mman.h> // mmap()
+#include <sys/stat.h> // fstat()
+#include <fcntl.h>    // open()
+#include <unistd.h>   // close()
+#endif
+
+namespace OVR {
+
+
+MappedFile::MappedFile() :
+    pData(nullptr),
+    Size(0)
+#if defined(OVR_OS_MS)
+    , hFile(INVALID_HANDLE_VALUE)
+    , hMapping(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#if defined(OVR_OS_MS)
+
+bool MappedFile::Open(const String& path)
+{
+    Close();
+
+    wchar_t wpath[MAX_PATH];
+    if (UTF8Util::GetLength(path.ToCStr()) >= MAX_PATH)
+    {
+        return false;
+    }
+    UTF8Util::DecodeString(wpath, path.ToCStr());
+
+    hFile = ::CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!::GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0 ||
+        (uint64_t)fileSize.QuadPart > (uint64_t)SIZE_MAX)
+    {
+        Close();
+        return false;
+    }
+
+    hMapping = ::CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!hMapping)
+    {
+        Close();
+        return false;
+    }
+
+    pData = (const uint8_t*)::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!pData)
+    {
+        Close();
+        return false;
+    }
+
+    Size = (size_t)fileSize.QuadPart;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (pData)
+    {
+        ::UnmapViewOfFile(pData);
+        pData = nullptr;
+    }
+    if (hMapping)
+    {
+        ::CloseHandle(hMapping);
+        hMapping = nullptr;
+    }
+    if (hFile != INVALID_HANDLE_VALUE)
+    {
+        ::CloseHandle(hFile);
+        hFile = INVALID_HANDLE_VALUE;
+    }
+    Size = 0;
+}
+
+#else // OVR_OS_MS
+
+bool MappedFile::Open(const String& path)
+{
+    Close();
+
+    int fd = ::open(path.ToCStr(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* data = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps its own reference to the file
+
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    pData = (const uint8_t*)data;
+    Size  = (size_t)st.st_size;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (pData)
+    {
+        ::munmap((void*)pData, Size);
+        pData = nullptr;
+    }
+    Size = 0;
+}
+
+#endif // OVR_OS_MS
+
+
+} // namespace OVR
@@ -0,0 +1,73 @@
+/************************************************************************************
+
+PublicHeader:   OVR_Kernel.h
+Filename    :   OVR_MappedFile.h
+Content     :   Read-only memory-mapped files
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#ifndef OVR_MappedFile_h
+#define OVR_MappedFile_h
+
+#include "OVR_Types.h"
+#include "OVR_String.h"
+
+namespace OVR {
+
+
+//-----------------------------------------------------------------------------------
+// ***** MappedFile
+
+// Maps a whole file read-only into the address space. Pages are loaded by the OS
+// on first access, so large binary files (recordings, caches) can be opened
+// instantly and read in place without copying them into heap buffers.
+
+class MappedFile
+{
+    OVR_NON_COPYABLE(MappedFile);
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // Maps the file at path. Returns false if the file can't be opened or is empty.
+    bool Open(const String& path);
+    void Close();
+
+    bool            IsOpen() const  { return pData != nullptr; }
+    const uint8_t*  GetData() const { return pData; }
+    size_t          GetSize() const { return Size; }
+
+protected:
+    const uint8_t*  pData;
+    size_t          Size;
+
+#if defined(OVR_OS_MS)
+    void*           hFile;
+    void*           hMapping;
+#endif
+};
+
+
+} // namespace OVR
+
+#endif // OVR_MappedFile_h
@@ -346,6 +346,15 @@ public:
         pObject = src;
     }
 
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    // Takes over the reference held by src, which is left null.
+    OVR_FORCE_INLINE Ptr(Ptr<C> &&src)
+        : pObject(src.pObject)
+    {
+        src.pObject = 0;
+    }
+#endif
+
     // Destructor
     OVR_FORCE_INLINE ~Ptr()
     {
@@ -403,6 +412,20 @@ public:
         return *this;
     }   
     
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    OVR_FORCE_INLINE const Ptr<C>& operator = (Ptr<C> &&src)
+    {
+        if (this != &src)
+        {
+            if (pObject)
+                pObject->Release();
+            pObject = src.pObject;
+            src.pObject = 0;
+        }
+        return *this;
+    }
+#endif
+
     OVR_FORCE_INLINE const Ptr<C>& operator = (C *psrc)
     {
         if (psrc)
@@ -507,6 +530,14 @@ public:
 
 };
 
+// Ptr holds nothing but the object pointer, so arrays of Ptr can be grown and
+// shifted with memcpy.
+template<class C>
+struct IsTriviallyRelocatable< Ptr<C> >
+{
+    enum { Value = true };
+};
+
 } // OVR
 
 #endif
@@ -0,0 +1,402 @@
+/************************************************************************************
+
+Filename    :   OVR_SlabAllocator.cpp
+Content     :   Size-class slab allocator with per-thread caches
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#include "OVR_SlabAllocator.h"
+#include <string.h>
+
+#if defined(OVR_OS_MS)
+    #include "OVR_Win32_IncludeWindows.h"
+#else
+    #include <pthread.h>
+#endif
+
+namespace OVR {
+
+
+// The owner is kept apart from the cache so that a thread whose cache was freed by
+// another thread (FlsFree in ~SlabAllocator) never reads it again.
+static OVR_THREAD_LOCAL void* pThreadCacheTLS      = nullptr;
+static OVR_THREAD_LOCAL void* pThreadCacheOwnerTLS = nullptr;
+
+// The page map covers 48-bit addresses on 64-bit platforms, the whole address space
+// on 32-bit ones.
+#ifdef OVR_64BIT_POINTERS
+static const size_t PageMapRootEntries = (size_t)1 << (48 - SlabAllocator::PageShift - 16);
+#else
+static const size_t PageMapRootEntries = (size_t)1 << (32 - SlabAllocator::PageShift - 16);
+#endif
+static const size_t PageMapLeafEntries = (size_t)1 << 16;
+
+
+struct SlabAllocator::ThreadCache
+{
+    SlabAllocator* pOwner;
+    FreeBlock*     pFree[ClassCount];
+    int            Count[ClassCount];
+};
+
+
+SlabAllocator::SlabAllocator()
+    : PageMapRootSize(PageMapRootEntries),
+      pChunkNext(nullptr),
+      pChunkEnd(nullptr),
+      ReservedPages(0),
+      ThreadExitKey(0),
+      ThreadExitKeyValid(false)
+{
+    for (int i = 0; i < ClassCount; i++)
+    {
+        Central[i].pFree     = nullptr;
+        Central[i].pCarve    = nullptr;
+        Central[i].pCarveEnd = nullptr;
+    }
+
+    // Zero-filled by the OS and only committed as it is touched.
+    pPageMap = (uint8_t**)SafeMMapAlloc(PageMapRootSize * sizeof(uint8_t*));
+
+    // Without the key, threads simply keep their cache until the process exits.
+#if defined(OVR_OS_MS)
+    DWORD index = FlsAlloc(threadExit);
+    ThreadExitKeyValid = (index != FLS_OUT_OF_INDEXES);
+    ThreadExitKey      = index;
+#else
+    pthread_key_t key;
+    ThreadExitKeyValid = (pthread_key_create(&key, threadExit) == 0);
+    ThreadExitKey      = (uintptr_t)key;
+#endif
+}
+
+SlabAllocator::~SlabAllocator()
+{
+    // Pages are intentionally not released: blocks may still be freed by static
+    // destructors that run after this one. The key is, so threads that exit later
+    // don't call back into this allocator; FlsFree runs the callback for the threads
+    // still holding a cache, pthread_key_delete leaves those caches behind.
+    if (ThreadExitKeyValid)
+    {
+#if defined(OVR_OS_MS)
+        FlsFree((DWORD)ThreadExitKey);
+#else
+        pthread_key_delete((pthread_key_t)ThreadExitKey);
+#endif
+        ThreadExitKeyValid = false;
+    }
+}
+
+// Size classes: 16-byte steps up to 128, then 32-byte steps up to MaxSmallSize.
+static const uint16_t ClassSizes[SlabAllocator::ClassCount] =
+{
+    16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256
+};
+
+// Size class by (size + 15) / 16.
+static const uint8_t ClassBySize16[SlabAllocator::MaxSmallSize / 16 + 1] =
+{
+    0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 8, 9, 9, 10, 10, 11, 11
+};
+
+// Blocks moved at once: MaxBatchBytes worth, between 8 and 64.
+static const uint8_t BatchCounts[SlabAllocator::ClassCount] =
+{
+    64, 64, 64, 64, 51, 42, 36, 32, 25, 21, 18, 16
+};
+
+int SlabAllocator::getClass(size_t size)
+{
+    return ClassBySize16[(size + 15) >> 4];
+}
+
+size_t SlabAllocator::getClassSize(int sizeClass)
+{
+    return ClassSizes[sizeClass];
+}
+
+int SlabAllocator::getBatchCount(int sizeClass)
+{
+    return BatchCounts[sizeClass];
+}
+
+int SlabAllocator::findClass(const void* p) const
+{
+    size_t page = (size_t)p >> PageShift;
+    size_t root = page / PageMapLeafEntries;
+
+    if (!pPageMap || root >= PageMapRootSize)
+        return -1;
+
+    // Leaves are published before any block in their range is handed out, and
+    // freshly mapped leaves read as zero, so foreign pointers safely map to -1.
+    const uint8_t* leaf = pPageMap[root];
+    if (!leaf)
+        return -1;
+    return (int)leaf[page % PageMapLeafEntries] - 1;
+}
+
+SlabAllocator::ThreadCache* SlabAllocator::getThreadCache()
+{
+    if (pThreadCacheOwnerTLS == this)
+        return (ThreadCache*)pThreadCacheTLS;
+
+    ThreadCache* cache = (ThreadCache*)malloc(sizeof(ThreadCache));
+    if (!cache)
+        return nullptr;
+    memset(cache, 0, sizeof(ThreadCache));
+    cache->pOwner = this;
+
+    if (ThreadExitKeyValid)
+    {
+#if defined(OVR_OS_MS)
+        FlsSetValue((DWORD)ThreadExitKey, cache);
+#else
+        pthread_setspecific((pthread_key_t)ThreadExitKey, cache);
+#endif
+    }
+
+    pThreadCacheTLS      = cache;
+    pThreadCacheOwnerTLS = this;
+    return cache;
+}
+
+void OVR_STDCALL SlabAllocator::threadExit(void* p)
+{
+    ThreadCache* cache = (ThreadCache*)p;
+    if (!cache)
+        return;
+
+    // Destructors of other thread-local objects may still allocate after this; they
+    // get a new cache, which pthreads frees on a later destructor pass.
+    if (pThreadCacheTLS == cache)
+    {
+        pThreadCacheTLS      = nullptr;
+        pThreadCacheOwnerTLS = nullptr;
+    }
+
+    for (int i = 0; i < ClassCount; i++)
+        cache->pOwner->release(cache, i, cache->Count[i]);
+    free(cache);
+}
+
+uint8_t* SlabAllocator::allocPage(int sizeClass)
+{
+    Lock::Locker lock(&PageLock);
+
+    if (pChunkNext == pChunkEnd)
+    {
+        // One extra page so the chunk can be aligned to the page size.
+        uint8_t* chunk = (uint8_t*)SafeMMapAlloc((ChunkPages + 1) * (size_t)PageSize);
+        if (!chunk)
+            return nullptr;
+        pChunkNext = (uint8_t*)(((size_t)chunk + PageSize - 1) & ~(size_t)(PageSize - 1));
+        pChunkEnd  = pChunkNext + ChunkPages * (size_t)PageSize;
+    }
+
+    uint8_t* page = pChunkNext;
+    size_t   index = (size_t)page >> PageShift;
+    size_t   root  = index / PageMapLeafEntries;
+    if (!pPageMap || root >= PageMapRootSize)
+        return nullptr;
+
+    if (!pPageMap[root])
+    {
+        pPageMap[root] = (uint8_t*)SafeMMapAlloc(PageMapLeafEntries);
+        if (!pPageMap[root])
+            return nullptr;
+    }
+    pPageMap[root][index % PageMapLeafEntries] = (uint8_t)(sizeClass + 1);
+
+    pChunkNext += PageSize;
+    ReservedPages.ExchangeAdd_NoSync(1);
+    return page;
+}
+
+void SlabAllocator::refill(ThreadCache* cache, int sizeClass)
+{
+    CentralList& central = Central[sizeClass];
+    size_t       size    = getClassSize(sizeClass);
+    int          count   = getBatchCount(sizeClass);
+
+    Lock::Locker lock(&central.ListLock);
+
+    for (int i = 0; i < count; i++)
+    {
+        FreeBlock* block = central.pFree;
+        if (block)
+        {
+            central.pFree = block->pNext;
+        }
+        else
+        {
+            if (central.pCarve == central.pCarveEnd)
+            {
+                uint8_t* page = allocPage(sizeClass);
+                if (!page)
+                    break;
+                central.pCarve    = page;
+                central.pCarveEnd = page + (PageSize / size) * size;
+            }
+            block = (FreeBlock*)central.pCarve;
+            central.pCarve += size;
+        }
+
+        block->pNext = cache->pFree[sizeClass];
+        cache->pFree[sizeClass] = block;
+        cache->Count[sizeClass]++;
+    }
+}
+
+void SlabAllocator::release(ThreadCache* cache, int sizeClass, int count)
+{
+    FreeBlock* first = cache->pFree[sizeClass];
+    if (!first || count <= 0)
+        return;
+
+    // Detach the first count blocks, then splice them into the central list at once.
+    FreeBlock* last = first;
+    int        n    = 1;
+    while (n < count && last->pNext)
+    {
+        last = last->pNext;
+        n++;
+    }
+    cache->pFree[sizeClass] = last->pNext;
+    cache->Count[sizeClass] -= n;
+
+    CentralList& central = Central[sizeClass];
+    Lock::Locker lock(&central.ListLock);
+    last->pNext   = central.pFree;
+    central.pFree = first;
+}
+
+void* SlabAllocator::allocSmall(int sizeClass)
+{
+    ThreadCache* cache = getThreadCache();
+    if (!cache)
+        return nullptr;
+
+    if (!cache->pFree[sizeClass])
+    {
+        refill(cache, sizeClass);
+        if (!cache->pFree[sizeClass])
+            return nullptr;
+    }
+
+    FreeBlock* block = cache->pFree[sizeClass];
+    cache->pFree[sizeClass] = block->pNext;
+    cache->Count[sizeClass]--;
+    return block;
+}
+
+void SlabAllocator::freeSmall(void* p, int sizeClass)
+{
+    ThreadCache* cache = getThreadCache();
+    FreeBlock*   block = (FreeBlock*)p;
+
+    if (!cache)
+    {
+        CentralList& central = Central[sizeClass];
+        Lock::Locker lock(&central.ListLock);
+        block->pNext  = central.pFree;
+        central.pFree = block;
+        return;
+    }
+
+    block->pNext = cache->pFree[sizeClass];
+    cache->pFree[sizeClass] = block;
+
+    int batch = getBatchCount(sizeClass);
+    if (++cache->Count[sizeClass] > 2 * batch)
+        release(cache, sizeClass, batch);
+}
+
+void* SlabAllocator::Alloc(size_t size)
+{
+    if (size > MaxSmallSize)
+        return DefaultAllocator::Alloc(size);
+
+    void* p = allocSmall(getClass(size));
+    trackAlloc(p, size);
+    return p;
+}
+
+void* SlabAllocator::AllocDebug(size_t size, const char* file, unsigned line)
+{
+    if (size > MaxSmallSize)
+        return DefaultAllocator::AllocDebug(size, file, line);
+    return Alloc(size);
+}
+
+void* SlabAllocator::Realloc(void* p, size_t newSize)
+{
+    if (!p)
+        return Alloc(newSize);
+
+    int sizeClass = findClass(p);
+    if (sizeClass < 0)
+        return DefaultAllocator::Realloc(p, newSize);
+
+    // Shrinking, or growing within the block, keeps the block.
+    size_t oldSize = getClassSize(sizeClass);
+    if (newSize <= oldSize)
+        return p;
+
+    void* newP = Alloc(newSize);
+    if (newP)
+    {
+        memcpy(newP, p, oldSize);
+        Free(p);
+    }
+    return newP;
+}
+
+void SlabAllocator::Free(void *p)
+{
+    if (!p)
+        return;
+
+    int sizeClass = findClass(p);
+    if (sizeClass < 0)
+    {
+        // Large block, or allocated before this allocator was installed.
+        DefaultAllocator::Free(p);
+        return;
+    }
+
+    untrackAlloc(p);
+    freeSmall(p, sizeClass);
+}
+
+void SlabAllocator::FlushThreadCache()
+{
+    if (pThreadCacheOwnerTLS != this)
+        return;
+    ThreadCache* cache = (ThreadCache*)pThreadCacheTLS;
+
+    for (int i = 0; i < ClassCount; i++)
+        release(cache, i, cache->Count[i]);
+}
+
+
+} // namespace OVR
@@ -0,0 +1,137 @@
+/************************************************************************************
+
+PublicHeader:   OVR_Kernel.h
+Filename    :   OVR_SlabAllocator.h
+Content     :   Size-class slab allocator with per-thread caches
+Created     :   October 16, 2026
+Authors     :   Ausias Pomes
+
+Copyright   :   Copyright 2014 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.2 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.2 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#ifndef OVR_SlabAllocator_h
+#define OVR_SlabAllocator_h
+
+#include "OVR_Allocator.h"
+
+namespace OVR {
+
+
+//-----------------------------------------------------------------------------------
+// ***** SlabAllocator
+
+// SlabAllocator serves small allocations (up to MaxSmallSize bytes) from size-classed
+// slabs and forwards everything else to DefaultAllocator. Install it with
+// System::Init(log, &slabAllocator) before any other kernel object is created.
+//
+// Memory is taken from the OS in chunks of 64 KB pages; each page holds blocks of a
+// single size class, recorded in a page map so that Free can tell the class of a block
+// (and whether it is one of ours at all) from its address alone. Blocks never carry a
+// header.
+//
+// Each thread keeps a small free list per size class and allocates and frees from it
+// without locking. When a thread list runs empty it takes a batch of blocks from the
+// central list of that class; when it grows past twice the batch size, a batch goes
+// back. The central lists are the only locked path.
+//
+// A thread's cache is flushed and freed when the thread exits, whether or not it is an
+// OVR::Thread. Pages are kept for the lifetime of the allocator, which must outlive
+// every block it handed out; in practice it is a global that stays installed until the
+// process exits.
+// Blocks allocated before installation are recognized and freed by DefaultAllocator.
+
+class SlabAllocator : public DefaultAllocator
+{
+public:
+    enum {
+        MaxSmallSize  = 256,
+        ClassCount    = 12,
+        PageShift     = 16,
+        PageSize      = 1 << PageShift,
+        ChunkPages    = 16,            // Pages reserved from the OS at a time
+        MaxBatchBytes = 4096           // Blocks moved between a thread and the central list at once
+    };
+
+    SlabAllocator();
+    virtual ~SlabAllocator();
+
+    virtual void*   Alloc(size_t size);
+    virtual void*   AllocDebug(size_t size, const char* file, unsigned line);
+    virtual void*   Realloc(void* p, size_t newSize);
+    virtual void    Free(void *p);
+
+    // Bytes of pages reserved from the OS for small blocks.
+    size_t          GetReservedBytes() const { return ReservedPages.Load_Acquire() * (size_t)PageSize; }
+
+    // Returns the blocks cached by the calling thread to the central lists. Threads
+    // do this on exit anyway; call it to hand the blocks back earlier.
+    void            FlushThreadCache();
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* pNext;
+    };
+
+    struct ThreadCache;
+
+    struct CentralList
+    {
+        Lock       ListLock;
+        FreeBlock* pFree;
+        uint8_t*   pCarve;            // Unused part of the page being split into blocks
+        uint8_t*   pCarveEnd;
+    };
+
+    static int     getClass(size_t size);
+    static size_t  getClassSize(int sizeClass);
+    static int     getBatchCount(int sizeClass);
+
+    // Returns the size class of a block from this allocator, or -1.
+    int            findClass(const void* p) const;
+
+    ThreadCache*   getThreadCache();
+    static void OVR_STDCALL threadExit(void* cache);
+    void*          allocSmall(int sizeClass);
+    void           freeSmall(void* p, int sizeClass);
+    void           refill(ThreadCache* cache, int sizeClass);
+    void           release(ThreadCache* cache, int sizeClass, int count);
+    uint8_t*       allocPage(int sizeClass);
+
+    CentralList    Central[ClassCount];
+
+    // Two-level map from page index to size class + 1; 0 for pages that aren't ours.
+    uint8_t**      pPageMap;
+    size_t         PageMapRootSize;
+
+    Lock           PageLock;
+    uint8_t*       pChunkNext;         // Pages left in the current chunk
+    uint8_t*       pChunkEnd;
+    AtomicInt<size_t> ReservedPages;
+
+    // TLS key (FLS index on Windows) whose destructor frees a thread's cache when the
+    // thread exits. Stored as uintptr_t to keep the platform headers out of here.
+    uintptr_t      ThreadExitKey;
+    bool           ThreadExitKeyValid;
+};
+
+
+} // namespace OVR
+
+#endif // OVR_SlabAllocator_h
@@ -42,15 +42,14 @@ String::DataDesc String::NullData = {String_LengthIsSize, AtomicInt<int32_t>(1),
 
 String::String()
 {
-    pData = &NullData;
-    pData->AddRef();
+    SetEmpty();
 };
 
 String::String(const char* pdata)
 {
     // Obtain length in bytes; it doesn't matter if _data is UTF8.
     size_t size = pdata ? OVR_strlen(pdata) : 0; 
-    pData = AllocDataCopy1(size, 0, pdata, size);
+    InitDataCopy1(size, 0, pdata, size);
 };
 
 String::String(const char* pdata1, const char* pdata2, const char* pdata3)
@@ -60,97 +59,104 @@ String::String(const char* pdata1, const char* pdata2, const char* pdata3)
     size_t size2 = pdata2 ? OVR_strlen(pdata2) : 0; 
     size_t size3 = pdata3 ? OVR_strlen(pdata3) : 0; 
 
-    DataDesc *pdataDesc = AllocDataCopy2(size1 + size2 + size3, 0,
-                                         pdata1, size1, pdata2, size2);
-    memcpy(pdataDesc->Data + size1 + size2, pdata3, size3);   
-    pData = pdataDesc;    
+    char* pbuffer = InitData(size1 + size2 + size3, 0);
+    memcpy(pbuffer, pdata1, size1);
+    memcpy(pbuffer + size1, pdata2, size2);
+    memcpy(pbuffer + size1 + size2, pdata3, size3);   
 }
 
 String::String(const char* pdata, size_t size)
 {
     OVR_ASSERT((size == 0) || (pdata != 0));
-    pData = AllocDataCopy1(size, 0, pdata, size);
+    InitDataCopy1(size, 0, pdata, size);
 };
 
 
 String::String(const InitStruct& src, size_t size)
 {
-    pData = AllocData(size, 0);
-    src.InitString(GetData()->Data, size);
+    char* pbuffer = InitData(size, 0);
+    src.InitString(pbuffer, size);
 }
 
 String::String(const String& src)
 {    
-    pData = src.GetData();
-    pData->AddRef();
+    memcpy(LocalData, src.LocalData, LocalBufferSize);
+    if (!IsLocal())
+        GetData()->AddRef();
 }
 
 String::String(const StringBuffer& src)
 {
-    pData = AllocDataCopy1(src.GetSize(), 0, src.ToCStr(), src.GetSize());
+    InitDataCopy1(src.GetSize(), 0, src.ToCStr(), src.GetSize());
 }
 
 String::String(const wchar_t* data)
 {
-    pData = &NullData;
-    pData->AddRef();
+    SetEmpty();
     // Simplified logic for wchar_t constructor.
     if (data)    
         *this = data;    
 }
 
 
-String::DataDesc* String::AllocData(size_t size, size_t lengthIsSize)
+char* String::InitData(size_t size, size_t lengthIsSize)
 {
-    String::DataDesc* pdesc;
-
-    if (size == 0)
+    if (size <= LocalCapacity)
     {
-        pdesc = &NullData;
-        pdesc->AddRef();
-        return pdesc;
+        LocalData[size] = 0;
+        SetTag(size | (lengthIsSize ? Tag_LengthIsSize : 0));
+        return LocalData;
     }
 
-    pdesc = (DataDesc*)OVR_ALLOC(sizeof(DataDesc)+ size);
+    String::DataDesc* pdesc = (DataDesc*)OVR_ALLOC(sizeof(DataDesc)+ size);
     pdesc->Data[size] = 0;
     pdesc->RefCount = 1;
     pdesc->Size     = size | lengthIsSize;  
-    return pdesc;
+    pData = pdesc;
+    SetTag(Tag_Heap);
+    return pdesc->Data;
 }
 
 
-String::DataDesc* String::AllocDataCopy1(size_t size, size_t lengthIsSize,
-                                         const char* pdata, size_t copySize)
+void String::InitDataCopy1(size_t size, size_t lengthIsSize,
+                           const char* pdata, size_t copySize)
 {
-    String::DataDesc* pdesc = AllocData(size, lengthIsSize);
-    memcpy(pdesc->Data, pdata, copySize);
-    return pdesc;
+    char* pbuffer = InitData(size, lengthIsSize);
+    memcpy(pbuffer, pdata, copySize);
 }
 
-String::DataDesc* String::AllocDataCopy2(size_t size, size_t lengthIsSize,
-                                         const char* pdata1, size_t copySize1,
-                                         const char* pdata2, size_t copySize2)
+void String::InitDataCopy2(size_t size, size_t lengthIsSize,
+                           const char* pdata1, size_t copySize1,
+                           const char* pdata2, size_t copySize2)
 {
-    String::DataDesc* pdesc = AllocData(size, lengthIsSize);
-    memcpy(pdesc->Data, pdata1, copySize1);
-    memcpy(pdesc->Data + copySize1, pdata2, copySize2);
-    return pdesc;
+    char* pbuffer = InitData(size, lengthIsSize);
+    memcpy(pbuffer, pdata1, copySize1);
+    memcpy(pbuffer + copySize1, pdata2, copySize2);
+}
+
+
+void String::SetLengthIsSize() const
+{
+    // Only caches what the contents already say, so it is allowed on a const string.
+    if (IsLocal())
+        const_cast<String*>(this)->SetTag(GetTag() | Tag_LengthIsSize);
+    else
+        GetData()->Size |= String_LengthIsSize;
 }
 
 
 size_t String::GetLength() const 
 {
     // Optimize length accesses for non-UTF8 character strings. 
-    DataDesc* pdata = GetData();
-    size_t    length, size = pdata->GetSize();
+    size_t    length, size = GetSize();
     
-    if (pdata->LengthIsSize())
+    if (LengthIsSize())
         return size;    
     
-    length = (size_t)UTF8Util::GetLength(pdata->Data, (size_t)size);
+    length = (size_t)UTF8Util::GetLength(ToCStr(), (size_t)size);
     
     if (length == size)
-        pdata->Size |= String_LengthIsSize;
+        SetLengthIsSize();
     
     return length;
 }
@@ -162,27 +168,25 @@ size_t String::GetLength() const
 uint32_t String::GetCharAt(size_t index) const 
 {  
     intptr_t    i = (intptr_t) index;
-    DataDesc*   pdata = GetData();
-    const char* buf = pdata->Data;
+    const char* buf = ToCStr();
     uint32_t    c;
     
-    if (pdata->LengthIsSize())
+    if (LengthIsSize())
     {
-        OVR_ASSERT(index < pdata->GetSize());
+        OVR_ASSERT(index < GetSize());
         buf += i;
         return UTF8Util::DecodeNextChar_Advance0(&buf);
     }
 
-    c = UTF8Util::GetCharAt(index, buf, pdata->GetSize());
+    c = UTF8Util::GetCharAt(index, buf, GetSize());
     return c;
 }
 
 uint32_t String::GetFirstCharAt(size_t index, const char** offset) const
 {
-    DataDesc*   pdata = GetData();
     intptr_t    i = (intptr_t) index;
-    const char* buf = pdata->Data;
-    const char* end = buf + pdata->GetSize();
+    const char* buf = ToCStr();
+    const char* end = buf + GetSize();
     uint32_t    c;
 
     do 
@@ -210,10 +214,29 @@ uint32_t String::GetNextChar(const char** offset) const
 
 
 
+void String::AppendData(const char* pdata, size_t size, size_t lengthIsSize)
+{
+    size_t oldSize = GetSize();
+    size_t newSize = oldSize + size;
+
+    if (IsLocal() && (newSize <= LocalCapacity))
+    {
+        // Inline data is never shared, so it is appended to in place. pdata may
+        // point into it.
+        memmove(LocalData + oldSize, pdata, size);
+        LocalData[newSize] = 0;
+        SetTag(newSize | (lengthIsSize ? Tag_LengthIsSize : 0));
+        return;
+    }
+
+    String result;
+    result.InitDataCopy2(newSize, lengthIsSize, ToCStr(), oldSize, pdata, size);
+    MoveData(result);
+}
+
+
 void String::AppendChar(uint32_t ch)
 {
-    DataDesc*   pdata = GetData();
-    size_t      size = pdata->GetSize();
     char        buff[8];
     intptr_t    encodeSize = 0;
 
@@ -221,9 +244,7 @@ void String::AppendChar(uint32_t ch)
     UTF8Util::EncodeChar(buff, &encodeSize, ch);
     OVR_ASSERT(encodeSize >= 0);
 
-    SetData(AllocDataCopy2(size + (size_t)encodeSize, 0,
-                           pdata->Data, size, buff, (size_t)encodeSize));
-    pdata->Release();
+    AppendData(buff, (size_t)encodeSize, 0);
 }
 
 
@@ -232,16 +253,15 @@ void String::AppendString(const wchar_t* pstr, intptr_t len)
     if (!pstr)
         return;
 
-    DataDesc*   pdata = GetData();
-    size_t      oldSize = pdata->GetSize();    
+    size_t      oldSize = GetSize();    
     size_t      encodeSize = (size_t)UTF8Util::GetEncodeStringSize(pstr, len);
 
-    DataDesc*   pnewData = AllocDataCopy1(oldSize + (size_t)encodeSize, 0,
-                                          pdata->Data, oldSize);
-    UTF8Util::EncodeString(pnewData->Data + oldSize,  pstr, len);
+    String      result;
+    char*       pbuffer = result.InitData(oldSize + (size_t)encodeSize, 0);
+    memcpy(pbuffer, ToCStr(), oldSize);
+    UTF8Util::EncodeString(pbuffer + oldSize,  pstr, len);
 
-    SetData(pnewData);
-    pdata->Release();
+    MoveData(result);
 }
 
 
@@ -252,28 +272,23 @@ void String::AppendString(const char* putf8str, intptr_t utf8StrSz)
     if (utf8StrSz == -1)
         utf8StrSz = (intptr_t)OVR_strlen(putf8str);
 
-    DataDesc*   pdata = GetData();
-    size_t      oldSize = pdata->GetSize();
-
-    SetData(AllocDataCopy2(oldSize + (size_t)utf8StrSz, 0,
-                           pdata->Data, oldSize, putf8str, (size_t)utf8StrSz));
-    pdata->Release();
+    AppendData(putf8str, (size_t)utf8StrSz, 0);
 }
 
 void    String::AssignString(const InitStruct& src, size_t size)
 {
-    DataDesc*   poldData = GetData();
-    DataDesc*   pnewData = AllocData(size, 0);
-    src.InitString(pnewData->Data, size);
-    SetData(pnewData);
-    poldData->Release();
+    String result;
+    char*  pbuffer = result.InitData(size, 0);
+    src.InitString(pbuffer, size);
+    MoveData(result);
 }
 
 void    String::AssignString(const char* putf8str, size_t size)
 {
-    DataDesc* poldData = GetData();
-    SetData(AllocDataCopy1(size, 0, putf8str, size));
-    poldData->Release();
+    // putf8str may point into this string.
+    String result;
+    result.InitDataCopy1(size, 0, putf8str, size);
+    MoveData(result);
 }
 
 void    String::operator = (const char* pstr)
@@ -285,45 +300,39 @@ void    String::operator = (const wchar_t* pwstr)
 {
     pwstr = pwstr ? pwstr : L"";
 
-    DataDesc*   poldData = GetData();
     size_t      size = (size_t)UTF8Util::GetEncodeStringSize(pwstr);
 
-    DataDesc*   pnewData = AllocData(size, 0);
-    UTF8Util::EncodeString(pnewData->Data, pwstr);
-    SetData(pnewData);
-    poldData->Release();
+    String      result;
+    char*       pbuffer = result.InitData(size, 0);
+    UTF8Util::EncodeString(pbuffer, pwstr);
+    MoveData(result);
 }
 
 
 void    String::operator = (const String& src)
 {     
-    DataDesc*    psdata = src.GetData();
-    DataDesc*    pdata = GetData();    
+    if (&src == this)
+        return;
 
-    SetData(psdata);
-    psdata->AddRef();
-    pdata->Release();
+    ReleaseData();
+    memcpy(LocalData, src.LocalData, LocalBufferSize);
+    if (!IsLocal())
+        GetData()->AddRef();
 }
 
 
 void    String::operator = (const StringBuffer& src)
 { 
-    DataDesc* polddata = GetData();    
-    SetData(AllocDataCopy1(src.GetSize(), 0, src.ToCStr(), src.GetSize()));
-    polddata->Release();
+    String result;
+    result.InitDataCopy1(src.GetSize(), 0, src.ToCStr(), src.GetSize());
+    MoveData(result);
 }
 
 void    String::operator += (const String& src)
 {
-    DataDesc   *pourData = GetData(),
-               *psrcData = src.GetData();
-    size_t      ourSize  = pourData->GetSize(),
-                srcSize  = psrcData->GetSize();
-    size_t      lflag    = pourData->GetLengthFlag() & psrcData->GetLengthFlag();
+    size_t      lflag    = GetLengthFlag() & src.GetLengthFlag();
 
-    SetData(AllocDataCopy2(ourSize + srcSize, lflag,
-                           pourData->Data, ourSize, psrcData->Data, srcSize));
-    pourData->Release();
+    AppendData(src.ToCStr(), src.GetSize(), lflag);
 }
 
 
@@ -343,8 +352,8 @@ String   String::operator + (const String& src) const
 
 void    String::Remove(size_t posAt, intptr_t removeLength)
 {
-    DataDesc*   pdata = GetData();
-    size_t      oldSize = pdata->GetSize();    
+    const char* pdata = ToCStr();
+    size_t      oldSize = GetSize();    
     // Length indicates the number of characters to remove. 
     size_t      length = GetLength();
 
@@ -356,13 +365,14 @@ void    String::Remove(size_t posAt, intptr_t removeLength)
         removeLength = length - posAt;
 
     // Get the byte position of the UTF8 char at position posAt.
-    intptr_t bytePos    = UTF8Util::GetByteIndex(posAt, pdata->Data, oldSize);
-    intptr_t removeSize = UTF8Util::GetByteIndex(removeLength, pdata->Data + bytePos, oldSize-bytePos);
+    intptr_t bytePos    = UTF8Util::GetByteIndex(posAt, pdata, oldSize);
+    intptr_t removeSize = UTF8Util::GetByteIndex(removeLength, pdata + bytePos, oldSize-bytePos);
 
-    SetData(AllocDataCopy2(oldSize - removeSize, pdata->GetLengthFlag(),
-                           pdata->Data, bytePos,
-                           pData->Data + bytePos + removeSize, (oldSize - bytePos - removeSize)));
-    pdata->Release();
+    String result;
+    result.InitDataCopy2(oldSize - removeSize, GetLengthFlag(),
+                         pdata, bytePos,
+                         pdata + bytePos + removeSize, (oldSize - bytePos - removeSize));
+    MoveData(result);
 }
 
 
@@ -372,31 +382,30 @@ String   String::Substring(size_t start, size_t end) const
     if ((start >= length) || (start >= end))
         return String();   
 
-    DataDesc* pdata = GetData();
+    const char* pdata = ToCStr();
     
     // If size matches, we know the exact index range.
-    if (pdata->LengthIsSize())
-        return String(pdata->Data + start, end - start);
+    if (LengthIsSize())
+        return String(pdata + start, end - start);
     
     // Get position of starting character.
-    intptr_t byteStart = UTF8Util::GetByteIndex(start, pdata->Data, pdata->GetSize());
-    intptr_t byteSize  = UTF8Util::GetByteIndex(end - start, pdata->Data + byteStart, pdata->GetSize()-byteStart);
-    return String(pdata->Data + byteStart, (size_t)byteSize);
+    intptr_t byteStart = UTF8Util::GetByteIndex(start, pdata, GetSize());
+    intptr_t byteSize  = UTF8Util::GetByteIndex(end - start, pdata + byteStart, GetSize()-byteStart);
+    return String(pdata + byteStart, (size_t)byteSize);
 }
 
 void String::Clear()
 {   
-    NullData.AddRef();
-    GetData()->Release();
-    SetData(&NullData);
+    ReleaseData();
+    SetEmpty();
 }
 
 
 String   String::ToUpper() const 
 {       
     uint32_t    c;
-    const char* psource = GetData()->Data;
-    const char* pend = psource + GetData()->GetSize();
+    const char* psource = ToCStr();
+    const char* pend = psource + GetSize();
     String      str;
     intptr_t    bufferOffset = 0;
     char        buffer[512];
@@ -419,8 +428,8 @@ String   String::ToUpper() const
 String   String::ToLower() const 
 {
     uint32_t    c;
-    const char* psource = GetData()->Data;
-    const char* pend = psource + GetData()->GetSize();
+    const char* psource = ToCStr();
+    const char* pend = psource + GetSize();
     String      str;
     intptr_t    bufferOffset = 0;
     char        buffer[512];
@@ -444,20 +453,20 @@ String   String::ToLower() const
 
 String& String::Insert(const char* substr, size_t posAt, intptr_t strSize)
 {
-    DataDesc* poldData   = GetData();
-    size_t    oldSize    = poldData->GetSize();
-    size_t    insertSize = (strSize < 0) ? OVR_strlen(substr) : (size_t)strSize;    
-    size_t    byteIndex  =  (poldData->LengthIsSize()) ?
-                            posAt : (size_t)UTF8Util::GetByteIndex(posAt, poldData->Data, oldSize);
+    const char* poldData   = ToCStr();
+    size_t      oldSize    = GetSize();
+    size_t      insertSize = (strSize < 0) ? OVR_strlen(substr) : (size_t)strSize;    
+    size_t      byteIndex  =  LengthIsSize() ?
+                              posAt : (size_t)UTF8Util::GetByteIndex(posAt, poldData, oldSize);
 
     OVR_ASSERT(byteIndex <= oldSize);
     
-    DataDesc* pnewData = AllocDataCopy2(oldSize + insertSize, 0,
-                                        poldData->Data, byteIndex, substr, insertSize);
-    memcpy(pnewData->Data + byteIndex + insertSize,
-           poldData->Data + byteIndex, oldSize - byteIndex);
-    SetData(pnewData);
-    poldData->Release();
+    String result;
+    char*  pbuffer = result.InitData(oldSize + insertSize, 0);
+    memcpy(pbuffer, poldData, byteIndex);
+    memcpy(pbuffer + byteIndex, substr, insertSize);
+    memcpy(pbuffer + byteIndex + insertSize, poldData + byteIndex, oldSize - byteIndex);
+    MoveData(result);
     return *this;
 }
 
@@ -50,7 +50,8 @@ class StringBuffer;
 // ***** String Class 
 
 // String is UTF8 based string class with copy-on-write implementation
-// for assignment.
+// for assignment. Strings of up to LocalCapacity bytes are stored inline in
+// the String object, without heap allocation or reference counting.
 
 class String
 {
@@ -109,15 +110,65 @@ protected:
         HT_Mask     = 3
     };
 
+    enum StorageConstants
+    {
+        // Bytes of inline storage. The last byte is the tag; the one before it
+        // leaves room for the terminating zero of the longest inline string.
+        LocalBufferSize  = 24,
+        LocalCapacity    = LocalBufferSize - 2,
+
+        // Tag bits. Inline strings keep their size in the tag.
+        Tag_Heap         = 0x80,    // Data is in a shared DataDesc (pData).
+        Tag_LengthIsSize = 0x40,    // Same as the DataDesc length flag, for inline strings.
+        Tag_SizeMask     = 0x3F
+    };
+
     union {
         DataDesc* pData;
         size_t    HeapTypeBits;
+        char      LocalData[LocalBufferSize];
     };
     typedef union {
         DataDesc* pData;
         size_t    HeapTypeBits;
     } DataDescUnion;
 
+    inline uint8_t     GetTag() const      { return (uint8_t)LocalData[LocalBufferSize - 1]; }
+    inline void        SetTag(size_t tag)  { LocalData[LocalBufferSize - 1] = (char)tag; }
+    inline bool        IsLocal() const     { return (GetTag() & Tag_Heap) == 0; }
+
+    // Makes this an empty inline string; doesn't release the previous data.
+    inline void        SetEmpty()
+    {
+        LocalData[0] = 0;
+        SetTag(Tag_LengthIsSize);
+    }
+
+    inline void        ReleaseData()
+    {
+        if (!IsLocal())
+            GetData()->Release();
+    }
+
+    // Releases our data and takes over the data of src, which is left empty.
+    inline void        MoveData(String& src)
+    {
+        ReleaseData();
+        memcpy(LocalData, src.LocalData, LocalBufferSize);
+        src.SetEmpty();
+    }
+
+    bool        LengthIsSize() const
+    {
+        return IsLocal() ? (GetTag() & Tag_LengthIsSize) != 0 : GetData()->LengthIsSize();
+    }
+    // Length flag in DataDesc format, to pass to InitData.
+    size_t      GetLengthFlag() const
+    {
+        return LengthIsSize() ? DataDesc::GetLengthFlagBit() : 0;
+    }
+    void        SetLengthIsSize() const;
+
     inline HeapType    GetHeapType() const { return (HeapType) (HeapTypeBits & HT_Mask); }
 
     inline DataDesc*   GetData() const
@@ -137,12 +188,17 @@ protected:
     }
 
     
-    DataDesc*   AllocData(size_t size, size_t lengthIsSize);
-    DataDesc*   AllocDataCopy1(size_t size, size_t lengthIsSize,
-                               const char* pdata, size_t copySize);
-    DataDesc*   AllocDataCopy2(size_t size, size_t lengthIsSize,
-                               const char* pdata1, size_t copySize1,
-                               const char* pdata2, size_t copySize2);
+    // Sets up storage for size bytes, inline if they fit, and returns it with the
+    // terminating zero written. The string must be empty or its data released.
+    char*       InitData(size_t size, size_t lengthIsSize);
+    void        InitDataCopy1(size_t size, size_t lengthIsSize,
+                              const char* pdata, size_t copySize);
+    void        InitDataCopy2(size_t size, size_t lengthIsSize,
+                              const char* pdata1, size_t copySize1,
+                              const char* pdata2, size_t copySize2);
+
+    // Appends size bytes; the result keeps the length flag only if lengthIsSize is set.
+    void        AppendData(const char* pdata, size_t size, size_t lengthIsSize);
 
     // Special constructor to avoid data initalization when used in derived class.
     struct NoConstructor { };
@@ -167,11 +223,18 @@ public:
     String(const StringBuffer& src);
     String(const InitStruct& src, size_t size);
     explicit String(const wchar_t* data);      
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    String(String&& src)
+    {
+        memcpy(LocalData, src.LocalData, LocalBufferSize);
+        src.SetEmpty();
+    }
+#endif
 
     // Destructor (Captain Obvious guarantees!)
     ~String()
     {
-        GetData()->Release();
+        ReleaseData();
     }
 
     // Declaration of NullString
@@ -183,12 +246,12 @@ public:
     void        Clear();
 
     // For casting to a pointer to char.
-    operator const char*() const        { return GetData()->Data; }
+    operator const char*() const        { return ToCStr(); }
     // Pointer to raw buffer.
-    const char* ToCStr() const          { return GetData()->Data; }
+    const char* ToCStr() const          { return IsLocal() ? LocalData : GetData()->Data; }
 
     // Returns number of bytes
-    size_t      GetSize() const         { return GetData()->GetSize() ; }
+    size_t      GetSize() const         { return IsLocal() ? (GetTag() & Tag_SizeMask) : GetData()->GetSize(); }
     // Tells whether or not the string is empty
     bool        IsEmpty() const         { return GetSize() == 0; }
 
@@ -239,7 +302,7 @@ public:
 //  String&    Insert(const uint32_t* substr, size_t posAt, intptr_t size = -1);
 
     // Get Byte index of the character at position = index
-    size_t      GetByteIndex(size_t index) const { return (size_t)UTF8Util::GetByteIndex(index, GetData()->Data); }
+    size_t      GetByteIndex(size_t index) const { return (size_t)UTF8Util::GetByteIndex(index, ToCStr()); }
 
     // Utility: case-insensitive string compare.  stricmp() & strnicmp() are not
     // ANSI or POSIX, do not seem to appear in Linux.
@@ -284,6 +347,9 @@ public:
     void        operator =  (const wchar_t* str);
     void        operator =  (const String& src);
     void        operator =  (const StringBuffer& src);
+#if !defined(OVR_CPP_NO_RVALUE_REFERENCES)
+    void        operator =  (String&& src)           { if (&src != this) MoveData(src); }
+#endif
 
     // Addition
     void        operator += (const String& src);
@@ -296,7 +362,7 @@ public:
     // Comparison
     bool        operator == (const String& str) const
     {
-        return (OVR_strcmp(GetData()->Data, str.GetData()->Data)== 0);
+        return (OVR_strcmp(ToCStr(), str.ToCStr())== 0);
     }
 
     bool        operator != (const String& str) const
@@ -306,7 +372,7 @@ public:
 
     bool        operator == (const char* str) const
     {
-        return OVR_strcmp(GetData()->Data, str) == 0;
+        return OVR_strcmp(ToCStr(), str) == 0;
     }
 
     bool        operator != (const char* str) const
@@ -316,47 +382,47 @@ public:
 
     bool        operator <  (const char* pstr) const
     {
-        return OVR_strcmp(GetData()->Data, pstr) < 0;
+        return OVR_strcmp(ToCStr(), pstr) < 0;
     }
 
     bool        operator <  (const String& str) const
     {
-        return *this < str.GetData()->Data;
+        return *this < str.ToCStr();
     }
 
     bool        operator >  (const char* pstr) const
     {
-        return OVR_strcmp(GetData()->Data, pstr) > 0;
+        return OVR_strcmp(ToCStr(), pstr) > 0;
     }
 
     bool        operator >  (const String& str) const
     {
-        return *this > str.GetData()->Data;
+        return *this > str.ToCStr();
     }
 
     int CompareNoCase(const char* pstr) const
     {
-        return CompareNoCase(GetData()->Data, pstr);
+        return CompareNoCase(ToCStr(), pstr);
     }
     int CompareNoCase(const String& str) const
     {
-        return CompareNoCase(GetData()->Data, str.ToCStr());
+        return CompareNoCase(ToCStr(), str.ToCStr());
     }
     int CompareNoCaseStartsWith(const String& str) const
     {
-        return CompareNoCase(GetData()->Data, str.ToCStr(), str.GetLength());
+        return CompareNoCase(ToCStr(), str.ToCStr(), str.GetLength());
     }
 
     // Accesses raw bytes
     const char&     operator [] (int index) const
     {
         OVR_ASSERT(index >= 0 && (size_t)index < GetSize());
-        return GetData()->Data[index];
+        return ToCStr()[index];
     }
     const char&     operator [] (size_t index) const
     {
         OVR_ASSERT(index < GetSize());
-        return GetData()->Data[index];
+        return ToCStr()[index];
     }
 
 
@@ -404,6 +470,14 @@ public:
 
 };
 
+// String holds no pointers into itself, so arrays of String can be grown and
+// shifted with memcpy.
+template<>
+struct IsTriviallyRelocatable<String>
+{
+    enum { Value = true };
+};
+
 
 //-----------------------------------------------------------------------------------
 // ***** String Buffer used for Building Strings
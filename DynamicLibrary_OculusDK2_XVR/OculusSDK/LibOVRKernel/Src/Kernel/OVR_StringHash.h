@@ -31,6 +31,7 @@ limitations under the License.
 
 #include "OVR_String.h"
 #include "OVR_Hash.h"
+#include "OVR_FlatHash.h"
 
 namespace OVR {
 
@@ -40,14 +41,17 @@ namespace OVR {
 // This is a custom string hash table that supports case-insensitive
 // searches through special functions such as GetCaseInsensitive, etc.
 // This class is used for Flash labels, exports and other case-insensitive tables.
+//
+// BaseHash is the underlying table; FlatStringHash below uses a FlatHash instead.
 
-template<class U, class Allocator = ContainerAllocator<U> >
-class StringHash : public Hash<String, U, String::NoCaseHashFunctor, Allocator>
+template<class U, class Allocator = ContainerAllocator<U>,
+         class BaseHash = Hash<String, U, String::NoCaseHashFunctor, Allocator> >
+class StringHash : public BaseHash
 {
 public:
     typedef U                                                        ValueType;
-    typedef StringHash<U, Allocator>                                 SelfType;
-    typedef Hash<String, U, String::NoCaseHashFunctor, Allocator>    BaseType;
+    typedef StringHash<U, Allocator, BaseHash>                       SelfType;
+    typedef BaseHash                                                 BaseType;
 
 public:    
 
@@ -95,6 +99,19 @@ public:
     } 
 };
 
+
+// StringHash on a FlatHash, for lookup-heavy tables.
+template<class U, class Allocator = ContainerAllocator<U> >
+class FlatStringHash
+    : public StringHash<U, Allocator, FlatHash<String, U, String::NoCaseHashFunctor, Allocator> >
+{
+public:
+    typedef FlatStringHash<U, Allocator>                                                       SelfType;
+    typedef StringHash<U, Allocator, FlatHash<String, U, String::NoCaseHashFunctor, Allocator> > BaseType;
+
+    void    operator = (const SelfType& src) { BaseType::operator = (src); }
+};
+
 } // OVR 
 
 #endif
@@ -99,7 +99,7 @@ static int System_Init_Count = 0;
 
 
 // Initializes System core, installing allocator.
-void System::Init(Log* log)
+void System::Init(Log* log, Allocator* allocator)
 {
     #if defined(_MSC_VER)
         // Make it so that failure of the C malloc family of functions results in the same behavior as C++ operator new failure.
@@ -117,6 +117,8 @@ void System::Init(Log* log)
 
     if (++System_Init_Count == 1)
     {
+        if (allocator)
+            Allocator::SetInstance(allocator);
         Log::SetGlobalLog(log);
         Timer::initializeTimerSystem();
     }
@@ -159,8 +159,10 @@ public:
     static bool OVR_CDECL IsInitialized();
 
     // Initializes System core.  Users can override memory implementation by passing
-    // a different Allocator here.
-    static void OVR_CDECL Init(Log* log = Log::ConfigureDefaultLog(LogMask_Debug));
+    // a different Allocator here. It is installed by the first Init and stays installed
+    // after Destroy, so it must outlive every allocation made through it.
+    static void OVR_CDECL Init(Log* log = Log::ConfigureDefaultLog(LogMask_Debug),
+                               Allocator* allocator = nullptr);
 
 	// De-initializes System more, finalizing the threading system and destroying
     // the global memory allocator.
@@ -407,4 +407,283 @@ bool ThreadCommandQueue::IsExiting() const
 }
 
 
+
+//-------------------------------------------------------------------------------------
+// ***** LocklessCommandQueue
+
+// Marks a record that only pads the ring up to its end, so that the next command is
+// contiguous in memory.
+static const uint32_t PaddingSpan = 0x80000000u;
+
+struct LocklessCommandQueue::ExitCommand : public ThreadCommand
+{
+    LocklessCommandQueue* pQueue;
+
+    ExitCommand(LocklessCommandQueue* queue, bool wait)
+        : ThreadCommand(sizeof(ExitCommand), wait, true), pQueue(queue) { }
+
+    virtual void Execute() const
+    {
+        pQueue->ExitProcessed = true;
+    }
+    virtual ThreadCommand* CopyConstruct(void* p) const
+    { return Construct<ExitCommand>(p, *this); }
+};
+
+
+LocklessCommandQueue::LocklessCommandQueue(unsigned slotCount)
+    : Head(0),
+      Tail(0),
+      ExitEnqueued(0),
+      ExitProcessed(false),
+      ConsumerWaiting(0),
+      SpaceWaiters(0),
+      PullThreadId(0)
+{
+    // Largest command (PopBuffer limit of 256 bytes) must fit in half the ring.
+    SlotCount = 8;
+    while (SlotCount < slotCount)
+        SlotCount <<= 1;
+    SlotMask = SlotCount - 1;
+
+    pSlots  = (uint8_t*)OVR_ALLOC_ALIGNED(SlotCount * SlotSize, SlotSize);
+    pStates = (SlotState*)OVR_ALLOC(SlotCount * sizeof(SlotState));
+
+    // A slot at position p is free for the lap starting at p when its sequence is p.
+    for (uint32_t i = 0; i < SlotCount; i++)
+    {
+        Construct<SlotState>(&pStates[i]);
+        pStates[i].Sequence.Store_Release(i);
+        pStates[i].Span = 0;
+    }
+    for (int i = 0; i < EventPoolSize; i++)
+        EventPool[i].InUse.Store_Release(0);
+}
+
+LocklessCommandQueue::~LocklessCommandQueue()
+{
+    // For ThreadCommands, we must consume everything before shutdown.
+    OVR_ASSERT(!hasCommand());
+    OVR_FREE(pStates);
+    OVR_FREE_ALIGNED(pSlots);
+}
+
+bool LocklessCommandQueue::hasCommand() const
+{
+    return pStates[Tail & SlotMask].Sequence.Load_Acquire() == Tail + 1;
+}
+
+void LocklessCommandQueue::releaseSlots(uint32_t pos, uint32_t span)
+{
+    // Slots are freed in order, so a producer that sees the last slot of its range
+    // free knows the whole range is.
+    for (uint32_t i = 0; i < span; i++)
+        pStates[(pos + i) & SlotMask].Sequence.Store_Release(pos + i + SlotCount);
+}
+
+void LocklessCommandQueue::waitForSpace(uint32_t pos)
+{
+    // Only producers that find the ring full get here, so the lock stays off the
+    // fast path.
+    SpaceWaiters.ExchangeAdd_Sync(1);
+    {
+        Mutex::Locker lock(&SpaceMutex);
+        if ((int32_t)(pStates[pos & SlotMask].Sequence.Load_Acquire() - pos) < 0)
+            SpaceCondition.Wait(&SpaceMutex);
+    }
+    SpaceWaiters.ExchangeAdd_Sync(-1);
+}
+
+void LocklessCommandQueue::wakeProducers()
+{
+    // Full barrier, pairs with the one in waitForSpace.
+    if (SpaceWaiters.ExchangeAdd_Sync(0) > 0)
+    {
+        Mutex::Locker lock(&SpaceMutex);
+        SpaceCondition.NotifyAll();
+    }
+}
+
+void LocklessCommandQueue::wakeConsumer()
+{
+    if (ConsumerWaiting.Load_Acquire() && ConsumerWaiting.CompareAndSet_Sync(1, 0))
+        ConsumerEvent.SetEvent();
+}
+
+LocklessCommandQueue::NotifyEvent* LocklessCommandQueue::allocNotifyEvent()
+{
+    // Start at a per-thread position so producers don't all contend on the first entry.
+    size_t start = ((size_t)OVR::GetCurrentThreadId() >> 4) % EventPoolSize;
+
+    for (int i = 0; i < EventPoolSize; i++)
+    {
+        PooledEvent& e = EventPool[(start + i) % EventPoolSize];
+        if (!e.InUse.Load_Acquire() && e.InUse.CompareAndSet_Sync(0, 1))
+            return &e.Event;
+    }
+    // More waiting producers than pooled events.
+    return new NotifyEvent;
+}
+
+void LocklessCommandQueue::freeNotifyEvent(NotifyEvent* p)
+{
+    for (int i = 0; i < EventPoolSize; i++)
+    {
+        if (p == &EventPool[i].Event)
+        {
+            EventPool[i].InUse.Store_Release(0);
+            return;
+        }
+    }
+    delete p;
+}
+
+bool LocklessCommandQueue::PushCommand(const ThreadCommand& command)
+{
+    if (command.NeedsWait() && PullThreadId == OVR::GetCurrentThreadId())
+    {
+        command.Execute();
+        return true;
+    }
+
+    uint32_t slots = (uint32_t)((command.GetSize() + SlotSize - 1) / SlotSize);
+    OVR_ASSERT(slots <= SlotCount / 2);
+
+    NotifyEvent* completeEvent = 0;
+
+    for (;;)
+    {
+        // Don't allow any commands after PushExitCommand() is called.
+        if (ExitEnqueued.Load_Acquire() && !command.ExitFlag)
+        {
+            if (completeEvent)
+                freeNotifyEvent(completeEvent);
+            return false;
+        }
+
+        uint32_t pos   = Head.Load_Acquire();
+        uint32_t index = pos & SlotMask;
+        uint32_t span  = slots;
+        bool     pad   = (index + slots > SlotCount);
+        if (pad)
+            span = SlotCount - index;
+
+        uint32_t last = pos + span - 1;
+        int32_t  diff = (int32_t)(pStates[last & SlotMask].Sequence.Load_Acquire() - last);
+
+        if (diff < 0)
+        {
+            // Ring is full; the consumer has not freed the previous lap yet.
+            waitForSpace(last);
+            continue;
+        }
+        if (diff > 0 || !Head.CompareAndSet_Sync(pos, pos + span))
+        {
+            // Another producer claimed this position first.
+            continue;
+        }
+
+        // The slots [pos, pos + span) are ours until published.
+        SlotState& state = pStates[index];
+        if (pad)
+        {
+            state.Span = span | PaddingSpan;
+            state.Sequence.Exchange_Sync(pos + 1);
+            continue;
+        }
+
+        ThreadCommand* c = command.CopyConstruct(pSlots + index * SlotSize);
+        if (c->NeedsWait())
+        {
+            if (!completeEvent)
+                completeEvent = allocNotifyEvent();
+            c->pEvent = completeEvent;
+        }
+        state.Span = span;
+
+        // Full barrier, so the consumer can't go to sleep without seeing this command.
+        state.Sequence.Exchange_Sync(pos + 1);
+        wakeConsumer();
+        break;
+    }
+
+    // Command was enqueued, wait if necessary.
+    if (completeEvent)
+    {
+        completeEvent->Wait();
+        freeNotifyEvent(completeEvent);
+    }
+    return true;
+}
+
+bool LocklessCommandQueue::PopCommand(ThreadCommand::PopBuffer* popBuffer)
+{
+    if (PullThreadId != OVR::GetCurrentThreadId())
+    {
+        PullThreadId = OVR::GetCurrentThreadId();
+    }
+
+    for (;;)
+    {
+        if (!hasCommand())
+            return false;
+
+        uint32_t pos     = Tail;
+        uint32_t span    = pStates[pos & SlotMask].Span;
+        bool     padding = (span & PaddingSpan) != 0;
+
+        if (padding)
+            span &= ~PaddingSpan;
+        else
+            popBuffer->InitFromBuffer(pSlots + (pos & SlotMask) * SlotSize);
+
+        Tail = pos + span;
+        releaseSlots(pos, span);
+
+        // Wake blocked producers each time half of the ring has been freed, rather than
+        // for every slot, so they refill it in a batch.
+        if (((pos ^ Tail) & ~(SlotCount / 2 - 1)) || !hasCommand())
+            wakeProducers();
+
+        if (!padding)
+            return true;
+    }
+}
+
+bool LocklessCommandQueue::WaitForCommand(unsigned delay)
+{
+    // Give producers a chance to fill the ring before paying for a sleep and a wake-up.
+    for (int i = 0; i < WaitSpinCount; i++)
+    {
+        if (hasCommand())
+            return true;
+        Thread::YieldCurrentThread();
+    }
+
+    ConsumerEvent.ResetEvent();
+    ConsumerWaiting.Exchange_Sync(1);
+
+    // Re-check after announcing the wait; a producer publishing from now on wakes us.
+    if (!hasCommand())
+        ConsumerEvent.Wait(delay);
+
+    ConsumerWaiting.Exchange_Sync(0);
+    return hasCommand();
+}
+
+void LocklessCommandQueue::PushExitCommand(bool wait)
+{
+    // Same two stages as ThreadCommandQueue::PushExitCommand.
+    if (!ExitEnqueued.CompareAndSet_Sync(0, 1))
+        return;
+
+    PushCommand(ExitCommand(this, wait));
+}
+
+bool LocklessCommandQueue::IsExiting() const
+{
+    return ExitProcessed;
+}
+
+
 } // namespace OVR
@@ -214,43 +214,17 @@ public:
 
 
 //-------------------------------------------------------------------------------------
-// ***** ThreadCommandQueue
+// ***** ThreadCommandCalls
 
-// ThreadCommandQueue is a queue of executable function-call commands intended to be
-// serviced by a single consumer thread. Commands are added to the queue with PushCall
-// and removed with PopCall; they are processed in FIFO order. Multiple producer threads
-// are supported and will be blocked if internal data buffer is full.
+// ThreadCommandCalls provides the PushCall family of functions for a command queue Q;
+// they wrap the call into a ThreadCommand and hand it to Q::PushCommand. Shared by
+// ThreadCommandQueue and LocklessCommandQueue.
 
-class ThreadCommandQueue
+template<class Q>
+class ThreadCommandCalls
 {
 public:
 
-    ThreadCommandQueue();
-    virtual ~ThreadCommandQueue();
-
-
-    // Pops the next command from the thread queue, if any is available.
-    // The command should be executed by calling popBuffer->Execute().
-    // Returns 'false' if no command is available at the time of the call.
-    bool PopCommand(ThreadCommand::PopBuffer* popBuffer);
-
-    // Generic implementaion of PushCommand; enqueues a command for execution.
-    // Returns 'false' if push failed, usually indicating thread shutdown.
-    bool PushCommand(const ThreadCommand& command);
-
-    // 
-    void PushExitCommand(bool wait);
-
-    // Returns 'true' once ExitCommand has been processed, so the thread can shut down.
-    bool IsExiting() const;
-
-
-    // These two virtual functions serve as notifications for derived
-    // thread waiting.    
-    virtual void OnPushNonEmpty_Locked() { }
-    virtual void OnPopEmpty_Locked()     { }
-
-
     // *** PushCall with no result
     
     // Enqueue a member function of 'this' class to be called on consumer thread.
@@ -258,27 +232,27 @@ public:
     // wait for completion.
     template<class C, class R>
     bool PushCall(R (C::*fn)(), bool wait = false)
-    { return PushCommand(ThreadCommandMF0<C,R>(static_cast<C*>(this), fn, 0, wait)); }       
+    { return static_cast<Q*>(this)->PushCommand(ThreadCommandMF0<C,R>(static_cast<C*>(this), fn, 0, wait)); }       
     template<class C, class R, class A0>
     bool PushCall(R (C::*fn)(A0), typename SelfType<A0>::Type a0, bool wait = false)
-    { return PushCommand(ThreadCommandMF1<C,R,A0>(static_cast<C*>(this), fn, 0, a0, wait)); }
+    { return static_cast<Q*>(this)->PushCommand(ThreadCommandMF1<C,R,A0>(static_cast<C*>(this), fn, 0, a0, wait)); }
     template<class C, class R, class A0, class A1>
     bool PushCall(R (C::*fn)(A0, A1),
                   typename SelfType<A0>::Type a0, typename SelfType<A1>::Type a1, bool wait = false)
-    { return PushCommand(ThreadCommandMF2<C,R,A0,A1>(static_cast<C*>(this), fn, 0, a0, a1, wait)); }
+    { return static_cast<Q*>(this)->PushCommand(ThreadCommandMF2<C,R,A0,A1>(static_cast<C*>(this), fn, 0, a0, a1, wait)); }
     // Enqueue a specified member function call of class C.
     // By default the function returns immediately; set 'wait' argument to 'true' to
     // wait for completion.
     template<class C, class R>
     bool PushCall(C* p, R (C::*fn)(), bool wait = false)
-    { return PushCommand(ThreadCommandMF0<C,R>(p, fn, 0, wait)); }
+    { return static_cast<Q*>(this)->PushCommand(ThreadCommandMF0<C,R>(p, fn, 0, wait)); }
     template<class C, class R, class A0>
     bool PushCall(C* p, R (C::*fn)(A0), typename SelfType<A0>::Type a0, bool wait = false)
-    { return PushCommand(ThreadCommandMF1<C,R,A0>(p, fn, 0, a0, wait)); }
+    { return static_cast<Q*>(this)->PushCommand(ThreadCommandMF1<C,R,A0>(p, fn, 0, a0, wait)); }
     template<class C, class R, class A0, class A1>
     bool PushCall(C* p, R (C::*fn)(A0, A1),
                   typename SelfType<A0>::Type a0, typename SelfType<A1>::Type a1, bool wait = false)
-    { return PushCommand(ThreadCommandMF2<C,R,A0,A1>(p, fn, 0, a0, a1, wait)); }
+    { return static_cast<Q*>(this)->PushCommand(ThreadCommandMF2<C,R,A0,A1>(p, fn, 0, a0, a1, wait)); }
     
     
     // *** PushCall with Result
@@ -287,32 +261,166 @@ public:
     // on consumer thread before returning.
     template<class C, class R>
     bool PushCallAndWaitResult(R (C::*fn)(), R* ret)
-    { return PushCommand(ThreadCommandMF0<C,R>(static_cast<C*>(this), fn, ret, true)); }       
+    { return static_cast<Q*>(this)->PushCommand(ThreadCommandMF0<C,R>(static_cast<C*>(this), fn, ret, true)); }       
     template<class C, class R, class A0>
     bool PushCallAndWaitResult(R (C::*fn)(A0), R* ret, typename SelfType<A0>::Type a0)
-    { return PushCommand(ThreadCommandMF1<C,R,A0>(static_cast<C*>(this), fn, ret, a0, true)); }
+    { return static_cast<Q*>(this)->PushCommand(ThreadCommandMF1<C,R,A0>(static_cast<C*>(this), fn, ret, a0, true)); }
     template<class C, class R, class A0, class A1>
     bool PushCallAndWaitResult(R (C::*fn)(A0, A1), R* ret,
                                typename SelfType<A0>::Type a0, typename SelfType<A1>::Type a1)
-    { return PushCommand(ThreadCommandMF2<C,R,A0,A1>(static_cast<C*>(this), fn, ret, a0, a1, true)); }
+    { return static_cast<Q*>(this)->PushCommand(ThreadCommandMF2<C,R,A0,A1>(static_cast<C*>(this), fn, ret, a0, a1, true)); }
     // Enqueue a member function call for class C and wait for the call to complete
     // on consumer thread before returning.
     template<class C, class R>
     bool PushCallAndWaitResult(C* p, R (C::*fn)(), R* ret)
-    { return PushCommand(ThreadCommandMF0<C,R>(p, fn, ret, true)); }
+    { return static_cast<Q*>(this)->PushCommand(ThreadCommandMF0<C,R>(p, fn, ret, true)); }
     template<class C, class R, class A0>
     bool PushCallAndWaitResult(C* p, R (C::*fn)(A0), R* ret, typename SelfType<A0>::Type a0)
-    { return PushCommand(ThreadCommandMF1<C,R,A0>(p, fn, ret, a0, true)); }
+    { return static_cast<Q*>(this)->PushCommand(ThreadCommandMF1<C,R,A0>(p, fn, ret, a0, true)); }
     template<class C, class R, class A0, class A1>
     bool PushCallAndWaitResult(C* p, R (C::*fn)(A0, A1), R* ret,
                                typename SelfType<A0>::Type a0, typename SelfType<A1>::Type a1)
-    { return PushCommand(ThreadCommandMF2<C,R,A0,A1>(p, fn, ret, a0, a1, true)); }
+    { return static_cast<Q*>(this)->PushCommand(ThreadCommandMF2<C,R,A0,A1>(p, fn, ret, a0, a1, true)); }
+};
+
+
+//-------------------------------------------------------------------------------------
+// ***** ThreadCommandQueue
+
+// ThreadCommandQueue is a queue of executable function-call commands intended to be
+// serviced by a single consumer thread. Commands are added to the queue with PushCall
+// and removed with PopCall; they are processed in FIFO order. Multiple producer threads
+// are supported and will be blocked if internal data buffer is full.
+
+class ThreadCommandQueue : public ThreadCommandCalls<ThreadCommandQueue>
+{
+public:
+
+    ThreadCommandQueue();
+    virtual ~ThreadCommandQueue();
+
+
+    // Pops the next command from the thread queue, if any is available.
+    // The command should be executed by calling popBuffer->Execute().
+    // Returns 'false' if no command is available at the time of the call.
+    bool PopCommand(ThreadCommand::PopBuffer* popBuffer);
+
+    // Generic implementaion of PushCommand; enqueues a command for execution.
+    // Returns 'false' if push failed, usually indicating thread shutdown.
+    bool PushCommand(const ThreadCommand& command);
+
+    // 
+    void PushExitCommand(bool wait);
+
+    // Returns 'true' once ExitCommand has been processed, so the thread can shut down.
+    bool IsExiting() const;
+
+
+    // These two virtual functions serve as notifications for derived
+    // thread waiting.    
+    virtual void OnPushNonEmpty_Locked() { }
+    virtual void OnPopEmpty_Locked()     { }
 
 private:
     class ThreadCommandQueueImpl* pImpl;
 };
 
 
+//-------------------------------------------------------------------------------------
+// ***** LocklessCommandQueue
+
+// LocklessCommandQueue is a drop-in variant of ThreadCommandQueue for queues with many
+// producers. Producers never take a lock: commands are copied into a bounded ring of
+// fixed-size slots, a command larger than one slot taking several contiguous ones. Each
+// slot carries a sequence number; a producer claims its slots by advancing the shared
+// head with a single compare-and-set and publishes the command by bumping the sequence
+// of its first slot, which is what the consumer polls. Completion events used by
+// PushCallAndWaitResult come from a fixed pool and are reused instead of allocated.
+//
+// Producers that find the ring full block until the consumer frees slots; that is the
+// only path taking a lock. A command pushed concurrently with PushExitCommand may still
+// land behind the exit command.
+//
+// Instead of the _Locked notifications the consumer can block in WaitForCommand.
+
+class LocklessCommandQueue : public ThreadCommandCalls<LocklessCommandQueue>
+{
+public:
+    enum {
+        SlotSize         = 64,
+        DefaultSlotCount = 512,     // 32 KB; producers that fill the ring sleep until half
+                                    // of it is free, so bursts must fit.
+        EventPoolSize    = 32,
+        WaitSpinCount    = 16
+    };
+
+    // slotCount is rounded up to a power of two.
+    LocklessCommandQueue(unsigned slotCount = DefaultSlotCount);
+    virtual ~LocklessCommandQueue();
+
+    // Same contract as ThreadCommandQueue; PopCommand must always be called from
+    // the same consumer thread.
+    bool PopCommand(ThreadCommand::PopBuffer* popBuffer);
+    bool PushCommand(const ThreadCommand& command);
+    void PushExitCommand(bool wait);
+    bool IsExiting() const;
+
+    // Blocks the consumer until a command is available or delay (ms) expires.
+    // Returns 'true' if a command is available.
+    bool WaitForCommand(unsigned delay = OVR_WAIT_INFINITE);
+
+private:
+    typedef ThreadCommand::NotifyEvent NotifyEvent;
+
+    struct ExitCommand;
+    friend struct ExitCommand;
+
+    struct SlotState
+    {
+        AtomicInt<uint32_t> Sequence;
+        uint32_t            Span;     // Slots used by the record in this slot, if first.
+    };
+
+    struct PooledEvent
+    {
+        AtomicInt<int> InUse;
+        NotifyEvent    Event;
+    };
+
+    bool         hasCommand() const;
+    void         releaseSlots(uint32_t pos, uint32_t span);
+    void         waitForSpace(uint32_t pos);
+    void         wakeProducers();
+    void         wakeConsumer();
+
+    NotifyEvent* allocNotifyEvent();
+    void         freeNotifyEvent(NotifyEvent* p);
+
+    uint8_t*            pSlots;
+    SlotState*          pStates;
+    uint32_t            SlotCount;
+    uint32_t            SlotMask;
+
+    AtomicInt<uint32_t> Head;              // Next position to be claimed by a producer.
+    uint32_t            Tail;              // Next position to be read; consumer only.
+
+    AtomicInt<int>      ExitEnqueued;
+    volatile bool       ExitProcessed;
+
+    AtomicInt<int>      ConsumerWaiting;
+    Event               ConsumerEvent;
+
+    AtomicInt<int>      SpaceWaiters;      // Producers blocked on a full ring.
+    Mutex               SpaceMutex;
+    WaitCondition       SpaceCondition;
+
+    PooledEvent         EventPool[EventPoolSize];
+
+    // See ThreadCommandQueueImpl::PullThreadId.
+    OVR::ThreadId       PullThreadId;
+};
+
+
 } // namespace OVR
 
 #endif // OVR_ThreadCommandQueue_h
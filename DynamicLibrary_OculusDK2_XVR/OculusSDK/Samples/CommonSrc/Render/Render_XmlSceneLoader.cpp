@@ -23,9 +23,107 @@ limitations under the License.
 
 #include "Render_XmlSceneLoader.h"
 #include <Kernel/OVR_Log.h>
+#include <Kernel/OVR_FlatHash.h>
+#include <Kernel/OVR_MappedFile.h>
 
 namespace OVR { namespace Render {
 
+const char* const SceneCacheExtension = ".scenebin";
+
+
+//-------------------------------------------------------------------------------------
+// ***** SceneCache
+
+// The binary scene file is a SceneCacheHeader followed by
+//   TextureCount x  { uint32_t length, name chars }
+//   ModelCount x    { SceneCacheModel, name chars, Vertex[VertexCount], uint16_t[IndexCount] }
+//   CollisionModelCount + GroundCollisionModelCount x { uint32_t planeCount, Planef[planeCount] }
+// in native byte order, with every item padded to 4 bytes. A file that doesn't
+// match is ignored and rewritten from the XML.
+
+enum
+{
+    SceneCacheMagic   = 0x4E435358,  // "XSCN"
+    // Bump whenever ReadFile changes what it makes of the XML.
+    SceneCacheVersion = 1
+};
+
+struct SceneCacheHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t VertexSize;            // sizeof(Vertex)
+    uint32_t TextureCount;
+    uint32_t ModelCount;
+    uint32_t CollisionModelCount;
+    uint32_t GroundCollisionModelCount;
+    uint32_t Reserved;
+    uint64_t SourceHash;            // MixHash::Hash64 of the XML file.
+    uint64_t SourceSize;            // Size of the XML file.
+    uint64_t FileSize;              // Size of this file.
+};
+
+struct SceneCacheModel
+{
+    uint32_t NameLength;
+    int32_t  DiffuseTextureIndex;   // -1 for none.
+    int32_t  LightmapTextureIndex;  // -1 for none.
+    uint32_t IsCollisionModel;
+    uint32_t VertexCount;
+    uint32_t IndexCount;
+};
+
+class SceneCacheReader
+{
+public:
+    SceneCacheReader(const uint8_t* data, size_t size) : pPos(data), pEnd(data + size) { }
+
+    // Returns the next count items and moves past them, or null if the file is too short.
+    template<class T>
+    const T* Read(size_t count = 1)
+    {
+        if (count > (size_t)(pEnd - pPos) / sizeof(T))
+            return NULL;
+        const T* items = (const T*)pPos;
+        size_t   size  = (sizeof(T) * count + 3) & ~(size_t)3;
+        pPos = (size < (size_t)(pEnd - pPos)) ? pPos + size : pEnd;
+        return items;
+    }
+
+private:
+    const uint8_t* pPos;
+    const uint8_t* pEnd;
+};
+
+class SceneCacheWriter
+{
+public:
+    template<class T>
+    void Write(const T* items, size_t count = 1)
+    {
+        size_t size = sizeof(T) * count;
+        Data.Append((const uint8_t*)items, size);
+        for (; size & 3; size++)
+            Data.PushBack(0);
+    }
+
+    ArrayPOD<uint8_t> Data;
+};
+
+// Returns the size and hash of a file, which a binary scene file baked from it records.
+// MixHash reads a word at a time; the byte-wise CRC32 took as long as reading the cache.
+static bool hashSourceFile(const char* fileName, uint64_t* size, uint64_t* hash)
+{
+    MappedFile file;
+    if (!file.Open(fileName))
+        return false;
+
+    *size = file.GetSize();
+    *hash = MixHash<uint8_t>::Hash64(file.GetData(), file.GetSize());
+    return true;
+}
+
+
 XmlHandler::XmlHandler() :
     pXmlDocument(NULL),
     textureCount(0),
@@ -48,14 +146,8 @@ bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRend
                           bool srgbAware /*= false*/,
                           bool anisotropic /*= false*/)
 {
-    if(pXmlDocument->LoadFile(fileName) != 0)
-    {
-        return false;
-    }
-
     // Extract the relative path to our working directory for loading textures
     filePath[0] = 0;
-    intptr_t pos = 0;
 	intptr_t len = strlen(fileName);
     for(intptr_t i = len; i > 0; i--)
     {
@@ -67,6 +159,26 @@ bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRend
         }        
     }    
 
+    int textureLoadFlags = 0;
+    textureLoadFlags |= srgbAware ? TextureLoad_SrgbAware : 0;
+    textureLoadFlags |= anisotropic ? TextureLoad_Anisotropic : 0;
+
+    // Use the binary scene file while it matches the XML file.
+    String   cachePath  = String(fileName) + SceneCacheExtension;
+    uint64_t sourceSize = 0;
+    uint64_t sourceHash = 0;
+    bool     hashed     = hashSourceFile(fileName, &sourceSize, &sourceHash);
+    if (hashed && ReadSceneCache(cachePath, sourceSize, sourceHash, pRender, pScene,
+                                 pCollisions, pGroundCollisions, textureLoadFlags))
+    {
+        return true;
+    }
+
+    if(pXmlDocument->LoadFile(fileName) != 0)
+    {
+        return false;
+    }
+
     // Load the textures
 	OVR_DEBUG_LOG_TEXT(("Loading textures..."));
     XMLElement* pXmlTexture = pXmlDocument->FirstChildElement("scene")->FirstChildElement("textures");
@@ -80,45 +192,8 @@ bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRend
     for(int i = 0; i < textureCount; ++i)
     {
         const char* textureName = pXmlTexture->Attribute("fileName");
-		intptr_t    dotpos = strcspn(textureName, ".");
-        char        fname[300];
-
-		if (pos == len)
-		{            
-			OVR_sprintf(fname, 300, "%s", textureName);
-		}
-		else
-		{
-			OVR_sprintf(fname, 300, "%s%s", filePath, textureName);
-		}
-
-        int textureLoadFlags = 0;
-        textureLoadFlags |= srgbAware ? TextureLoad_SrgbAware : 0;
-        textureLoadFlags |= anisotropic ? TextureLoad_Anisotropic : 0;
-
-        SysFile* pFile = new SysFile(fname);
-		Ptr<Texture> texture;
-		if (textureName[dotpos + 1] == 'd' || textureName[dotpos + 1] == 'D')
-		{
-			// DDS file
-            Texture* tmp_ptr = LoadTextureDDSTopDown(pRender, pFile, textureLoadFlags);
-			if(tmp_ptr)
-			{
-				texture.SetPtr(*tmp_ptr);
-			}
-		}
-		else
-		{
-            Texture* tmp_ptr = LoadTextureTgaTopDown(pRender, pFile, textureLoadFlags, 255);
-			if(tmp_ptr)
-			{
-				texture.SetPtr(*tmp_ptr);
-			}
-		}
-
-        Textures.PushBack(texture);
-		pFile->Close();
-		pFile->Release();
+        Textures.PushBack(LoadTexture(textureName, pRender, textureLoadFlags));
+        TextureNames.PushBack(textureName);
         pXmlTexture = pXmlTexture->NextSiblingElement("texture");
     }
 	OVR_DEBUG_LOG_TEXT(("Done.\n"));
@@ -148,34 +223,37 @@ bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRend
 
         bool tree_c = (strcmp(name, "tree_C") == 0) || (strcmp(name, "Object03") == 0);
 
+        // The parsed arrays only live until the model's vertices are built.
+        ArenaScope scratch(ParseArena);
+
         //read the vertices
-        OVR::Array<Vector3f> *vertices = new OVR::Array<Vector3f>();
+        ArrayArenaPOD<Vector3f> vertices;
         ParseVectorString(pXmlModel->FirstChildElement("vertices")->FirstChild()->
-			              ToText()->Value(), vertices);
+			              ToText()->Value(), &vertices);
 
-		for (unsigned int vertexIndex = 0; vertexIndex < vertices->GetSize(); ++vertexIndex)
+		for (unsigned int vertexIndex = 0; vertexIndex < vertices.GetSize(); ++vertexIndex)
 		{
-			vertices->At(vertexIndex).x *= -1.0f;
+			vertices.At(vertexIndex).x *= -1.0f;
 
             if (tree_c)
             {   // Move the terrace tree closer to the house
-                vertices->At(vertexIndex).z += 0.5;
+                vertices.At(vertexIndex).z += 0.5;
             }
 		}
 
         //read the normals
-        OVR::Array<Vector3f> *normals = new OVR::Array<Vector3f>();
+        ArrayArenaPOD<Vector3f> normals;
         ParseVectorString(pXmlModel->FirstChildElement("normals")->FirstChild()->
-			              ToText()->Value(), normals);
+			              ToText()->Value(), &normals);
 
-		for (unsigned int normalIndex = 0; normalIndex < normals->GetSize(); ++normalIndex)
+		for (unsigned int normalIndex = 0; normalIndex < normals.GetSize(); ++normalIndex)
 		{
-			normals->At(normalIndex).z *= -1.0f;
+			normals.At(normalIndex).z *= -1.0f;
 		}
 
         //read the textures
-        OVR::Array<Vector3f> *diffuseUVs = new OVR::Array<Vector3f>();
-        OVR::Array<Vector3f> *lightmapUVs = new OVR::Array<Vector3f>();
+        ArrayArenaPOD<Vector3f> diffuseUVs;
+        ArrayArenaPOD<Vector3f> lightmapUVs;
         int         diffuseTextureIndex = -1;
         int         lightmapTextureIndex = -1;
         XMLElement* pXmlCurMaterial = pXmlModel->FirstChildElement("material");
@@ -189,7 +267,7 @@ bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRend
                 if(diffuseTextureIndex > -1)
                 {
                     ParseVectorString(pXmlCurMaterial->FirstChildElement("texture")->
-						              FirstChild()->ToText()->Value(), diffuseUVs, true);
+						              FirstChild()->ToText()->Value(), &diffuseUVs, true);
                 }
             }
             else if(pXmlCurMaterial->Attribute("name", "lightmap"))
@@ -202,7 +280,7 @@ bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRend
                     XMLNode* firstChild = firstChildElement->FirstChild();
                     XMLText* text = firstChild->ToText();
                     const char* value = text->Value();
-                    ParseVectorString(value, lightmapUVs, true);
+                    ParseVectorString(value, &lightmapUVs, true);
                 }
             }
 
@@ -210,51 +288,38 @@ bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRend
         }
 
         //set up the shader
-        Ptr<ShaderFill> shader = *new ShaderFill(*pRender->CreateShaderSet());
-        shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Vertex, VShader_MVP));
-        if(diffuseTextureIndex > -1)
-        {
-            shader->SetTexture(0, Textures[diffuseTextureIndex]);
-            if(lightmapTextureIndex > -1)
-            {
-                shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Fragment, FShader_MultiTexture));
-                shader->SetTexture(1, Textures[lightmapTextureIndex]);
-            }
-            else
-            {
-                shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Fragment, FShader_Texture));
-            }
-        }
-        else
-        {
-            shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Fragment, FShader_LitGouraud));
-        }
-        Models[i]->Fill = shader;
+        Models[i]->Fill = CreateFill(pRender, diffuseTextureIndex, lightmapTextureIndex);
+
+        ModelInfo info;
+        info.Name                 = name;
+        info.DiffuseTextureIndex  = diffuseTextureIndex;
+        info.LightmapTextureIndex = lightmapTextureIndex;
+        ModelInfos.PushBack(info);
 
         //add all the vertices to the model
-        const size_t numVerts = vertices->GetSize();
+        const size_t numVerts = vertices.GetSize();
         for(size_t v = 0; v < numVerts; ++v)
         {
             if(diffuseTextureIndex > -1)
             {
                 if(lightmapTextureIndex > -1)
                 {
-                    Models[i]->AddVertex(vertices->At(v).z, vertices->At(v).y, vertices->At(v).x, Color(255, 255, 255),
-                                          diffuseUVs->At(v).x, diffuseUVs->At(v).y, lightmapUVs->At(v).x, lightmapUVs->At(v).y,
-                                          normals->At(v).x, normals->At(v).y, normals->At(v).z);
+                    Models[i]->AddVertex(vertices.At(v).z, vertices.At(v).y, vertices.At(v).x, Color(255, 255, 255),
+                                          diffuseUVs.At(v).x, diffuseUVs.At(v).y, lightmapUVs.At(v).x, lightmapUVs.At(v).y,
+                                          normals.At(v).x, normals.At(v).y, normals.At(v).z);
                 }
                 else
                 {
-                    Models[i]->AddVertex(vertices->At(v).z, vertices->At(v).y, vertices->At(v).x, Color(255, 255, 255),
-                                          diffuseUVs->At(v).x, diffuseUVs->At(v).y, 0, 0,
-                                          normals->At(v).x, normals->At(v).y, normals->At(v).z);
+                    Models[i]->AddVertex(vertices.At(v).z, vertices.At(v).y, vertices.At(v).x, Color(255, 255, 255),
+                                          diffuseUVs.At(v).x, diffuseUVs.At(v).y, 0, 0,
+                                          normals.At(v).x, normals.At(v).y, normals.At(v).z);
                 }
             }
             else
             {
-                Models[i]->AddVertex(vertices->At(v).z, vertices->At(v).y, vertices->At(v).x, Color(255, 255, 255, 255),
+                Models[i]->AddVertex(vertices.At(v).z, vertices.At(v).y, vertices.At(v).x, Color(255, 255, 255, 255),
                                       0, 0, 0, 0,
-                                      normals->At(v).x, normals->At(v).y, normals->At(v).z);
+                                      normals.At(v).x, normals.At(v).y, normals.At(v).z);
             }
         }
 
@@ -294,11 +359,6 @@ bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRend
             indices[indexCount - revIndex - 1] = itemp;            
         }
 
-        delete vertices;
-        delete normals;
-        delete diffuseUVs;
-        delete lightmapUVs;
-
         pScene->World.Add(Models[i]);
         pScene->Models.PushBack(Models[i]);
         pXmlModel = pXmlModel->NextSiblingElement("model");
@@ -342,6 +402,7 @@ bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRend
             pXmlPlane = pXmlPlane->NextSiblingElement("plane");
         }
 
+        CollisionModels.PushBack(cm);
         if (pCollisions)
         pCollisions->PushBack(cm);
         pXmlCollisionModel = pXmlCollisionModel->NextSiblingElement("collisionModel");
@@ -379,16 +440,291 @@ bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRend
             pXmlPlane = pXmlPlane->NextSiblingElement("plane");
         }
 
+        GroundCollisionModels.PushBack(cm);
         if (pGroundCollisions)
         pGroundCollisions->PushBack(cm);
         pXmlCollisionModel = pXmlCollisionModel->NextSiblingElement("collisionModel");
     }
     }
 	OVR_DEBUG_LOG(("done."));
+
+    // Failing to write the binary scene file only costs the next load its speed.
+    if (hashed && !WriteSceneCache(cachePath, sourceSize, sourceHash))
+    {
+        OVR_DEBUG_LOG(("Could not write %s.", cachePath.ToCStr()));
+    }
 	return true;
 }
 
-void XmlHandler::ParseVectorString(const char* str, OVR::Array<OVR::Vector3f> *array,
+Ptr<Texture> XmlHandler::LoadTexture(const char* textureName, OVR::Render::RenderDevice* pRender,
+                                     int textureLoadFlags)
+{
+    intptr_t dotpos = strcspn(textureName, ".");
+    char     fname[300];
+    OVR_sprintf(fname, 300, "%s%s", filePath, textureName);
+
+    SysFile* pFile = new SysFile(fname);
+    Ptr<Texture> texture;
+    if (textureName[dotpos] && (textureName[dotpos + 1] == 'd' || textureName[dotpos + 1] == 'D'))
+    {
+        // DDS file
+        Texture* tmp_ptr = LoadTextureDDSTopDown(pRender, pFile, textureLoadFlags);
+        if(tmp_ptr)
+        {
+            texture.SetPtr(*tmp_ptr);
+        }
+    }
+    else
+    {
+        Texture* tmp_ptr = LoadTextureTgaTopDown(pRender, pFile, textureLoadFlags, 255);
+        if(tmp_ptr)
+        {
+            texture.SetPtr(*tmp_ptr);
+        }
+    }
+
+    pFile->Close();
+    pFile->Release();
+    return texture;
+}
+
+Ptr<ShaderFill> XmlHandler::CreateFill(OVR::Render::RenderDevice* pRender,
+                                       int diffuseTextureIndex, int lightmapTextureIndex)
+{
+    Ptr<ShaderFill> shader = *new ShaderFill(*pRender->CreateShaderSet());
+    shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Vertex, VShader_MVP));
+    if(diffuseTextureIndex > -1)
+    {
+        shader->SetTexture(0, Textures[diffuseTextureIndex]);
+        if(lightmapTextureIndex > -1)
+        {
+            shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Fragment, FShader_MultiTexture));
+            shader->SetTexture(1, Textures[lightmapTextureIndex]);
+        }
+        else
+        {
+            shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Fragment, FShader_Texture));
+        }
+    }
+    else
+    {
+        shader->GetShaders()->SetShader(pRender->LoadBuiltinShader(Shader_Fragment, FShader_LitGouraud));
+    }
+    return shader;
+}
+
+bool XmlHandler::ReadSceneCache(const char* cachePath, uint64_t sourceSize, uint64_t sourceHash,
+                                OVR::Render::RenderDevice* pRender, OVR::Render::Scene* pScene,
+                                OVR::Array<Ptr<CollisionModel> >* pCollisions,
+                                OVR::Array<Ptr<CollisionModel> >* pGroundCollisions,
+                                int textureLoadFlags)
+{
+    MappedFile file;
+    if (!file.Open(cachePath))
+    {
+        return false;
+    }
+
+    SceneCacheReader        reader(file.GetData(), file.GetSize());
+    const SceneCacheHeader* header = reader.Read<SceneCacheHeader>();
+    if (!header || (header->Magic != SceneCacheMagic) || (header->Version != SceneCacheVersion) ||
+        (header->VertexSize != sizeof(Vertex)) || (header->SourceHash != sourceHash) ||
+        (header->SourceSize != sourceSize) || (header->FileSize != file.GetSize()))
+    {
+        return false;
+    }
+
+    // Find every item before creating anything, so that a damaged file is ignored as a whole.
+    struct ModelItems
+    {
+        const SceneCacheModel* pModel;
+        const char*            pName;
+        const Vertex*          pVertices;
+        const uint16_t*        pIndices;
+    };
+    struct PlaneItems
+    {
+        uint32_t      Count;
+        const Planef* pPlanes;
+    };
+    OVR::Array<String>     textureNames;
+    OVR::Array<ModelItems> models;
+    OVR::Array<PlaneItems> planes;
+
+    for (uint32_t i = 0; i < header->TextureCount; ++i)
+    {
+        const uint32_t* length = reader.Read<uint32_t>();
+        const char*     name   = length ? reader.Read<char>(*length) : NULL;
+        if (!name)
+        {
+            return false;
+        }
+        textureNames.PushBack(String(name, *length));
+    }
+
+    for (uint32_t i = 0; i < header->ModelCount; ++i)
+    {
+        ModelItems items;
+        items.pModel = reader.Read<SceneCacheModel>();
+        if (!items.pModel ||
+            (items.pModel->DiffuseTextureIndex  >= (int32_t)header->TextureCount) ||
+            (items.pModel->LightmapTextureIndex >= (int32_t)header->TextureCount))
+        {
+            return false;
+        }
+        items.pName     = reader.Read<char>(items.pModel->NameLength);
+        items.pVertices = reader.Read<Vertex>(items.pModel->VertexCount);
+        items.pIndices  = reader.Read<uint16_t>(items.pModel->IndexCount);
+        if (!items.pName || !items.pVertices || !items.pIndices)
+        {
+            return false;
+        }
+        // Indices go straight to the index buffer; one outside the vertices means a bad file.
+        for (uint32_t j = 0; j < items.pModel->IndexCount; ++j)
+        {
+            if (items.pIndices[j] >= items.pModel->VertexCount)
+            {
+                return false;
+            }
+        }
+        models.PushBack(items);
+    }
+
+    for (uint32_t i = 0; i < header->CollisionModelCount + header->GroundCollisionModelCount; ++i)
+    {
+        const uint32_t* count = reader.Read<uint32_t>();
+        PlaneItems      items;
+        items.Count   = count ? *count : 0;
+        items.pPlanes = count ? reader.Read<Planef>(items.Count) : NULL;
+        if (!items.pPlanes)
+        {
+            return false;
+        }
+        planes.PushBack(items);
+    }
+
+    OVR_DEBUG_LOG(("Loading scene from %s...", cachePath));
+
+    textureCount = (int)header->TextureCount;
+    for (int i = 0; i < textureCount; ++i)
+    {
+        Textures.PushBack(LoadTexture(textureNames[i], pRender, textureLoadFlags));
+    }
+
+    modelCount = (int)header->ModelCount;
+    for (int i = 0; i < modelCount; ++i)
+    {
+        const SceneCacheModel* info  = models[i].pModel;
+        Ptr<Model>             model = *new Model(Prim_Triangles, String(models[i].pName, info->NameLength));
+        model->IsCollisionModel = (info->IsCollisionModel != 0);
+        if (model->IsCollisionModel)
+        {
+            model->Visible = false;
+        }
+        model->Fill = CreateFill(pRender, info->DiffuseTextureIndex, info->LightmapTextureIndex);
+        model->Vertices.Append(models[i].pVertices, info->VertexCount);
+        model->Indices.Append(models[i].pIndices, info->IndexCount);
+
+        Models.PushBack(model);
+        pScene->World.Add(model);
+        pScene->Models.PushBack(model);
+    }
+
+    collisionModelCount       = (int)header->CollisionModelCount;
+    groundCollisionModelCount = (int)header->GroundCollisionModelCount;
+    for (size_t i = 0; i < planes.GetSize(); ++i)
+    {
+        Ptr<CollisionModel> cm = *new CollisionModel();
+        cm->Planes.Append(planes[i].pPlanes, planes[i].Count);
+
+        OVR::Array<Ptr<CollisionModel> >* pCollisionModels =
+            ((int)i < collisionModelCount) ? pCollisions : pGroundCollisions;
+        if (pCollisionModels)
+        {
+            pCollisionModels->PushBack(cm);
+        }
+    }
+
+    OVR_DEBUG_LOG(("Done."));
+    return true;
+}
+
+bool XmlHandler::WriteSceneCache(const char* cachePath, uint64_t sourceSize, uint64_t sourceHash)
+{
+    SceneCacheWriter writer;
+
+    SceneCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header.Magic                     = SceneCacheMagic;
+    header.Version                   = SceneCacheVersion;
+    header.VertexSize                = sizeof(Vertex);
+    header.SourceHash                = sourceHash;
+    header.SourceSize                = sourceSize;
+    header.TextureCount              = (uint32_t)TextureNames.GetSize();
+    header.ModelCount                = (uint32_t)Models.GetSize();
+    header.CollisionModelCount       = (uint32_t)CollisionModels.GetSize();
+    header.GroundCollisionModelCount = (uint32_t)GroundCollisionModels.GetSize();
+    writer.Write(&header);
+
+    for (size_t i = 0; i < TextureNames.GetSize(); ++i)
+    {
+        uint32_t length = (uint32_t)TextureNames[i].GetSize();
+        writer.Write(&length);
+        writer.Write(TextureNames[i].ToCStr(), length);
+    }
+
+    for (size_t i = 0; i < Models.GetSize(); ++i)
+    {
+        const Model*     model = Models[i];
+        const ModelInfo& info  = ModelInfos[i];
+
+        SceneCacheModel item;
+        item.NameLength           = (uint32_t)info.Name.GetSize();
+        item.DiffuseTextureIndex  = info.DiffuseTextureIndex;
+        item.LightmapTextureIndex = info.LightmapTextureIndex;
+        item.IsCollisionModel     = model->IsCollisionModel ? 1 : 0;
+        item.VertexCount          = (uint32_t)model->Vertices.GetSize();
+        item.IndexCount           = (uint32_t)model->Indices.GetSize();
+        writer.Write(&item);
+        writer.Write(info.Name.ToCStr(), item.NameLength);
+        writer.Write(model->Vertices.GetDataPtr(), item.VertexCount);
+        writer.Write(model->Indices.GetDataPtr(), item.IndexCount);
+    }
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        const OVR::Array<Ptr<CollisionModel> >& collisionModels = pass ? GroundCollisionModels : CollisionModels;
+        for (size_t i = 0; i < collisionModels.GetSize(); ++i)
+        {
+            uint32_t planeCount = (uint32_t)collisionModels[i]->Planes.GetSize();
+            writer.Write(&planeCount);
+            writer.Write(collisionModels[i]->Planes.GetDataPtr(), planeCount);
+        }
+    }
+
+    header.FileSize = writer.Data.GetSize();
+    memcpy(writer.Data.GetDataPtr(), &header, sizeof(header));
+
+    // Write to a temporary file and rename it, so that a reader never maps a partial file.
+    String  tempPath = String(cachePath) + ".tmp";
+    SysFile out(tempPath, File::Open_Write | File::Open_Create | File::Open_Truncate);
+    if (!out.IsValid())
+    {
+        return false;
+    }
+    int  size    = (int)writer.Data.GetSize();
+    bool written = (out.Write(writer.Data.GetDataPtr(), size) == size);
+    written = out.Close() && written;
+    if (!written)
+    {
+        remove(tempPath.ToCStr());
+        return false;
+    }
+    remove(cachePath);
+    return rename(tempPath.ToCStr(), cachePath) == 0;
+}
+
+void XmlHandler::ParseVectorString(const char* str, OVR::ArrayArenaPOD<OVR::Vector3f> *array,
 	                               bool is2element)
 {
     size_t stride = is2element ? 2 : 3;
@@ -26,6 +26,7 @@ limitations under the License.
 
 #include "Render_Device.h"
 #include <Kernel/OVR_SysFile.h>
+#include <Kernel/OVR_FrameArena.h>
 using namespace OVR;
 using namespace OVR::Render;
 
@@ -35,6 +36,13 @@ namespace OVR { namespace Render {
 
 using namespace tinyxml2;
 
+// XmlHandler imports the XML scenes exported for the samples.
+//
+// Parsing the vertex data out of the XML text dominates load time for large scenes,
+// so ReadFile bakes what it imports into a binary scene file next to the XML file
+// (fileName + SceneCacheExtension) and loads that instead, memory mapped, for as
+// long as the XML file's size and hash match the ones it was baked from. Vertices
+// and indices are stored in their final Vertex and uint16_t layout.
 class XmlHandler
 {
 public:
@@ -49,10 +57,31 @@ public:
                   bool anisotropic = false);
 
 protected:
-    void ParseVectorString(const char* str, OVR::Array<OVR::Vector3f> *array,
+    void ParseVectorString(const char* str, OVR::ArrayArenaPOD<OVR::Vector3f> *array,
 		                   bool is2element = false);
 
+    Ptr<Texture>    LoadTexture(const char* textureName, OVR::Render::RenderDevice* pRender,
+                                int textureLoadFlags);
+    Ptr<ShaderFill> CreateFill(OVR::Render::RenderDevice* pRender,
+                               int diffuseTextureIndex, int lightmapTextureIndex);
+
+    // Binary scene file; see SceneCache in the .cpp for the layout.
+    bool ReadSceneCache(const char* cachePath, uint64_t sourceSize, uint64_t sourceHash,
+                        OVR::Render::RenderDevice* pRender, OVR::Render::Scene* pScene,
+                        OVR::Array<Ptr<CollisionModel> >* pCollisions,
+                        OVR::Array<Ptr<CollisionModel> >* pGroundCollisions,
+                        int textureLoadFlags);
+    bool WriteSceneCache(const char* cachePath, uint64_t sourceSize, uint64_t sourceHash);
+
 private:
+    // What the binary scene file needs of each imported model besides its vertices.
+    struct ModelInfo
+    {
+        String Name;
+        int    DiffuseTextureIndex;
+        int    LightmapTextureIndex;
+    };
+
     tinyxml2::XMLDocument* pXmlDocument;
     char                   filePath[250];
     int                    textureCount;
@@ -61,8 +90,20 @@ private:
     OVR::Array<Ptr<Model> > Models;
     int                    collisionModelCount;
     int                    groundCollisionModelCount;
+
+    // Scratch memory for the vertex data of the model being imported from XML.
+    OVR::LinearArena       ParseArena;
+
+    // Imported from XML, for WriteSceneCache.
+    OVR::Array<String>     TextureNames;
+    OVR::Array<ModelInfo>  ModelInfos;
+    OVR::Array<Ptr<CollisionModel> > CollisionModels;
+    OVR::Array<Ptr<CollisionModel> > GroundCollisionModels;
 };
 
+// Appended to the XML file name to name its binary scene file.
+extern const char* const SceneCacheExtension;
+
 }} // OVR::Render
 
 #ifdef OVR_DEFINE_NEW
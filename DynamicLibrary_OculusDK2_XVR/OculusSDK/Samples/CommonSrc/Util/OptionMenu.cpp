@@ -662,6 +662,14 @@ bool FindLineCharRange(const char* text, int searchLine, size_t charRange[2])
     return false;
 }
 
+// Appends line to a block of menu text, one item per line.
+static void AppendTextLine(ArrayArenaPOD<char>& text, const String& line)
+{
+    if (text.GetSize() > 0)
+        text.PushBack('\n');
+    text.Append(line.ToCStr(), line.GetSize());
+}
+
 Color ApplyGammaCurve(Color inColor, float gammaCurve)
 {
     inColor.R = (uint8_t)(pow(OVR::Alg::Clamp(((float)inColor.R) / 255.999f, 0.0f, 1.0f), gammaCurve) * 255.999f);
@@ -722,42 +730,38 @@ Recti OptionSelectionMenu::Render(RenderDevice* prender, String title, float tex
 
     prender->MeasureText(&DejaVu, "      ", textSize, bufferSize);
 
-    String values;
-    String menuItems;
+    // The text is rebuilt every frame, so it lives in scratch memory.
+    ArenaScope          scratch(TextArena);
+    ArrayArenaPOD<char> values;
+    ArrayArenaPOD<char> menuItems;
 
     int highlightIndex = 0;
     if (DisplayState == Display_Menu)
     {
         highlightIndex = SelectedIndex;
         for (uint32_t i = 0; i < Items.GetSize(); i++)
-        {
-            if (i > 0)
-                values += "\n";
-            values += Items[i]->GetValue();
-        }
+            AppendTextLine(values, Items[i]->GetValue());
 
         for (uint32_t i = 0; i < Items.GetSize(); i++)
-        {
-            if (i > 0)
-                menuItems += "\n";
-            menuItems += Items[i]->GetLabel();
-        }
+            AppendTextLine(menuItems, Items[i]->GetLabel());
     }
     else
     {
-        values = Items[SelectedIndex]->GetValue();
-        menuItems = Items[SelectedIndex]->GetLabel();
+        AppendTextLine(values, Items[SelectedIndex]->GetValue());
+        AppendTextLine(menuItems, Items[SelectedIndex]->GetLabel());
     }
+    values.PushBack(0);
+    menuItems.PushBack(0);
 
     // Measure labels
-    const char* menuItemsCStr = menuItems.ToCStr();
+    const char* menuItemsCStr = menuItems.GetDataPtr();
     bool havelLabelSelection = FindLineCharRange(menuItemsCStr, highlightIndex, selection);
 	OVR_UNUSED(havelLabelSelection);
     prender->MeasureText(&DejaVu, menuItemsCStr, textSize, labelsSize,
                          selection, labelSelectionRect);
 
     // Measure label-to-value gap
-    const char* valuesCStr = values.ToCStr();
+    const char* valuesCStr = values.GetDataPtr();
     bool haveValueSelection = FindLineCharRange(valuesCStr, highlightIndex, selection);
 	OVR_UNUSED(haveValueSelection);
     prender->MeasureText(&DejaVu, valuesCStr, textSize, valuesSize, selection, valueSelectionRect);
@@ -33,6 +33,7 @@ limitations under the License.
 #include <Kernel/OVR_SysFile.h>
 #include <Kernel/OVR_Log.h>
 #include <Kernel/OVR_Timer.h>
+#include <Kernel/OVR_FrameArena.h>
 
 
 using namespace OVR;
@@ -461,6 +462,9 @@ public:
     OptionShortcut NavShortcuts[Nav_LAST];
     OptionShortcut ToggleShortcut;
     OptionShortcut ToggleSingleItemShortcut;
+
+    // Scratch memory for the menu text Render builds every frame.
+    LinearArena    TextArena;
 };
 
 